@@ -0,0 +1,5 @@
+#pragma once
+
+#define PROGRAM_VERSION_STRING " 9.1-Pulstar(dev)"
+
+#define PROGRAM_BUILT_STRING __DATE__ " - " __TIME__
@@ -1,16 +1,16 @@
 #include "GameNameMapManager.h"
 #include <utils/String.h>
 
-const char* GameNameMapManager::mFlashbackNameToRealName[GameNameMapManager::sFlashbackListSize * 2] =
+constexpr const char* const GameNameMapManager::mFlashbackNameToRealName[GameNameMapManager::sFlashbackListSize * 2] =
 {
   "instru_f", "Flashback DOS (disk)",
   "instru_e", "Flashback DOS (CD)",
   "demo_uk", "Flashback DOS (Demo)",
 };
 
-int GameNameMapManager::mFlashbackNameHashes[GameNameMapManager::sFlashbackListSize];
+constexpr PerfectHash<GameNameMapManager::sFlashbackListSize, 4, 16> GameNameMapManager::mFlashbackNameIndex(GameNameMapManager::mFlashbackNameToRealName, 2);
 
-const char* GameNameMapManager::mMameNameToRealName[GameNameMapManager::sMameListSize * 2] =
+constexpr const char* const GameNameMapManager::mMameNameToRealName[GameNameMapManager::sMameListSize * 2] =
 {
 	"005", "005", 
 	"10yard", "10-Yard Fight (World, set 1)", 
@@ -30460,7 +30460,8 @@ const char* GameNameMapManager::mMameNameToRealName[GameNameMapManager::sMameLis
 	"zzyzzyx2", "Zzyzzyxx (set 2)",
 };
 
-int GameNameMapManager::mMameNameHashes[GameNameMapManager::sMameListSize];
+constexpr PerfectHash<GameNameMapManager::sMameListSize, GameNameMapManager::sMameBucketCount, GameNameMapManager::sMameTableSize>
+  GameNameMapManager::mMameNameIndex(GameNameMapManager::mMameNameToRealName, 2);
 
 HashMap<String, bool> GameNameMapManager::mMameBios =
 {
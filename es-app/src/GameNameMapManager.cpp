@@ -5,53 +5,16 @@
 #include <utils/String.h>
 #include "GameNameMapManager.h"
 
-void GameNameMapManager::GenerateMameNameHashes()
-{
-  for(int i = sMameListSize; --i >=0; )
-    mMameNameHashes[i] = String::Hash(mMameNameToRealName[i * 2]);
-}
-
-void GameNameMapManager::GenerateFlashbackNameHashes()
-{
-  for(int i = sFlashbackListSize; --i >=0; )
-    mFlashbackNameHashes[i] = String::Hash(mFlashbackNameToRealName[i * 2]);
-}
-
 const char* GameNameMapManager::GetCleanMameName(const String& from)
 {
-  static bool HashGenerated = false;
-  if (!HashGenerated)
-  {
-    GenerateMameNameHashes();
-    HashGenerated = true;
-  }
-
-  int hash = from.Hash();
-  for(int i = sMameListSize; --i >= 0; )
-    if (mMameNameHashes[i] == hash)
-      if (strcmp(from.c_str(), mMameNameToRealName[i << 1]) == 0)
-        return mMameNameToRealName[(i << 1) + 1];
-
-  return nullptr;
+  int index = mMameNameIndex.Lookup(from.c_str());
+  return index >= 0 ? mMameNameToRealName[(index << 1) + 1] : nullptr;
 }
 
-
 const char* GameNameMapManager::GetCleanFlashbackName(const String& from)
 {
-  static bool HashGenerated = false;
-  if (!HashGenerated)
-  {
-    GenerateFlashbackNameHashes();
-    HashGenerated = true;
-  }
-
-  int hash = from.Hash();
-  for(int i = sFlashbackListSize; --i >= 0; )
-    if (mFlashbackNameHashes[i] == hash)
-      if (strcmp(from.c_str(), mFlashbackNameToRealName[i << 1]) == 0)
-        return mFlashbackNameToRealName[(i << 1) + 1];
-
-  return nullptr;
+  int index = mFlashbackNameIndex.Lookup(from.c_str());
+  return index >= 0 ? mFlashbackNameToRealName[(index << 1) + 1] : nullptr;
 }
 
 bool GameNameMapManager::HasRenaming(const SystemData& system)
@@ -5,6 +5,7 @@
 
 #include <utils/String.h>
 #include <utils/storage/HashMap.h>
+#include <utils/storage/PerfectHash.h>
 #include <systems/SystemData.h>
 
 class GameNameMapManager
@@ -12,13 +13,17 @@ class GameNameMapManager
   private:
     //! MAME name count
     static constexpr int sMameListSize = 30444;
+    //! MAME name perfect hash buckets
+    static constexpr int sMameBucketCount = 8192;
+    //! MAME name perfect hash slots
+    static constexpr int sMameTableSize = 65536;
     //! Flashback name count
     static constexpr int sFlashbackListSize = 3;
 
     //! Mame names
-    static const char* mMameNameToRealName[sMameListSize * 2];
-    //! Mame hashed
-    static int         mMameNameHashes[sMameListSize];
+    static const char* const mMameNameToRealName[sMameListSize * 2];
+    //! Mame name index, built at compile time
+    static const PerfectHash<sMameListSize, sMameBucketCount, sMameTableSize> mMameNameIndex;
 
     //! Mame device files - TODO: use et set
     static HashMap<String, bool> mMameDevices;
@@ -26,19 +31,9 @@ class GameNameMapManager
     static HashMap<String, bool> mMameBios;
 
     //! Mame names
-    static const char* mFlashbackNameToRealName[sFlashbackListSize * 2];
-    //! Mame hashed
-    static int         mFlashbackNameHashes[sFlashbackListSize];
-
-    /*!
-     * @brief Initialize all MAME hashes
-     */
-    static void GenerateMameNameHashes();
-
-    /*!
-     * @brief Initialize all MAME hashes
-     */
-    static void GenerateFlashbackNameHashes();
+    static const char* const mFlashbackNameToRealName[sFlashbackListSize * 2];
+    //! Flashback name index, built at compile time
+    static const PerfectHash<sFlashbackListSize, 4, 16> mFlashbackNameIndex;
 
     /*!
      * @brief Get a MAME game name, given the file name
@@ -37,6 +37,7 @@
 #include <emulators/run/GameRunner.h>
 #include <sdl2/Sdl2Init.h>
 #include <patreon/PatronInfo.h>
+#include <utils/profiling/StartupProfiler.h>
 // #include <utils/os/system/Thread.h>
 
 class CheckNetwork : private Thread
@@ -115,6 +116,9 @@ MainRunner::ExitState MainRunner::Run()
 {
   try
   {
+    // Start boot profiling
+    StartupProfiler::Start();
+
     // Hardware board
     Board board(*this);
 
@@ -183,8 +187,11 @@ MainRunner::ExitState MainRunner::Run()
     window.RenderAll();
     PlayLoadingSound(audioManager);
 
-    if (!TryToLoadConfiguredSystems(systemManager, fileNotifier, sForceReloadFromDisk))
-      return ExitState::FatalError;
+    {
+      StartupProfiler::Scope scope("boot", "Systems");
+      if (!TryToLoadConfiguredSystems(systemManager, fileNotifier, sForceReloadFromDisk))
+        return ExitState::FatalError;
+    }
     ResetForceReloadState();
 
     // Scrapers
@@ -259,7 +266,10 @@ MainRunner::ExitState MainRunner::Run()
       ScraperSeamless seamlessScraper;
 
       // Input ok?
-      InitializeUserInterface(window);
+      {
+        StartupProfiler::Scope scope("boot", "UserInterface");
+        InitializeUserInterface(window);
+      }
 
       // Update?
       CheckUpdateMessage(window);
@@ -284,6 +294,9 @@ MainRunner::ExitState MainRunner::Run()
       fileNotifier.WatchFile(externalNotificationFolder)
                   .SetEventNotifier(EventType::CloseWrite | EventType::Remove | EventType::Create, this);
 
+      // Boot complete
+      StartupProfiler::Complete();
+
       // Main SDL loop
       exitState = MainLoop(window, systemManager, fileNotifier, mSyncMessageFactory);
 
@@ -372,16 +385,17 @@ MainRunner::ExitState MainRunner::MainLoop(ApplicationWindow& window, SystemMana
   for(;;)
   {
     // File watching
-    fileNotifier.CheckAndDispatch();
+    bool activity = fileNotifier.CheckAndDispatch();
     InputManager::Instance().WatchJoystickAddRemove(&window);
 
     // Sync'ed message
-    syncMessageFactory.DispatchMessage();
+    activity |= syncMessageFactory.DispatchMessage();
 
     // SDL
     SDL_Event event;
     while (SDL_PollEvent(&event) != 0)
     {
+      activity = true;
       switch (event.type)
       {
         case SDL_QUIT: return ExitState::Quit;
@@ -424,6 +438,7 @@ MainRunner::ExitState MainRunner::MainLoop(ApplicationWindow& window, SystemMana
         default: break;
       }
     }
+    if (activity) window.Invalidate();
 
     if (window.isSleeping() && !GameClipView::IsGameClipEnabled())
     {
@@ -431,8 +446,8 @@ MainRunner::ExitState MainRunner::MainLoop(ApplicationWindow& window, SystemMana
         demoMode.runDemo();
 
       lastTime = (int)SDL_GetTicks();
-      // Take a breath
-      SDL_Delay(1);
+      // Take a breath until something happens
+      SDL_WaitEventTimeout(nullptr, sIdleWaitTime);
       continue;
     }
 
@@ -443,7 +458,9 @@ MainRunner::ExitState MainRunner::MainLoop(ApplicationWindow& window, SystemMana
       deltaTime = 1000;
 
     window.Update(deltaTime);
-    window.RenderAll();
+    // Render only when the screen changes, otherwise wait for events without consuming them
+    if (window.NeedRendering()) window.RenderAll();
+    else SDL_WaitEventTimeout(nullptr, sIdleWaitTime);
 
     // Quit Request?
     if (sQuitRequested)
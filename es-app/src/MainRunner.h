@@ -117,6 +117,8 @@ class MainRunner
   private:
     //! Power button: Threshold from short to long press, in milisecond
     static constexpr const int sPowerButtonThreshold = 500;
+    //! Maximum time to wait for events when nothing has to be rendered, in milisecond
+    static constexpr const int sIdleWaitTime = 50;
 
     //! Requested width
     unsigned int mRequestedWidth;
@@ -103,37 +103,14 @@ void RatingComponent::Render(const Transform4x4f& parentTrans)
 	Transform4x4f trans = (parentTrans * getTransform()).round();
 	Renderer::SetMatrix(trans);
 
-	glEnable(GL_TEXTURE_2D);
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	
-	
-	int r = ((int)mColor >> 24) & 0xFF;
-	int g = ((int)mColor >> 16) & 0xFF;
-	int b = ((int)mColor >> 8 ) & 0xFF;
-	//int a = mColor & 0xFF;
-
-	glColor4ub(r, g, b, getOpacity());
-
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-	
-	glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &mVertices[0].pos);
-	glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &mVertices[0].tex);
-	
+	// Theme color, component opacity
+	unsigned int color = (mColor & 0xFFFFFF00) | (unsigned int)getOpacity();
+
 	mFilledTexture->bind();
-	glDrawArrays(GL_TRIANGLES, 0, 6);
+	Renderer::DrawTexturedTriangles(0, &mVertices[0], color, 6, true);
 
 	mUnfilledTexture->bind();
-	glDrawArrays(GL_TRIANGLES, 6, 6);
-
-	glDisableClientState(GL_VERTEX_ARRAY);
-	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-	
-	glDisable(GL_TEXTURE_2D);
-	glDisable(GL_BLEND);
-
-	glColor4ub(255, 255, 255, 255);
+	Renderer::DrawTexturedTriangles(0, &mVertices[6], color, 6, true);
 
 	renderChildren(trans);
 }
@@ -33,6 +33,8 @@ protected:
 	using IList<TextListData, T>::getTransform;
 	using IList<TextListData, T>::mSize;
 	using IList<TextListData, T>::mCursor;
+	using IList<TextListData, T>::mWindow;
+	using IList<TextListData, T>::NameOf;
   using typename IList<TextListData, T>::Entry;
 
 public:
@@ -53,6 +55,12 @@ public:
 
 	void add(const String& name, const T& obj, int colorId, bool toTheBeginning = false);
   void add(const String& name, const T& obj, int colorId, signed char colorBackgroundId, HorizontalAlignment alignment);
+  /*!
+   * @brief Add an entry whose name is built by the name provider, only when it is displayed
+   * @param obj Entry object
+   * @param colorId Color index
+   */
+  void addLazy(const T& obj, int colorId);
   void changeTextAt(int index, const String& name);
   void changeBackgroundColorAt(int index, int colorIndex);
   int Lookup(T object);
@@ -60,6 +68,7 @@ public:
   inline void setSelectedAt(int index, const T& object) { mEntries[index].object = object; }
 	inline void setAlignment(HorizontalAlignment align) { mAlignment = align; }
 	inline void setCursorChangedCallback(const std::function<void(CursorState)>& func) { mCursorChangedCallback = func; }
+	inline void setNameProvider(const std::function<String(const T&)>& func) { mNameProvider = func; }
 	inline void setFont(const std::shared_ptr<Font>& font)
 	{
 		mFont = font;
@@ -93,6 +102,7 @@ public:
   protected:
 	virtual void onScroll(int amt) { (void)amt; AudioManager::Instance().PlaySound(mScrollSound); }
 	virtual void onCursorChanged(const CursorState& state);
+	String ResolveName(const T& object) override { return mNameProvider ? mNameProvider(object) : String(); }
 
 private:
   void updateBarColor()
@@ -130,6 +140,7 @@ private:
   unsigned int mColors[COLOR_ID_COUNT];
   std::shared_ptr<Font> mFont;
   std::function<void(CursorState state)> mCursorChangedCallback;
+  std::function<String(const T& object)> mNameProvider;
   AudioManager::AudioHandle mScrollSound;
 
   ITextListComponentOverlay<T>* mOverlay;
@@ -211,6 +222,11 @@ void TextListComponent<T>::Render(const Transform4x4f& parentTrans)
 	int listCutoff = startEntry + screenCount;
 	if(listCutoff > size())	listCutoff = size();
 
+  // Rasterize the glyphs of the surrounding entries in the background, before they scroll into view
+  for (int i = Math::max(0, startEntry - screenCount); i < Math::min(size(), listCutoff + screenCount); i++)
+    if (!mEntries[i].data.textCache)
+      font->prewarmText(mUppercase ? NameOf(mEntries[i]).ToUpperCaseUTF8() : NameOf(mEntries[i]));
+
   // clip to inside margins
   Vector3f dim(mSize.x(), mSize.y(), 0);
   dim = trans * dim - trans.translation();
@@ -254,7 +270,7 @@ void TextListComponent<T>::Render(const Transform4x4f& parentTrans)
     unsigned int color = (mCursor == i && (mSelectedColor != 0)) ? mSelectedColor : mColors[entry.data.colorId];
 
 		if(!entry.data.textCache)
-			entry.data.textCache = std::unique_ptr<TextCache>(font->buildTextCache(mUppercase ? entry.name.ToUpperCaseUTF8() : entry.name, 0, 0, 0x000000FF));
+			entry.data.textCache = std::unique_ptr<TextCache>(font->buildTextCache(mUppercase ? NameOf(entry).ToUpperCaseUTF8() : NameOf(entry), 0, 0, 0x000000FF));
 
 		entry.data.textCache->setColor(color);
 
@@ -413,7 +429,12 @@ bool TextListComponent<T>::ProcessInput(const InputCompactEvent& event)
 template <typename T>
 void TextListComponent<T>::Update(int deltaTime)
 {
-  if (mBarTimer > 0) mBarTimer -= deltaTime;
+  if (mBarTimer > 0)
+  {
+    mBarTimer -= deltaTime;
+    if (mBarTimer <= sBarFadeTime) mWindow.Invalidate(); // Fading out
+  }
+  int previousOffset = mMarqueeOffset;
 
 	listUpdate(deltaTime);
 	if(!isScrolling() && size() > 0 && mEntries[mCursor].data.textCache)
@@ -460,6 +481,7 @@ void TextListComponent<T>::Update(int deltaTime)
       mMarqueeTime += deltaTime;
     }
 	}
+  if (mMarqueeOffset != previousOffset) mWindow.Invalidate();
 
   Component::Update(deltaTime);
 }
@@ -498,6 +520,20 @@ void TextListComponent<T>::add(const String& name, const T& obj, int color, sign
   ((IList< TextListData, T >*)this)->add(entry);
 }
 
+template <typename T>
+void TextListComponent<T>::addLazy(const T& obj, int color)
+{
+  assert((unsigned int)color < COLOR_ID_COUNT);
+
+  typename IList<TextListData, T>::Entry entry;
+  entry.object = obj;
+  entry.lazyName = true;
+  entry.data.colorId = color;
+  entry.data.colorBackgroundId = -1;
+  entry.data.useHzAlignment = false;
+  ((IList< TextListData, T >*)this)->add(entry);
+}
+
 template <typename T>
 void TextListComponent<T>::changeTextAt(int index, const String& name)
 {
@@ -219,6 +219,9 @@ bool GameRunner::RunGame(FileData& game, const EmulatorData& emulator, const Gam
   // Update last played time
   game.Metadata().SetLastPlayedNow();
 
+  // Persist session data
+  SystemData::JournalGame(game);
+
   return exitCode == 0;
 }
 
@@ -228,13 +231,15 @@ void GameRunner::SubSystemPrepareForRun()
     if (VideoEngine::IsInstantiated())
       VideoEngine::Instance().StopVideo(false);
     AudioManager::Instance().Deactivate();
-    WindowManager::Finalize();
+    WindowManager::Suspend();
   }
 }
 
 void GameRunner::SubSystemRestore()
 {
   if(mWindowManager != nullptr) {
+    mWindowManager->StartResumeTiming();
+    auto start = std::chrono::steady_clock::now();
     // Reinit
     Sdl2Init::Finalize();
     Sdl2Init::Initialize();
@@ -242,6 +247,7 @@ void GameRunner::SubSystemRestore()
     mWindowManager->normalizeNextUpdate();
     AudioManager::Instance().Reactivate();
     InputManager::Instance().Refresh(mWindowManager, false);
+    { LOG(LogInfo) << "[Run] Subsystems restored in " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() << "ms"; }
   }
 }
 
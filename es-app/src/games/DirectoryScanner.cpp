@@ -0,0 +1,289 @@
+#include "DirectoryScanner.h"
+#include "GameFilesUtils.h"
+#include "GameNameMapManager.h"
+#include <systems/SystemData.h>
+#include <utils/IniFile.h>
+#include <utils/Log.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+//! Raw getdents64 record
+struct LinuxDirent64
+{
+  ino64_t        d_ino;
+  off64_t        d_off;
+  unsigned short d_reclen;
+  unsigned char  d_type;
+  char           d_name[];
+};
+
+/*!
+ * @brief Split a filename into stem & extension, the same way Path does
+ * @param name Filename
+ * @param stem Filename without extension
+ * @param extension Extension, including the dot
+ */
+static void SplitFilename(const String& name, String& stem, String& extension)
+{
+  const char* p = name.c_str();
+  int startExt = -1;
+  while(p[++startExt] == '.');
+  for(int i = (int)name.size(); --i >= startExt;)
+    if (p[i] == '.')
+    {
+      stem.Assign(p, i);
+      extension.Assign(p + i);
+      return;
+    }
+  stem = name;
+  extension.clear();
+}
+
+ExtensionFilter::ExtensionFilter(const String& extensionList)
+  : mList(extensionList)
+  , mFileMode(false)
+  , mMultiDisk(GameFilesUtils::ContainsMultiDiskFile(extensionList))
+{
+  #define sFilesPrefix "files:"
+  int start = 0;
+  if (extensionList.StartsWith(LEGACY_STRING(sFilesPrefix)))
+  {
+    mFileMode = true;
+    start = sizeof(sFilesPrefix) - 1;
+  }
+
+  const char* p = extensionList.c_str();
+  for(int end = start; ; ++end)
+    if (p[end] == ' ' || p[end] == 0)
+    {
+      if (end > start)
+      {
+        if (mFileMode) mItems.insert(String(p + start, end - start));
+        else
+          // Any extension ending the item matches, so store all dot-suffixes (.tar.gz => .tar.gz & .gz)
+          for(int i = start; i < end; ++i)
+            if (p[i] == '.') mItems.insert(String(p + i, end - i));
+      }
+      if (p[end] == 0) break;
+      start = end + 1;
+    }
+}
+
+bool ExtensionFilter::IsMatching(const String& stem, const String& extension) const
+{
+  if (!mFileMode) return mItems.contains(extension);
+
+  String file(stem); file.Append(extension).LowerCase();
+  return mItems.contains(file);
+}
+
+ScannedFolder::~ScannedFolder()
+{
+  for(const Entry& entry : mEntries)
+    delete entry.Child;
+  delete mOwnFilter;
+}
+
+DirectoryScanner::DirectoryScanner(const SystemData& system, const String& ignoreList)
+  : mSystem(system)
+  , mRoot(nullptr)
+  , mPool(nullptr)
+  , mOutstanding(0)
+  , mHasFiltering(GameNameMapManager::HasFiltering(system))
+{
+  // Only names enclosed in commas are ignored
+  const char* p = ignoreList.c_str();
+  for(int start = (int)ignoreList.Find(','); start >= 0; )
+  {
+    int end = (int)ignoreList.Find(',', start + 1);
+    if (end < 0) break;
+    if (end > start + 1) mIgnoreList.insert(String(p + start + 1, end - start - 1));
+    start = end;
+  }
+}
+
+const ScannedFolder* DirectoryScanner::Scan(const Path& folder, const String& extensions, const HashSet<String>* only)
+{
+  delete mRoot;
+  mRoot = nullptr;
+
+  if (!folder.IsDirectory())
+  {
+    { LOG(LogWarning) << "[FolderData] Error - folder with path \"" << folder.ToString() << "\" is not a directory!"; }
+    return nullptr;
+  }
+
+  // media folder?
+  if (folder.FilenameWithoutExtension() == "media")
+    return nullptr;
+
+  //make sure that this isn't a symlink to a thing we already have
+  if (folder.IsSymLink())
+  {
+    // if this symlink resolves to somewhere that's at the beginning of our path, it's gonna recurse
+    Path canonical = folder.ToCanonical();
+    if (folder.ToString().compare(0, canonical.ToString().size(), canonical.ToChars()) == 0)
+    { LOG(LogWarning) << "[FolderData] Skipping infinitely recursive symlink \"" << folder.ToString() << "\""; return nullptr; }
+  }
+
+  ExtensionFilter* rootFilter = new ExtensionFilter(extensions);
+  mRoot = new ScannedFolder(folder, rootFilter);
+  mRoot->mOwnFilter = rootFilter;
+
+  // Scan level by level
+  ScanFolder(*mRoot);
+  if (only != nullptr)
+    for(int i = (int)mRoot->mEntries.size(); --i >= 0; )
+      if (!only->contains(mRoot->mEntries[i].Name))
+      {
+        delete mRoot->mEntries[i].Child;
+        mRoot->mEntries.erase(mRoot->mEntries.begin() + i);
+      }
+
+  // Scan sub-folders using a single pool: each job pushes the sub-folders it finds
+  WorkStealingThreadPool<ScannedFolder*, bool> pool(this, "Rom-Scan", true);
+  mPool = &pool;
+  mOutstanding = 0;
+  mCompleted.Reset();
+  for(const ScannedFolder::Entry& entry : mRoot->mEntries)
+    if (entry.Child != nullptr)
+    {
+      mOutstanding++;
+      pool.PushFeed(entry.Child);
+    }
+  if (mOutstanding != 0)
+  {
+    pool.Run(sMaxWorkers, true);
+    mCompleted.WaitSignal();
+  }
+  mPool = nullptr;
+
+  return mRoot;
+}
+
+bool DirectoryScanner::ThreadPoolRunJob(ScannedFolder*& feed)
+{
+  ScanFolder(*feed);
+  // Count sub-folders before this one completes, so that the counter cannot reach 0 too early
+  for(const ScannedFolder::Entry& entry : feed->mEntries)
+    if (entry.Child != nullptr)
+    {
+      mOutstanding++;
+      mPool->PushFeed(entry.Child);
+    }
+  if (--mOutstanding == 0) mCompleted.Fire();
+  return true;
+}
+
+void DirectoryScanner::ReadDirectory(const Path& folder, std::vector<RawEntry>& entries)
+{
+  int fd = open(folder.ToChars(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0) return;
+
+  alignas(LinuxDirent64) char buffer[sBufferSize];
+  for(long read; (read = syscall(SYS_getdents64, fd, buffer, sizeof(buffer))) > 0; )
+    for(long offset = 0; offset < read; )
+    {
+      const LinuxDirent64* entry = (const LinuxDirent64*)(buffer + offset);
+      offset += entry->d_reclen;
+      // Ignore "." and ".."
+      const char* name = entry->d_name;
+      if (name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0))) continue;
+      entries.push_back({ String(name), entry->d_type });
+    }
+
+  close(fd);
+}
+
+bool DirectoryScanner::IsOfType(const Path& folder, const RawEntry& entry, unsigned int mode)
+{
+  switch(entry.Type)
+  {
+    case DT_REG: return mode == S_IFREG;
+    case DT_DIR: return mode == S_IFDIR;
+    case DT_LNK:
+    case DT_UNKNOWN:
+    {
+      // Follow links & resolve unknown types
+      struct stat64 info {};
+      if (stat64((folder / entry.Name).ToChars(), &info) != 0) return false;
+      return (info.st_mode & S_IFMT) == mode;
+    }
+    default: return false;
+  }
+}
+
+void DirectoryScanner::ScanFolder(ScannedFolder& folder)
+{
+  const Path& folderPath = folder.mPath;
+  std::vector<RawEntry> items;
+  ReadDirectory(folderPath, items);
+
+  // Subsystem override
+  for(const RawEntry& item : items)
+    if (item.Name == ".system.cfg")
+    {
+      IniFile subSystem(folderPath / ".system.cfg", false, false);
+      folder.mOwnFilter = new ExtensionFilter(subSystem.AsString("extensions", folder.mFilter->List()));
+      folder.mFilter = folder.mOwnFilter;
+      break;
+    }
+  const ExtensionFilter& filter = *folder.mFilter;
+
+  String stem;
+  String extension;
+  HashSet<String> blacklist;
+  if (filter.HasMultiDiskFiles())
+    for(const RawEntry& item : items)
+    {
+      SplitFilename(item.Name, stem, extension);
+      if (extension == ".cue" || extension == ".ccd" || extension == ".gdi" || extension == ".m3u")
+        GameFilesUtils::ExtractUselessFiles(folderPath / item.Name, blacklist);
+    }
+
+  for(const RawEntry& item : items)
+  {
+    SplitFilename(item.Name, stem, extension);
+    if (stem == "gamelist") continue; // Ignore gamelist.zip/xml
+    if (stem.empty()) continue;
+
+    // Force to hide ignored files
+    if (mIgnoreList.contains(item.Name)) continue;
+    if (!blacklist.empty() && blacklist.contains((folderPath / item.Name).ToString())) continue;
+    // Hidden
+    if (item.Name[0] == '.') continue;
+
+    //fyi, folders *can* also match the extension and be added as games - this is mostly just to support higan
+    //see issue #75: https://github.com/Aloshi/EmulationStation/issues/75
+    extension.LowerCase();
+    if ((filter.IsEmpty() && IsOfType(folderPath, item, S_IFREG)) ||
+        (!extension.empty() && filter.IsMatching(stem, extension)))
+    {
+      if (mHasFiltering && GameNameMapManager::IsFiltered(mSystem, stem))
+        continue; // MAME Bios or Machine
+      folder.mEntries.push_back({ item.Name, ScannedFolder::Kind::Game, nullptr });
+      continue;
+    }
+
+    //add directories that also do not match an extension as folders
+    if (!IsOfType(folderPath, item, S_IFDIR)) continue;
+    // media folder?
+    if (stem == "media") continue;
+    // make sure that this isn't a symlink to a thing we already have
+    if (item.Type == DT_LNK || item.Type == DT_UNKNOWN)
+    {
+      Path subFolder(folderPath / item.Name);
+      if (subFolder.IsSymLink())
+      {
+        // if this symlink resolves to somewhere that's at the beginning of our path, it's gonna recurse
+        Path canonical = subFolder.ToCanonical();
+        if (subFolder.ToString().compare(0, canonical.ToString().size(), canonical.ToChars()) == 0)
+        { LOG(LogWarning) << "[FolderData] Skipping infinitely recursive symlink \"" << subFolder.ToString() << "\""; continue; }
+      }
+    }
+    folder.mEntries.push_back({ item.Name, ScannedFolder::Kind::Folder, new ScannedFolder(folderPath / item.Name, folder.mFilter) });
+  }
+}
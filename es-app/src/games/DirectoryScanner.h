@@ -0,0 +1,194 @@
+#pragma once
+
+#include <vector>
+#include <utils/os/fs/Path.h>
+#include <utils/storage/Set.h>
+#include <utils/os/system/IThreadPoolWorkerInterface.h>
+#include <utils/os/system/WorkStealingThreadPool.h>
+#include <utils/os/system/Signal.h>
+#include <atomic>
+
+class SystemData;
+
+/*!
+ * @brief Extension list, precomputed into a hash set
+ * Regular lists match any extension ending a space-separated item,
+ * "files:" lists match complete lowercase filenames.
+ */
+class ExtensionFilter
+{
+  public:
+    /*!
+     * @brief Constructor
+     * @param extensionList Space separated extension list, or "files:" list
+     */
+    explicit ExtensionFilter(const String& extensionList);
+
+    /*!
+     * @brief Check if the given file matches the filter
+     * @param stem Filename without extension
+     * @param extension Lowercase extension, including the dot
+     * @return True if the file matches
+     */
+    [[nodiscard]] bool IsMatching(const String& stem, const String& extension) const;
+
+    //! Source list
+    [[nodiscard]] const String& List() const { return mList; }
+    //! True if the source list is empty
+    [[nodiscard]] bool IsEmpty() const { return mList.empty(); }
+    //! True if the list contains multi-disk file extensions (cue, m3u, ...)
+    [[nodiscard]] bool HasMultiDiskFiles() const { return mMultiDisk; }
+
+  private:
+    //! Source list
+    String mList;
+    //! Extensions or filenames
+    HashSet<String> mItems;
+    //! Filename list
+    bool mFileMode;
+    //! Multi-disk extensions
+    bool mMultiDisk;
+};
+
+/*!
+ * @brief Result of a directory scan: launchable entries and sub-folders, in directory order
+ */
+class ScannedFolder
+{
+  public:
+    //! Entry type
+    enum class Kind
+    {
+      Game,   //!< Launchable entry
+      Folder, //!< Sub-folder to recurse into
+    };
+
+    //! Scanned entry
+    struct Entry
+    {
+      String         Name;  //!< Filename
+      Kind           Type;  //!< Entry type
+      ScannedFolder* Child; //!< Scanned sub-folder, or null for games
+    };
+
+    /*!
+     * @brief Constructor
+     * @param path Folder path
+     * @param filter Extension filter inherited from the parent
+     */
+    ScannedFolder(const Path& path, const ExtensionFilter* filter)
+      : mPath(path)
+      , mFilter(filter)
+      , mOwnFilter(nullptr)
+    {
+    }
+
+    //! Destructor
+    ~ScannedFolder();
+
+    //! Folder path
+    [[nodiscard]] const Path& FolderPath() const { return mPath; }
+    //! Entries
+    [[nodiscard]] const std::vector<Entry>& Entries() const { return mEntries; }
+
+  private:
+    friend class DirectoryScanner;
+
+    //! Folder path
+    Path mPath;
+    //! Entries
+    std::vector<Entry> mEntries;
+    //! Active extension filter
+    const ExtensionFilter* mFilter;
+    //! Filter owned by this folder, when overridden by a .system.cfg
+    ExtensionFilter* mOwnFilter;
+};
+
+/*!
+ * @brief Rom folder scanner
+ *
+ * Directories are read using batched getdents64 calls and classified from d_type,
+ * so that stat calls are only required for symlinks and filesystems not reporting types.
+ * Sub-folders are scanned by a small work-stealing pool, created once per scan:
+ * each job pushes the sub-folders it finds, until no folder is left.
+ * The resulting tree only holds candidate entries, in directory order, so that building
+ * the FileData tree from it gives exactly the same result as a sequential walk.
+ */
+class DirectoryScanner final : private IThreadPoolWorkerInterface<ScannedFolder*, bool>
+{
+  public:
+    /*!
+     * @brief Constructor
+     * @param system System being scanned (for bios/devices filtering)
+     * @param ignoreList Comma separated filenames to ignore
+     */
+    DirectoryScanner(const SystemData& system, const String& ignoreList);
+
+    //! Destructor
+    ~DirectoryScanner() { delete mRoot; }
+
+    /*!
+     * @brief Scan the given folder tree
+     * @param folder Root folder
+     * @param extensions Extension list
+     * @param only If not null, only entries of the root folder with these names are kept (and scanned)
+     * @return Scanned root folder, or null if the folder cannot be scanned. Owned by the scanner
+     */
+    const ScannedFolder* Scan(const Path& folder, const String& extensions, const HashSet<String>* only = nullptr);
+
+  private:
+    //! Maximum workers
+    static constexpr int sMaxWorkers = 4;
+    //! getdents64 buffer size
+    static constexpr int sBufferSize = 32768;
+
+    //! Raw directory entry
+    struct RawEntry
+    {
+      String        Name; //!< Filename
+      unsigned char Type; //!< d_type
+    };
+
+    //! System
+    const SystemData& mSystem;
+    //! Filenames to ignore
+    HashSet<String> mIgnoreList;
+    //! Root folder
+    ScannedFolder* mRoot;
+    //! Running pool, during scans
+    WorkStealingThreadPool<ScannedFolder*, bool>* mPool;
+    //! Folders pushed and not scanned yet
+    std::atomic<int> mOutstanding;
+    //! Fired when all folders are scanned
+    Signal mCompleted;
+    //! Bios/devices filtering
+    bool mHasFiltering;
+
+    /*!
+     * @brief Read all entries of the given directory, except . and ..
+     * @param folder Folder to read
+     * @param entries Entry list to fill
+     */
+    static void ReadDirectory(const Path& folder, std::vector<RawEntry>& entries);
+
+    /*!
+     * @brief Get entry type, using stat only when d_type is not conclusive
+     * @param folder Parent folder
+     * @param entry Entry
+     * @param mode Type to check (S_IFREG, S_IFDIR)
+     * @return True if the entry is of the given type
+     */
+    static bool IsOfType(const Path& folder, const RawEntry& entry, unsigned int mode);
+
+    /*!
+     * @brief Scan a single folder, creating (but not scanning) its sub-folders
+     * @param folder Folder to scan
+     */
+    void ScanFolder(ScannedFolder& folder);
+
+    /*
+     * IThreadPoolWorkerInterface implementation
+     */
+
+    bool ThreadPoolRunJob(ScannedFolder*& feed) override;
+};
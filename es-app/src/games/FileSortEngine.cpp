@@ -0,0 +1,187 @@
+#include "FileSortEngine.h"
+#include <games/FolderData.h>
+#include <systems/SystemData.h>
+#include <RecalboxConf.h>
+#include <algorithm>
+#include <cstring>
+
+std::vector<FileSortEngine::CacheEntry> FileSortEngine::sCache;
+
+unsigned int FileSortEngine::Ordered(float value)
+{
+  unsigned int bits = 0;
+  memcpy(&bits, &value, sizeof(bits));
+  // Negative floats sort reversed, positive floats just need to be above negatives
+  return (bits & 0x80000000u) != 0 ? ~bits : bits | 0x80000000u;
+}
+
+String FileSortEngine::Normalize(const String& text)
+{
+  String result;
+  result.reserve(text.size());
+  for(int pos = 0;;)
+  {
+    String::Unicode c = text.ReadUTF8(pos);
+    if (c == 0) break;
+    result.AppendUTF8(String::UpperUnicode(c));
+  }
+  return result;
+}
+
+std::vector<const SystemData*> FileSortEngine::RankSystems(const FileData::List& items)
+{
+  std::vector<const SystemData*> systems;
+  const SystemData* last = nullptr;
+  for(const FileData* item : items)
+    if (&item->System() != last)
+    {
+      last = &item->System();
+      if (std::find(systems.begin(), systems.end(), last) == systems.end())
+        systems.push_back(last);
+    }
+  std::sort(systems.begin(), systems.end(), [](const SystemData* a, const SystemData* b)
+  {
+    int c = Normalize(a->Name()).compare(Normalize(b->Name()));
+    return c != 0 ? c < 0 : a < b;
+  });
+  return systems;
+}
+
+FileSortEngine::Fingerprint FileSortEngine::GetFingerprint(const FileData& item, FileSorts::Sorts sort, bool useFileName,
+                                                           const std::vector<const SystemData*>& systemRanks)
+{
+  const MetadataDescriptor& metadata = item.Metadata();
+  // Folders first
+  unsigned long long group = item.Type() == ItemType::Folder ? 0ULL : 1ULL << 32;
+  switch(sort)
+  {
+    case FileSorts::Sorts::FileNameAscending:
+    case FileSorts::Sorts::FileNameDescending:
+      return { group, useFileName ? metadata.FileIndex() : metadata.NameIndex() };
+    case FileSorts::Sorts::SystemAscending:
+    case FileSorts::Sorts::SystemDescending:
+    {
+      // No folder/game grouping in system sorts
+      unsigned int rank = std::find(systemRanks.begin(), systemRanks.end(), &item.System()) - systemRanks.begin();
+      return { rank, metadata.NameIndex() };
+    }
+    case FileSorts::Sorts::RatingAscending:
+    case FileSorts::Sorts::RatingDescending:
+      return { group | Ordered(metadata.Rating()), metadata.NameIndex() };
+    case FileSorts::Sorts::TimesPlayedAscending:
+    case FileSorts::Sorts::TimesPlayedDescending:
+      return { group | Ordered(metadata.PlayCount()), metadata.NameIndex() };
+    case FileSorts::Sorts::LastPlayedAscending:
+    case FileSorts::Sorts::LastPlayedDescending:
+    {
+      // Never played games go last
+      unsigned int epoch = metadata.LastPlayedEpoc();
+      return { group | (epoch != 0 ? epoch : 0xFFFFFFFFu), metadata.NameIndex() };
+    }
+    case FileSorts::Sorts::PlayersAscending:
+    case FileSorts::Sorts::PlayersDescending:
+      return { group | Ordered(metadata.PlayerRange()), metadata.NameIndex() };
+    case FileSorts::Sorts::DeveloperAscending:
+    case FileSorts::Sorts::DeveloperDescending:
+      return { group, metadata.DeveloperIndex() };
+    case FileSorts::Sorts::PublisherAscending:
+    case FileSorts::Sorts::PublisherDescending:
+      return { group, metadata.PublisherIndex() };
+    case FileSorts::Sorts::GenreAscending:
+    case FileSorts::Sorts::GenreDescending:
+      return { group | Ordered((int)metadata.GenreId()), metadata.NameIndex() };
+    case FileSorts::Sorts::ReleaseDateAscending:
+    case FileSorts::Sorts::ReleaseDateDescending:
+      return { group | Ordered((int)metadata.ReleaseDateEpoc()), metadata.NameIndex() };
+    default: break;
+  }
+  return { group, metadata.NameIndex() };
+}
+
+String FileSortEngine::GetText(const FileData& item, FileSorts::Sorts sort, bool useFileName)
+{
+  switch(sort)
+  {
+    case FileSorts::Sorts::FileNameAscending:
+    case FileSorts::Sorts::FileNameDescending:
+      return useFileName ? item.Metadata().RomFileOnly().ToString() : item.Name();
+    case FileSorts::Sorts::DeveloperAscending:
+    case FileSorts::Sorts::DeveloperDescending: return item.Metadata().Developer();
+    case FileSorts::Sorts::PublisherAscending:
+    case FileSorts::Sorts::PublisherDescending: return item.Metadata().Publisher();
+    default: break;
+  }
+  return item.Name();
+}
+
+void FileSortEngine::Sort(FileData::List& items, FileSorts::Sorts sort, const FolderData* folder, int filter)
+{
+  if (items.size() < 2) return;
+
+  bool useFileName = RecalboxConf::Instance().GetDisplayByFileName();
+  bool systemSort = sort == FileSorts::Sorts::SystemAscending || sort == FileSorts::Sorts::SystemDescending;
+  std::vector<const SystemData*> systemRanks;
+  if (systemSort) systemRanks = RankSystems(items);
+
+  // Raw fields
+  int count = (int)items.size();
+  std::vector<Fingerprint> prints;
+  prints.reserve(count);
+  for(const FileData* item : items)
+    prints.push_back(GetFingerprint(*item, sort, useFileName, systemRanks));
+
+  // Lookup cache
+  for(int i = 0; i < (int)sCache.size(); ++i)
+  {
+    CacheEntry& entry = sCache[i];
+    if (entry.Folder != folder || entry.Sort != sort || entry.Filter != filter) continue;
+    if (entry.UseFileName == useFileName && entry.Source == items && entry.Prints == prints)
+    {
+      items = entry.Sorted;
+      // Most recent first
+      if (i != 0) std::rotate(sCache.begin(), sCache.begin() + i, sCache.begin() + i + 1);
+      return;
+    }
+    // Outdated
+    sCache.erase(sCache.begin() + i);
+    break;
+  }
+
+  // Extract keys
+  std::vector<String> texts(count);
+  std::vector<Key> keys(count);
+  for(int i = count; --i >= 0; )
+  {
+    texts[i] = Normalize(GetText(*items[i], sort, useFileName));
+    unsigned long long prefix = 0;
+    const unsigned char* p = (const unsigned char*)texts[i].c_str();
+    for(int b = 0; b < 8; ++b)
+    {
+      prefix = (prefix << 8) | *p;
+      if (*p != 0) ++p;
+    }
+    keys[i] = { prints[i].Primary, prefix, i };
+  }
+
+  // Merge sort keys. Full texts are only compared when all 8 prefix bytes are equal & non-zero
+  auto compare = [&texts](const Key& a, const Key& b)
+  {
+    if (a.Primary != b.Primary) return a.Primary < b.Primary ? -1 : 1;
+    if (a.Prefix != b.Prefix) return a.Prefix < b.Prefix ? -1 : 1;
+    if ((a.Prefix & 0xFF) == 0) return 0;
+    return strcmp(texts[a.Index].c_str() + 8, texts[b.Index].c_str() + 8);
+  };
+  if (FileSorts::IsAscending(sort))
+    std::stable_sort(keys.begin(), keys.end(), [&compare](const Key& a, const Key& b) { return compare(a, b) < 0; });
+  else
+    std::stable_sort(keys.begin(), keys.end(), [&compare](const Key& a, const Key& b) { return compare(a, b) > 0; });
+
+  // Store
+  if ((int)sCache.size() >= sMaxCacheEntries) sCache.pop_back();
+  sCache.insert(sCache.begin(), { folder, sort, filter, useFileName, items, std::move(prints), FileData::List() });
+  FileData::List& sorted = sCache.front().Sorted;
+  sorted.reserve(count);
+  for(const Key& key : keys)
+    sorted.push_back(items[key.Index]);
+  items = sorted;
+}
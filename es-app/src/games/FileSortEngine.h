@@ -0,0 +1,112 @@
+#pragma once
+
+#include <vector>
+#include <games/FileData.h>
+#include <games/FileSorts.h>
+
+class FolderData;
+
+/*!
+ * @brief Key based sort engine
+ *
+ * Instead of fetching & comparing metadata strings on each comparison, a compact key is extracted
+ * once per game: numeric fields packed in a 64bit integer, the first bytes of the uppercased name
+ * packed in another 64bit integer, and an index to the full uppercased name for the rare ties.
+ * Keys are then merge-sorted (stable) in a contiguous array.
+ *
+ * Results are cached per (folder, sort, filter). A cached result is reused as long as the item list
+ * and the raw (non-string) sort fields are unchanged, so that switching back and forth between
+ * sorts or reopening a list does not sort again.
+ *
+ * Must be used from the main thread only.
+ */
+class FileSortEngine
+{
+  public:
+    /*!
+     * @brief Sort the given list
+     * @param items Items to sort
+     * @param sort Sort to apply
+     * @param folder Folder the items come from (cache key)
+     * @param filter Filter used to get items (cache key)
+     */
+    static void Sort(FileData::List& items, FileSorts::Sorts sort, const FolderData* folder, int filter);
+
+    /*!
+     * @brief Drop all cached results
+     */
+    static void ClearCache() { sCache.clear(); }
+
+  private:
+    //! Maximum cached sorts
+    static constexpr int sMaxCacheEntries = 4;
+
+    //! Compact sort key
+    struct Key
+    {
+      unsigned long long Primary; //!< Folder/Game group & numeric field
+      unsigned long long Prefix;  //!< First 8 bytes of the uppercased text, big endian
+      int Index;                  //!< Item index, also index of the full uppercased text
+    };
+
+    //! Raw sort fields, used to check cached results
+    struct Fingerprint
+    {
+      unsigned long long Primary; //!< Folder/Game group & numeric field
+      int Text;                   //!< Text index in the metadata string holder
+      bool operator == (const Fingerprint& r) const { return Primary == r.Primary && Text == r.Text; }
+    };
+
+    //! Cached sort
+    struct CacheEntry
+    {
+      const FolderData* Folder;        //!< Source folder
+      FileSorts::Sorts Sort;           //!< Sort
+      int Filter;                      //!< Filter
+      bool UseFileName;                //!< Filename used as name
+      FileData::List Source;           //!< Unsorted items
+      std::vector<Fingerprint> Prints; //!< Raw sort fields of unsorted items
+      FileData::List Sorted;           //!< Sorted items
+    };
+
+    //! Cached sorts, most recent first
+    static std::vector<CacheEntry> sCache;
+
+    /*!
+     * @brief Get raw sort fields of an item
+     * @param item Item
+     * @param sort Sort
+     * @param useFileName Use filename instead of name
+     * @param systemRanks Rank of each system in system name order (system sorts only)
+     * @return Fingerprint
+     */
+    static Fingerprint GetFingerprint(const FileData& item, FileSorts::Sorts sort, bool useFileName, const std::vector<const SystemData*>& systemRanks);
+
+    /*!
+     * @brief Get the text an item is sorted by, when numeric fields are equal
+     * @param item Item
+     * @param sort Sort
+     * @param useFileName Use filename instead of name
+     * @return Text
+     */
+    static String GetText(const FileData& item, FileSorts::Sorts sort, bool useFileName);
+
+    /*!
+     * @brief Uppercase the given UTF-8 text, so that byte comparisons give the same result as FileSorts comparers
+     * @param text Text to normalize
+     * @return Normalized text
+     */
+    static String Normalize(const String& text);
+
+    /*!
+     * @brief Build the list of systems of the given items, ordered by name
+     * @param items Items
+     * @return Ordered system list
+     */
+    static std::vector<const SystemData*> RankSystems(const FileData::List& items);
+
+    //! Map a signed value to an unsigned value keeping the order
+    static unsigned int Ordered(int value) { return (unsigned int)value ^ 0x80000000u; }
+    //! Map a float value to an unsigned value keeping the order
+    static unsigned int Ordered(float value);
+};
@@ -5,7 +5,6 @@
 #include "FolderData.h"
 #include "utils/Log.h"
 #include "systems/SystemData.h"
-#include "GameNameMapManager.h"
 #include "GameFilesUtils.h"
 #include <utils/Files.h>
 
@@ -57,144 +56,89 @@ bool FolderData::RemoveChildRecursively(const FileData* file)
   return result;
 }
 
-static bool IsMatching(const String& fileWoExt, const String& extension, const String& extensionList)
+void FolderData::PopulateRecursiveFolder(RootFolderData& root, const String& filteredExtensions, const String& ignoreList, FileData::StringMap& doppelgangerWatcher)
 {
-  #define sFilesPrefix "files:"
-  if (!extensionList.StartsWith(LEGACY_STRING(sFilesPrefix)))
-  {
-    // Seek in regular extensions
-    int start = 0;
-    while(start < (int)extensionList.size())
-    {
-      int extensionPos = extensionList.Find(extension, start);
-      if (extensionPos < 0) return false;
-      const char* p = extensionList.data();
-      char endChar = p[extensionPos + extension.size()];
-      if (endChar == ' ' || endChar == 0) return true;
-      start += (int)(extensionPos + extension.size());
-    }
-    return false;
-  }
-
-  // Seek complete files
-  constexpr int sFilesPrefixLength = sizeof(sFilesPrefix) - 1;
-  String file(fileWoExt); file.Append(extension).LowerCase();
-  int filePos = extensionList.Find(file);
-  if (filePos < 0) return false;
-  const char* p = extensionList.data();
-  return ((filePos == sFilesPrefixLength) || (p[filePos - 1] == ' ')) &&
-         ((filePos + file.size() == extensionList.size()) || (p[filePos + file.size()] == ' '));
+  DirectoryScanner scanner(System(), ignoreList);
+  const ScannedFolder* folder = scanner.Scan(RomPath(), filteredExtensions);
+  if (folder != nullptr)
+    PopulateFromScan(root, *folder, doppelgangerWatcher);
 }
 
-void FolderData::PopulateRecursiveFolder(RootFolderData& root, const String& originalFilteredExtensions, const String& ignoreList, FileData::StringMap& doppelgangerWatcher)
+void FolderData::PopulateFromScan(RootFolderData& root, const ScannedFolder& folder, FileData::StringMap& doppelgangerWatcher)
 {
-  const Path folderPath(RomPath());
-  if (!folderPath.IsDirectory())
+  for (const ScannedFolder::Entry& entry : folder.Entries())
   {
-    { LOG(LogWarning) << "[FolderData] Error - folder with path \"" << folderPath.ToString() << "\" is not a directory!"; }
-    return;
-  }
-
-  // media folder?
-  if (folderPath.FilenameWithoutExtension() == "media")
-    return;
-
-  //make sure that this isn't a symlink to a thing we already have
-  if (folderPath.IsSymLink())
-  {
-    // if this symlink resolves to somewhere that's at the beginning of our path, it's gonna recurse
-    Path canonical = folderPath.ToCanonical();
-    if (folderPath.ToString().compare(0, canonical.ToString().size(), canonical.ToChars()) == 0)
-    { LOG(LogWarning) << "[FolderData] Skipping infinitely recursive symlink \"" << folderPath.ToString() << "\""; return; }
-  }
+    Path filePath(folder.FolderPath() / entry.Name);
+    if (entry.Type == ScannedFolder::Kind::Game)
+    {
+      // Get the key for duplicate detection. MUST MATCH KEYS USED IN Gamelist.findOrCreateFile - Always fullpath
+      if (doppelgangerWatcher.find(filePath.ToString()) == doppelgangerWatcher.end())
+      {
+        FileData* newGame = new FileData(filePath, root);
+        newGame->Metadata().SetDirty();
+        AddChild(newGame, true);
+        doppelgangerWatcher[filePath.ToString()] = newGame;
+      }
+    }
+    else
+    {
+      FolderData* newFolder = new FolderData(filePath, root);
+      newFolder->PopulateFromScan(root, *entry.Child, doppelgangerWatcher);
 
-  // Subsystem override
-  String filteredExtensions = originalFilteredExtensions;
-  if ((folderPath / ".system.cfg").Exists())
-  {
-    IniFile subSystem(folderPath / ".system.cfg", false, false);
-    filteredExtensions = subSystem.AsString("extensions", originalFilteredExtensions);
+      //ignore folders that do not contain games
+      if (newFolder->HasChildren())
+      {
+        const String key = newFolder->RomPath().ToString();
+        if (doppelgangerWatcher.find(key) == doppelgangerWatcher.end())
+        {
+          AddChild(newFolder, true);
+          doppelgangerWatcher[key] = newFolder;
+        }
+      }
+      else
+        delete newFolder;
+    }
   }
+}
 
-  // special system?
-  bool hasFiltering = GameNameMapManager::HasFiltering(System());
-  // No extension?
-  bool noExtensions = filteredExtensions.empty();
-
-  // Keep temporary object outside the loop to avoid construction/destruction and keep memory allocated AMAP
-  Path::PathList items = folderPath.GetDirectoryContent();
-
-  HashSet<String> blacklist;
-  bool containsMultiDiskFile = GameFilesUtils::ContainsMultiDiskFile(filteredExtensions);
-  if (containsMultiDiskFile)
-    for(const auto& itemPath : items)
-      GameFilesUtils::ExtractUselessFiles(itemPath, blacklist);
-
-  for (Path& filePath : items)
+bool FolderData::MergeFromScan(RootFolderData& root, const ScannedFolder& folder, FileData::StringMap& doppelgangerWatcher)
+{
+  bool added = false;
+  for (const ScannedFolder::Entry& entry : folder.Entries())
   {
-    // Get file
-    String stem = filePath.FilenameWithoutExtension();
-    if (stem == "gamelist") continue; // Ignore gamelist.zip/xml
-    if (stem.empty()) continue;
-
-    // Force to hide ignored files
-    // Force to hide ignored files
-    const String fileName = filePath.Filename();
-    int p = (int)ignoreList.find(fileName);
-    if (p > 0 && ignoreList[p-1] == ',')
-      if (ignoreList[p + fileName.length()] == ',')
-        continue;
-
-    if (containsMultiDiskFile && blacklist.contains(filePath.ToString())) continue;
-
-    // and Extension
-    String extension = filePath.Extension().LowerCase();
-
-    //fyi, folders *can* also match the extension and be added as games - this is mostly just to support higan
-    //see issue #75: https://github.com/Aloshi/EmulationStation/issues/75
-    bool isLaunchableGame = false;
-    if (!filePath.IsHidden())
+    Path filePath(folder.FolderPath() / entry.Name);
+    FileData** existing = doppelgangerWatcher.try_get(filePath.ToString());
+    if (entry.Type == ScannedFolder::Kind::Game)
     {
-      if ((noExtensions && filePath.IsFile()) ||
-          (!extension.empty() && IsMatching(stem, extension, filteredExtensions)))
+      if (existing == nullptr)
       {
-        if (hasFiltering)
-        {
-          if (GameNameMapManager::IsFiltered(System(), stem))
-            continue; // MAME Bios or Machine
-        }
-        // Get the key for duplicate detection. MUST MATCH KEYS USED IN Gamelist.findOrCreateFile - Always fullpath
-        if (doppelgangerWatcher.find(filePath.ToString()) == doppelgangerWatcher.end())
-        {
-          FileData* newGame = new FileData(filePath, root);
-          newGame->Metadata().SetDirty();
-          AddChild(newGame, true);
-          doppelgangerWatcher[filePath.ToString()] = newGame;
-        }
-        isLaunchableGame = true;
+        FileData* newGame = new FileData(filePath, root);
+        newGame->Metadata().SetDirty();
+        AddChild(newGame, true);
+        doppelgangerWatcher[filePath.ToString()] = newGame;
+        added = true;
       }
-
-      //add directories that also do not match an extension as folders
-      if (!isLaunchableGame && filePath.IsDirectory())
+    }
+    else if (existing != nullptr)
+    {
+      if ((*existing)->IsFolder())
+        added |= ((FolderData*)*existing)->MergeFromScan(root, *entry.Child, doppelgangerWatcher);
+    }
+    else
+    {
+      FolderData* newFolder = new FolderData(filePath, root);
+      newFolder->PopulateFromScan(root, *entry.Child, doppelgangerWatcher);
+      if (newFolder->HasChildren())
       {
-        FolderData* newFolder = new FolderData(filePath, root);
-        newFolder->PopulateRecursiveFolder(root, filteredExtensions, ignoreList, doppelgangerWatcher);
-
-        //ignore folders that do not contain games
-        if (newFolder->HasChildren())
-        {
-          const String key = newFolder->RomPath().ToString();
-          if (doppelgangerWatcher.find(key) == doppelgangerWatcher.end())
-          {
-            AddChild(newFolder, true);
-            doppelgangerWatcher[key] = newFolder;
-          }
-        }
-        else
-          delete newFolder;
+        AddChild(newFolder, true);
+        doppelgangerWatcher[filePath.ToString()] = newFolder;
+        added = true;
       }
+      else
+        delete newFolder;
     }
   }
+  return added;
 }
 
 void FolderData::ExtractUselessFiles(const Path::PathList& items, FileSet& blacklist)
@@ -4,6 +4,7 @@
 #include "FileData.h"
 #include "IFilter.h"
 #include "IParser.h"
+#include "DirectoryScanner.h"
 
 class FolderData : public FileData
 {
@@ -146,6 +147,14 @@ class FolderData : public FileData
 
     static constexpr int sMaxGdiFileSize = (10 << 10); // 10 Kb
 
+    /*!
+     * Build the current tree from a scanned folder
+     * @param root Root folder
+     * @param folder Scanned folder matching the current folder
+     * @param doppelgangerWatcher Map used to check duplicate games
+     */
+    void PopulateFromScan(RootFolderData& root, const ScannedFolder& folder, FileData::StringMap& doppelgangerWatcher);
+
   public:
     typedef std::vector<FolderData*> List;
     typedef std::vector<const FolderData*> ConstList;
@@ -309,6 +318,16 @@ class FolderData : public FileData
      */
     void PopulateRecursiveFolder(RootFolderData& root, const String& filteredExtensions, const String& ignoreList, FileData::StringMap& doppelgangerWatcher);
 
+    /*!
+     * Merge a scanned folder into the current tree: only games & folders missing from the doppelganger map are added,
+     * existing sub-folders are merged recursively
+     * @param root Root folder
+     * @param folder Scanned folder matching the current folder
+     * @param doppelgangerWatcher Map of all items already in the tree
+     * @return True if at least one item has been added
+     */
+    bool MergeFromScan(RootFolderData& root, const ScannedFolder& folder, FileData::StringMap& doppelgangerWatcher);
+
     /*!
      * Get next favorite game, starting from the reference entry
      * The method seek for next favorite forth, then back.
@@ -0,0 +1,159 @@
+#include "GamelistJournal.h"
+#include <games/RootFolderData.h>
+#include <games/MetadataFieldDescriptor.h>
+#include <games/GamelistJournalSyncer.h>
+#include <utils/Files.h>
+#include <utils/Log.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+GamelistJournal::GamelistJournal(const Path& romFolder)
+  : mRomFolder(romFolder)
+  , mPath(romFolder / sJournalFile)
+{
+}
+
+void GamelistJournal::Escape(String& output, const String& value)
+{
+  for(char c : value)
+    switch(c)
+    {
+      case '\\': output.Append("\\\\", 2); break;
+      case '\t': output.Append("\\t", 2); break;
+      case '\n': output.Append("\\n", 2); break;
+      case '\r': output.Append("\\r", 2); break;
+      default: output.Append(c); break;
+    }
+}
+
+String GamelistJournal::Unescape(const String& value)
+{
+  String result;
+  result.reserve(value.size());
+  for(int i = 0; i < (int)value.size(); ++i)
+  {
+    char c = value[i];
+    if (c == '\\' && i + 1 < (int)value.size())
+      switch(value[++i])
+      {
+        case 't': c = '\t'; break;
+        case 'n': c = '\n'; break;
+        case 'r': c = '\r'; break;
+        default: c = value[i]; break;
+      }
+    result.Append(c);
+  }
+  return result;
+}
+
+bool GamelistJournal::Append(const FileData::List& items, bool& mustCompact)
+{
+  mustCompact = false;
+  // Build records
+  String records;
+  for(FileData* item : items)
+  {
+    bool ok = false;
+    Path relative = item->RomPath().MakeRelative(mRomFolder, ok);
+    if (!ok) continue;
+
+    records.Append(item->IsFolder() ? 'F' : 'G').Append('\t');
+    Escape(records, relative.ToString());
+    int count = 0;
+    MetadataDescriptor& metadata = item->Metadata();
+    const MetadataFieldDescriptor* fields = metadata.GetMetadataFieldDescriptors(count);
+    for(int i = 0; i < count; ++i)
+      if (fields[i].MetaType() != MetadataType::Path)
+      {
+        records.Append('\t').Append(fields[i].Key()).Append('=');
+        String value = (metadata.*fields[i].GetValueMethod())();
+        // Media paths are stored relative to the rom folder, like in the gamelist
+        if (fields[i].Type() == MetadataFieldDescriptor::DataType::Path && !value.empty())
+        {
+          bool dummy = false;
+          value = Path(value).MakeRelative(mRomFolder, dummy).ToString();
+        }
+        Escape(records, value);
+      }
+    records.Append('\n');
+  }
+  if (records.empty()) return false;
+
+  // Append all records at once
+  int fd = open(mPath.ToChars(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0)
+  {
+    { LOG(LogError) << "[GamelistJournal] Cannot open " << mPath.ToString(); }
+    return false;
+  }
+  bool written = write(fd, records.data(), records.size()) == (ssize_t)records.size();
+  off_t size = lseek(fd, 0, SEEK_END);
+  close(fd);
+  if (!written)
+  {
+    { LOG(LogError) << "[GamelistJournal] Cannot write " << mPath.ToString(); }
+    return false;
+  }
+
+  // Sync in background
+  GamelistJournalSyncer::Instance().Push(mPath);
+  mustCompact = size >= sCompactionThreshold;
+  return true;
+}
+
+int GamelistJournal::Replay(RootFolderData& root)
+{
+  if (!mPath.Exists()) return 0;
+  String content = Files::LoadFile(mPath);
+  if (content.empty()) return 0;
+
+  // Lookup map
+  FileData::StringMap items;
+  root.BuildDoppelgangerMap(items, true);
+
+  int replayed = 0;
+  for(int start = 0; start < (int)content.size(); )
+  {
+    int end = content.Find('\n', start);
+    if (end < 0) break; // Incomplete record
+    String::List parts = content.SubString(start, end - start).Split('\t');
+    start = end + 1;
+    if (parts.size() < 2 || parts[0].size() != 1) continue;
+
+    // Lookup item
+    FileData** found = items.try_get((mRomFolder / Unescape(parts[1])).ToString());
+    if (found == nullptr) continue; // Removed since
+    FileData* item = *found;
+    if (item->IsFolder() != (parts[0][0] == 'F')) continue;
+
+    // Restore fields
+    int count = 0;
+    MetadataDescriptor& metadata = item->Metadata();
+    const MetadataFieldDescriptor* fields = metadata.GetMetadataFieldDescriptors(count);
+    for(int p = 2; p < (int)parts.size(); ++p)
+    {
+      int equal = parts[p].Find('=');
+      if (equal <= 0) continue;
+      String key = parts[p].SubString(0, equal);
+      for(int i = 0; i < count; ++i)
+        if (fields[i].MetaType() != MetadataType::Path && fields[i].Key() == key)
+        {
+          String value = Unescape(parts[p].SubString(equal + 1));
+          if (fields[i].Type() == MetadataFieldDescriptor::DataType::Path && !value.empty())
+            value = Path(value).ToAbsolute(mRomFolder).ToString();
+          (metadata.*fields[i].SetValueMethod())(value);
+          break;
+        }
+    }
+    replayed++;
+  }
+
+  { LOG(LogInfo) << "[GamelistJournal] " << replayed << " records replayed from " << mPath.ToString(); }
+  return replayed;
+}
+
+void GamelistJournal::Clear()
+{
+  if (mPath.Exists())
+    (void)mPath.Delete();
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <games/FileData.h>
+
+class RootFolderData;
+
+/*!
+ * @brief Append-only journal of metadata changes of a root folder
+ *
+ * Instead of rewriting the whole gamelist each time a game changes (play count, last played,
+ * favorite, hidden, scraped data, ...), the complete metadata record of the changed items is
+ * appended to a journal lying beside the gamelist. One line per record:
+ * type, path relative to the root folder, then all fields as tab-separated key=value pairs.
+ * Media paths are relative to the root folder as well.
+ *
+ * The journal is replayed on top of the gamelist at load time. Replayed items are dirty,
+ * so the next gamelist update compacts them into the gamelist, then deletes the journal.
+ * A record interrupted by a power loss is ignored at replay.
+ */
+class GamelistJournal
+{
+  public:
+    /*!
+     * @brief Constructor
+     * @param romFolder Rom folder (root) of the journal
+     */
+    explicit GamelistJournal(const Path& romFolder);
+
+    /*!
+     * @brief Append the current metadata of the given items
+     * @param items Games or folders, all from the journal root folder
+     * @param mustCompact Set to true if the journal has grown enough to be compacted
+     * @return True if the records have been written, false on I/O error
+     * @note Data are synced to the storage in background
+     */
+    bool Append(const FileData::List& items, [[out]] bool& mustCompact);
+
+    /*!
+     * @brief Replay the journal on the given root folder
+     * @param root Root folder
+     * @return Replayed record count
+     */
+    int Replay(RootFolderData& root);
+
+    /*!
+     * @brief Delete the journal, once compacted into the gamelist
+     */
+    void Clear();
+
+  private:
+    //! Journal file name
+    static constexpr const char* sJournalFile = "gamelist.journal";
+    //! Size above which a journal should be compacted
+    static constexpr long long sCompactionThreshold = 256 << 10;
+
+    //! Rom folder
+    Path mRomFolder;
+    //! Journal path
+    Path mPath;
+
+    /*!
+     * @brief Escape tabs, newlines & backslashes
+     * @param output Output string
+     * @param value Value to escape
+     */
+    static void Escape(String& output, const String& value);
+
+    /*!
+     * @brief Unescape a value
+     * @param value Escaped value
+     * @return Unescaped value
+     */
+    static String Unescape(const String& value);
+};
@@ -0,0 +1,42 @@
+#include "GamelistJournalSyncer.h"
+#include <utils/Log.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+void GamelistJournalSyncer::Push(const Path& journal)
+{
+  {
+    Mutex::AutoLock locker(mLocker);
+    mPending.insert(journal.ToString());
+    if (!IsRunning()) Thread::Start("JournalSync");
+  }
+  mSignal.Fire();
+}
+
+void GamelistJournalSyncer::SyncPending()
+{
+  HashSet<String> pending;
+  {
+    Mutex::AutoLock locker(mLocker);
+    pending.swap(mPending);
+  }
+  for(const String& journal : pending)
+  {
+    // The journal may have been compacted & deleted meanwhile
+    int fd = open(journal.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) continue;
+    if (fdatasync(fd) != 0) { LOG(LogWarning) << "[GamelistJournal] Cannot sync " << journal; }
+    close(fd);
+  }
+}
+
+void GamelistJournalSyncer::Run()
+{
+  while(IsRunning())
+  {
+    mSignal.WaitSignal();
+    SyncPending();
+  }
+  // Last syncs before exiting
+  SyncPending();
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <utils/os/fs/Path.h>
+#include <utils/os/system/Thread.h>
+#include <utils/os/system/Signal.h>
+#include <utils/os/system/Mutex.h>
+#include <utils/storage/Set.h>
+
+/*!
+ * @brief Background data sync of gamelist journals
+ *
+ * Journals are appended from the main thread. Flushing them to the storage may take a while
+ * on SD cards & USB keys, so it is done here. Several syncs of the same journal are merged.
+ */
+class GamelistJournalSyncer : private Thread
+{
+  public:
+    //! Get the unique syncer
+    static GamelistJournalSyncer& Instance() { static GamelistJournalSyncer sSyncer; return sSyncer; }
+
+    /*!
+     * @brief Queue a data sync of the given journal
+     * @param journal Journal path
+     */
+    void Push(const Path& journal);
+
+  private:
+    //! Journals to sync
+    HashSet<String> mPending;
+    //! Protect pending journals
+    Mutex mLocker;
+    //! Working signal
+    Signal mSignal;
+
+    //! Constructor
+    GamelistJournalSyncer() = default;
+
+    //! Sync all pending journals
+    void SyncPending();
+
+    /*
+     * Thread implementation
+     */
+
+    void Run() override;
+    void Break() override { mSignal.Fire(); }
+};
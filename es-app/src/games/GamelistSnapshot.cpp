@@ -0,0 +1,320 @@
+#include "GamelistSnapshot.h"
+#include <RootFolders.h>
+#include <utils/Files.h>
+#include <utils/Log.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+GamelistSnapshot::GamelistSnapshot(const Path& romFolder)
+  : mRomFolder(romFolder)
+  , mMemory(nullptr)
+  , mSize(0)
+  , mHeader(nullptr)
+  , mRecords(nullptr)
+{
+}
+
+GamelistSnapshot::~GamelistSnapshot()
+{
+  Close();
+}
+
+Path GamelistSnapshot::SnapshotPath(const Path& romFolder)
+{
+  return RootFolders::DataRootFolder / sSnapshotFolder / String(romFolder.ToString().Hash(), 8, String::Hexa::None).Append(".bin");
+}
+
+MetadataStringHolder& GamelistSnapshot::Holder(GamelistSnapshot::Pool pool)
+{
+  switch(pool)
+  {
+    case Pool::Name: return MetadataDescriptor::sNameHolder;
+    case Pool::Description: return MetadataDescriptor::sDescriptionHolder;
+    case Pool::Developer: return MetadataDescriptor::sDeveloperHolder;
+    case Pool::Publisher: return MetadataDescriptor::sPublisherHolder;
+    case Pool::Genre: return MetadataDescriptor::sGenreHolder;
+    case Pool::Emulator: return MetadataDescriptor::sEmulatorHolder;
+    case Pool::Core: return MetadataDescriptor::sCoreHolder;
+    case Pool::Ratio: return MetadataDescriptor::sRatioHolder;
+    case Pool::Path: return MetadataDescriptor::sPathHolder;
+    case Pool::File:
+    case Pool::Count:
+    default: break;
+  }
+  return MetadataDescriptor::sFileHolder;
+}
+
+GamelistSnapshot::Stamp GamelistSnapshot::BuildStamp(const Path& gamelist, const Path& romFolder, const String& configuration)
+{
+  Stamp stamp { -1, -1, -1, configuration.Hash() };
+  struct stat info {};
+  if (stat(gamelist.ToChars(), &info) == 0)
+  {
+    stamp.GamelistSize = (long long)info.st_size;
+    stamp.GamelistTime = (long long)info.st_mtim.tv_sec * 1000000000LL + (long long)info.st_mtim.tv_nsec;
+  }
+  if (stat(romFolder.ToChars(), &info) == 0)
+    stamp.RomFolderTime = (long long)info.st_mtim.tv_sec * 1000000000LL + (long long)info.st_mtim.tv_nsec;
+  return stamp;
+}
+
+void GamelistSnapshot::Delete(const Path& romFolder)
+{
+  (void)SnapshotPath(romFolder).Delete();
+}
+
+bool GamelistSnapshot::Save(const Path& romFolder, const Stamp& stamp, const FileData::List& items)
+{
+  // Invalid stamp?
+  if (stamp.GamelistSize < 0 || stamp.RomFolderTime < 0) return false;
+
+  // Build pools - Holder index => pool index
+  HashMap<int, int> poolIndexes[(int)Pool::Count];
+  String pools[(int)Pool::Count];
+  Header header {};
+  auto store = [&poolIndexes, &pools, &header](Pool pool, int index) -> int
+  {
+    int* local = poolIndexes[(int)pool].try_get(index);
+    if (local != nullptr) return *local;
+    int result = header.PoolCounts[(int)pool]++;
+    poolIndexes[(int)pool][index] = result;
+    pools[(int)pool].Append(Holder(pool).GetString(index)).Append('\0');
+    return result;
+  };
+
+  // Build records
+  Array<Record> records(items.size() != 0 ? (int)items.size() : 1);
+  for(const FileData* item : items)
+  {
+    const MetadataDescriptor& source = item->Metadata();
+    Record record {};
+    record.TimeStamp     = source.mTimeStamp;
+    record.RomFile       = store(Pool::File, source.mRomFile);
+    record.Name          = store(Pool::Name, source.mName);
+    record.Description   = store(Pool::Description, source.mDescription);
+    record.ImageFile     = store(Pool::File, source.mImageFile);
+    record.ThumbnailFile = store(Pool::File, source.mThumbnailFile);
+    record.VideoFile     = store(Pool::File, source.mVideoFile);
+    record.Rating        = source.mRating;
+    record.ReleaseDate   = source.mReleaseDate;
+    record.LastPlayed    = source.mLastPlayed;
+    record.Genre         = store(Pool::Genre, source.mGenre);
+    record.Developer     = store(Pool::Developer, source.mDeveloper);
+    record.Publisher     = store(Pool::Publisher, source.mPublisher);
+    record.Players       = source.mPlayers;
+    record.RomCrc32      = source.mRomCrc32;
+    record.Region        = source.mRegion.Pack;
+    record.RomPath       = store(Pool::Path, source.mRomPath);
+    record.ImagePath     = store(Pool::Path, source.mImagePath);
+    record.ThumbnailPath = store(Pool::Path, source.mThumbnailPath);
+    record.VideoPath     = store(Pool::Path, source.mVideoPath);
+    record.Emulator      = store(Pool::Emulator, source.mEmulator);
+    record.Core          = store(Pool::Core, source.mCore);
+    record.LastPatchPath = store(Pool::Path, source.mLastPatchPath);
+    record.LastPatchFile = store(Pool::File, source.mLastPatchFile);
+    record.Ratio         = store(Pool::Ratio, source.mRatio);
+    record.TimePlayed    = source.mTimePlayed;
+    record.PlayCount     = source.mPlayCount;
+    record.GenreId       = (short)source.mGenreId;
+    record.Type          = (unsigned char)item->Type();
+    record.Flags         = (source.mFavorite ? sFlagFavorite : 0) |
+                           (source.mHidden ? sFlagHidden : 0) |
+                           (source.mAdult ? sFlagAdult : 0);
+    record.Rotation      = (unsigned char)source.mRotation;
+    records.Add(record);
+  }
+
+  // Build header
+  memcpy(header.Magic, sMagic, sizeof(header.Magic));
+  header.Version = sVersion;
+  header.Validation = stamp;
+  header.RomFolderHash = romFolder.ToString().Hash();
+  header.RecordCount = records.Count();
+  for(int i = (int)Pool::Count; --i >= 0; )
+  {
+    // Align pools on 4 bytes so that records are always aligned
+    while((pools[i].Count() & 3) != 0) pools[i].Append('\0');
+    header.PoolSizes[i] = pools[i].Count();
+  }
+
+  // Build file image
+  String image;
+  image.Append((const char*)&header, (int)sizeof(header));
+  for(const String& pool : pools) image.Append(pool);
+  image.Append((const char*)records.BufferReadOnly(), records.Count() * (int)sizeof(Record));
+
+  // Save in a temporary file first, then atomically replace the previous snapshot
+  Path path = SnapshotPath(romFolder);
+  Path temporary = path.ChangeExtension(".tmp");
+  (void)path.Directory().CreatePath();
+  if (!Files::SaveFile(temporary, image) || !Path::Rename(temporary, path))
+  {
+    { LOG(LogError) << "[GamelistSnapshot] Cannot save snapshot of " << romFolder.ToString(); }
+    (void)temporary.Delete();
+    return false;
+  }
+
+  { LOG(LogDebug) << "[GamelistSnapshot] Snapshot of " << romFolder.ToString() << " saved: " << records.Count() << " items, " << image.Count() << " bytes."; }
+  return true;
+}
+
+bool GamelistSnapshot::Open(const Stamp& stamp)
+{
+  Close();
+
+  // Map the whole file
+  Path path = SnapshotPath(mRomFolder);
+  int fd = open(path.ToChars(), O_RDONLY);
+  if (fd < 0) return false;
+  struct stat info {};
+  if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(Header))
+  {
+    close(fd);
+    return false;
+  }
+  mSize = (long long)info.st_size;
+  mMemory = mmap(nullptr, (size_t)mSize, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+  close(fd);
+  if (mMemory == MAP_FAILED)
+  {
+    mMemory = nullptr;
+    return false;
+  }
+
+  // Check header & validation stamp
+  mHeader = (const Header*)mMemory;
+  bool valid = memcmp(mHeader->Magic, sMagic, sizeof(mHeader->Magic)) == 0 &&
+               mHeader->Version == sVersion &&
+               mHeader->Validation.GamelistSize == stamp.GamelistSize &&
+               mHeader->Validation.GamelistTime == stamp.GamelistTime &&
+               mHeader->Validation.RomFolderTime == stamp.RomFolderTime &&
+               mHeader->Validation.ConfigurationHash == stamp.ConfigurationHash &&
+               mHeader->RomFolderHash == mRomFolder.ToString().Hash() &&
+               mHeader->RecordCount >= 0;
+
+  // Check size consistency
+  long long expectedSize = (long long)sizeof(Header) + (long long)mHeader->RecordCount * (long long)sizeof(Record);
+  for(int i = (int)Pool::Count; valid && --i >= 0; )
+  {
+    valid = mHeader->PoolSizes[i] >= 0 && (mHeader->PoolSizes[i] & 3) == 0;
+    expectedSize += mHeader->PoolSizes[i];
+  }
+  if (!valid || expectedSize != mSize)
+  {
+    { LOG(LogDebug) << "[GamelistSnapshot] Snapshot of " << mRomFolder.ToString() << " is missing or outdated."; }
+    Close();
+    return false;
+  }
+
+  // Check pools: each one must hold its string count
+  const char* pools[(int)Pool::Count];
+  const char* p = (const char*)mMemory + sizeof(Header);
+  for(int i = 0; valid && i < (int)Pool::Count; ++i)
+  {
+    pools[i] = p;
+    const char* end = p + mHeader->PoolSizes[i];
+    const char* s = p;
+    valid = mHeader->PoolCounts[i] >= 0;
+    for(int count = mHeader->PoolCounts[i]; valid && --count >= 0; )
+    {
+      int length = (int)strnlen(s, end - s);
+      valid = s + length < end;
+      s += length + 1;
+    }
+    p = end;
+  }
+  mRecords = (const Record*)p;
+
+  // Check record indexes against pool counts
+  for(int i = mHeader->RecordCount; valid && --i >= 0; )
+  {
+    const Record& r = mRecords[i];
+    auto check = [this](Pool pool, int index) { return (unsigned int)index < (unsigned int)mHeader->PoolCounts[(int)pool]; };
+    valid = check(Pool::File, r.RomFile) && check(Pool::Name, r.Name) && check(Pool::Description, r.Description) &&
+            check(Pool::File, r.ImageFile) && check(Pool::File, r.ThumbnailFile) && check(Pool::File, r.VideoFile) &&
+            check(Pool::Genre, r.Genre) && check(Pool::Developer, r.Developer) && check(Pool::Publisher, r.Publisher) &&
+            check(Pool::Path, r.RomPath) && check(Pool::Path, r.ImagePath) && check(Pool::Path, r.ThumbnailPath) &&
+            check(Pool::Path, r.VideoPath) && check(Pool::Emulator, r.Emulator) && check(Pool::Core, r.Core) &&
+            check(Pool::Path, r.LastPatchPath) && check(Pool::File, r.LastPatchFile) && check(Pool::Ratio, r.Ratio) &&
+            (r.Type == (unsigned char)ItemType::Game || r.Type == (unsigned char)ItemType::Folder);
+  }
+
+  // Inject pools into holders, only once the whole snapshot is known to be valid
+  for(int i = 0; valid && i < (int)Pool::Count; ++i)
+  {
+    MetadataStringHolder& holder = Holder((Pool)i);
+    const char* s = pools[i];
+    for(int count = mHeader->PoolCounts[i]; --count >= 0; )
+    {
+      int length = (int)strlen(s);
+      mRemap[i].Add(holder.AddString32(String(s, length)));
+      s += length + 1;
+    }
+  }
+  if (!valid)
+  {
+    { LOG(LogError) << "[GamelistSnapshot] Snapshot of " << mRomFolder.ToString() << " is corrupted!"; }
+    Close();
+    return false;
+  }
+
+  { LOG(LogDebug) << "[GamelistSnapshot] Snapshot of " << mRomFolder.ToString() << " opened: " << mHeader->RecordCount << " items."; }
+  return true;
+}
+
+void GamelistSnapshot::Close()
+{
+  if (mMemory != nullptr)
+    munmap(mMemory, (size_t)mSize);
+  mMemory = nullptr;
+  mSize = 0;
+  mHeader = nullptr;
+  mRecords = nullptr;
+  for(Array<int>& remap : mRemap) remap.Clear();
+}
+
+Path GamelistSnapshot::RomPath(int index) const
+{
+  const Record& r = mRecords[index];
+  return Holder(Pool::Path).GetPath(Remap(Pool::Path, r.RomPath)) / Holder(Pool::File).GetString(Remap(Pool::File, r.RomFile));
+}
+
+void GamelistSnapshot::Restore(int index, MetadataDescriptor& target) const
+{
+  const Record& r = mRecords[index];
+  target.mTimeStamp     = r.TimeStamp;
+  target.mRomFile       = Remap(Pool::File, r.RomFile);
+  target.mName          = Remap(Pool::Name, r.Name);
+  target.mDescription   = Remap(Pool::Description, r.Description);
+  target.mImageFile     = Remap(Pool::File, r.ImageFile);
+  target.mThumbnailFile = Remap(Pool::File, r.ThumbnailFile);
+  target.mVideoFile     = Remap(Pool::File, r.VideoFile);
+  target.mRating        = r.Rating;
+  target.mReleaseDate   = r.ReleaseDate;
+  target.mLastPlayed    = r.LastPlayed;
+  target.mGenre         = Remap(Pool::Genre, r.Genre);
+  target.mDeveloper     = Remap(Pool::Developer, r.Developer);
+  target.mPublisher     = Remap(Pool::Publisher, r.Publisher);
+  target.mPlayers       = r.Players;
+  target.mRomCrc32      = r.RomCrc32;
+  target.mRegion.Pack   = r.Region;
+  target.mRomPath       = (MetadataStringHolder::Index16)Remap(Pool::Path, r.RomPath);
+  target.mImagePath     = (MetadataStringHolder::Index16)Remap(Pool::Path, r.ImagePath);
+  target.mThumbnailPath = (MetadataStringHolder::Index16)Remap(Pool::Path, r.ThumbnailPath);
+  target.mVideoPath     = (MetadataStringHolder::Index16)Remap(Pool::Path, r.VideoPath);
+  target.mEmulator      = (MetadataStringHolder::Index16)Remap(Pool::Emulator, r.Emulator);
+  target.mCore          = (MetadataStringHolder::Index16)Remap(Pool::Core, r.Core);
+  target.mLastPatchPath = (MetadataStringHolder::Index16)Remap(Pool::Path, r.LastPatchPath);
+  target.mLastPatchFile = (MetadataStringHolder::Index16)Remap(Pool::File, r.LastPatchFile);
+  target.mRatio         = (MetadataStringHolder::Index8)Remap(Pool::Ratio, r.Ratio);
+  target.mTimePlayed    = r.TimePlayed;
+  target.mPlayCount     = r.PlayCount;
+  target.mGenreId       = (GameGenres)r.GenreId;
+  target.mFavorite      = (r.Flags & sFlagFavorite) != 0;
+  target.mHidden        = (r.Flags & sFlagHidden) != 0;
+  target.mAdult         = (r.Flags & sFlagAdult) != 0;
+  target.mRotation      = (RotationType)r.Rotation;
+  target.mDirty         = false;
+}
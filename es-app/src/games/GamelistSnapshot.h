@@ -0,0 +1,204 @@
+#pragma once
+
+#include <games/FileData.h>
+#include <utils/storage/Array.h>
+
+/*!
+ * @brief Binary, memory-mappable image of a parsed gamelist
+ *
+ * A snapshot holds all metadata records of a root folder, with their strings stored
+ * in one pool per MetadataStringHolder. At load time, each pool is injected once
+ * into its holder, then records are copied straight into the descriptors.
+ * No XML parsing, no string-to-value conversion.
+ *
+ * A snapshot is only valid while the gamelist file (size & mtime), the rom folder (mtime)
+ * and the system configuration (extensions & ignored files) are unchanged.
+ */
+class GamelistSnapshot
+{
+  public:
+    //! Validation stamp
+    struct Stamp
+    {
+      long long GamelistSize;      //!< Gamelist size
+      long long GamelistTime;      //!< Gamelist modification time
+      long long RomFolderTime;     //!< Rom folder modification time
+      int       ConfigurationHash; //!< Hash of the system configuration relevant to gamelist loading
+    };
+
+    /*!
+     * @brief Build a validation stamp
+     * @param gamelist Gamelist path
+     * @param romFolder Rom folder
+     * @param configuration Configuration string
+     * @return Stamp
+     */
+    static Stamp BuildStamp(const Path& gamelist, const Path& romFolder, const String& configuration);
+
+    /*!
+     * @brief Save a snapshot of the given items, for the given rom folder
+     * @param romFolder Rom folder (root)
+     * @param stamp Validation stamp
+     * @param items Items (games & folders) to store
+     * @return True if the snapshot has been written
+     */
+    static bool Save(const Path& romFolder, const Stamp& stamp, const FileData::List& items);
+
+    /*!
+     * @brief Delete the snapshot of the given rom folder
+     * @param romFolder Rom folder (root)
+     */
+    static void Delete(const Path& romFolder);
+
+    /*!
+     * @brief Constructor
+     * @param romFolder Rom folder (root) to open the snapshot of
+     */
+    explicit GamelistSnapshot(const Path& romFolder);
+
+    //! Destructor
+    ~GamelistSnapshot();
+
+    /*!
+     * @brief Map the snapshot and check its validity against the given stamp.
+     * On success, all string pools are injected into the metadata holders.
+     * @param stamp Validation stamp
+     * @return True if the snapshot is valid and ready to use
+     */
+    bool Open(const Stamp& stamp);
+
+    //! Record count
+    [[nodiscard]] int Count() const { return mHeader != nullptr ? mHeader->RecordCount : 0; }
+
+    /*!
+     * @brief Get the item type of the given record
+     * @param index Record index
+     * @return Item type
+     */
+    [[nodiscard]] ItemType Type(int index) const { return (ItemType)mRecords[index].Type; }
+
+    /*!
+     * @brief Get the full rom path of the given record
+     * @param index Record index
+     * @return Rom path
+     */
+    [[nodiscard]] Path RomPath(int index) const;
+
+    /*!
+     * @brief Restore metadata from the given record
+     * @param index Record index
+     * @param target Target metadata
+     */
+    void Restore(int index, MetadataDescriptor& target) const;
+
+  private:
+    //! Magic
+    static constexpr const char* sMagic = "RGLS";
+    //! Version - Increment each time Header or Record is modified
+    static constexpr int sVersion = 1;
+    //! Snapshot folder
+    static constexpr const char* sSnapshotFolder = "system/.emulationstation/cache/gamelists";
+
+    //! String pools
+    enum class Pool
+    {
+      Name,
+      Description,
+      Developer,
+      Publisher,
+      Genre,
+      Emulator,
+      Core,
+      Ratio,
+      Path,
+      File,
+      Count,
+    };
+
+    //! Record flags
+    static constexpr unsigned char sFlagFavorite = 1;
+    static constexpr unsigned char sFlagHidden   = 2;
+    static constexpr unsigned char sFlagAdult    = 4;
+
+    //! File header
+    struct Header
+    {
+      char      Magic[4];                    //!< Magic identifier
+      int       Version;                     //!< File version
+      Stamp     Validation;                  //!< Validation stamp
+      int       RomFolderHash;               //!< Rom folder path hash
+      int       RecordCount;                 //!< Record count
+      int       PoolCounts[(int)Pool::Count]; //!< String count per pool
+      int       PoolSizes[(int)Pool::Count];  //!< Byte size per pool (4 byte aligned)
+    };
+
+    //! Flat metadata record. String fields are indexes in their pool
+    struct Record
+    {
+      unsigned int TimeStamp;
+      int          RomFile;
+      int          Name;
+      int          Description;
+      int          ImageFile;
+      int          ThumbnailFile;
+      int          VideoFile;
+      float        Rating;
+      unsigned int ReleaseDate;
+      unsigned int LastPlayed;
+      int          Genre;
+      int          Developer;
+      int          Publisher;
+      int          Players;
+      int          RomCrc32;
+      int          Region;
+      int          RomPath;
+      int          ImagePath;
+      int          ThumbnailPath;
+      int          VideoPath;
+      int          Emulator;
+      int          Core;
+      int          LastPatchPath;
+      int          LastPatchFile;
+      int          Ratio;
+      int          TimePlayed;
+      short        PlayCount;
+      short        GenreId;
+      unsigned char Type;
+      unsigned char Flags;
+      unsigned char Rotation;
+      unsigned char Padding;
+    };
+
+    //! Rom folder
+    Path mRomFolder;
+    //! Mapped memory
+    void* mMemory;
+    //! Mapped size
+    long long mSize;
+    //! Header
+    const Header* mHeader;
+    //! Records
+    const Record* mRecords;
+    //! Pool index to holder index, per pool
+    Array<int> mRemap[(int)Pool::Count];
+
+    /*!
+     * @brief Get the snapshot path of the given rom folder
+     * @param romFolder Rom folder
+     * @return Snapshot path
+     */
+    static Path SnapshotPath(const Path& romFolder);
+
+    /*!
+     * @brief Get the metadata holder associated to the given pool
+     * @param pool Pool
+     * @return Metadata string holder
+     */
+    static MetadataStringHolder& Holder(Pool pool);
+
+    //! Unmap memory
+    void Close();
+
+    //! Get holder index from a pool index
+    [[nodiscard]] int Remap(Pool pool, int index) const { return mRemap[(int)pool][index]; }
+};
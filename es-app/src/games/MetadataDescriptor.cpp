@@ -1,6 +1,8 @@
 #include "MetadataDescriptor.h"
 #include "MetadataFieldDescriptor.h"
 #include "utils/locale/LocaleHelper.h"
+#include <RecalboxConf.h>
+#include <utils/os/system/Thread.h>
 
 // TODO: Use const char* instead
 const String MetadataDescriptor::GameNodeIdentifier("game");
@@ -365,6 +367,30 @@ void MetadataDescriptor::Merge(const MetadataDescriptor& sourceMetadata)
   }
 }
 
+/*!
+ * @brief Build the description search index in background.
+ * Searches use the linear scanner until the index is available
+ */
+class DescriptionIndexBuilder : private Thread
+{
+  public:
+    //! Constructor
+    explicit DescriptionIndexBuilder(MetadataStringHolder& holder) : mHolder(holder) {}
+
+    //! Start building, after the previous build if any
+    void Build() { Thread::Start("DescIndex"); }
+
+  private:
+    //! Description holder
+    MetadataStringHolder& mHolder;
+
+    void Run() override
+    {
+      mHolder.BuildSearchIndex();
+      { LOG(LogDebug) << "[MetadataDescriptor] Description search index: " << mHolder.SearchIndexSize() << " bytes"; }
+    }
+};
+
 void MetadataDescriptor::CleanupHolders()
 {
   LOG(LogDebug) << "[MetadataDescriptor] Name storage: "        << sNameHolder.StorageSize()          << " - object count: " << sNameHolder.ObjectCount()       ;
@@ -388,4 +414,19 @@ void MetadataDescriptor::CleanupHolders()
   sEmulatorHolder.Finalize();
   sPathHolder.Finalize();
   sFileHolder.Finalize();
+
+  // Build search indexes. Description index is large: build it in background
+  sNameHolder.BuildSearchIndex();
+  sFileHolder.BuildSearchIndex();
+  sDeveloperHolder.BuildSearchIndex();
+  sPublisherHolder.BuildSearchIndex();
+  static DescriptionIndexBuilder sDescriptionIndexBuilder(sDescriptionHolder);
+  if (RecalboxConf::Instance().AsBool("emulationstation.search.indexdescriptions", true))
+    sDescriptionIndexBuilder.Build();
+  else
+    sDescriptionHolder.ReleaseSearchIndex();
+
+  LOG(LogDebug) << "[MetadataDescriptor] Search indexes: " << (sNameHolder.SearchIndexSize() + sFileHolder.SearchIndexSize() +
+                                                               sDeveloperHolder.SearchIndexSize() + sPublisherHolder.SearchIndexSize() +
+                                                               sDescriptionHolder.SearchIndexSize()) << " bytes";
 }
@@ -17,6 +17,9 @@ class MetadataFieldDescriptor;
 class MetadataDescriptor
 {
   private:
+    // Snapshots read & write raw fields and holders
+    friend class GamelistSnapshot;
+
     #ifdef _METADATA_STATS_
     static int LivingClasses;
     static int LivingFolders;
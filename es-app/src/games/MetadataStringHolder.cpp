@@ -6,20 +6,28 @@
 //
 
 #include "MetadataStringHolder.h"
+#include <algorithm>
 
 MetadataStringHolder::MetadataStringHolder(int capacity, int granularity)
   : mMetaString(capacity, granularity)
   , mIndexes(1024, 1024)
+  , mIndexedStrings(0)
+  , mGeneration(0)
 {
   Initialize();
 }
 
 void MetadataStringHolder::Initialize()
 {
+  // Synchronize
+  Mutex::AutoLock locker(mSyncher);
+
   // Reinit everything
+  mGeneration++;
   mMetaString.Clear();
   mIndexes.Clear();
   mStringToIndexes.clear();
+  ReleaseSearchIndex();
   // Add empty string so that all uninitialized indexes must be set to 0
   AddString32(String::Empty);
 }
@@ -92,25 +100,134 @@ MetadataStringHolder::Index32 MetadataStringHolder::AddString32(const String& ne
 }
 
 void MetadataStringHolder::FindText(const String& text, MetadataStringHolder::FoundTextList& output, int context)
+{
+  // Synchronize
+  Mutex::AutoLock locker(mSyncher);
+
+  // No index or text too short to get trigrams: full scan
+  if (mIndexedStrings == 0 || text.size() < 3)
+  {
+    FindTextInRange(text, output, context, 0, mMetaString.Count(), -1);
+    return;
+  }
+
+  // Collect unique trigram buckets of the searched text
+  int buckets[64];
+  int bucketCount = 0;
+  for(int i = 0; i <= (int)text.size() - 3 && bucketCount < (int)(sizeof(buckets) / sizeof(buckets[0])); ++i)
+  {
+    int bucket = TrigramBucket(&text[i]);
+    if (std::find(&buckets[0], &buckets[bucketCount], bucket) == &buckets[bucketCount])
+      buckets[bucketCount++] = bucket;
+  }
+
+  // Start from the shortest posting list
+  int shortest = 0;
+  for(int i = bucketCount; --i > 0; )
+    if (mTrigramOffsets[buckets[i] + 1] - mTrigramOffsets[buckets[i]] < mTrigramOffsets[buckets[shortest] + 1] - mTrigramOffsets[buckets[shortest]])
+      shortest = i;
+
+  // Intersect with other posting lists, then verify remaining candidates
+  const Index32* postings = mTrigramPostings.data();
+  for(int p = mTrigramOffsets[buckets[shortest]]; p < mTrigramOffsets[buckets[shortest] + 1]; ++p)
+  {
+    Index32 candidate = postings[p];
+    bool found = true;
+    for(int i = bucketCount; found && --i >= 0; )
+      if (i != shortest)
+        found = std::binary_search(&postings[mTrigramOffsets[buckets[i]]], &postings[mTrigramOffsets[buckets[i] + 1]], candidate);
+    if (found)
+      FindTextInRange(text, output, context, mIndexes[candidate], EndOf(candidate), candidate);
+  }
+
+  // Strings added after the index build
+  if (mIndexedStrings < mIndexes.Count())
+    FindTextInRange(text, output, context, mIndexes[mIndexedStrings], mMetaString.Count(), -1);
+}
+
+void MetadataStringHolder::FindTextInRange(const String& text, MetadataStringHolder::FoundTextList& output, int context, int from, int to, Index32 index)
 {
   const char* fdn = mMetaString.BufferReadOnly();             // Keep filedata name pointer for fast result computation
   const char* tts = text.c_str();                             // Keep text pointer for fast search reset
-  int lmax = (int)mMetaString.Count() - (int)text.size() + 1; // MAximum byte to search in
+  int lmax = to - from - (int)text.size() + 1;                // MAximum byte to search in
 
-  for(const char* p = fdn; --lmax >= 0; ++p)                  // Run through the game name, straight forward
-    if ((*p | 0x20) == (*tts))                                // Try to catch the first char
+  for(const char* p = fdn + from; --lmax >= 0; ++p)           // Run through the game name, straight forward
+    if ((*p | 0x20) == (*tts) && *p != 0)                     // Try to catch the first char
       for (const char* s = tts, *ip = p; ; )                  // Got it, run through both string
       {
         const char c = *(++s);
-        if ((c != 0) && ((*(++ip) | 0x20) != c) ) break;      // Chars are not equal, exit the inner loop
+        if ((c != 0) && ((*(++ip) | 0x20) != c || *ip == 0)) break; // Chars are not equal (or end of string), exit the inner loop
         if (c == 0)
         {
-          output.Add(IndexFromPos((int) (p - fdn), context)); // Chars are equal, got a zero terminal? Found it!
+          if (index >= 0) output.Add({ index, (short)((p - fdn) - from), (short)context });
+          else output.Add(IndexFromPos((int) (p - fdn), context)); // Chars are equal, got a zero terminal? Found it!
           break;
         }
       }
 }
 
+void MetadataStringHolder::BuildSearchIndex()
+{
+  // Snapshot strings, so that the holder stays available while the index is built
+  std::vector<char> buffer;
+  std::vector<Index32> starts;
+  int generation = 0;
+  {
+    Mutex::AutoLock locker(mSyncher);
+    buffer.assign(mMetaString.BufferReadOnly(), mMetaString.BufferReadOnly() + mMetaString.Count());
+    starts.assign(mIndexes.BufferReadOnly(), mIndexes.BufferReadOnly() + mIndexes.Count());
+    generation = mGeneration;
+  }
+  int count = (int)starts.size();
+  starts.push_back((Index32)buffer.size());
+
+  // First pass: count unique strings per bucket
+  std::vector<Index32> lastString(sTrigramBuckets, -1);
+  std::vector<Index32> offsets(sTrigramBuckets + 1, 0);
+  for(Index32 index = 0; index < count; ++index)
+    for(int p = starts[index], end = starts[index + 1] - 1 - 2; p < end; ++p)
+    {
+      int bucket = TrigramBucket(&buffer[p]);
+      if (lastString[bucket] == index) continue;
+      lastString[bucket] = index;
+      offsets[bucket + 1]++;
+    }
+  for(int i = 0; i < sTrigramBuckets; ++i)
+    offsets[i + 1] += offsets[i];
+
+  // Second pass: fill in postings, sorted by string index
+  std::vector<Index32> writeAt(offsets.begin(), offsets.end() - 1);
+  lastString.assign(sTrigramBuckets, -1);
+  std::vector<Index32> postings(offsets[sTrigramBuckets], 0);
+  for(Index32 index = 0; index < count; ++index)
+    for(int p = starts[index], end = starts[index + 1] - 1 - 2; p < end; ++p)
+    {
+      int bucket = TrigramBucket(&buffer[p]);
+      if (lastString[bucket] == index) continue;
+      lastString[bucket] = index;
+      postings[writeAt[bucket]++] = index;
+    }
+
+  // Swap in, unless the holder has been reinitialized meanwhile
+  Mutex::AutoLock locker(mSyncher);
+  if (generation != mGeneration) return;
+  mTrigramOffsets.swap(offsets);
+  mTrigramPostings.swap(postings);
+  mIndexedStrings = count;
+}
+
+void MetadataStringHolder::ReleaseSearchIndex()
+{
+  // Synchronize
+  Mutex::AutoLock locker(mSyncher);
+
+  mTrigramOffsets.clear();
+  mTrigramOffsets.shrink_to_fit();
+  mTrigramPostings.clear();
+  mTrigramPostings.shrink_to_fit();
+  mIndexedStrings = 0;
+}
+
 MetadataStringHolder::IndexAndDistance MetadataStringHolder::IndexFromPos(int pos, int context)
 {
   // Out of bounds?
@@ -121,8 +238,8 @@ MetadataStringHolder::IndexAndDistance MetadataStringHolder::IndexFromPos(int po
   for(int left = 0, right = mIndexes.Count() - 2; ; )
   {
     int pivot = (left + right) >> 1;
-    if (pos < mIndexes[pivot]) right = pivot;
-    else if (pos >= mIndexes[pivot + 1]) left = pivot;
+    if (pos < mIndexes[pivot]) right = pivot - 1;
+    else if (pos >= mIndexes[pivot + 1]) left = pivot + 1;
     else return { pivot, (short)(pos - mIndexes[pivot]), (short)context };
   }
 }
@@ -11,6 +11,7 @@
 #include <utils/storage/HashMap.h>
 #include <utils/os/system/Mutex.h>
 #include <cassert>
+#include <vector>
 
 class MetadataStringHolder
 {
@@ -99,7 +100,10 @@ class MetadataStringHolder
     Path GetPath(Index32 index);
 
     //! Get storage size
-    [[nodiscard]] int StorageSize() const { return mMetaString.Capacity() + mIndexes.ByteSize(); }
+    [[nodiscard]] int StorageSize() const { return mMetaString.Capacity() + mIndexes.ByteSize() + SearchIndexSize(); }
+
+    //! Get search index size
+    [[nodiscard]] int SearchIndexSize() const { return (int)((mTrigramOffsets.capacity() + mTrigramPostings.capacity()) * sizeof(Index32)); }
 
     //! Get storage size
     [[nodiscard]] int ObjectCount() const { return mIndexes.Count(); }
@@ -114,7 +118,25 @@ class MetadataStringHolder
      */
     void FindText(const String& text, FoundTextList& output, int context);
 
+    /*!
+     * @brief Build the trigram search index of all strings currently stored.
+     * FindText then only verifies the strings containing all trigrams of the searched text.
+     * Strings added after the build are still searched using the linear scanner.
+     * May run in background: strings are snapshotted first, and the index is swapped in once built.
+     */
+    void BuildSearchIndex();
+
+    /*!
+     * @brief Release the trigram search index
+     */
+    void ReleaseSearchIndex();
+
   private:
+    //! Trigram bucket bits
+    static constexpr int sTrigramBits = 15;
+    //! Trigram buckets
+    static constexpr int sTrigramBuckets = 1 << sTrigramBits;
+
     //! Synchronizer
     Mutex mSyncher;
     //! String containing all substrings
@@ -123,6 +145,45 @@ class MetadataStringHolder
     Array<Index32> mIndexes;
     //! Temporary dictionnary string => indexes
     HashMap<String, Index32> mStringToIndexes;
+    //! Trigram bucket => first posting (sTrigramBuckets + 1 entries, empty if no index)
+    std::vector<Index32> mTrigramOffsets;
+    //! Postings: sorted string indexes, per bucket
+    std::vector<Index32> mTrigramPostings;
+    //! Number of strings covered by the trigram index
+    Index32 mIndexedStrings;
+    //! Incremented on each initialization, to drop indexes built from former strings
+    int mGeneration;
+
+    /*!
+     * @brief Get the trigram bucket of 3 chars, case insensitive
+     * @param p Pointer to the first char
+     * @return Bucket index
+     */
+    static int TrigramBucket(const char* p)
+    {
+      unsigned int key = (((unsigned int)(unsigned char)p[0] | 0x20) << 16) |
+                         (((unsigned int)(unsigned char)p[1] | 0x20) << 8) |
+                          ((unsigned int)(unsigned char)p[2] | 0x20);
+      return (int)((key * 2654435761u) >> (32 - sTrigramBits));
+    }
+
+    /*!
+     * @brief Get the char position following the given string (after its zero terminal)
+     * @param index String index
+     * @return Char position
+     */
+    [[nodiscard]] int EndOf(Index32 index) const { return index < mIndexes.Count() - 1 ? mIndexes[index + 1] : mMetaString.Count(); }
+
+    /*!
+     * @brief Linear search of text in the given char range of the metastring
+     * @param text Text to search for
+     * @param output Output list to fill with found results
+     * @param context User context
+     * @param from First char
+     * @param to Last char (excluded)
+     * @param index String index if the range covers a single string, or -1
+     */
+    void FindTextInRange(const String& text, FoundTextList& output, int context, int from, int to, Index32 index);
 
     /*!
      * @brief Get the index of the sub-string at the given char position from metastring
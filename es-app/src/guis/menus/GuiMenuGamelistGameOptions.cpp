@@ -106,7 +106,7 @@ GuiMenuGamelistGameOptions::GuiMenuGamelistGameOptions(WindowManager& window, IS
 GuiMenuGamelistGameOptions::~GuiMenuGamelistGameOptions()
 {
   if(mGame.Metadata().IsDirty())
-    mSystem.UpdateGamelistXml();
+    SystemData::JournalGame(mGame);
 }
 
 std::vector<GuiMenuBase::ListEntry<String>> GuiMenuGamelistGameOptions::GetRatioEntries()
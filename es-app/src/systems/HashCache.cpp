@@ -0,0 +1,90 @@
+#include "HashCache.h"
+#include <RootFolders.h>
+#include <utils/Files.h>
+#include <utils/Log.h>
+#include <cstring>
+
+HashCache::HashCache()
+  : mLoaded(false)
+  , mModified(false)
+{
+}
+
+Path HashCache::CachePath()
+{
+  return RootFolders::DataRootFolder / sCacheFile;
+}
+
+void HashCache::Load()
+{
+  Mutex::AutoLock locker(mLocker);
+  if (mLoaded) return;
+  mLoaded = true;
+
+  String image = Files::LoadFile(CachePath());
+  if ((int)image.size() < (int)sizeof(Header)) return;
+  const Header& header = *(const Header*)image.data();
+  if (memcmp(header.Magic, sMagic, sizeof(header.Magic)) != 0 || header.Version != sVersion) return;
+
+  // Read records, stop on any truncated record
+  int offset = (int)sizeof(Header);
+  mEntries.reserve(header.Count);
+  for(int i = header.Count; --i >= 0; )
+  {
+    if (offset + (int)sizeof(Record) > (int)image.size()) break;
+    Record record {};
+    memcpy(&record, image.data() + offset, sizeof(Record));
+    offset += (int)sizeof(Record);
+    if (record.PathLength <= 0 || offset + record.PathLength > (int)image.size()) break;
+    mEntries[String(image.data() + offset, record.PathLength)] = { record.Size, record.Time, record.Crc32 };
+    offset += record.PathLength;
+  }
+  { LOG(LogDebug) << "[HashCache] " << mEntries.size() << " hashes loaded"; }
+}
+
+void HashCache::Save()
+{
+  String image;
+  {
+    Mutex::AutoLock locker(mLocker);
+    if (!mModified) return;
+    mModified = false;
+
+    Header header {};
+    memcpy(header.Magic, sMagic, sizeof(header.Magic));
+    header.Version = sVersion;
+    header.Count = (int)mEntries.size();
+    image.Append((const char*)&header, sizeof(header));
+    for(const auto& entry : mEntries)
+    {
+      Record record { entry.second.Size, entry.second.Time, entry.second.Crc32, (int)entry.first.size() };
+      image.Append((const char*)&record, sizeof(record)).Append(entry.first);
+    }
+  }
+
+  // Save in a temporary file first, then atomically replace the previous cache
+  Path path = CachePath();
+  Path temporary = path.ChangeExtension(".tmp");
+  (void)path.Directory().CreatePath();
+  if (!Files::SaveFile(temporary, image) || !Path::Rename(temporary, path))
+  {
+    { LOG(LogWarning) << "[HashCache] Cannot save " << path.ToString(); }
+    (void)temporary.Delete();
+  }
+}
+
+bool HashCache::Lookup(const String& path, long long size, long long time, unsigned int& crc32)
+{
+  Mutex::AutoLock locker(mLocker);
+  Entry* entry = mEntries.try_get(path);
+  if (entry == nullptr || entry->Size != size || entry->Time != time) return false;
+  crc32 = entry->Crc32;
+  return true;
+}
+
+void HashCache::Store(const String& path, long long size, long long time, unsigned int crc32)
+{
+  Mutex::AutoLock locker(mLocker);
+  mEntries[path] = { size, time, crc32 };
+  mModified = true;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <utils/os/fs/Path.h>
+#include <utils/os/system/Mutex.h>
+#include <utils/storage/HashMap.h>
+
+/*!
+ * @brief Persistent rom Crc32 cache
+ *
+ * Crc32 are keyed by rom path, size & modification time, so that roms whose gamelist
+ * has not been saved (or has been rebuilt) are never hashed twice while unchanged.
+ * Thread safe.
+ */
+class HashCache
+{
+  public:
+    //! Constructor
+    HashCache();
+
+    /*!
+     * @brief Load the cache file, once
+     */
+    void Load();
+
+    /*!
+     * @brief Save the cache file if it has been modified
+     */
+    void Save();
+
+    /*!
+     * @brief Lookup a Crc32
+     * @param path Rom path
+     * @param size Rom size
+     * @param time Rom modification time (ns)
+     * @param crc32 Output Crc32
+     * @return True if a Crc32 has been found for this exact rom
+     */
+    bool Lookup(const String& path, long long size, long long time, unsigned int& crc32);
+
+    /*!
+     * @brief Store a Crc32
+     * @param path Rom path
+     * @param size Rom size
+     * @param time Rom modification time (ns)
+     * @param crc32 Crc32
+     */
+    void Store(const String& path, long long size, long long time, unsigned int crc32);
+
+  private:
+    //! Magic
+    static constexpr const char* sMagic = "RHSC";
+    //! Version - Increment each time Header or Record is modified
+    static constexpr int sVersion = 1;
+    //! Cache file
+    static constexpr const char* sCacheFile = "system/.emulationstation/cache/hashes.cache";
+
+    //! File header
+    struct Header
+    {
+      char Magic[4]; //!< Magic identifier
+      int  Version;  //!< File version
+      int  Count;    //!< Record count
+      int  Padding;  //!< Padding
+    };
+
+    //! Record, followed by the path
+    struct Record
+    {
+      long long    Size;       //!< Rom size
+      long long    Time;       //!< Rom modification time
+      unsigned int Crc32;      //!< Crc32
+      int          PathLength; //!< Path length
+    };
+
+    //! Cached value
+    struct Entry
+    {
+      long long    Size;  //!< Rom size
+      long long    Time;  //!< Rom modification time
+      unsigned int Crc32; //!< Crc32
+    };
+
+    //! Entries
+    HashMap<String, Entry> mEntries;
+    //! Protect entries
+    Mutex mLocker;
+    //! Loaded flag
+    bool mLoaded;
+    //! Modified flag
+    bool mModified;
+
+    //! Get cache file path
+    static Path CachePath();
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+class SystemData;
+class RootFolderData;
+class ScannedFolder;
+
+class IRomFolderRescanNotification
+{
+  public:
+    //! Destructor
+    virtual ~IRomFolderRescanNotification() = default;
+
+    /*!
+     * @brief Called from the main thread when a rom folder has been scanned again
+     * @param system Regular system owning the root
+     * @param root Root folder
+     * @param folder Scanned folder (part of the root tree)
+     */
+    virtual void RomFolderRescanned(SystemData& system, RootFolderData& root, const ScannedFolder& folder) = 0;
+};
@@ -22,6 +22,12 @@ class ISlowSystemOperation
     //! Default constructor
     virtual ~ISlowSystemOperation() = default;
 
+    /*!
+     * @brief Prepare the populate operation, called from the main thread before the operation starts
+     * @param listToPopulate System list to populate
+     */
+    virtual void SlowPopulatePrepare(const List& listToPopulate) = 0;
+
     //! Populate operation
     virtual void SlowPopulateExecute(const List& listToPopulate) = 0;
 
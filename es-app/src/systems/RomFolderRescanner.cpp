@@ -0,0 +1,90 @@
+#include "RomFolderRescanner.h"
+#include <systems/SystemData.h>
+
+RomFolderRescanner::RomFolderRescanner(IRomFolderRescanNotification& notification)
+  : mNotification(notification)
+  , mSender(*this)
+{
+}
+
+RomFolderRescanner::~RomFolderRescanner()
+{
+  Cancel();
+}
+
+void RomFolderRescanner::Push(SystemData& system, RootFolderData& root, const Path& folder, const String& extensions, const HashSet<String>& names)
+{
+  {
+    Mutex::AutoLock locker(mLocker);
+    bool merged = false;
+    for(Request& request : mPending)
+      if (request.Root == &root && request.Folder == folder)
+      {
+        // Empty name set means the whole folder
+        if (names.empty()) request.Names.clear();
+        else if (!request.Names.empty())
+          for(const String& name : names)
+            request.Names.insert(name);
+        merged = true;
+        break;
+      }
+    if (!merged) mPending.push_back({ &system, &root, folder, extensions, names, nullptr, nullptr });
+    // Restart after a Cancel (systems reloaded)
+    if (!IsRunning()) Thread::Start("RomRescan");
+  }
+  mSignal.Fire();
+}
+
+void RomFolderRescanner::Cancel()
+{
+  Thread::Stop();
+  Mutex::AutoLock locker(mLocker);
+  for(const Request& request : mCompleted)
+    delete request.Scanner;
+  mCompleted.clear();
+  mPending.clear();
+}
+
+void RomFolderRescanner::Run()
+{
+  while(IsRunning())
+  {
+    mSignal.WaitSignal();
+
+    for(Request request {}; IsRunning(); )
+    {
+      {
+        Mutex::AutoLock locker(mLocker);
+        if (mPending.empty()) break;
+        request = std::move(mPending.front());
+        mPending.erase(mPending.begin());
+      }
+
+      String ignoreList(','); ignoreList.Append(request.System->Descriptor().IgnoredFiles()).Append(',');
+      request.Scanner = new DirectoryScanner(*request.System, ignoreList);
+      request.Result = request.Scanner->Scan(request.Folder, request.Extensions, request.Names.empty() ? nullptr : &request.Names);
+      { LOG(LogDebug) << "[RomFolderRescanner] " << request.Folder.ToString() << " scanned" << (request.Names.empty() ? " entirely" : ""); }
+
+      {
+        Mutex::AutoLock locker(mLocker);
+        mCompleted.push_back(std::move(request));
+      }
+      mSender.Send();
+    }
+  }
+}
+
+void RomFolderRescanner::ReceiveSyncMessage()
+{
+  std::vector<Request> completed;
+  {
+    Mutex::AutoLock locker(mLocker);
+    completed.swap(mCompleted);
+  }
+  for(const Request& request : completed)
+  {
+    if (request.Result != nullptr)
+      mNotification.RomFolderRescanned(*request.System, *request.Root, *request.Result);
+    delete request.Scanner;
+  }
+}
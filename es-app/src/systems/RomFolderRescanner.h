@@ -0,0 +1,83 @@
+#pragma once
+
+#include <systems/IRomFolderRescanNotification.h>
+#include <games/DirectoryScanner.h>
+#include <utils/os/system/Thread.h>
+#include <utils/os/system/Signal.h>
+#include <utils/os/system/Mutex.h>
+#include <utils/sync/SyncMessageSender.h>
+#include <vector>
+
+/*!
+ * @brief Background scanner of rom folders where new items have been created
+ *
+ * Requests on the same folder are merged. Scans run in a background thread,
+ * then results are delivered to the main thread, one by one, so that trees are only modified there.
+ */
+class RomFolderRescanner : private Thread
+                         , private ISyncMessageReceiver<void>
+{
+  public:
+    /*!
+     * @brief Constructor
+     * @param notification Scan result receiver
+     */
+    explicit RomFolderRescanner(IRomFolderRescanNotification& notification);
+
+    //! Destructor
+    ~RomFolderRescanner() override;
+
+    /*!
+     * @brief Queue a folder scan
+     * @param system Regular system owning the root
+     * @param root Root folder
+     * @param folder Folder to scan. Must be the root folder or one of its sub-folders already in the tree
+     * @param extensions Extension list in effect in the folder
+     * @param names Entries to scan in the folder. Empty to scan the whole folder
+     */
+    void Push(SystemData& system, RootFolderData& root, const Path& folder, const String& extensions, const HashSet<String>& names);
+
+    /*!
+     * @brief Systems are about to be deleted: stop scanning & drop all pending scans and results
+     */
+    void Cancel();
+
+  private:
+    //! Scan request
+    struct Request
+    {
+      SystemData* System;          //!< System
+      RootFolderData* Root;        //!< Root folder
+      Path Folder;                 //!< Folder to scan
+      String Extensions;           //!< Extension list in the folder
+      HashSet<String> Names;       //!< Entries to scan, all if empty
+      DirectoryScanner* Scanner;   //!< Scanner holding the result, once scanned
+      const ScannedFolder* Result; //!< Scanned folder, null if the folder cannot be scanned
+    };
+
+    //! Result receiver
+    IRomFolderRescanNotification& mNotification;
+    //! Working signal
+    Signal mSignal;
+    //! Protect requests
+    Mutex mLocker;
+    //! Pending requests
+    std::vector<Request> mPending;
+    //! Scanned requests
+    std::vector<Request> mCompleted;
+    //! Main thread delivery
+    SyncMessageSender<void> mSender;
+
+    /*
+     * Thread implementation
+     */
+
+    void Run() override;
+    void Break() override { mSignal.Fire(); }
+
+    /*
+     * ISyncMessageReceiver<void> implementation
+     */
+
+    void ReceiveSyncMessage() override;
+};
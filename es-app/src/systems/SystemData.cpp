@@ -2,6 +2,7 @@
 #include <systems/SystemManager.h>
 #include "audio/AudioManager.h"
 #include "games/GameFilesUtils.h"
+#include "games/GamelistJournal.h"
 #include <usernotifications/NotificationManager.h>
 #include <utils/Files.h>
 #include <themes/ThemeException.h>
@@ -188,6 +189,15 @@ void SystemData::ParseGamelistXml(RootFolderData& root, FileData::StringMap& dop
     Path xmlpath = getGamelistPath(root, false);
     if (!xmlpath.Exists()) return;
 
+    String ignoreList(','); ignoreList.Append(mDescriptor.IgnoredFiles()).Append(',');
+
+    // Try the binary snapshot first
+    bool useSnapshot = !forceCheckFile && RecalboxConf::Instance().AsBool("emulationstation.gamelistsnapshot", true);
+    GamelistSnapshot::Stamp stamp = GamelistSnapshot::BuildStamp(xmlpath, root.RomPath(), String(mDescriptor.Extension()).Append(ignoreList));
+    if (useSnapshot)
+      if (ParseGamelistSnapshot(root, stamp, doppelgangerWatcher))
+        return;
+
     XmlDocument gameList;
     if (xmlpath.Extension().LowerCase() == ".zip")
     {
@@ -221,11 +231,10 @@ void SystemData::ParseGamelistXml(RootFolderData& root, FileData::StringMap& dop
       }
     }
 
-    String ignoreList(','); ignoreList.Append(mDescriptor.IgnoredFiles()).Append(',');
-
     const Path relativeTo(root.RomPath());
     XmlNode games = gameList.child("gameList");
     HashSet<String> blacklist;
+    FileData::List loaded;
 
     if (games != nullptr)
     {
@@ -269,8 +278,13 @@ void SystemData::ParseGamelistXml(RootFolderData& root, FileData::StringMap& dop
 
         // load the metadata
         file->Metadata().Deserialize(fileNode, relativeTo);
+        loaded.push_back(file);
       }
     }
+
+    // Store a fresh snapshot for the next run
+    if (useSnapshot)
+      GamelistSnapshot::Save(root.RomPath(), stamp, loaded);
   }
   catch (std::exception& ex)
   {
@@ -279,6 +293,30 @@ void SystemData::ParseGamelistXml(RootFolderData& root, FileData::StringMap& dop
   }
 }
 
+bool SystemData::ParseGamelistSnapshot(RootFolderData& root, const GamelistSnapshot::Stamp& stamp, FileData::StringMap& doppelgangerWatcher)
+{
+  GamelistSnapshot snapshot(root.RomPath());
+  if (!snapshot.Open(stamp)) return false;
+
+  const Path relativeTo(root.RomPath());
+  for(int i = 0; i < snapshot.Count(); ++i)
+  {
+    Path path = snapshot.RomPath(i);
+    FileData* file = LookupOrCreateGame(root, relativeTo, path, snapshot.Type(i), doppelgangerWatcher);
+    if (file == nullptr)
+    {
+      { LOG(LogError) << "[Gamelist] Error finding/creating FileData for \"" << path.ToString() << "\", skipping."; }
+      continue;
+    }
+
+    // Restore the metadata
+    snapshot.Restore(i, file->Metadata());
+  }
+
+  { LOG(LogInfo) << "[Gamelist] " << FullName() << ": " << snapshot.Count() << " items loaded from snapshot of " << root.RomPath().ToString(); }
+  return true;
+}
+
 void SystemData::UpdateGamelistXml()
 {
   // We do this by reading the XML again, adding changes and then writing it back,
@@ -347,6 +385,7 @@ void SystemData::UpdateGamelistXml()
           if (zip.Add(Writer.mOutput, xmlTruePath.Filename()))
           {
             (void)xmlTruePath.Delete();
+            GamelistJournal(rootPath).Clear();
             { LOG(LogInfo) << "[Gamelist] Saved gamelist.zip for system " << FullName() << ". Updated items: " << fileList.size() << "/" << fileList.size(); }
           }
           else { LOG(LogError) << "[Gamelist] Failed to save " << xmlWritePath.ToString(); }
@@ -356,6 +395,7 @@ void SystemData::UpdateGamelistXml()
           if (Files::SaveFile(xmlWritePath, Writer.mOutput))
           {
             (void)xmlWritePath.ChangeExtension(".zip").Delete();
+            GamelistJournal(rootPath).Clear();
             { LOG(LogInfo) << "[Gamelist] Saved gamelist.xml for system " << FullName() << ". Updated items: " << fileList.size() << "/" << fileList.size(); }
           }
           else { LOG(LogError) << "[Gamelist] Failed to save " << xmlWritePath.ToString(); }
@@ -367,6 +407,26 @@ void SystemData::UpdateGamelistXml()
       }
 }
 
+void SystemData::JournalGame(FileData& game)
+{
+  RootFolderData& root = game.TopAncestor();
+  if (root.ReadOnly() || root.Virtual()) return;
+
+  // On I/O error, the game stays dirty so that the next gamelist update saves it
+  bool mustCompact = false;
+  if (!GamelistJournal(root.RomPath()).Append({ &game }, mustCompact)) return;
+
+  // Compact when the journal becomes too large, or just forget the change, now journaled
+  if (mustCompact) game.System().UpdateGamelistXml();
+  else game.Metadata().UnsetDirty();
+}
+
+void SystemData::ReplayGamelistJournal(RootFolderData& root)
+{
+  if (!root.ReadOnly())
+    GamelistJournal(root.RomPath()).Replay(root);
+}
+
 bool SystemData::IsAutoScrapable() const
 {
   return (mProperties & Properties::GameInPng) != 0;
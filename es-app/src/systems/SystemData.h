@@ -10,6 +10,7 @@
 #include "games/MetadataType.h"
 #include "VirtualSystemType.h"
 #include <systems/SystemDataBase.h>
+#include <games/GamelistSnapshot.h>
 
 class SystemManager;
 
@@ -102,6 +103,15 @@ class SystemData : private INoCopy
      */
     void ParseGamelistXml(RootFolderData& root, FileData::StringMap& doppelgangerWatcher, bool forceCheckFile);
 
+    /*!
+     * @brief Load games from the binary snapshot of the given root, if it's still valid
+     * @param root Root rom folder
+     * @param stamp Current validation stamp of the root gamelist
+     * @param doppelgangerWatcher Maps to avoid duplicate entries
+     * @return True if the snapshot has been loaded, false if the xml gamelist must be parsed
+     */
+    bool ParseGamelistSnapshot(RootFolderData& root, const GamelistSnapshot::Stamp& stamp, FileData::StringMap& doppelgangerWatcher);
+
     /*!
      * @brief Get root folder of the given type
      * @param type root type
@@ -267,6 +277,20 @@ class SystemData : private INoCopy
      */
     void UpdateGamelistXml();
 
+    /*!
+     * @brief Persist the metadata of the given game in its gamelist journal, without rewriting the gamelist.
+     * The gamelist is compacted when the journal becomes too large.
+     * Once journaled, the game is no longer dirty. It stays dirty if the journal cannot be written.
+     * @param game Modified game
+     */
+    static void JournalGame(FileData& game);
+
+    /*!
+     * @brief Replay the gamelist journal of the given root, if any
+     * @param root Root rom folder
+     */
+    static void ReplayGamelistJournal(RootFolderData& root);
+
     /*!
      * @brief Update game list with a single game on top of the list
      * @param game game to insert or move
@@ -32,12 +32,6 @@ class SystemDeserializer
     //! User systems
     XmlDocument mUserDocument;
 
-    /*!
-     * @brief Get Template Configuration filepath
-     * @return Template Configuration filepath
-     */
-    static Path TemplateConfigurationPath() { return RootFolders::TemplateRootFolder / "system/.emulationstation/systemlist.xml"; }
-
     /*!
      * @brief Deserialize an emulator node and all its tree into an EmulatorList object
      * @param treeNode XML node to deserialize
@@ -81,6 +75,12 @@ class SystemDeserializer
      */
     static Path UserConfigurationPath()     { return RootFolders::DataRootFolder / "system/.emulationstation/systemlist.xml"; }
 
+    /*!
+     * @brief Get Template Configuration filepath
+     * @return Template Configuration filepath
+     */
+    static Path TemplateConfigurationPath() { return RootFolders::TemplateRootFolder / "system/.emulationstation/systemlist.xml"; }
+
     /*!
      * @brief Deserialize XML system node into a SystemDescriptor object
      * @param index System index from 0..Count()-1
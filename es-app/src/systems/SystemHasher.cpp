@@ -3,8 +3,26 @@
 //
 
 #include "SystemHasher.h"
+#include <utils/hash/Crc32File.h>
+#include <utils/Files.h>
+#include <utils/json/JSONBuilder.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
+#include <sys/sysmacros.h>
+#include <sys/sysinfo.h>
+#include <chrono>
+#include <climits>
+#include <cstring>
 
 SystemHasher::SystemHasher()
+  : mCurrent(nullptr)
+  , mPool(nullptr)
+  , mPending(0)
+  , mHashed(0)
+  , mCached(0)
+  , mBytes(0)
+  , mDuration(0)
+  , mRunStart(0)
 {
   Thread::Start("Hasher");
 }
@@ -14,6 +32,69 @@ SystemHasher::~SystemHasher()
   Thread::Stop();
 }
 
+bool SystemHasher::GetStamp(const Path& path, long long& size, long long& time)
+{
+  struct stat64 info {};
+  if (stat64(path.ToChars(), &info) != 0) return false;
+  size = info.st_size;
+  time = (long long)info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+  return true;
+}
+
+SystemHasher::StorageType SystemHasher::GetStorageType(const Path& path)
+{
+  // Network filesystems
+  struct statfs fs {};
+  if (statfs(path.ToChars(), &fs) == 0)
+    switch((unsigned int)fs.f_type)
+    {
+      case 0x6969u:     // NFS
+      case 0x517Bu:     // SMB
+      case 0xFF534D42u: // CIFS
+      case 0xFE534D42u: // SMB2
+        return StorageType::Network;
+      default: break;
+    }
+
+  // Block device
+  struct stat info {};
+  if (stat(path.ToChars(), &info) != 0) return StorageType::SolidState;
+  Path device(String("/sys/dev/block/").Append(major(info.st_dev)).Append(':').Append(minor(info.st_dev)));
+  char resolved[PATH_MAX];
+  if (realpath(device.ToChars(), resolved) != nullptr && strstr(resolved, "/mmcblk") != nullptr) return StorageType::SDCard;
+  // Partitions have no queue: look into the parent disk
+  String rotational = Files::LoadFile(device / "queue/rotational");
+  if (rotational.empty()) rotational = Files::LoadFile(device / "../queue/rotational");
+  return rotational.Trim() == "1" ? StorageType::HardDrive : StorageType::SolidState;
+}
+
+int SystemHasher::WorkerCount(StorageType type)
+{
+  int forced = RecalboxConf::Instance().AsInt("emulationstation.hasher.workers", 0);
+  if (forced > 0) return forced;
+  switch(type)
+  {
+    case StorageType::HardDrive: return 1;           // Avoid seeks
+    case StorageType::SDCard: return 2;              // Overlap open/read latencies only
+    case StorageType::Network: return 4;             // Latency bound
+    case StorageType::SolidState:
+    default: return std::min(4, get_nprocs());
+  }
+}
+
+const char* SystemHasher::StorageName(StorageType type)
+{
+  switch(type)
+  {
+    case StorageType::HardDrive: return "hard drive";
+    case StorageType::SDCard: return "SD card";
+    case StorageType::Network: return "network";
+    case StorageType::SolidState:
+    default: break;
+  }
+  return "solid state";
+}
+
 void SystemHasher::CheckMissingHashes(SystemData& system)
 {
   class MissingHashes : public IParser
@@ -21,16 +102,12 @@ void SystemHasher::CheckMissingHashes(SystemData& system)
     private:
       //! Parent reference
       SystemHasher& mHasher;
-      //! Hashed rom count
-      int mCount;
-      //! Found flag
-      bool mFound;
+      //! Roms to hash
+      FileData::List mGames;
 
     public:
       explicit MissingHashes(SystemHasher& hasher)
         : mHasher(hasher)
-        , mCount(0)
-        , mFound(false)
       {}
 
       void Parse(FileData& game) override
@@ -38,33 +115,102 @@ void SystemHasher::CheckMissingHashes(SystemData& system)
         if (!mHasher.IsRunning()) return;
         if (game.IsGame())
           if (game.Metadata().RomCrc32() == 0)
-          {
-            game.CalculateHash();
-            mCount++;
-            mFound = true;
-          }
+            mGames.push_back(&game);
       }
 
-      [[nodiscard]] int HashCount() const { return mCount; }
-      [[nodiscard]] bool MissingHashesFound() const { return mFound; }
+      [[nodiscard]] const FileData::List& Games() const { return mGames; }
   } missingHashes(*this);
 
   if (RecalboxConf::Instance().GetNetplayEnabled())
     if (system.Descriptor().HasNetPlayCores())
     {
-      DateTime start;
       system.MasterRoot().ParseAllItems(missingHashes);
-      if (missingHashes.MissingHashesFound())
-      { LOG(LogInfo) << "[SystemHasher] Calculated " << missingHashes.HashCount() << " missing hashes of " << system.FullName() << ". Took " << (DateTime() - start).TotalMilliseconds() << "ms."; }
+      if (missingHashes.Games().empty()) return;
+      mCache.Load();
+
+      // Get hashes from cache first
+      ThreadPool<FileData*, bool> pool(this, "Hasher", false);
+      int cached = 0;
+      for(FileData* game : missingHashes.Games())
+      {
+        long long size = 0;
+        long long time = 0;
+        unsigned int crc32 = 0;
+        if (!GetStamp(game->RomPath(), size, time) || size > sMaxFileSize) continue;
+        if (mCache.Lookup(game->RomPath().ToString(), size, time, crc32) && crc32 != 0)
+        {
+          game->Metadata().SetRomCrc32((int)crc32);
+          cached++;
+        }
+        else pool.PushFeed(game);
+      }
+      mCached += cached;
+
+      // Then hash remaining roms
+      int pending = pool.PendingJobs();
+      int hashed = mHashed;
+      long long bytes = mBytes;
+      long long duration = 0;
+      if (pending != 0 && IsRunning())
+      {
+        StorageType storage = GetStorageType(system.MasterRoot().SubRoots().empty() ? system.Descriptor().RomPath() : system.MasterRoot().SubRoots()[0]->RomPath());
+        int workers = std::min(WorkerCount(storage), pending);
+        { LOG(LogDebug) << "[SystemHasher] Hashing " << pending << " roms of " << system.FullName() << " using " << workers << " workers (" << StorageName(storage) << ')'; }
+
+        mPending = pending;
+        { Mutex::AutoLock locker(mLocker); mPool = &pool; }
+        auto start = std::chrono::steady_clock::now();
+        mRunStart = std::chrono::duration_cast<std::chrono::milliseconds>(start.time_since_epoch()).count();
+        pool.Run(workers, false);
+        duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        { Mutex::AutoLock locker(mLocker); mPool = nullptr; }
+        mPending = 0;
+        mRunStart = 0;
+        mDuration += duration;
+      }
+      mCache.Save();
+
+      hashed = mHashed - hashed;
+      bytes = mBytes - bytes;
+      { LOG(LogInfo) << "[SystemHasher] " << system.FullName() << ": " << hashed << " roms hashed (" << (bytes >> 10) << " KB in " << duration << "ms, "
+                     << (duration != 0 ? (bytes * 1000 / duration) >> 20 : 0) << " MB/s), " << cached << " from cache."; }
     }
 }
 
+void SystemHasher::ThreadPoolJobStart(FileData*& feed)
+{
+  (void)feed;
+  // De-prioritize workers to IDLE, once
+  static thread_local bool sIdle = false;
+  if (!sIdle)
+  {
+    sched_param params { .sched_priority = 0 };
+    sIdle = pthread_setschedparam(pthread_self(), SCHED_IDLE, &params) == 0;
+  }
+}
+
+bool SystemHasher::ThreadPoolRunJob(FileData*& feed)
+{
+  mPending--;
+  if (!IsRunning()) return false;
+
+  feed->CalculateHash();
+  long long size = 0;
+  long long time = 0;
+  if (unsigned int crc32 = (unsigned int)feed->Metadata().RomCrc32(); crc32 != 0)
+    if (GetStamp(feed->RomPath(), size, time))
+      mCache.Store(feed->RomPath().ToString(), size, time, crc32);
+  mHashed++;
+  mBytes += size;
+  return true;
+}
+
 void SystemHasher::Run()
 {
   // De-prioritize this thread to IDLE
   sched_param params { .sched_priority = 0 };
   if (pthread_setschedparam(pthread_self(), SCHED_IDLE, &params) == 0)
-    { LOG(LogDebug) << "[SystemHasher] Hasher thread set to IDLE priority"; }
+    { LOG(LogDebug) << "[SystemHasher] Hasher thread set to IDLE priority" << (Crc32File::HasHardwareCrc32() ? ", using hardware Crc32" : ""); }
   else
     { LOG(LogError) << "[SystemHasher] Error setting IDLE priority to Hasher thread"; }
 
@@ -74,15 +220,18 @@ void SystemHasher::Run()
     // Wait until a job is queued
     mSignal.WaitSignal();
 
-    // Dequeue
-    mLocker.Lock();
-    SystemData* system = !mQueue.Empty() ? mQueue.Pop() : nullptr;
-    mLocker.UnLock();
-
-    if (system !=  nullptr)
+    // Dequeue all
+    for(SystemData* system = nullptr; IsRunning(); )
     {
+      mLocker.Lock();
+      system = !mQueue.Empty() ? mQueue.Pop() : nullptr;
+      mCurrent = system;
+      mLocker.UnLock();
+      if (system == nullptr) break;
+
       { LOG(LogDebug) << "[SystemHasher] Start checking hash of " << system->FullName(); }
       CheckMissingHashes(*system);
+      { Mutex::AutoLock locker(mLocker); mCurrent = nullptr; }
     }
   }
 }
@@ -90,6 +239,9 @@ void SystemHasher::Run()
 void SystemHasher::Push(SystemData* system)
 {
   mLocker.Lock();
+  // Restart after a MustQuit (systems reloaded)
+  if (!IsRunning())
+    Thread::Start("Hasher");
   mQueue.Push(system);
   mLocker.UnLock();
   mSignal.Fire();
@@ -97,6 +249,49 @@ void SystemHasher::Push(SystemData* system)
 
 void SystemHasher::MustQuit()
 {
+  {
+    Mutex::AutoLock locker(mLocker);
+    if (mPool != nullptr) mPool->CancelPendingJobs();
+  }
   Thread::Stop();
+  // Queued systems are about to be deleted
+  mLocker.Lock();
+  while(!mQueue.Empty()) (void)mQueue.Pop();
+  mLocker.UnLock();
+  mCache.Save();
 }
 
+std::vector<SystemData*> SystemHasher::Suspend()
+{
+  std::vector<SystemData*> systems;
+  {
+    Mutex::AutoLock locker(mLocker);
+    if (mCurrent != nullptr) systems.push_back(mCurrent);
+    while(!mQueue.Empty()) systems.push_back(mQueue.Pop());
+  }
+  MustQuit();
+  return systems;
+}
+
+SystemHasher::Statistics SystemHasher::GetStatistics() const
+{
+  long long duration = mDuration;
+  if (long long start = mRunStart; start != 0)
+    duration += std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count() - start;
+  return { mPending, mHashed, mCached, mBytes, duration };
+}
+
+String SystemHasher::Report() const
+{
+  Statistics s = GetStatistics();
+  JSONBuilder json;
+  json.Open()
+      .Field("pending", s.Pending)
+      .Field("hashed", s.Hashed)
+      .Field("cached", s.Cached)
+      .Field("bytes", s.Bytes)
+      .Field("elapsed", s.Duration)
+      .Field("throughput", s.Duration != 0 ? s.Bytes * 1000 / s.Duration : 0LL)
+      .Close();
+  return json;
+}
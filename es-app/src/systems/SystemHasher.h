@@ -5,12 +5,26 @@
 
 #include <utils/os/system/Thread.h>
 #include <utils/os/system/Signal.h>
+#include <utils/os/system/ThreadPool.h>
 #include <utils/storage/Queue.h>
 #include <systems/SystemData.h>
+#include <systems/HashCache.h>
+#include <atomic>
 
 class SystemHasher : private Thread
+                   , private IThreadPoolWorkerInterface<FileData*, bool>
 {
   public:
+    //! Progress & throughput counters, since the hasher started
+    struct Statistics
+    {
+      int       Pending;  //!< Roms waiting to be hashed in the current system
+      int       Hashed;   //!< Hashed roms
+      int       Cached;   //!< Roms whose hash has been found in the cache
+      long long Bytes;    //!< Hashed bytes
+      long long Duration; //!< Time spent hashing (ms), including the running system
+    };
+
     //! Constructor
     SystemHasher();
 
@@ -23,13 +37,59 @@ class SystemHasher : private Thread
     //! Application is about to quit - stop any processing asap
     void MustQuit();
 
+    /*!
+     * @brief Stop any processing asap, so that game trees can be modified safely
+     * @return Systems being hashed or queued, to push again once the trees are modified
+     */
+    std::vector<SystemData*> Suspend();
+
+    //! Get progress & throughput counters
+    [[nodiscard]] Statistics GetStatistics() const;
+
+    /*!
+     * @brief Get progress & throughput counters
+     * @return JSON report
+     */
+    [[nodiscard]] String Report() const;
+
   private:
+    //! Storage type of a rom folder
+    enum class StorageType
+    {
+      SolidState, //!< SSD, NVMe, USB keys
+      SDCard,     //!< SD & eMMC
+      HardDrive,  //!< Rotational drives
+      Network,    //!< NFS, SMB
+    };
+
+    //! Larger files are never hashed
+    static constexpr long long sMaxFileSize = 20 << 20;
+
     //! Working signal
     Signal mSignal;
     //! Queue protector
     Mutex mLocker;
     //! System queue
     ::Queue<SystemData*> mQueue;
+    //! System being hashed, if any
+    SystemData* mCurrent;
+    //! Running worker pool, if any
+    ThreadPool<FileData*, bool>* mPool;
+    //! Persistent hash cache
+    HashCache mCache;
+
+    //! Pending roms
+    std::atomic<int> mPending;
+    //! Hashed roms
+    std::atomic<int> mHashed;
+    //! Roms found in cache
+    std::atomic<int> mCached;
+    //! Hashed bytes
+    std::atomic<long long> mBytes;
+    //! Time spent hashing completed systems (ms)
+    std::atomic<long long> mDuration;
+    //! Start time of the running system (steady clock, ms), 0 if none
+    std::atomic<long long> mRunStart;
 
     /*!
      * @brief Check missing hashed and calculate them all
@@ -37,6 +97,32 @@ class SystemHasher : private Thread
      */
     void CheckMissingHashes(SystemData& system);
 
+    /*!
+     * @brief Get size & modification time of a rom
+     * @param path Rom path
+     * @param size Output size
+     * @param time Output modification time (ns)
+     * @return True if the rom exists
+     */
+    static bool GetStamp(const Path& path, long long& size, long long& time);
+
+    /*!
+     * @brief Get the storage type of the given folder
+     * @param path Folder
+     * @return Storage type
+     */
+    static StorageType GetStorageType(const Path& path);
+
+    /*!
+     * @brief Get the worker count suitable for the given storage
+     * @param type Storage type
+     * @return Worker count
+     */
+    static int WorkerCount(StorageType type);
+
+    //! Storage name, for logs
+    static const char* StorageName(StorageType type);
+
     /*
      * Thread implementation
      */
@@ -50,4 +136,14 @@ class SystemHasher : private Thread
      * @brief Process missing hashes in the queued systems
      */
     void Run() override;
+
+    /*
+     * IThreadPoolWorkerInterface implementation
+     */
+
+    //! Lower worker priority to IDLE
+    void ThreadPoolJobStart(FileData*& feed) override;
+
+    //! Hash a single rom
+    bool ThreadPoolRunJob(FileData*& feed) override;
 };
@@ -5,15 +5,17 @@
 #include "SystemManager.h"
 #include "SystemDescriptor.h"
 #include "SystemDeserializer.h"
-#include "LightGunDatabase.h"
 #include "games/classifications/Versions.h"
 #include "utils/hash/Crc32.h"
 #include "games/GameFilesUtils.h"
 #include <systems/arcade/ArcadeVirtualSystems.h>
-#include <utils/os/system/ThreadPool.h>
+#include <utils/os/system/WorkStealingThreadPool.h>
 #include <utils/os/fs/StringMapFile.h>
 #include <utils/Files.h>
+#include <utils/IniFile.h>
+#include <utils/profiling/StartupProfiler.h>
 #include <dirent.h>
+#include <algorithm>
 
 SystemManager::RomSources SystemManager::GetRomSource(const SystemDescriptor& systemDescriptor, PortTypes port)
 {
@@ -241,7 +243,10 @@ void SystemManager::InitializeSystem(SystemData* system)
     }
     // Load theme (not for port games)
     if (!system->IsPorts())
+    {
+      StartupProfiler::Scope scope("theme", system->Name());
       system->loadTheme();
+    }
 
     // Set initialised
     system->SetInitialized();
@@ -286,10 +291,21 @@ void SystemManager::PopulateRegularSystem(SystemData* system)
     // Populate items from disk
     bool loadFromDisk = mForceReload || (!RecalboxConf::Instance().GetStartupGamelistOnly() && rootPath.first.Contains("/share/") );
     if (loadFromDisk)
+    {
+      StartupProfiler::Scope scope("folder", system->Name());
       system->populateFolder(root, doppelgangerWatcher);
+      StartupProfiler::Count("folders");
+    }
 
     // Populate items from gamelist.xml
-    system->ParseGamelistXml(root, doppelgangerWatcher, mForceReload);
+    {
+      StartupProfiler::Scope scope("gamelist", system->Name());
+      system->ParseGamelistXml(root, doppelgangerWatcher, mForceReload);
+      StartupProfiler::Count("gamelists");
+    }
+
+    // Replay changes not yet compacted into gamelist.xml
+    SystemData::ReplayGamelistJournal(root);
 
     #ifdef DEBUG
     { LOG(LogDebug) << "[System] " << root.CountAll(false, FileData::Filter::None) << " games found for " << system->Descriptor().FullName() << " in " << rootPath.first; }
@@ -335,38 +351,14 @@ void SystemManager::PopulatePortsSystem(SystemData* systemPorts)
 
 void SystemManager::PopulateLastPlayedSystem(SystemData* systemLastPlayed)
 {
-  class Filter: public IFilter
-  {
-    private:
-      FileData::TopLevelFilter mFilter;
-    public:
-      Filter() : mFilter(FileData::BuildTopLevelFilter()) {}
-      [[nodiscard]] bool ApplyFilter(const FileData& file) override
-      {
-        return file.Metadata().LastPlayedEpoc() != 0;
-      }
-  } filter;
-
   if (RecalboxConf::Instance().GetCollectionLastPlayed())
-    PopulateMetaSystemWithFilter(systemLastPlayed, &filter, nullptr);
+    PopulateVirtualSystemWithGames(systemLastPlayed, mVirtualSystemIndex.Games(VirtualSystemIndex::Flag::LastPlayed));
 }
 
 void SystemManager::PopulateMultiPlayerSystem(SystemData* systemMultiPlayer)
 {
-  class Filter: public IFilter
-  {
-    private:
-      FileData::TopLevelFilter mFilter;
-    public:
-      Filter() : mFilter(FileData::BuildTopLevelFilter()) {}
-      [[nodiscard]] bool ApplyFilter(const FileData& file) override
-      {
-        return (file.Metadata().PlayerMin() > 1 || file.Metadata().PlayerMax() > 1);
-      }
-  } filter;
-
   if (RecalboxConf::Instance().GetCollectionMultiplayer())
-    PopulateMetaSystemWithFilter(systemMultiPlayer, &filter, nullptr);
+    PopulateVirtualSystemWithGames(systemMultiPlayer, mVirtualSystemIndex.Games(VirtualSystemIndex::Flag::Multiplayer));
 }
 
 void SystemManager::PopulateAllGamesSystem(SystemData* systemAllGames)
@@ -385,28 +377,13 @@ void SystemManager::PopulateAllGamesSystem(SystemData* systemAllGames)
 void SystemManager::PopulateLightgunSystem(SystemData* systemLightGun)
 {
   if (RecalboxConf::Instance().GetCollectionLightGun())
-  {
-    LightGunDatabase database;
-    PopulateMetaSystemWithFilter(systemLightGun, &database, nullptr);
-  }
+    PopulateVirtualSystemWithGames(systemLightGun, mVirtualSystemIndex.Games(VirtualSystemIndex::Flag::Lightgun));
 }
 
 void SystemManager::PopulateTateSystem(SystemData* systemTate)
 {
-  class Filter: public IFilter
-  {
-    private:
-      FileData::TopLevelFilter mFilter;
-    public:
-      Filter() : mFilter(FileData::BuildTopLevelFilter()) {}
-      [[nodiscard]] bool ApplyFilter(const FileData& file) override
-      {
-        return (file.Metadata().Rotation() == RotationType::Left || file.Metadata().Rotation() == RotationType::Right);
-      }
-  } filter;
-
   if (RecalboxConf::Instance().GetCollectionTate())
-    PopulateMetaSystemWithFilter(systemTate, &filter, nullptr);
+    PopulateVirtualSystemWithGames(systemTate, mVirtualSystemIndex.Games(VirtualSystemIndex::Flag::Tate));
 }
 
 void SystemManager::PopulateArcadeSystem(SystemData* systemArcade)
@@ -431,151 +408,19 @@ void SystemManager::PopulateArcadeSystem(SystemData* systemArcade)
 
 void SystemManager::PopulateGenreSystem(SystemData* systemGenre)
 {
-  class Filter : public IFilter
-  {
-    private:
-      GameGenres mGenre;
-      bool mSubGenre;
-
-    public:
-      explicit Filter(GameGenres genre) : mGenre(genre), mSubGenre(Genres::IsSubGenre(genre)) {}
-      [[nodiscard]] bool ApplyFilter(const FileData& file) override
-      {
-        if (mSubGenre) return file.Metadata().GenreId() == mGenre;
-        return Genres::TopGenreMatching(file.Metadata().GenreId(), mGenre);
-      }
-  };
-
   // Lookup genre
-  GameGenres genre = Genres::LookupFromName(String(systemGenre->Name()).Remove(sGenrePrefix));
+  GameGenres genre = GenreFromSystem(*systemGenre);
   if (genre == GameGenres::None) { LOG(LogError) << "[SystemManager] Unable to lookup system genre!"; abort(); }
 
   if (RecalboxConf::Instance().IsInCollectionGenre(BuildGenreSystemName(genre)))
-  {
-    Filter filter(genre);
-    PopulateMetaSystemWithFilter(systemGenre, &filter, nullptr);
-  }
+    PopulateVirtualSystemWithGames(systemGenre, mVirtualSystemIndex.GamesOfGenre(genre));
 }
 
 void SystemManager::PopulateArcadeManufacturersSystem(SystemData* system)
 {
-  class Filter : public IFilter
-  {
-    private:
-      const ArcadeDatabaseManager& mArcadeDatabaseManager;
-      const ArcadeDatabase* mDatabase;
-      const FolderData* mParent;
-      String mManufacturerName;
-      int mManufacturerIndex;
-      HashMap<const ArcadeDatabase*, int> mManufacturerIndexesFastLookup;
-
-    public:
-      /*!
-       * @brief Constructor
-       * @param arcadeDatabaseManager Database manager from witch to retrieve arcade database
-       * @param manufacturerName manufacturer name to lookup for games matching this manufacturer
-       */
-      explicit Filter(const ArcadeDatabaseManager& arcadeDatabaseManager, const String& manufacturerName)
-        : mArcadeDatabaseManager(arcadeDatabaseManager)
-        , mDatabase(nullptr)
-        , mParent(nullptr)
-        , mManufacturerName(manufacturerName)
-        , mManufacturerIndex(-1)
-      {
-      }
-
-      /*!
-       * @brief Main filter method
-       * @param file File to filter
-       * @return True of the file is accepted, false if it's rejected
-       */
-      [[nodiscard]] bool ApplyFilter(const FileData& file) override
-      {
-        // Update the database regarding the emulator configured for the current Folder
-        // After the database is updated, lookup the manufacturer index regarding the manufacturer name.
-        // If neither no database, nor manufacturer index is found, ignore the current game
-        if (mDatabase == nullptr || mParent != file.Parent())
-        {
-          if (mDatabase = mArcadeDatabaseManager.LookupDatabase(*(mParent = file.Parent())); mDatabase != nullptr)
-          {
-            if (int* cacheList = mManufacturerIndexesFastLookup.try_get(mDatabase); cacheList != nullptr) mManufacturerIndex = *cacheList;
-            else mManufacturerIndexesFastLookup[mDatabase] = (mManufacturerIndex = mDatabase->RawManufacturerIndexFromName(
-                mManufacturerName));
-          }
-          else return false; // No database for the current folder
-        }
-        // Valid data?
-        if (mManufacturerIndex < 0) return false; // No manufacturer
-
-        // Lookup the current game in the arcade database
-        const ArcadeGame* arcade = mDatabase->LookupGame(file);
-        // No arcade data for that game, it's an unknown game, ignore it
-        if (arcade == nullptr) return false;
-        // Not a regular arcade game?
-        if (arcade->Hierarchy() == ArcadeGame::Type::Bios) return false;
-        // Finally, compare the manufacturer index. If it's the right index, we got a game!
-        return arcade->RawManufacturer().Contains(mManufacturerIndex);
-      }
-  };
-
-  String identifier = system->Name();
-  String manufacturer(identifier); manufacturer.Remove(sArcadeManufacturerPrefix).Replace('-', '\\');
-  if (RecalboxConf::Instance().IsInCollectionArcadeManufacturers(identifier))
-  {
-    // Filter and insert items
-    FileData::List allGames;
-    FileData::StringMap doppelganger;
-    for (const SystemData* regular: mAllSystems)
-      if (regular->Descriptor().IsTrueArcade())
-      {
-        Filter filter(regular->ArcadeDatabases(), manufacturer);
-        for (const RootFolderData* root: regular->MasterRoot().SubRoots())
-          if (!root->Virtual())
-          {
-            FileData::List list = root->GetFilteredItemsRecursively(&filter, true);
-            allGames.reserve(allGames.size() + list.size());
-            allGames.insert(allGames.end(), list.begin(), list.end());
-          }
-        // dopplegagner must be build using file only
-        // Let the virtual system re-create all intermediate folder and destroy them properly
-        regular->BuildDoppelgangerMap(doppelganger, false);
-      }
-
-    // Not empty?
-    if (!allGames.empty())
-      PopulateVirtualSystemWithGames(system, allGames, doppelganger);
-  }
-}
-
-void SystemManager::PopulateMetaSystemWithFilter(SystemData* system, IFilter* filter, FileData::Comparer comparer)
-{
-  // Filter and insert items
-  FileData::List allGames;
-  FileData::StringMap doppelganger;
-  for (SystemData* regular : mAllSystems)
-    if (!regular->IsVirtual())
-    {
-      for (const RootFolderData* root : regular->MasterRoot().SubRoots())
-        if (!root->Virtual())
-        {
-          FileData::List list = root->GetFilteredItemsRecursively(filter, true);
-          allGames.reserve(allGames.size() + list.size());
-          allGames.insert(allGames.end(), list.begin(), list.end());
-        }
-      // doppleganger must be built using file only
-      // Let the virtual system re-create all intermediate folder and destroy them properly
-      regular->BuildDoppelgangerMap(doppelganger, false);
-    }
-
-  // Not empty?
-  if (!allGames.empty())
-  {
-    // Sort if required
-    if (comparer != nullptr) FolderData::Sort(allGames, comparer, true);
-    // Populate!
-    { LOG(LogInfo) << "[System] Populating " << system->FullName() << " meta-system"; }
-    PopulateVirtualSystemWithGames(system, allGames, doppelganger);
-  }
+  if (RecalboxConf::Instance().IsInCollectionArcadeManufacturers(system->Name()))
+    if (const FileData::List* games = mVirtualSystemIndex.GamesOfManufacturer(ArcadeManufacturerFromSystem(*system)); games != nullptr)
+      PopulateVirtualSystemWithGames(system, *games);
 }
 
 void SystemManager::PopulateVirtualSystemWithSystem(SystemData* system, const List & systems, FileData::StringMap& doppelganger, bool includesubfolder)
@@ -591,10 +436,16 @@ void SystemManager::PopulateVirtualSystemWithSystem(SystemData* system, const Li
       }
 }
 
-void SystemManager::PopulateVirtualSystemWithGames(SystemData* system, const FileData::List& games, FileData::StringMap& doppelganger)
+void SystemManager::PopulateVirtualSystemWithGames(SystemData* system, const FileData::List& games)
 {
   if (!games.empty())
   {
+    // doppleganger must be built using file only
+    // Let the virtual system re-create all intermediate folder and destroy them properly
+    FileData::StringMap doppelganger;
+    for (FileData* fd : games)
+      doppelganger[fd->RomPath().ToString()] = fd;
+
     RootFolderData& root = system->CreateRootFolder(Path(), RootFolderData::Ownership::FolderOnly, RootFolderData::Types::Virtual);
     { LOG(LogDebug) << "[System] Add " << games.size() << " games into " << system->FullName(); }
     for (auto* fd : games)
@@ -602,6 +453,17 @@ void SystemManager::PopulateVirtualSystemWithGames(SystemData* system, const Fil
   }
 }
 
+GameGenres SystemManager::GenreFromSystem(const SystemData& system)
+{
+  return Genres::LookupFromName(String(system.Name()).Remove(sGenrePrefix));
+}
+
+String SystemManager::ArcadeManufacturerFromSystem(const SystemData& system)
+{
+  String manufacturer(system.Name());
+  return manufacturer.Remove(sArcadeManufacturerPrefix).Replace('-', '\\');
+}
+
 SystemData* SystemManager::CreateRegularSystem(const SystemDescriptor& systemDescriptor)
 {
   // Create system
@@ -797,7 +659,9 @@ SystemData* SystemManager::ThreadPoolRunJob(SystemDescriptor& systemDescriptor)
 {
   try
   {
+    StartupProfiler::Scope scope("system", systemDescriptor.Name());
     SystemData* newSys = CreateRegularSystem(systemDescriptor);
+    StartupProfiler::Count("systems");
     { LOG(LogDebug) << "[System] Adding \"" << systemDescriptor.Name() << "\" in system list."; }
     return newSys;
   }
@@ -817,6 +681,224 @@ void SystemManager::WatchGameList(FileNotifier& gamelistWatcher)
         gamelistWatcher.WatchFile(path);
 }
 
+void SystemManager::WatchRomFolders()
+{
+  mRomFolderWatcher.UnwatchAll();
+  if (!RecalboxConf::Instance().AsBool("emulationstation.watchromfolders", true)) return;
+
+  for(const SystemData* system : mAllSystems)
+    if (!system->IsVirtual())
+      for(const RootFolderData* root : system->MasterRoot().SubRoots())
+        if (root->Normal() && root->RomPath().IsDirectory())
+          mRomFolderWatcher.WatchRoot(root->RomPath());
+}
+
+void SystemManager::SuspendGameWorkers()
+{
+  if (mGameWorkersSuspended) return;
+  mGameWorkersSuspended = true;
+  mSuspendedHashes = mHasher.Suspend();
+  mSuspendedVerification = mRomsetVerifier.IsVerifying();
+  if (mSuspendedVerification) mRomsetVerifier.MustQuit();
+}
+
+bool SystemManager::StartRomsetVerification()
+{
+  if (mRomsetVerifier.IsVerifying()) return false;
+  if (bool expected = false; !mVerificationRequested.compare_exchange_strong(expected, true)) return false;
+  mVerificationStarter.Send();
+  return true;
+}
+
+void SystemManager::ReceiveSyncMessage()
+{
+  // Systems are only loaded/deleted in the main thread: they cannot vanish while starting
+  if (!mGameWorkersSuspended) (void)mRomsetVerifier.Start(mAllSystems);
+  else mSuspendedVerification = true;
+  mVerificationRequested = false;
+}
+
+void SystemManager::ResumeGameWorkers()
+{
+  if (!mGameWorkersSuspended) return;
+  mGameWorkersSuspended = false;
+  for(SystemData* system : mSuspendedHashes)
+    mHasher.Push(system);
+  mSuspendedHashes.clear();
+  if (mSuspendedVerification) (void)mRomsetVerifier.Start(mAllSystems);
+  mSuspendedVerification = false;
+}
+
+bool SystemManager::ApplyRomFolderChanges(SystemData& system, RootFolderData& root, const FileSystemChangeSet& changes)
+{
+  FileData::StringMap items;
+  root.BuildDoppelgangerMap(items, true);
+
+  // Removed items. When events have been lost, check all items
+  HashSet<FileData*> removed;
+  if (changes.mOverflow)
+  {
+    for(const auto& item : items)
+      if (!item.second->RomPath().Exists())
+        removed.insert(item.second);
+  }
+  else
+    for(const Path& path : changes.mRemoved)
+      if (FileData** found = items.try_get(path.ToString()); found != nullptr)
+        removed.insert(*found);
+
+  // Workers must not hold pointers to items being deleted
+  if (!removed.empty()) SuspendGameWorkers();
+
+  int removedCount = 0;
+  for(FileData* item : removed)
+  {
+    // Items of a removed folder go with their folder
+    bool parentRemoved = false;
+    for(FolderData* parent = item->Parent(); parent != nullptr && !parentRemoved; parent = parent->Parent())
+      parentRemoved = removed.contains(parent);
+    if (parentRemoved) continue;
+    if (item->IsGame()) system.RemoveArcadeReference(*item);
+    else for(const FileData* game : ((FolderData*)item)->GetAllItemsRecursively(false, FileData::Filter::None))
+      system.RemoveArcadeReference(*game);
+    RootFolderData::DeleteChild(item);
+    removedCount++;
+  }
+
+  // Scan in the background, and only the highest unknown items that may add games or folders
+  if (changes.mOverflow)
+    mRomFolderRescanner.Push(system, root, root.RomPath(), ExtensionsInFolder(system, root.RomPath(), root.RomPath()), HashSet<String>());
+  else
+  {
+    HashMap<String, HashSet<String>> rescans;
+    for(const Path& path : changes.mCreated)
+    {
+      if (items.contains(path.ToString()) || mWatcherIgnoredFiles.contains(path.ToString())) continue;
+      if (!IsRescanCandidate(system, root.RomPath(), path)) continue;
+      // Lookup the nearest folder already in the tree
+      Path entry(path);
+      Path folder(path.Directory());
+      while(folder != root.RomPath() && folder.StartWidth(root.RomPath()) && !items.contains(folder.ToString()))
+      {
+        entry = folder;
+        folder = folder.Directory();
+      }
+      rescans[folder.ToString()].insert(entry.Filename());
+    }
+    for(const auto& rescan : rescans)
+    {
+      Path folder(rescan.first);
+      mRomFolderRescanner.Push(system, root, folder, ExtensionsInFolder(system, root.RomPath(), folder), rescan.second);
+    }
+  }
+
+  if (removedCount == 0) return false;
+  { LOG(LogInfo) << "[SystemManager] " << system.FullName() << ": " << root.RomPath().ToString() << " updated (" << removedCount << " removed)"; }
+  return true;
+}
+
+String SystemManager::ExtensionsInFolder(const SystemData& system, const Path& root, const Path& folder)
+{
+  // Nearest .system.cfg override
+  for(Path item(folder); item.StartWidth(root); item = item.Directory())
+  {
+    Path subSystem(item / ".system.cfg");
+    if (subSystem.Exists())
+      return IniFile(subSystem, false, false).AsString("extensions", system.Descriptor().Extension().ToLowerCase());
+    if (item == root) break;
+  }
+  return system.Descriptor().Extension().ToLowerCase();
+}
+
+bool SystemManager::IsRescanCandidate(const SystemData& system, const Path& root, const Path& path)
+{
+  // Hidden items & media folders are never scanned
+  int last = path.ItemCount() - 1;
+  for(int i = root.ItemCount(); i < last; ++i)
+  {
+    String item = path.Item(i);
+    if (item[0] == '.' || item == "media") return false;
+  }
+  String name = path.Filename();
+  // Extension overrides
+  if (name == ".system.cfg") return true;
+  if (name.empty() || name[0] == '.') return false;
+  if (path.FilenameWithoutExtension() == "gamelist") return false;
+  String ignoreList(','); ignoreList.Append(system.Descriptor().IgnoredFiles()).Append(',');
+  if (ignoreList.Contains(String(',').Append(name).Append(','))) return false;
+
+  // Folders may contain anything
+  if (path.IsDirectory()) return true;
+  ExtensionFilter filter(ExtensionsInFolder(system, root, path.Directory()));
+  return filter.IsEmpty() || filter.IsMatching(path.FilenameWithoutExtension(), path.Extension().ToLowerCase());
+}
+
+void SystemManager::ClassifySystemChange(SystemData* system, bool hasVisibleBefore, List& addedSystems, List& removedSystems, List& modifiedSystems)
+{
+  bool hasVisibleNow = system->HasVisibleGame();
+  if (hasVisibleBefore)
+  {
+    if (hasVisibleNow) modifiedSystems.Add(system);
+    else { removedSystems.Add(system); LogSystemRemoved(system); }
+  }
+  else if (hasVisibleNow) { addedSystems.Add(system); LogSystemAdded(system); }
+}
+
+void SystemManager::RomFolderRescanned(SystemData& system, RootFolderData& root, const ScannedFolder& folder)
+{
+  FileData::StringMap items;
+  root.BuildDoppelgangerMap(items, true);
+  FolderData* target = &root;
+  if (folder.FolderPath() != root.RomPath())
+  {
+    FileData** found = items.try_get(folder.FolderPath().ToString());
+    if (found == nullptr || !(*found)->IsFolder()) return; // Removed meanwhile
+    target = (FolderData*)*found;
+  }
+
+  bool hasVisibleBefore = system.HasVisibleGame();
+  SuspendGameWorkers();
+  bool added = target->MergeFromScan(root, folder, items);
+  // New roms need hashing
+  if (added && std::find(mSuspendedHashes.begin(), mSuspendedHashes.end(), &system) == mSuspendedHashes.end())
+    mSuspendedHashes.push_back(&system);
+  ResumeGameWorkers();
+  if (!added) return;
+  { LOG(LogInfo) << "[SystemManager] " << system.FullName() << ": " << folder.FolderPath().ToString() << " updated (new items added)"; }
+
+  List addedSystems;
+  List removedSystems;
+  List modifiedSystems;
+  ClassifySystemChange(&system, hasVisibleBefore, addedSystems, removedSystems, modifiedSystems);
+  // Virtual systems gather games from regular systems
+  UpdateSystemsOnMultipleGameChanges(MetadataType::Path, addedSystems, removedSystems, modifiedSystems);
+  ApplySystemChanges(&addedSystems, &removedSystems, &modifiedSystems, false);
+}
+
+void SystemManager::FileSystemBatchNotification(const FileSystemChangeSet& changes)
+{
+  List addedSystems;
+  List removedSystems;
+  List modifiedSystems;
+  bool changed = false;
+  for(SystemData* system : mAllSystems)
+    if (!system->IsVirtual())
+      for(RootFolderData* root : system->MasterRoot().SubRoots())
+        if (root->Normal() && root->RomPath() == changes.mRoot)
+        {
+          bool hasVisibleBefore = system->HasVisibleGame();
+          if (!ApplyRomFolderChanges(*system, *root, changes)) continue;
+          changed = true;
+          ClassifySystemChange(system, hasVisibleBefore, addedSystems, removedSystems, modifiedSystems);
+        }
+  ResumeGameWorkers();
+  if (!changed) return;
+
+  // Virtual systems gather games from regular systems
+  UpdateSystemsOnMultipleGameChanges(MetadataType::Path, addedSystems, removedSystems, modifiedSystems);
+  ApplySystemChanges(&addedSystems, &removedSystems, &modifiedSystems, false);
+}
+
 // Creates systems from information located in a config file
 bool SystemManager::LoadSystemConfigurations(FileNotifier& gamelistWatcher, bool forceReloadFromDisk, bool portableSystem)
 {
@@ -864,6 +946,24 @@ bool SystemManager::LoadSingleSystemConfigurations(const String& UUID)
   return LoadSystems(list, nullptr, false, true);
 }
 
+void SystemManager::NotifyLoadingPhase(ISystemLoadingPhase::Phase phase)
+{
+  // Profile the previous phase
+  long long now = StartupProfiler::Now();
+  if (mLoadingPhaseStart != 0)
+    switch(mLoadingPhase)
+    {
+      case ISystemLoadingPhase::Phase::RegularSystems: StartupProfiler::Record("phase", "RegularSystems", mLoadingPhaseStart, now - mLoadingPhaseStart); break;
+      case ISystemLoadingPhase::Phase::VirtualSystems: StartupProfiler::Record("phase", "VirtualSystems", mLoadingPhaseStart, now - mLoadingPhaseStart); break;
+      case ISystemLoadingPhase::Phase::Completed:
+      default: break;
+    }
+  mLoadingPhase = phase;
+  mLoadingPhaseStart = phase != ISystemLoadingPhase::Phase::Completed ? now : 0;
+
+  if (mLoadingPhaseInterface != nullptr) mLoadingPhaseInterface->SystemLoadingPhase(phase);
+}
+
 bool SystemManager::LoadSystems(const DescriptorList& systemList, FileNotifier* gamelistWatcher, bool portableSystem, bool novirtuals)
 {
   // Phase #1
@@ -875,7 +975,7 @@ bool SystemManager::LoadSystems(const DescriptorList& systemList, FileNotifier*
   StringMapFile weights(sWeightFilePath);
   weights.Load();
   // Create automatic thread-pool
-  ThreadPool<SystemDescriptor, SystemData*> threadPool(this, "System-Load", false, 20);
+  WorkStealingThreadPool<SystemDescriptor, SystemData*> threadPool(this, "System-Load", false, 20);
   // Push system to process
   mSystemNameToSystemRootPath.clear();
   for (const SystemDescriptor& descriptor : systemList)
@@ -944,6 +1044,7 @@ bool SystemManager::LoadSystems(const DescriptorList& systemList, FileNotifier*
   // Add gamelist watching
   if (gamelistWatcher != nullptr){
     WatchGameList(*gamelistWatcher);
+    WatchRomFolders();
   }
 
   // Finalize arcade loading
@@ -983,16 +1084,18 @@ bool SystemManager::VirtualSystemNeedRefresh(const DescriptorList& systemList, V
           return true;
       return false;
     }
-    case VirtualSystemType::None:
-    default: break;
+    case VirtualSystemType::None: break;
   }
   return false;
 }
 
 void SystemManager::LoadVirtualSystems(const DescriptorList& systemList, bool portableSystem)
 {
+  // Categorize all games once. Virtual systems are then populated concurrently from the index, read only
+  mVirtualSystemIndex.Build(mAllSystems);
+
   // Create automatic thread-pool
-  ThreadPool<VirtualSystemDescriptor, VirtualSystemResult> threadPool(this, "Virtual-Load", false, 20);
+  WorkStealingThreadPool<VirtualSystemDescriptor, VirtualSystemResult> threadPool(this, "Virtual-Load", false, 20);
 
   int priority = -1;
   int arcadeIndex = -100;
@@ -1058,6 +1161,7 @@ void SystemManager::LoadVirtualSystems(const DescriptorList& systemList, bool po
 
 VirtualSystemResult SystemManager::ThreadPoolRunJob(VirtualSystemDescriptor& virtualDescriptor)
 {
+  long long start = StartupProfiler::Now();
   SystemData* system = nullptr;
 
   switch(virtualDescriptor.Type())
@@ -1072,14 +1176,15 @@ VirtualSystemResult SystemManager::ThreadPoolRunJob(VirtualSystemDescriptor& vir
     case VirtualSystemType::Tate: { system = CreateTateSystem(); break; }
     case VirtualSystemType::Genre: { system = CreateGenreSystem(virtualDescriptor.Genre()); break; }
     case VirtualSystemType::ArcadeManufacturers: { system = CreateArcadeManufacturersSystem(virtualDescriptor.ArcadeManufacturer()); break; }
-    case VirtualSystemType::None:
-    default: break;
+    case VirtualSystemType::None: break;
   }
 
   // Initialize
   if (system != nullptr) InitializeSystem(system);
   else { LOG(LogError) << "[SystemManager] Unprocessed virtual descriptor!"; abort(); }
 
+  StartupProfiler::Record("virtual", system->Name(), start, StartupProfiler::Now() - start);
+  StartupProfiler::Count("virtual-systems");
   return { system, virtualDescriptor.Index() };
 }
 
@@ -1110,7 +1215,7 @@ void SystemManager::UpdateAllGameLists()
   if (mProgressInterface != nullptr)
     mProgressInterface->SetMaximum((int)mAllSystems.Count());
   // Create automatic thread-pool
-  ThreadPool<SystemData*, bool> threadPool(this, "System-Save", false, 20);
+  WorkStealingThreadPool<SystemData*, bool> threadPool(this, "System-Save", false, 20);
   // Push system to process
   for(SystemData* system : mVisibleSystems)
     if (!system->IsVirtual())
@@ -1126,10 +1231,14 @@ void SystemManager::UpdateAllGameLists()
 void SystemManager::DeleteAllSystems(bool updateGamelists)
 {
   mHasher.MustQuit();
+  mRomsetVerifier.MustQuit();
+  mRomFolderWatcher.UnwatchAll();
+  mRomFolderRescanner.Cancel();
 
   if (updateGamelists && !mAllSystems.Empty())
     UpdateAllGameLists();
 
+  mVirtualSystemIndex.Clear();
   for(SystemData* system : mAllSystems)
     delete system;
 
@@ -1521,6 +1630,7 @@ void SystemManager::UpdateSystemsOnGameChange(FileData* target, MetadataType cha
 bool SystemManager::UpdateSystemsOnGameDeletion(FileData* target, List& removedSystems, List& modifiedSystems)
 {
   bool result = false;
+  mVirtualSystemIndex.Remove(target);
 
   for(SystemData* system : mAllSystems)
     // Only virtual system have to be modified
@@ -1542,10 +1652,13 @@ bool SystemManager::UpdateSystemsOnMultipleGameChanges(MetadataType changes, Sys
                                                        SystemManager::List& modifiedSystems)
 {
   bool result = false;
+  bool indexed = false;
   for(SystemData* system : mAllSystems)
-    // Is this virtual system sensible to changed metadata?
-    if (system->IsVirtual() && (changes & system->MetadataSensitivity()) != 0)
+    // Is this virtual system sensible to changed metadata? (Path changes mean games have been added or removed)
+    if (system->IsVirtual() && (changes & (system->MetadataSensitivity() | MetadataType::Path)) != 0)
     {
+      // Categorize all games again, once, before the first re-population
+      if (!indexed) { mVirtualSystemIndex.Build(mAllSystems); indexed = true; }
       bool hasVisibleBefore = system->HasVisibleGame();
       // Empty system
       system->MasterRoot().DeleteVirtualSubTree();
@@ -1577,13 +1690,15 @@ bool SystemManager::UpdateSystemsOnSingleGameChanges(FileData* target, MetadataT
                                                      SystemManager::List& modifiedSystems)
 {
   bool result = false;
+  // Move the game between index lists
+  VirtualSystemIndex::Categories categories = mVirtualSystemIndex.Update(*target);
   for(SystemData* system : mAllSystems)
     // Is this virtual system sensible to changed metadata?
     if (system->IsVirtual() && (changes & system->MetadataSensitivity()) != 0)
     {
       // Game already in this system?
       bool isAlreadyIn = system->MasterRoot().LookupGame(target);
-      bool shouldBeIn = ShouldGameBelongToThisVirtualSystem(target, system);
+      bool shouldBeIn = ShouldGameBelongToThisVirtualSystem(categories, system);
       // Process only changed states & ignore equal states
       if (isAlreadyIn && !shouldBeIn) // Must remove
       {
@@ -1626,23 +1741,40 @@ int SystemManager::GetVisibleRegularSystemCount() const
   return count;
 }
 
-bool SystemManager::ShouldGameBelongToThisVirtualSystem(const FileData* game, const SystemData* system)
+bool SystemManager::ShouldGameBelongToThisVirtualSystem(const VirtualSystemIndex::Categories& categories, const SystemData* system) const
 {
-  // Favorite?
-  if (system->Name() == sFavoriteSystemShortName) return game->Metadata().Favorite();
-  // Last played?
-  if (system->Name() == sLastPlayedSystemShortName) return game->Metadata().LastPlayedEpoc() != 0;
-  // Multiplayer ?
-  if (system->Name() == sMultiplayerSystemShortName) return game->Metadata().PlayerMin() > 1;
-  // Tate ?
-  if (system->Name() == sTateSystemShortName) return game->Metadata().Rotation() == RotationType::Left || game->Metadata().Rotation() == RotationType::Right;
-  // All game?
-  if (system->Name() == sAllGamesSystemShortName) return true;
+  switch(system->VirtualType())
+  {
+    case VirtualSystemType::Favorites: return categories.Has(VirtualSystemIndex::Flag::Favorite);
+    case VirtualSystemType::LastPlayed: return categories.Has(VirtualSystemIndex::Flag::LastPlayed);
+    case VirtualSystemType::Multiplayers: return categories.Has(VirtualSystemIndex::Flag::Multiplayer);
+    case VirtualSystemType::Tate: return categories.Has(VirtualSystemIndex::Flag::Tate);
+    case VirtualSystemType::Lightgun: return categories.Has(VirtualSystemIndex::Flag::Lightgun);
+    case VirtualSystemType::Genre: return categories.HasGenre(GenreFromSystem(*system));
+    case VirtualSystemType::ArcadeManufacturers:
+      return categories.HasManufacturer(mVirtualSystemIndex.ManufacturerIdentifier(ArcadeManufacturerFromSystem(*system)));
+    case VirtualSystemType::AllGames: return true;
+    case VirtualSystemType::Ports:
+    case VirtualSystemType::Arcade:
+    case VirtualSystemType::None: break;
+  }
 
   // We don't know...
   return false;
 }
 
+void SystemManager::SlowPopulatePrepare(const SystemManager::List& listToPopulate)
+{
+  // Virtual systems are populated from the index. Build it here, in the main thread which owns all game trees,
+  // so that the worker only reads it
+  for (const SystemData* system : listToPopulate)
+    if (system->IsVirtual() && !system->HasGame())
+    {
+      mVirtualSystemIndex.Build(mAllSystems);
+      break;
+    }
+}
+
 void SystemManager::SlowPopulateExecute(const SystemManager::List& listToPopulate)
 {
   // Initialize & populate (if required)
@@ -8,10 +8,16 @@
 #include <views/IProgressInterface.h>
 #include "IRomFolderChangeNotification.h"
 #include "SystemHasher.h"
+#include "VirtualSystemIndex.h"
+#include <systems/arcade/dats/RomsetVerifier.h>
 #include "VirtualSystemDescriptor.h"
 #include "VirtualSystemResult.h"
 #include "ISystemLoadingPhase.h"
 #include "ISystemChangeNotifier.h"
+#include <utils/os/fs/watching/FileSystemBatchWatcher.h>
+#include "RomFolderRescanner.h"
+#include <utils/sync/SyncMessageSender.h>
+#include <atomic>
 
 class SystemManager : private INoCopy // No copy allowed
                     , public IThreadPoolWorkerInterface<SystemDescriptor, SystemData*> // Multi-threaded system loading
@@ -19,6 +25,9 @@ class SystemManager : private INoCopy // No copy allowed
                     , public IThreadPoolWorkerInterface<VirtualSystemDescriptor, VirtualSystemResult> // Multi-threaded system unloading
                     , public IMountMonitorNotifications
                     , public ISlowSystemOperation
+                    , private IFileSystemBatchNotification
+                    , private IRomFolderRescanNotification
+                    , private ISyncMessageReceiver<void> // Romset verification start requests
 {
   public:
     //! Requested Visibility
@@ -115,6 +124,12 @@ class SystemManager : private INoCopy // No copy allowed
     //! Hasher
     SystemHasher mHasher;
 
+    //! Game categories virtual systems are populated from
+    VirtualSystemIndex mVirtualSystemIndex;
+
+    //! Arcade romset verification
+    RomsetVerifier mRomsetVerifier;
+
     //! Visible system, including virtual system (Arcade)
     List mVisibleSystems;
     //! ALL systems, visible and hidden
@@ -134,6 +149,10 @@ class SystemManager : private INoCopy // No copy allowed
     IProgressInterface* mProgressInterface;
     //! System loading phase interface
     ISystemLoadingPhase* mLoadingPhaseInterface;
+    //! Current loading phase
+    ISystemLoadingPhase::Phase mLoadingPhase;
+    //! Current loading phase start time (µs), 0 when no phase is running
+    long long mLoadingPhaseStart;
     //! Rom path change notifications interface
     IRomFolderChangeNotification& mRomFolderChangeNotificationInterface;
     //! Interface for system changes
@@ -144,6 +163,21 @@ class SystemManager : private INoCopy // No copy allowed
     //! The system manager is instructed to reload game list from disk, not only from gamelist.xml
     bool mForceReload;
 
+    //! Rom folder watcher
+    FileSystemBatchWatcher mRomFolderWatcher;
+    //! Background scans of rom folders where new items have been created
+    RomFolderRescanner mRomFolderRescanner;
+    //! Systems to hash again once game workers are resumed
+    std::vector<SystemData*> mSuspendedHashes;
+    //! Romset verification to restart once game workers are resumed
+    bool mSuspendedVerification;
+    //! Game workers suspended while trees are modified
+    bool mGameWorkersSuspended;
+    //! Romset verification start requests, from any thread to the main thread
+    SyncMessageSender<void> mVerificationStarter;
+    //! A romset verification start request is pending
+    std::atomic<bool> mVerificationRequested;
+
     /*!
      * @brief Check if there are at least one file from the given path whose extension is in the given set
      * @param path Path (folder) to check files in
@@ -338,19 +372,23 @@ class SystemManager : private INoCopy // No copy allowed
     /*!
      * @brief Generic method to pupulate a virtual system using contents from a list of games
      * @param target system to populate
-     * @param games Game list to populate the target system with
-     * @param doppelganger Pre-build doppelganger
+     * @param games Game list to populate the target system with. The doppelganger is built from these games only
+     */
+    static void PopulateVirtualSystemWithGames(SystemData* system, const FileData::List& games);
+
+    /*!
+     * @brief Get the genre of the given genre virtual system
+     * @param system Genre system
+     * @return Genre or GameGenres::None
      */
-    static void PopulateVirtualSystemWithGames(SystemData* system, const FileData::List& games, FileData::StringMap& doppelganger);
+    static GameGenres GenreFromSystem(const SystemData& system);
 
     /*!
-     * @brief Populate meta system with a filtered game list (from all regular systems)
-     * @param system System to fill with filter results
-     * @param filter Filter interface
-     * @param comparer Optional comparer - if not null, filter results are sorted using this filter
-     * @param arcadeOnly if True, only true arcade systems are filtered
+     * @brief Get the raw manufacturer name of the given arcade manufacturer virtual system
+     * @param system Arcade manufacturer system
+     * @return Raw manufacturer name, as stored in arcade databases
      */
-    void PopulateMetaSystemWithFilter(SystemData* system, IFilter* filter, FileData::Comparer comparer);
+    static String ArcadeManufacturerFromSystem(const SystemData& system);
 
     /*!
      * @brief Ensure the given system is in the visible list (== initialized with games)
@@ -460,12 +498,12 @@ class SystemManager : private INoCopy // No copy allowed
     bool UpdateSystemsOnSingleGameChanges(FileData* target, MetadataType changes, List& addedSystems, List& removedSystems, List& modifiedSystems);
 
     /*!
-     * @brief Check if the given game should belong to the given virtual system, regarding its metadata
-     * @param game Game to check
+     * @brief Check if a game should belong to the given virtual system, regarding its categories
+     * @param categories Categories of the game to check
      * @param system Target virtual system
      * @return True of the game has metadata that make it belonging to the target virtual system. False otherwise
      */
-    static bool ShouldGameBelongToThisVirtualSystem(const FileData* game, const SystemData* system);
+    [[nodiscard]] bool ShouldGameBelongToThisVirtualSystem(const VirtualSystemIndex::Categories& categories, const SystemData* system) const;
 
     /*!
      * @brief Notify system changes via the ISystemChangeNotifier interface
@@ -502,12 +540,101 @@ class SystemManager : private INoCopy // No copy allowed
      * ISlowSystemOperation implementation
      */
 
+    //! Prepare populate operation
+    void SlowPopulatePrepare(const List& listToPopulate) override;
+
     //! Populate operation
     void SlowPopulateExecute(const List& listToPopulate) override;
 
     //! Completed
     void SlowPopulateCompleted(const List& listToPopulate, bool autoSelectMonoSystem) override;
 
+    /*!
+     * @brief Watch all regular rom folders, if enabled in configuration
+     */
+    void WatchRomFolders();
+
+    /*!
+     * @brief Stop background workers holding game pointers (hasher, romset verifier)
+     * so that game trees can be modified safely. Does nothing if already suspended
+     */
+    void SuspendGameWorkers();
+
+    /*!
+     * @brief Restart background workers stopped by SuspendGameWorkers()
+     */
+    void ResumeGameWorkers();
+
+    /*!
+     * @brief Get the extension list in effect in the given folder, taking .system.cfg overrides into account
+     * @param system Regular system
+     * @param root Root folder path
+     * @param folder Folder path, in the root folder
+     * @return Extension list
+     */
+    static String ExtensionsInFolder(const SystemData& system, const Path& root, const Path& folder);
+
+    /*!
+     * @brief Check if a created item may add games or folders to the tree
+     * Hidden items, media folders, gamelists, ignored files & files whose extension is not handled are rejected
+     * @param system Regular system
+     * @param root Root folder path
+     * @param path Created item
+     * @return True if the item must be scanned
+     */
+    static bool IsRescanCandidate(const SystemData& system, const Path& root, const Path& path);
+
+    /*!
+     * @brief Sort a modified system in the added/removed/modified lists, from its visibility change
+     * @param system Modified system
+     * @param hasVisibleBefore True if the system had visible games before the modification
+     * @param addedSystems Systems that became visible
+     * @param removedSystems Systems that became invisible
+     * @param modifiedSystems Systems still visible
+     */
+    void ClassifySystemChange(SystemData* system, bool hasVisibleBefore, List& addedSystems, List& removedSystems, List& modifiedSystems);
+
+    /*!
+     * @brief Apply the changes of a rom folder to the tree of the given root
+     * Removed items are deleted, and folders where new candidate items have been created are queued for a background scan
+     * @param system Regular system owning the root
+     * @param root Root folder
+     * @param changes Coalesced changes
+     * @return True if the tree has been modified
+     */
+    bool ApplyRomFolderChanges(SystemData& system, RootFolderData& root, const FileSystemChangeSet& changes);
+
+    /*
+     * IFileSystemBatchNotification implementation
+     */
+
+    /*!
+     * @brief Rom folder changes: update trees incrementally instead of reloading systems
+     * @param changes Coalesced changes of a rom folder
+     */
+    void FileSystemBatchNotification(const FileSystemChangeSet& changes) override;
+
+    /*
+     * IRomFolderRescanNotification implementation
+     */
+
+    /*!
+     * @brief Merge new games & folders of a rescanned rom folder
+     * @param system Regular system owning the root
+     * @param root Root folder
+     * @param folder Scanned folder
+     */
+    void RomFolderRescanned(SystemData& system, RootFolderData& root, const ScannedFolder& folder) override;
+
+    /*
+     * ISyncMessageReceiver<void> implementation
+     */
+
+    /*!
+     * @brief Start a requested romset verification, in the main thread
+     */
+    void ReceiveSyncMessage() override;
+
   public:
     /*!
      * @brief constructor
@@ -517,10 +644,18 @@ class SystemManager : private INoCopy // No copy allowed
       , mFastSearchCacheHash(0)
       , mProgressInterface(nullptr)
       , mLoadingPhaseInterface(nullptr)
+      , mLoadingPhase(ISystemLoadingPhase::Phase::Completed)
+      , mLoadingPhaseStart(0)
       , mRomFolderChangeNotificationInterface(interface)
       , mSystemChangeNotifier(nullptr)
       , mWatcherIgnoredFiles(watcherIgnoredFiles)
       , mForceReload(false)
+      , mRomFolderWatcher(*this)
+      , mRomFolderRescanner(*this)
+      , mSuspendedVerification(false)
+      , mGameWorkersSuspended(false)
+      , mVerificationStarter(*this)
+      , mVerificationRequested(false)
     {
       MetadataDescriptor::InitializeDefaultMetadata();
     }
@@ -550,10 +685,10 @@ class SystemManager : private INoCopy // No copy allowed
     void SetChangeNotifierInterface(ISystemChangeNotifier* interface) { mSystemChangeNotifier = interface; }
 
     /*!
-     * @brief Notify loading phase to the interface, if ona has been set
+     * @brief Notify loading phase to the interface, if ona has been set, and profile the previous phase
      * @param phase Loading phase
      */
-    void NotifyLoadingPhase(ISystemLoadingPhase::Phase phase) const { if (mLoadingPhaseInterface !=  nullptr) mLoadingPhaseInterface->SystemLoadingPhase(phase); }
+    void NotifyLoadingPhase(ISystemLoadingPhase::Phase phase);
 
     /*!
      * @brief Get favorite system
@@ -670,6 +805,26 @@ class SystemManager : private INoCopy // No copy allowed
      */
     [[nodiscard]] int GetVisibleRegularSystemCount() const;
 
+    /*!
+     * @brief Request a background verification of all arcade romsets
+     * May be called from any thread: the verification is started from the main thread,
+     * so that systems cannot be reloaded meanwhile
+     * @return False if a verification is already running or requested
+     */
+    bool StartRomsetVerification();
+
+    /*!
+     * @brief Get the last (or current) arcade romset verification report
+     * @return JSON report
+     */
+    [[nodiscard]] String RomsetVerificationReport() { return mRomsetVerifier.Report(); }
+
+    /*!
+     * @brief Get rom hashing progress & throughput
+     * @return JSON report
+     */
+    [[nodiscard]] String HashingReport() const { return mHasher.Report(); }
+
     /*!
      * @brief Get all system, including EMPTY systems
      * @return all system list
@@ -0,0 +1,177 @@
+#include "VirtualSystemIndex.h"
+#include <systems/SystemData.h>
+#include <systems/LightGunDatabase.h>
+#include <systems/arcade/ArcadeDatabase.h>
+#include <games/IParser.h>
+#include <games/IFilter.h>
+#include <utils/datetime/DateTime.h>
+#include <utils/Log.h>
+#include <algorithm>
+
+bool VirtualSystemIndex::Categories::operator==(const Categories& other) const
+{
+  if (Flags != other.Flags || Genre != other.Genre || ManufacturerCount != other.ManufacturerCount) return false;
+  for(int i = ManufacturerCount; --i >= 0; )
+    if (Manufacturers[i] != other.Manufacturers[i]) return false;
+  return true;
+}
+
+VirtualSystemIndex::VirtualSystemIndex()
+  : mLightgunDatabase(nullptr)
+{
+}
+
+VirtualSystemIndex::~VirtualSystemIndex()
+{
+  delete mLightgunDatabase;
+}
+
+void VirtualSystemIndex::Build(const Array<SystemData*>& systems)
+{
+  class Parser : public IParser
+  {
+    private:
+      VirtualSystemIndex& mIndex;
+    public:
+      explicit Parser(VirtualSystemIndex& index) : mIndex(index) {}
+      void Parse(FileData& file) override
+      {
+        if (!file.IsGame()) return;
+        Categories categories = mIndex.Classify(file);
+        mIndex.mCategories[&file] = categories;
+        mIndex.AddToLists(file, categories);
+      }
+  } parser(*this);
+
+  DateTime start;
+  Clear();
+  for(SystemData* system : systems)
+    if (!system->IsVirtual())
+      for(RootFolderData* root : system->MasterRoot().SubRoots())
+        if (!root->Virtual())
+          root->ParseAllItems(parser);
+  { LOG(LogInfo) << "[VirtualSystemIndex] " << mCategories.size() << " games indexed in " << (DateTime() - start).TotalMilliseconds() << "ms"; }
+}
+
+void VirtualSystemIndex::Clear()
+{
+  mCategories.clear();
+  for(FileData::List& list : mFlagLists) list.clear();
+  mGenreLists.clear();
+  mManufacturerLists.clear();
+}
+
+VirtualSystemIndex::Categories VirtualSystemIndex::Update(const FileData& game)
+{
+  Categories categories = Classify(game);
+  if (Categories* previous = mCategories.try_get(&game); previous != nullptr)
+  {
+    if (*previous == categories) return categories;
+    RemoveFromLists(&game, *previous);
+  }
+  mCategories[&game] = categories;
+  AddToLists(game, categories);
+  return categories;
+}
+
+void VirtualSystemIndex::Remove(const FileData* game)
+{
+  if (Categories* previous = mCategories.try_get(game); previous != nullptr)
+  {
+    RemoveFromLists(game, *previous);
+    mCategories.erase(game);
+  }
+}
+
+VirtualSystemIndex::Categories VirtualSystemIndex::Lookup(const FileData* game) const
+{
+  if (Categories* categories = mCategories.try_get(game); categories != nullptr) return *categories;
+  return {};
+}
+
+FileData::List VirtualSystemIndex::GamesOfGenre(GameGenres genre) const
+{
+  if (Genres::IsSubGenre(genre))
+  {
+    if (FileData::List* list = mGenreLists.try_get((int)genre); list != nullptr) return *list;
+    return {};
+  }
+  // Top genre: all sub-genres of the same family
+  FileData::List result;
+  for(const auto& list : mGenreLists)
+    if (Genres::TopGenreMatching((GameGenres)list.first, genre))
+      result.insert(result.end(), list.second.begin(), list.second.end());
+  return result;
+}
+
+const FileData::List* VirtualSystemIndex::GamesOfManufacturer(const String& manufacturer) const
+{
+  int identifier = ManufacturerIdentifier(manufacturer);
+  return identifier >= 0 ? mManufacturerLists.try_get(identifier) : nullptr;
+}
+
+int VirtualSystemIndex::ManufacturerIdentifier(const String& manufacturer) const
+{
+  if (int* identifier = mManufacturerIdentifiers.try_get(manufacturer); identifier != nullptr) return *identifier;
+  return -1;
+}
+
+int VirtualSystemIndex::ManufacturerIdentifierOrCreate(const String& manufacturer)
+{
+  if (int* identifier = mManufacturerIdentifiers.try_get(manufacturer); identifier != nullptr) return *identifier;
+  int identifier = (int)mManufacturerIdentifiers.size();
+  mManufacturerIdentifiers[manufacturer] = identifier;
+  return identifier;
+}
+
+VirtualSystemIndex::Categories VirtualSystemIndex::Classify(const FileData& game)
+{
+  Categories categories;
+  const MetadataDescriptor& metadata = game.Metadata();
+  if (metadata.Favorite()) categories.Flags |= 1 << (int)Flag::Favorite;
+  if (metadata.LastPlayedEpoc() != 0) categories.Flags |= 1 << (int)Flag::LastPlayed;
+  if (metadata.PlayerMin() > 1 || metadata.PlayerMax() > 1) categories.Flags |= 1 << (int)Flag::Multiplayer;
+  if (metadata.Rotation() == RotationType::Left || metadata.Rotation() == RotationType::Right) categories.Flags |= 1 << (int)Flag::Tate;
+  if (mLightgunDatabase == nullptr) mLightgunDatabase = new LightGunDatabase();
+  if (((IFilter*)mLightgunDatabase)->ApplyFilter(game)) categories.Flags |= 1 << (int)Flag::Lightgun;
+  categories.Genre = metadata.GenreId();
+
+  // Arcade manufacturers, from the database of the emulator configured for the game's folder
+  const SystemData& system = game.System();
+  if (system.Descriptor().IsTrueArcade() && game.Parent() != nullptr)
+    if (const ArcadeDatabase* database = system.ArcadeDatabases().LookupDatabase(*game.Parent()); database != nullptr)
+      if (const ArcadeGame* arcade = database->LookupGame(game); arcade != nullptr && arcade->Hierarchy() != ArcadeGame::Type::Bios)
+        for(int i = 0; i < arcade->RawManufacturer().Count() && categories.ManufacturerCount < Categories::sMaxManufacturers; ++i)
+          categories.Manufacturers[categories.ManufacturerCount++] =
+            ManufacturerIdentifierOrCreate(database->RawManufacturerNameFromIndex(arcade->RawManufacturer().Manufacturer(i)));
+
+  return categories;
+}
+
+void VirtualSystemIndex::AddToLists(const FileData& game, const Categories& categories)
+{
+  FileData* file = (FileData*)&game;
+  for(int i = (int)Flag::_Count; --i >= 0; )
+    if (categories.Has((Flag)i)) mFlagLists[i].push_back(file);
+  if (categories.Genre != GameGenres::None) mGenreLists[(int)categories.Genre].push_back(file);
+  for(int i = 0; i < categories.ManufacturerCount; ++i)
+    mManufacturerLists[categories.Manufacturers[i]].push_back(file);
+}
+
+void VirtualSystemIndex::RemoveFromLists(const FileData* game, const Categories& categories)
+{
+  for(int i = (int)Flag::_Count; --i >= 0; )
+    if (categories.Has((Flag)i)) RemoveFromList(mFlagLists[i], game);
+  if (categories.Genre != GameGenres::None)
+    if (FileData::List* list = mGenreLists.try_get((int)categories.Genre); list != nullptr)
+      RemoveFromList(*list, game);
+  for(int i = 0; i < categories.ManufacturerCount; ++i)
+    if (FileData::List* list = mManufacturerLists.try_get(categories.Manufacturers[i]); list != nullptr)
+      RemoveFromList(*list, game);
+}
+
+void VirtualSystemIndex::RemoveFromList(FileData::List& list, const FileData* game)
+{
+  auto it = std::find(list.begin(), list.end(), game);
+  if (it != list.end()) list.erase(it);
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <games/FileData.h>
+#include <games/classifications/Genres.h>
+#include <utils/storage/HashMap.h>
+#include <utils/storage/Array.h>
+
+class SystemData;
+class LightGunDatabase;
+
+/*!
+ * @brief Categorization index of all games in regular systems
+ *
+ * Built in a single pass over all games, it maps each category virtual systems are made of
+ * (last played, multiplayer, tate, lightgun, genres & arcade manufacturers) to its game list.
+ * Virtual systems are materialized from these lists instead of scanning all systems each,
+ * and the index is updated game by game when metadata change.
+ * Lists are read concurrently while virtual systems are loaded: the index must not be modified meanwhile.
+ */
+class VirtualSystemIndex
+{
+  public:
+    //! Flag categories
+    enum class Flag : char
+    {
+      Favorite,    //!< Favorite game
+      LastPlayed,  //!< Game played at least once
+      Multiplayer, //!< More than one player
+      Tate,        //!< Vertical game
+      Lightgun,    //!< Lightgun game
+      _Count,
+    };
+
+    //! Categories of a single game
+    struct Categories
+    {
+      //! Maximum manufacturers per game
+      static constexpr int sMaxManufacturers = 4;
+
+      int Flags = 0;                            //!< Flag bits
+      GameGenres Genre = GameGenres::None;      //!< Genre
+      int Manufacturers[sMaxManufacturers] {};  //!< Manufacturer identifiers, see ManufacturerName
+      int ManufacturerCount = 0;                //!< Manufacturer count
+
+      //! Check flag
+      [[nodiscard]] bool Has(Flag flag) const { return (Flags & (1 << (int)flag)) != 0; }
+      //! Check genre: exact match for sub-genres, family match for top genres
+      [[nodiscard]] bool HasGenre(GameGenres genre) const
+      {
+        return Genre != GameGenres::None && (Genres::IsSubGenre(genre) ? Genre == genre : Genres::TopGenreMatching(Genre, genre));
+      }
+      //! Check manufacturer identifier
+      [[nodiscard]] bool HasManufacturer(int manufacturer) const
+      {
+        for(int i = ManufacturerCount; --i >= 0; )
+          if (Manufacturers[i] == manufacturer) return true;
+        return false;
+      }
+      //! Equality
+      bool operator == (const Categories& other) const;
+    };
+
+    //! Constructor
+    VirtualSystemIndex();
+
+    //! Destructor
+    ~VirtualSystemIndex();
+
+    /*!
+     * @brief Rebuild the whole index from all regular systems, in a single pass
+     * @param systems All systems. Virtual ones are ignored
+     */
+    void Build(const Array<SystemData*>& systems);
+
+    //! Empty the index
+    void Clear();
+
+    /*!
+     * @brief Classify the given game again and move it between lists if required
+     * @param game Updated game
+     * @return New categories
+     */
+    Categories Update(const FileData& game);
+
+    /*!
+     * @brief Remove the given game from all lists. The game is not dereferenced
+     * @param game Game to remove
+     */
+    void Remove(const FileData* game);
+
+    /*!
+     * @brief Get the categories of the given game
+     * @param game Game
+     * @return Categories, empty if the game is unknown
+     */
+    [[nodiscard]] Categories Lookup(const FileData* game) const;
+
+    //! Games of the given flag category
+    [[nodiscard]] const FileData::List& Games(Flag flag) const { return mFlagLists[(int)flag]; }
+
+    /*!
+     * @brief Get games of the given genre
+     * @param genre Sub-genre (exact match) or top genre (all its sub-genres)
+     * @return Game list
+     */
+    [[nodiscard]] FileData::List GamesOfGenre(GameGenres genre) const;
+
+    /*!
+     * @brief Get games of the given raw arcade manufacturer
+     * @param manufacturer Raw manufacturer name, as stored in arcade databases
+     * @return Game list or nullptr if there is no such game
+     */
+    [[nodiscard]] const FileData::List* GamesOfManufacturer(const String& manufacturer) const;
+
+    /*!
+     * @brief Get the identifier of the given raw manufacturer name
+     * @param manufacturer Raw manufacturer name
+     * @return Identifier or -1 if no game has been made by this manufacturer
+     */
+    [[nodiscard]] int ManufacturerIdentifier(const String& manufacturer) const;
+
+  private:
+    //! Per game categories
+    HashMap<const FileData*, Categories> mCategories;
+    //! Flag category lists
+    FileData::List mFlagLists[(int)Flag::_Count];
+    //! Genre lists
+    HashMap<int, FileData::List> mGenreLists;
+    //! Manufacturer lists, by identifier
+    HashMap<int, FileData::List> mManufacturerLists;
+    //! Manufacturer identifiers
+    HashMap<String, int> mManufacturerIdentifiers;
+    //! Lightgun database, loaded on first use
+    LightGunDatabase* mLightgunDatabase;
+
+    /*!
+     * @brief Compute the categories of the given game
+     * @param game Game
+     * @return Categories
+     */
+    Categories Classify(const FileData& game);
+
+    /*!
+     * @brief Add the game to the lists of the given categories
+     * @param game Game
+     * @param categories Categories
+     */
+    void AddToLists(const FileData& game, const Categories& categories);
+
+    /*!
+     * @brief Remove the game from the lists of the given categories
+     * @param game Game
+     * @param categories Categories
+     */
+    void RemoveFromLists(const FileData* game, const Categories& categories);
+
+    //! Get or create a manufacturer identifier
+    int ManufacturerIdentifierOrCreate(const String& manufacturer);
+
+    //! Remove a game from a list
+    static void RemoveFromList(FileData::List& list, const FileData* game);
+};
@@ -5,7 +5,9 @@
 #include "ArcadeDatabaseManager.h"
 #include "emulators/EmulatorManager.h"
 #include "ArcadeVirtualSystems.h"
-#include <utils/Files.h>
+#include "ArcadeFlatIndex.h"
+#include <utils/profiling/StartupProfiler.h>
+#include <algorithm>
 #include <systems/SystemManager.h>
 
 ArcadeDatabaseManager::ArcadeDatabaseManager(SystemData& parentSystem)
@@ -27,6 +29,7 @@ void ArcadeDatabaseManager::LoadDatabases()
   // Valid arcade system?
   if (!mSystem.Descriptor().IsTrueArcade()) return;
   if (!mSystem.HasGame()) return;
+  StartupProfiler::Scope scope("arcade", mSystem.Name());
 
   // Load all possible database
   for(int e = mSystem.Descriptor().EmulatorTree().Count(); --e >= 0;)
@@ -53,10 +56,9 @@ ArcadeDatabase* ArcadeDatabaseManager::LoadFlatDatabase([[maybe_unused]] const S
   for(const String& ignored : ignoredManufacturerString.Split(','))
     ignoredManufacturers.insert_unique(ignored);
 
-  // Load all lines
-  String::List lines = Files::LoadAllFileLines(database);
-  if (!lines.empty()) lines.erase(lines.begin()); // Remove header
-  if (lines.empty())
+  // Map database index
+  ArcadeFlatIndex index(database);
+  if (!index.Open() || index.Count() == 0)
   {
     LOG(LogError) << "[Arcade] Invalid database: " << database.ToString();
     return new ArcadeDatabase();
@@ -85,11 +87,18 @@ ArcadeDatabase* ArcadeDatabaseManager::LoadFlatDatabase([[maybe_unused]] const S
   rawManufacturers.insert_unique("", { "", 0, 0 }); // all "others"
   int nextIndex = 1;
 
+  // Lookup lines of available games only
+  std::vector<int> records;
+  for(const auto& kv : map)
+    for(int record = index.Lookup(kv.first); record >= 0; record = index.Next(record))
+      records.push_back(record);
+  // Keep the reverse file order of whole-file deserialization
+  std::sort(records.begin(), records.end(), std::greater<int>());
+
   // Build game array
-  Array<ArcadeGame> games((int)lines.size(), 1, false); // Allocate all
-  for(int i = (int)lines.size(); --i >= 0; )
-    if (const String& line = lines[i]; !line.empty())
-      DeserializeTo(games, line, map, rawManufacturers, ignoredManufacturers, nextIndex);
+  Array<ArcadeGame> games(std::max(1, (int)records.size()), 1, false); // Allocate all
+  for(int record : records)
+    DeserializeTo(games, index.Line(record), map, rawManufacturers, ignoredManufacturers, nextIndex);
 
   // Build final manufacturers
   ArcadeDatabase::ManufacturerLists finalDrivers = BuildAndRemapManufacturers(rawManufacturers, games, nextIndex);
@@ -0,0 +1,218 @@
+#include "ArcadeFlatIndex.h"
+#include <RootFolders.h>
+#include <utils/Files.h>
+#include <utils/Log.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+ArcadeFlatIndex::ArcadeFlatIndex(const Path& flatFile)
+  : ArcadeFlatIndex(flatFile, RootFolders::DataRootFolder / sIndexFolder)
+{
+}
+
+ArcadeFlatIndex::ArcadeFlatIndex(const Path& flatFile, const Path& indexFolder)
+  : mFlatFile(flatFile)
+  , mIndexFolder(indexFolder)
+  , mMemory(nullptr)
+  , mSize(0)
+  , mHeader(nullptr)
+  , mRecords(nullptr)
+  , mTable(nullptr)
+  , mPool(nullptr)
+{
+}
+
+Path ArcadeFlatIndex::IndexPath() const
+{
+  return mIndexFolder / mFlatFile.Filename().Append(".idx");
+}
+
+bool ArcadeFlatIndex::Open()
+{
+  Close();
+
+  // Flat file stamp
+  struct stat64 source {};
+  if (stat64(mFlatFile.ToChars(), &source) != 0) return false;
+  long long sourceSize = source.st_size;
+  long long sourceTime = (long long)source.st_mtim.tv_sec * 1000000000LL + source.st_mtim.tv_nsec;
+
+  // Try to map an existing image
+  Path path = IndexPath();
+  if (int fd = open(path.ToChars(), O_RDONLY | O_CLOEXEC); fd >= 0)
+  {
+    struct stat info {};
+    if (fstat(fd, &info) == 0 && info.st_size >= (off_t)sizeof(Header))
+    {
+      mSize = (long long)info.st_size;
+      mMemory = mmap(nullptr, (size_t)mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mMemory == MAP_FAILED) mMemory = nullptr;
+    }
+    close(fd);
+    if (mMemory != nullptr)
+    {
+      if (Attach(mMemory, mSize, sourceSize, sourceTime)) return true;
+      Close();
+    }
+  }
+
+  // Build a new image
+  String image = Build(sourceSize, sourceTime);
+  if (image.empty()) return false;
+
+  // Save in a per-thread temporary file first, then atomically replace the previous image
+  Path temporary = path.ChangeExtension(String(".").Append((int)getpid()).Append('-').Append((int)syscall(SYS_gettid)).Append(".tmp"));
+  (void)path.Directory().CreatePath();
+  if (!Files::SaveFile(temporary, image) || !Path::Rename(temporary, path))
+  {
+    { LOG(LogWarning) << "[ArcadeFlatIndex] Cannot save index of " << mFlatFile.ToString(); }
+    (void)temporary.Delete();
+  }
+  else { LOG(LogDebug) << "[ArcadeFlatIndex] Index of " << mFlatFile.ToString() << " saved: " << image.Count() << " bytes."; }
+
+  // Use it from memory
+  mImage = std::move(image);
+  return Attach(mImage.data(), (long long)mImage.size(), sourceSize, sourceTime);
+}
+
+String ArcadeFlatIndex::Build(long long size, long long time) const
+{
+  String content = Files::LoadFile(mFlatFile).Remove('\r');
+  if (content.empty()) return String();
+  while((content.size() & 3) != 0) content.Append('\0');
+
+  // Extract lines, header excluded
+  std::vector<Record> records;
+  const char* p = content.data();
+  int length = (int)content.size();
+  bool header = true;
+  for(int start = 0; start < length; )
+  {
+    const char* eol = (const char*)memchr(p + start, '\n', length - start);
+    int end = eol != nullptr ? (int)(eol - p) : length;
+    int lineLength = end - start;
+    while(lineLength > 0 && p[start + lineLength - 1] == 0) --lineLength; // Padding
+    if (!header && lineLength > 0)
+    {
+      const char* zipEnd = (const char*)memchr(p + start, '|', lineLength);
+      records.push_back({ start, lineLength, zipEnd != nullptr ? (int)(zipEnd - (p + start)) : lineLength, -1 });
+    }
+    header = false;
+    start = end + 1;
+  }
+
+  // Hash table, at most half full
+  int tableSize = 16;
+  while(tableSize < (int)records.size() * 2) tableSize <<= 1;
+  std::vector<int> table(tableSize, 0);
+  std::vector<int> last(records.size(), -1); // Last record of each chain, on chain heads
+  for(int i = 0; i < (int)records.size(); ++i)
+  {
+    Record& record = records[i];
+    for(unsigned int slot = Hash(p + record.Offset, record.ZipLength);; ++slot)
+    {
+      int& entry = table[slot & (tableSize - 1)];
+      if (entry == 0) { entry = i + 1; last[i] = i; break; }
+      const Record& head = records[entry - 1];
+      if (head.ZipLength == record.ZipLength && memcmp(p + head.Offset, p + record.Offset, record.ZipLength) == 0)
+      {
+        // Same zip, chain in file order
+        records[last[entry - 1]].Next = i;
+        last[entry - 1] = i;
+        break;
+      }
+    }
+  }
+
+  // Build image
+  Header fileHeader {};
+  memcpy(fileHeader.Magic, sMagic, sizeof(fileHeader.Magic));
+  fileHeader.Version = sVersion;
+  fileHeader.SourceSize = size;
+  fileHeader.SourceTime = time;
+  fileHeader.RecordCount = (int)records.size();
+  fileHeader.TableSize = tableSize;
+  fileHeader.PoolSize = (int)content.size();
+
+  String image;
+  image.Append((const char*)&fileHeader, (int)sizeof(fileHeader));
+  image.Append((const char*)records.data(), (int)(records.size() * sizeof(Record)));
+  image.Append((const char*)table.data(), (int)(table.size() * sizeof(int)));
+  image.Append(content);
+  return image;
+}
+
+bool ArcadeFlatIndex::Attach(const void* image, long long size, long long sourceSize, long long sourceTime)
+{
+  const Header* header = (const Header*)image;
+  bool valid = size >= (long long)sizeof(Header) &&
+               memcmp(header->Magic, sMagic, sizeof(header->Magic)) == 0 &&
+               header->Version == sVersion &&
+               header->SourceSize == sourceSize &&
+               header->SourceTime == sourceTime &&
+               header->RecordCount >= 0 &&
+               header->TableSize > 0 && (header->TableSize & (header->TableSize - 1)) == 0 &&
+               header->PoolSize >= 0 &&
+               size == (long long)sizeof(Header) + (long long)header->RecordCount * (long long)sizeof(Record) +
+                       (long long)header->TableSize * (long long)sizeof(int) + header->PoolSize;
+  if (!valid)
+  {
+    { LOG(LogDebug) << "[ArcadeFlatIndex] Index of " << mFlatFile.ToString() << " is missing or outdated."; }
+    return false;
+  }
+
+  // Check records & table
+  const Record* records = (const Record*)(header + 1);
+  const int* table = (const int*)(records + header->RecordCount);
+  for(int i = header->RecordCount; valid && --i >= 0; )
+  {
+    const Record& r = records[i];
+    valid = r.Offset >= 0 && r.Length >= 0 && r.Offset + r.Length <= header->PoolSize &&
+            r.ZipLength >= 0 && r.ZipLength <= r.Length && r.Next >= -1 && r.Next < header->RecordCount;
+  }
+  for(int i = header->TableSize; valid && --i >= 0; )
+    valid = table[i] >= 0 && table[i] <= header->RecordCount;
+  if (!valid)
+  {
+    { LOG(LogError) << "[ArcadeFlatIndex] Index of " << mFlatFile.ToString() << " is corrupted!"; }
+    return false;
+  }
+
+  mHeader = header;
+  mRecords = records;
+  mTable = table;
+  mPool = (const char*)(table + header->TableSize);
+  return true;
+}
+
+void ArcadeFlatIndex::Close()
+{
+  if (mMemory != nullptr)
+    munmap(mMemory, (size_t)mSize);
+  mMemory = nullptr;
+  mSize = 0;
+  mImage.clear();
+  mHeader = nullptr;
+  mRecords = nullptr;
+  mTable = nullptr;
+  mPool = nullptr;
+}
+
+int ArcadeFlatIndex::Lookup(const String& zip) const
+{
+  if (mHeader == nullptr) return -1;
+  int mask = mHeader->TableSize - 1;
+  for(unsigned int slot = Hash(zip.data(), (int)zip.size());; ++slot)
+  {
+    int entry = mTable[slot & mask];
+    if (entry == 0) return -1;
+    const Record& record = mRecords[entry - 1];
+    if (record.ZipLength == (int)zip.size() && memcmp(mPool + record.Offset, zip.data(), zip.size()) == 0)
+      return entry - 1;
+  }
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <utils/os/fs/Path.h>
+#include <utils/String.h>
+
+/*!
+ * @brief Binary, memory-mappable index of an arcade flat database
+ *
+ * The flat database text is stored as-is in a pool, with one record per line and an
+ * open-addressing hash table keyed by the zip name (first field). Lines sharing the same
+ * zip name are chained, in file order.
+ * The image is built once from the flat file and saved in the ES cache, then mapped on
+ * following loads: only lines of games actually present in rom folders are ever read.
+ *
+ * An image is only valid while the flat file is unchanged (size & mtime).
+ * If the image cannot be saved, it is kept in memory for the current load.
+ */
+class ArcadeFlatIndex
+{
+  public:
+    /*!
+     * @brief Constructor
+     * @param flatFile Flat database file
+     */
+    explicit ArcadeFlatIndex(const Path& flatFile);
+
+    /*!
+     * @brief Constructor
+     * @param flatFile Flat database file
+     * @param indexFolder Folder to save the index image in
+     */
+    ArcadeFlatIndex(const Path& flatFile, const Path& indexFolder);
+
+    //! Destructor
+    ~ArcadeFlatIndex() { Close(); }
+
+    /*!
+     * @brief Map the index image, building it first if it is missing or outdated
+     * @return True if the index is ready to use
+     */
+    bool Open();
+
+    //! Record (line) count, header excluded
+    [[nodiscard]] int Count() const { return mHeader != nullptr ? mHeader->RecordCount : 0; }
+
+    /*!
+     * @brief Lookup the first line of the given zip name
+     * @param zip Zip name, w/o extension
+     * @return Record index or -1 if not found
+     */
+    [[nodiscard]] int Lookup(const String& zip) const;
+
+    /*!
+     * @brief Get the next line sharing the same zip name
+     * @param index Record index
+     * @return Next record index or -1
+     */
+    [[nodiscard]] int Next(int index) const { return mRecords[index].Next; }
+
+    /*!
+     * @brief Get a raw text line
+     * @param index Record index
+     * @return Text line
+     */
+    [[nodiscard]] String Line(int index) const { return String(mPool + mRecords[index].Offset, mRecords[index].Length); }
+
+  private:
+    //! Magic
+    static constexpr const char* sMagic = "RAFI";
+    //! Version - Increment each time Header or Record is modified
+    static constexpr int sVersion = 2;
+    //! Index folder
+    static constexpr const char* sIndexFolder = "system/.emulationstation/cache/arcade";
+
+    //! File header
+    struct Header
+    {
+      char      Magic[4];    //!< Magic identifier
+      int       Version;     //!< File version
+      long long SourceSize;  //!< Flat file size
+      long long SourceTime;  //!< Flat file modification time
+      int       RecordCount; //!< Record count
+      int       TableSize;   //!< Hash table size (power of 2)
+      int       PoolSize;    //!< Text pool size (4 byte aligned)
+      int       Padding;     //!< Padding
+    };
+
+    //! Line record
+    struct Record
+    {
+      int Offset;    //!< Line offset in the pool
+      int Length;    //!< Line length
+      int ZipLength; //!< Zip name length
+      int Next;      //!< Next record with the same zip name, or -1
+    };
+
+    //! Flat file
+    Path mFlatFile;
+    //! Index image folder
+    Path mIndexFolder;
+    //! Mapped memory
+    void* mMemory;
+    //! Mapped size
+    long long mSize;
+    //! In-memory image, when the image cannot be saved
+    String mImage;
+    //! Header
+    const Header* mHeader;
+    //! Records
+    const Record* mRecords;
+    //! Hash table: record index + 1, 0 for empty slots
+    const int* mTable;
+    //! Text pool
+    const char* mPool;
+
+    //! Get the index image path
+    [[nodiscard]] Path IndexPath() const;
+
+    /*!
+     * @brief Build the index image from the flat file
+     * @param size Flat file size
+     * @param time Flat file modification time
+     * @return Image, or empty string if the flat file cannot be read
+     */
+    [[nodiscard]] String Build(long long size, long long time) const;
+
+    /*!
+     * @brief Check and set pointers to the given image
+     * @param image Image
+     * @param size Image size
+     * @param sourceSize Expected flat file size
+     * @param sourceTime Expected flat file modification time
+     * @return True if the image is valid
+     */
+    bool Attach(const void* image, long long size, long long sourceSize, long long sourceTime);
+
+    //! Unmap memory
+    void Close();
+
+    /*!
+     * @brief Hash a zip name (FNV-1a)
+     * Zip names are not zero-terminated in the pool, and String::Hash may read one byte past the end
+     * @param zip Zip name
+     * @param length Zip name length
+     * @return Hash
+     */
+    static unsigned int Hash(const char* zip, int length)
+    {
+      unsigned int hash = 2166136261u;
+      for(int i = 0; i < length; ++i) hash = (hash ^ (unsigned char)zip[i]) * 16777619u;
+      return hash;
+    }
+};
@@ -0,0 +1,53 @@
+#include "ChdHeader.h"
+#include <unistd.h>
+#include <fcntl.h>
+#include <cstring>
+
+/*
+  Header layouts (big endian) - Hashes offsets:
+
+  v1 & v2: md5 @44
+  v3:      md5 @44, sha1 @80
+  v4:      sha1 @48
+  v5:      sha1 @84 (@64 is the raw sha1, w/o metadata)
+*/
+
+bool ChdHeader::Read(const Path& path)
+{
+  *this = ChdHeader();
+
+  unsigned char header[sMaxHeaderSize];
+  int file = open(path.ToChars(), O_RDONLY);
+  if (file < 0) return false;
+  int size = (int)read(file, header, sizeof(header));
+  close(file);
+
+  if (size < 16 || memcmp(header, sMagic, 8) != 0) return false;
+  int length = (int)BigEndian32(&header[8]);
+  int version = (int)BigEndian32(&header[12]);
+  if (length > size) return false;
+
+  int md5Offset = -1;
+  int sha1Offset = -1;
+  switch(version)
+  {
+    case 1:
+    case 2: md5Offset = 44; break;
+    case 3: md5Offset = 44; sha1Offset = 80; break;
+    case 4: sha1Offset = 48; break;
+    case 5: sha1Offset = 84; break;
+    default: return false;
+  }
+  if (md5Offset >= 0 && md5Offset + (int)sizeof(mMd5) <= length)
+  {
+    memcpy(mMd5, &header[md5Offset], sizeof(mMd5));
+    mHasMd5 = true;
+  }
+  if (sha1Offset >= 0 && sha1Offset + (int)sizeof(mSha1) <= length)
+  {
+    memcpy(mSha1, &header[sha1Offset], sizeof(mSha1));
+    mHasSha1 = true;
+  }
+  mVersion = version;
+  return true;
+}
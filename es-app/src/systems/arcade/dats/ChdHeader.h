@@ -0,0 +1,60 @@
+#pragma once
+
+#include <utils/os/fs/Path.h>
+#include <systems/arcade/dats/RomFileHolder.h>
+
+/*!
+ * @brief CHD header hashes
+ *
+ * CHD files embed the hashes of their whole content in their header:
+ * md5 up to v3, sha1 from v3. Checking a CHD against a dat only requires these few bytes
+ * instead of hashing gigabytes of data.
+ */
+class ChdHeader
+{
+  public:
+    //! Empty (invalid) header
+    ChdHeader()
+      : mMd5()
+      , mSha1()
+      , mVersion(0)
+      , mHasMd5(false)
+      , mHasSha1(false)
+    {
+    }
+
+    /*!
+     * @brief Read the header of the given CHD
+     * @param path CHD path
+     * @return True if the file exists and has a supported CHD header
+     */
+    bool Read(const Path& path);
+
+    //! Valid header?
+    [[nodiscard]] bool IsValid() const { return mVersion != 0; }
+    //! CHD version
+    [[nodiscard]] int Version() const { return mVersion; }
+    //! Header has a md5?
+    [[nodiscard]] bool HasMd5() const { return mHasMd5; }
+    //! Header has a sha1?
+    [[nodiscard]] bool HasSha1() const { return mHasSha1; }
+    //! Content md5
+    [[nodiscard]] const MD5::DigestMd5& Md5() const { return mMd5; }
+    //! Content sha1
+    [[nodiscard]] const RomFileHolder::DigestSha1& Sha1() const { return mSha1; }
+
+  private:
+    //! CHD magic
+    static constexpr const char* sMagic = "MComprHD";
+    //! Largest known header (v5)
+    static constexpr int sMaxHeaderSize = 124;
+
+    MD5::DigestMd5 mMd5;             //!< Content md5
+    RomFileHolder::DigestSha1 mSha1; //!< Content sha1 (including metadata)
+    int mVersion;                    //!< Version, 0 if invalid
+    bool mHasMd5;                    //!< Md5 available
+    bool mHasSha1;                   //!< Sha1 available
+
+    //! Read a big endian 32bit value
+    static unsigned int BigEndian32(const unsigned char* p) { return ((unsigned int)p[0] << 24) | ((unsigned int)p[1] << 16) | ((unsigned int)p[2] << 8) | p[3]; }
+};
@@ -2,8 +2,6 @@
 // Created by bkg2k on 17/06/23.
 //
 
-#include <unistd.h>
-#include <fcntl.h>
 #include "DatContent.h"
 #include "utils/Files.h"
 #include <systems/SystemData.h>
@@ -26,7 +24,7 @@ void DatContent::Load(const Path& flatDatabasdePath)
     {
       mEntryList.push_back(entry); // Record rom list
       gameList.push_back(game);    // Keep track of game name (zip)
-      gameList.push_back(parent);  // Keep track of parent name (may be empty)
+      parentList.push_back(parent);  // Keep track of parent name (may be empty)
     }
   }
 
@@ -41,14 +39,14 @@ void DatContent::Load(const Path& flatDatabasdePath)
         mEntryList[i].SetParent(*entry);
 }
 
-const DatEntry* DatContent::Lookup(const FileData& game)
+const DatEntry* DatContent::Lookup(const FileData& game) const
 {
   DatEntry** entry = mEntryMap.try_get(game.Metadata().RomFileOnly().FilenameWithoutExtension());
   if (entry == nullptr) return nullptr;
   return *entry;
 }
 
-bool DatContent::Scan(const FileData& game, ScanResult::Result::RomFailList& failures)
+bool DatContent::Scan(const FileData& game, RomsetFileCache& files, ScanResult::Result::RomFailList& failures) const
 {
   // Be optimistic :)
   bool result = true;
@@ -60,10 +58,11 @@ bool DatContent::Scan(const FileData& game, ScanResult::Result::RomFailList& fai
   const DatEntry* entry = Lookup(game);
   if (entry == nullptr) return false; // Game not found in dat = not supported at all
 
-  // Now we have information, scan files
+  // Now we have information, scan files. Parent directory is shared with all its clones
   Path gamePath = game.RomPath();
-  Zip zippedGame(gamePath, false);
-  Zip zippedParent(entry->HasParent() ? gamePath.Directory() / (entry->mParent->Name() + ".zip") : Path::Empty, false);
+  std::shared_ptr<const RomsetFileCache::ZipDirectory> zippedGame = files.Directory(gamePath);
+  std::shared_ptr<const RomsetFileCache::ZipDirectory> zippedParent;
+  if (entry->HasParent()) zippedParent = files.Directory(gamePath.Directory() / (entry->mParent->Name() + ".zip"));
   for(int i = entry->RomCount(); --i >= 0;)
   {
     const RomFileHolder& rom = entry->Rom(i);
@@ -74,11 +73,11 @@ bool DatContent::Scan(const FileData& game, ScanResult::Result::RomFailList& fai
         bool filefound = false;
         unsigned int realcrc32 = 0;
         // Lookup in zipped game
-        bool match = LookForRom(zippedGame, rom, filefound, realcrc32);
+        bool match = LookForRom(zippedGame.get(), rom, filefound, realcrc32);
         if (filefound) processedFiles.insert(rom.RomFile());
         // Not found? look in parent game
         if (!match)
-          match = LookForRom(zippedParent, rom, filefound, realcrc32);
+          match = LookForRom(zippedParent.get(), rom, filefound, realcrc32);
         if (!match)
         {
           // Record failure
@@ -90,23 +89,17 @@ bool DatContent::Scan(const FileData& game, ScanResult::Result::RomFailList& fai
       }
       case RomFileHolder::Type::Chd:
       {
-        Path romPath = game.RomPath();
-        Path chdPath = romPath.Directory() / romPath.FilenameWithoutExtension() / rom.RomFile();
-        MD5::DigestMd5 md5;
-        if (!Md5File(chdPath, md5))  // No CHD file (or error occurred while reading data)
+        Path chdPath = gamePath.Directory() / gamePath.FilenameWithoutExtension() / rom.RomFile();
+        bool found = false;
+        RomFileHolder::HashUnion real(0);
+        bool match = CheckChd(chdPath, rom, files, found, real);
+        if (found) processedFiles.insert(rom.RomFile());
+        if (!match)
         {
-          failures.push_back(ScanResult::Result::RomFail(rom.RomFile(), rom.RomMd5()));
+          if (found) failures.push_back(ScanResult::Result::RomFail(rom, real)); // Hash not matching
+          else failures.push_back(ScanResult::Result::RomFail(rom)); // No CHD file
           result = false;
         }
-        else
-        {
-          processedFiles.insert(rom.RomFile());
-          if (memcmp(md5, rom.RomMd5(), sizeof(MD5::DigestMd5)) != 0) // MD5 not matching
-          {
-            failures.push_back(ScanResult::Result::RomFail(rom.RomFile(), rom.RomMd5(), md5));
-            result = false;
-          }
-        }
         break;
       }
       case RomFileHolder::Type::Unknown:
@@ -119,40 +112,57 @@ bool DatContent::Scan(const FileData& game, ScanResult::Result::RomFailList& fai
   }
 
   // Add unknown files for future romset rebuilding
-  AddUnknownFile(game.RomPath(), zippedGame, processedFiles, failures);
+  AddUnknownFile(gamePath, zippedGame.get(), processedFiles, failures);
 
   return result;
 }
 
-bool DatContent::Md5File(const Path& file, MD5::DigestMd5& hash)
+bool DatContent::CheckChd(const Path& chd, const RomFileHolder& rom, RomsetFileCache& files, bool& found, RomFileHolder::HashUnion& real)
 {
-  MD5 md5;
-  unsigned char buffer[256 << 10]; // 256ko
-
-  int chdFile = open(file.ToChars(), O_RDONLY);
-  if (chdFile < 0) return false; // CHD missing
-  for(unsigned int readbytes = 0; (readbytes = read(chdFile, buffer, sizeof(buffer))) > 0; )
-    md5.update(buffer, readbytes);
-  close(chdFile);
-
-  md5.finalize();
-  memcpy(hash, md5.Output(), sizeof(MD5::DigestMd5));
-  return true;
+  found = false;
+  ChdHeader header;
+  bool valid = files.Header(chd, header);
+  switch(rom.RomHashType())
+  {
+    case RomFileHolder::HashType::Sha1:
+    {
+      // Sha1 are only available from headers
+      if (!valid) { found = chd.Exists(); return false; }
+      found = true;
+      if (header.HasSha1() && memcmp(header.Sha1(), rom.RomSha1(), sizeof(RomFileHolder::DigestSha1)) == 0) return true;
+      if (header.HasSha1()) real = RomFileHolder::HashUnion(header.Sha1());
+      return false;
+    }
+    case RomFileHolder::HashType::Md5:
+    {
+      // Header md5 first, whole file md5 otherwise
+      MD5::DigestMd5 md5;
+      if (valid && header.HasMd5()) memcpy(md5, header.Md5(), sizeof(md5));
+      else if (!files.Md5(chd, md5)) return false;
+      found = true;
+      if (memcmp(md5, rom.RomMd5(), sizeof(MD5::DigestMd5)) == 0) return true;
+      real = RomFileHolder::HashUnion(md5);
+      return false;
+    }
+    case RomFileHolder::HashType::Crc32:
+    default: break;
+  }
+  return false;
 }
 
-bool DatContent::LookForRom(const Zip& zip, const RomFileHolder& rom, [[out]] bool& filefound, [[out]] unsigned int& crc32)
+bool DatContent::LookForRom(const RomsetFileCache::ZipDirectory* zip, const RomFileHolder& rom, [[out]] bool& filefound, [[out]] unsigned int& crc32)
 {
-  bool result = false;
-  for(int rc = zip.Count(); --rc >= 0 && !result; )
-    if (String file = zip.FileName(rc).Filename(); file  == rom.RomFile())
+  if (zip == nullptr) return false;
+  for(const RomsetFileCache::ZipEntry& file : *zip)
+    if (file.Name == rom.RomFile())
     {
-      if (filefound = true; rom.RomCrc32() == (unsigned int) zip.Crc32(rc)) result = true;
-      else crc32 = (unsigned int) zip.Crc32(rc);
+      if (filefound = true; rom.RomCrc32() == file.Crc32) return true;
+      crc32 = file.Crc32;
     }
-  return result;
+  return false;
 }
 
-void DatContent::AddUnknownFile(const Path& romPath, const Zip& zippedGame, const HashSet<String>& processedFiles,
+void DatContent::AddUnknownFile(const Path& romPath, const RomsetFileCache::ZipDirectory* zippedGame, const HashSet<String>& processedFiles,
                                 ScanResult::Result::RomFailList& failures)
 {
   (void)romPath;
@@ -8,7 +8,7 @@
 #include "DatEntry.h"
 #include "games/FileData.h"
 #include "ScanResult.h"
-#include "utils/Zip.h"
+#include "RomsetFileCache.h"
 #include "utils/storage/Set.h"
 
 class DatContent
@@ -28,11 +28,13 @@ class DatContent
 
     /*!
      * @brief Lookup DatEntry for the given game, then scan file content and return an emulatiopn status
+     * Thread safe: several games may be scanned concurrently
      * @param game Game to scan
+     * @param files Zip directories & CHD hashes
      * @param failures Detail of failures
      * @return Bool if the gam eis suported, false otherwise
      */
-    bool Scan(const FileData& game, ScanResult::Result::RomFailList& failures);
+    bool Scan(const FileData& game, RomsetFileCache& files, ScanResult::Result::RomFailList& failures) const;
 
   private:
     //! Entry list type
@@ -56,31 +58,34 @@ class DatContent
      * @param game Game to retrieve a DatEntry from
      * @return DatEntry reference or nullptr if there is no match
      */
-    const DatEntry* Lookup(const FileData& game);
+    const DatEntry* Lookup(const FileData& game) const;
 
     /*!
-     * @brief Get the MD5 from the given file
-     * @param file File to hash
-     * @param md5 MD5 result
-     * @return True if the result is ok, false if an error occurred
-     */
-    static bool Md5File(const Path& file, [[out]] MD5::DigestMd5& md5);
-
-    /*!
-     * @brief Look for the given rom into the given zip file
+     * @brief Look for the given rom into the given zip directory
      * It looks for a file name match and a crc32 match
-     * @param zip Zipped game
+     * @param zip Zipped game directory, may be null
      * @param rom Rom
      * @return True if the rom is found, false otherwize
      */
-    static bool LookForRom(const Zip& zip, const RomFileHolder& rom, [[out]] bool& filefound, [[out]] unsigned int& crc32);
+    static bool LookForRom(const RomsetFileCache::ZipDirectory* zip, const RomFileHolder& rom, [[out]] bool& filefound, [[out]] unsigned int& crc32);
+
+    /*!
+     * @brief Check the given CHD against its dat hash, using its header hashes whenever possible
+     * @param chd CHD path
+     * @param rom Dat rom
+     * @param files Zip directories & CHD hashes
+     * @param found Output: True if the CHD exists
+     * @param real Output: Real hash when it does not match
+     * @return True if the CHD matches
+     */
+    static bool CheckChd(const Path& chd, const RomFileHolder& rom, RomsetFileCache& files, [[out]] bool& found, [[out]] RomFileHolder::HashUnion& real);
 
     /*!
      * @brief Add unknwon files from zip and chd folder
      * @param romPath Zip path
-     * @param zippedGame Zipped game
+     * @param zippedGame Zipped game directory, may be null
      * @param processedFiles Already processed files, both rom & chd
      * @param failures Failure list where unknown files are added
      */
-    void AddUnknownFile(const Path& romPath, const Zip& zippedGame, const HashSet<String>& processedFiles, ScanResult::Result::RomFailList& failures);
+    static void AddUnknownFile(const Path& romPath, const RomsetFileCache::ZipDirectory* zippedGame, const HashSet<String>& processedFiles, ScanResult::Result::RomFailList& failures);
 };
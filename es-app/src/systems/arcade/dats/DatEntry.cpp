@@ -57,10 +57,22 @@ void DatEntry::AddRom(const String& rom, const String& hash)
     }
     case RomFileHolder::Type::Chd:
     {
-      MD5::DigestMd5 md5;
-      for(int i = 16; --i>= 0; )
-        md5[i] = (unsigned char)String('$').Append(hash.SubString(i * 2, 2)).AsInt();
-      mRomList.push_back(RomFileHolder(rom, md5));
+      // MAME dats give disk sha1, older ones md5
+      if (hash.Count() == (int)sizeof(RomFileHolder::DigestSha1) * 2)
+      {
+        RomFileHolder::DigestSha1 sha1;
+        for(int i = (int)sizeof(sha1); --i >= 0; )
+          sha1[i] = (unsigned char)String('$').Append(hash.SubString(i * 2, 2)).AsInt();
+        mRomList.push_back(RomFileHolder(rom, sha1));
+      }
+      else
+      {
+        MD5::DigestMd5 md5;
+        for(int i = (int)sizeof(md5); --i >= 0; )
+          md5[i] = (unsigned char)String('$').Append(hash.SubString(i * 2, 2)).AsInt();
+        mRomList.push_back(RomFileHolder(rom, md5));
+      }
+      break;
     }
     case RomFileHolder::Type::Unknown:
     default: break;
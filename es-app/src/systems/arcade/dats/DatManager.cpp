@@ -5,6 +5,7 @@
 #include "DatManager.h"
 
 DatManager::DatManager(const SystemData& system)
+  : mStamp(0)
 {
   LoadAllDats(system);
 }
@@ -34,9 +35,17 @@ void DatManager::LoadDat(const String& emulator, const String& core, const Strin
 {
   Path flatDatabasePath = Path("/recalbox/system/arcade/flats/" + databaseFilename).ChangeExtension(".fdt");
   mDatPerEmulatorCore[Key(emulator, core)] = new DatContent(flatDatabasePath);
+
+  // Dats are loaded in a fixed order: mix emulator/core & file state into the stamp
+  long long size = -1;
+  long long time = 0;
+  (void)RomsetFileCache::GetStamp(flatDatabasePath, size, time);
+  mStamp = mStamp * 1099511628211ULL + (unsigned int)Key(emulator, core).Hash();
+  mStamp = mStamp * 1099511628211ULL + (unsigned long long)size;
+  mStamp = mStamp * 1099511628211ULL + (unsigned long long)time;
 }
 
-ScanResult DatManager::Scan(const FileData& game)
+ScanResult DatManager::Scan(const FileData& game, RomsetFileCache& files) const
 {
   ScanResult result;
 
@@ -45,7 +54,7 @@ ScanResult DatManager::Scan(const FileData& game)
     if (String emulator, core; kv.first.Extract('|', emulator, core, false))
     {
       ScanResult::Result::RomFailList failures;
-      bool ok = kv.second->Scan(game, failures);
+      bool ok = kv.second->Scan(game, files, failures);
       ScanResult::Status status = ok ? ScanResult::Status::Unknown : ScanResult::Status::NotSupported;
       if (ok) // Game match database,; adjust emulation status
         if (const ArcadeDatabase* database = game.System().ArcadeDatabases().LookupDatabaseFor(emulator, core); database != nullptr)
@@ -21,14 +21,24 @@ class DatManager
 
     /*!
      * @brief Scan the given game and return a ScanResult struture
+     * Thread safe: several games may be scanned concurrently
      * @param game Game to scan
+     * @param files Zip directories & CHD hashes
      * @return Scan results
      */
-    ScanResult Scan(const FileData& game);
+    ScanResult Scan(const FileData& game, RomsetFileCache& files) const;
+
+    /*!
+     * @brief Get a stamp of all loaded dats. Changes whenever a dat is added, removed or updated
+     * @return Dat stamp
+     */
+    [[nodiscard]] unsigned long long Stamp() const { return mStamp; }
 
   private:
     //! Hold dar contents per emulator/core couple
     HashMap<String, DatContent*> mDatPerEmulatorCore;
+    //! Stamp of all loaded dats
+    unsigned long long mStamp;
 
     /*!
      * @brief Get a unique key per couple of emulator/core
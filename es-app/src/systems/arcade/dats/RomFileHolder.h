@@ -17,15 +17,29 @@ class RomFileHolder
       Chd,     //!< Chd file
     };
 
+    //! Hash kind
+    enum class HashType
+    {
+      Crc32, //!< Zipped rom crc32
+      Md5,   //!< Chd md5
+      Sha1,  //!< Chd sha1
+    };
+
+    //! Sha1 digest
+    typedef unsigned char DigestSha1[20];
+
     union HashUnion
     {
       unsigned int mCrc32; //!< Crc32 (4 bytes)
       MD5::DigestMd5 mMd5; //!< Md5 (16 bytes)
+      DigestSha1 mSha1;    //!< Sha1 (20 bytes)
 
       //! CRC32 constructor
       explicit HashUnion(unsigned crc32) : mCrc32(crc32) {}
       //! MD5 constructor
-      explicit HashUnion(const MD5::DigestMd5& md5) : mCrc32(0){ memcpy(mMd5, md5, sizeof(MD5::DigestMd5)); }
+      explicit HashUnion(const MD5::DigestMd5& md5) : mSha1() { memcpy(mMd5, md5, sizeof(MD5::DigestMd5)); }
+      //! SHA1 constructor
+      explicit HashUnion(const DigestSha1& sha1) : mSha1() { memcpy(mSha1, sha1, sizeof(DigestSha1)); }
     };
 
     //! CRC constructor
@@ -33,6 +47,7 @@ class RomFileHolder
       : mRomFile(romFile)
       , mHashes(crc32)
       , mType(Type::Bin)
+      , mHashType(HashType::Crc32)
     {
     }
 
@@ -40,9 +55,18 @@ class RomFileHolder
     RomFileHolder(const String& romFile, const MD5::DigestMd5& md5)
       : mRomFile(romFile)
       , mHashes(md5)
-      , mType(Type::Bin)
+      , mType(Type::Chd)
+      , mHashType(HashType::Md5)
     {
+    }
 
+    //! SHA1 constructor
+    RomFileHolder(const String& romFile, const DigestSha1& sha1)
+      : mRomFile(romFile)
+      , mHashes(sha1)
+      , mType(Type::Chd)
+      , mHashType(HashType::Sha1)
+    {
     }
 
     //! Get rom file
@@ -53,10 +77,17 @@ class RomFileHolder
     [[nodiscard]] unsigned int RomCrc32() const { return mHashes.mCrc32; }
     //! Get Md5
     [[nodiscard]] const MD5::DigestMd5& RomMd5() const { return mHashes.mMd5; }
+    //! Get Sha1
+    [[nodiscard]] const DigestSha1& RomSha1() const { return mHashes.mSha1; }
+    //! Get hash kind
+    [[nodiscard]] HashType RomHashType() const { return mHashType; }
+    //! Get all hashes
+    [[nodiscard]] const HashUnion& RomHashes() const { return mHashes; }
 
   private:
     String mRomFile;   //!< Rom name w/ its extension
     HashUnion mHashes; //!< Hashes
     Type mType;        //!< Rom type
+    HashType mHashType; //!< Hash kind
 };
 
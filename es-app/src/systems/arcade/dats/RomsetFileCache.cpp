@@ -0,0 +1,124 @@
+#include "RomsetFileCache.h"
+#include <utils/Zip.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cstring>
+
+thread_local RomsetFileCache::FileStampList* RomsetFileCache::sRecorder = nullptr;
+
+bool RomsetFileCache::GetStamp(const Path& path, long long& size, long long& time)
+{
+  struct stat64 info {};
+  if (stat64(path.ToChars(), &info) != 0) return false;
+  size = info.st_size;
+  time = (long long)info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+  return true;
+}
+
+std::shared_ptr<const RomsetFileCache::ZipDirectory> RomsetFileCache::Directory(const Path& zip)
+{
+  if (zip.IsEmpty()) return nullptr;
+  if (sRecorder != nullptr)
+  {
+    long long size = 0;
+    long long time = 0;
+    bool exists = GetStamp(zip, size, time);
+    Record(zip, exists, size, time);
+  }
+  {
+    Mutex::AutoLock locker(mLocker);
+    if (std::shared_ptr<const ZipDirectory>* directory = mDirectories.try_get(zip.ToString()); directory != nullptr)
+      return *directory;
+  }
+
+  // Read outside of the lock. Concurrent reads of the same zip are harmless
+  std::shared_ptr<ZipDirectory> directory;
+  if (zip.Exists())
+  {
+    Zip archive(zip, false);
+    directory = std::make_shared<ZipDirectory>();
+    directory->reserve(archive.Count());
+    for(int i = 0; i < archive.Count(); ++i)
+      directory->push_back({ archive.FileName(i).Filename(), (unsigned int)archive.Crc32(i) });
+  }
+
+  Mutex::AutoLock locker(mLocker);
+  mDirectories[zip.ToString()] = directory;
+  return directory;
+}
+
+bool RomsetFileCache::Header(const Path& chd, ChdHeader& header)
+{
+  long long size = 0;
+  long long time = 0;
+  bool exists = GetStamp(chd, size, time);
+  Record(chd, exists, size, time);
+  if (!exists) return false;
+  {
+    Mutex::AutoLock locker(mLocker);
+    if (ChdEntry* entry = mChds.try_get(chd.ToString()); entry != nullptr && entry->Size == size && entry->Time == time)
+    {
+      header = entry->Header;
+      return header.IsValid();
+    }
+  }
+
+  (void)header.Read(chd);
+  Mutex::AutoLock locker(mLocker);
+  mChds[chd.ToString()] = { size, time, header, {}, false };
+  return header.IsValid();
+}
+
+bool RomsetFileCache::Md5(const Path& file, MD5::DigestMd5& md5)
+{
+  long long size = 0;
+  long long time = 0;
+  bool exists = GetStamp(file, size, time);
+  Record(file, exists, size, time);
+  if (!exists) return false;
+  {
+    Mutex::AutoLock locker(mLocker);
+    if (ChdEntry* entry = mChds.try_get(file.ToString()); entry != nullptr && entry->Size == size && entry->Time == time && entry->HasMd5)
+    {
+      memcpy(md5, entry->Md5, sizeof(MD5::DigestMd5));
+      return true;
+    }
+  }
+
+  if (!Md5File(file, md5)) return false;
+  Mutex::AutoLock locker(mLocker);
+  ChdEntry& entry = mChds[file.ToString()];
+  if (entry.Size != size || entry.Time != time)
+  {
+    // Header unknown or outdated
+    (void)entry.Header.Read(file);
+    entry.Size = size;
+    entry.Time = time;
+  }
+  memcpy(entry.Md5, md5, sizeof(MD5::DigestMd5));
+  entry.HasMd5 = true;
+  return true;
+}
+
+void RomsetFileCache::ReleaseDirectories()
+{
+  Mutex::AutoLock locker(mLocker);
+  mDirectories.clear();
+}
+
+bool RomsetFileCache::Md5File(const Path& file, MD5::DigestMd5& hash)
+{
+  MD5 md5;
+  unsigned char buffer[256 << 10]; // 256ko
+
+  int chdFile = open(file.ToChars(), O_RDONLY);
+  if (chdFile < 0) return false; // CHD missing
+  for(ssize_t readbytes = 0; (readbytes = read(chdFile, buffer, sizeof(buffer))) > 0; )
+    md5.update(buffer, (unsigned int)readbytes);
+  close(chdFile);
+
+  md5.finalize();
+  memcpy(hash, md5.Output(), sizeof(MD5::DigestMd5));
+  return true;
+}
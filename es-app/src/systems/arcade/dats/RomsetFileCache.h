@@ -0,0 +1,124 @@
+#pragma once
+
+#include <utils/os/fs/Path.h>
+#include <utils/os/system/Mutex.h>
+#include <utils/storage/HashMap.h>
+#include <systems/arcade/dats/ChdHeader.h>
+#include <memory>
+#include <vector>
+
+/*!
+ * @brief Romset file cache, shared by all verification workers
+ *
+ * Zip central directories are read once per verification, so that parent sets are read only once
+ * for all their clones. CHD hashes are kept as long as the file size & modification time do not change.
+ * Thread safe.
+ */
+class RomsetFileCache
+{
+  public:
+    //! Zipped file
+    struct ZipEntry
+    {
+      String Name;        //!< File name, w/o folder
+      unsigned int Crc32; //!< Crc32
+    };
+
+    //! Zip central directory
+    typedef std::vector<ZipEntry> ZipDirectory;
+
+    //! File state at the time it has been read
+    struct FileStamp
+    {
+      String Path;    //!< File path
+      long long Size; //!< File size, -1 if the file does not exist
+      long long Time; //!< Modification time (ns)
+    };
+
+    //! File stamp list
+    typedef std::vector<FileStamp> FileStampList;
+
+    /*!
+     * @brief Get the central directory of the given zip
+     * @param zip Zip path
+     * @return Central directory, nullptr if the zip does not exist
+     */
+    std::shared_ptr<const ZipDirectory> Directory(const Path& zip);
+
+    /*!
+     * @brief Get the header of the given CHD
+     * @param chd CHD path
+     * @param header Output header
+     * @return True if the CHD exists and its header is valid
+     */
+    bool Header(const Path& chd, [[out]] ChdHeader& header);
+
+    /*!
+     * @brief Get the md5 of the whole given file, computing it only if the file has changed
+     * @param file File path
+     * @param md5 Output md5
+     * @return True if the file exists
+     */
+    bool Md5(const Path& file, [[out]] MD5::DigestMd5& md5);
+
+    //! Forget zip directories. CHD hashes are kept
+    void ReleaseDirectories();
+
+    /*!
+     * @brief Record stamps of all files read by the calling thread, until StopRecording is called
+     * @param stamps Stamp list to fill
+     */
+    static void StartRecording(FileStampList& stamps) { sRecorder = &stamps; }
+
+    //! Stop recording stamps in the calling thread
+    static void StopRecording() { sRecorder = nullptr; }
+
+    /*!
+     * @brief Get size & modification time of a file
+     * @param path File path
+     * @param size Output size
+     * @param time Output modification time (ns)
+     * @return True if the file exists
+     */
+    static bool GetStamp(const Path& path, long long& size, long long& time);
+
+  private:
+    //! Cached CHD
+    struct ChdEntry
+    {
+      long long Size;     //!< File size
+      long long Time;     //!< Modification time (ns)
+      ChdHeader Header;   //!< Header hashes
+      MD5::DigestMd5 Md5; //!< Whole file md5
+      bool HasMd5;        //!< Md5 computed
+    };
+
+    //! Zip directories
+    HashMap<String, std::shared_ptr<const ZipDirectory>> mDirectories;
+    //! CHD hashes
+    HashMap<String, ChdEntry> mChds;
+    //! Protect maps
+    Mutex mLocker;
+    //! Stamps of files read by the current thread, if recording
+    static thread_local FileStampList* sRecorder;
+
+    /*!
+     * @brief Record a file stamp if the current thread is recording
+     * @param path File path
+     * @param exists File exists
+     * @param size File size
+     * @param time Modification time (ns)
+     */
+    static void Record(const Path& path, bool exists, long long size, long long time)
+    {
+      if (sRecorder != nullptr) sRecorder->push_back({ path.ToString(), exists ? size : -1, exists ? time : 0 });
+    }
+
+    /*!
+     * @brief Compute the md5 of the whole given file
+     * @param file File to hash
+     * @param md5 Md5 result
+     * @return True if the result is ok, false if an error occurred
+     */
+    static bool Md5File(const Path& file, [[out]] MD5::DigestMd5& md5);
+};
@@ -0,0 +1,201 @@
+#include "RomsetScanCache.h"
+#include <RootFolders.h>
+#include <utils/Files.h>
+#include <utils/Log.h>
+#include <cstring>
+
+RomsetScanCache::RomsetScanCache()
+  : mLoaded(false)
+  , mModified(false)
+{
+}
+
+Path RomsetScanCache::CachePath()
+{
+  return RootFolders::DataRootFolder / sCacheFile;
+}
+
+bool RomsetScanCache::Read(const String& image, int& offset, void* to, int size)
+{
+  if (size < 0 || offset + size > (int)image.size()) return false;
+  memcpy(to, image.data() + offset, size);
+  offset += size;
+  return true;
+}
+
+bool RomsetScanCache::Read(const String& image, int& offset, int length, String& to)
+{
+  if (length < 0 || offset + length > (int)image.size()) return false;
+  to.Assign(image, offset, length);
+  offset += length;
+  return true;
+}
+
+bool RomsetScanCache::ReadGame(const String& image, int& offset, String& path, Entry& entry)
+{
+  GameRecord game {};
+  if (!Read(image, offset, &game, (int)sizeof(game))) return false;
+  if (game.PathLength <= 0 || !Read(image, offset, game.PathLength, path)) return false;
+  entry.DatStamp = game.DatStamp;
+
+  // Files
+  if (game.FileCount < 0) return false;
+  entry.Files.reserve(game.FileCount);
+  for(int f = game.FileCount; --f >= 0; )
+  {
+    FileRecord file {};
+    String filePath;
+    if (!Read(image, offset, &file, (int)sizeof(file))) return false;
+    if (!Read(image, offset, file.PathLength, filePath)) return false;
+    entry.Files.push_back({ filePath, file.Size, file.Time });
+  }
+
+  // Results
+  if (game.ResultCount < 0) return false;
+  std::shared_ptr<ScanResult> scan = std::make_shared<ScanResult>();
+  scan->mResults.reserve(game.ResultCount);
+  for(int r = game.ResultCount; --r >= 0; )
+  {
+    ResultRecord result {};
+    String emulator;
+    String core;
+    if (!Read(image, offset, &result, (int)sizeof(result))) return false;
+    if (!Read(image, offset, result.EmulatorLength, emulator)) return false;
+    if (!Read(image, offset, result.CoreLength, core)) return false;
+    if (result.Status < (int)ScanResult::Status::Error || result.Status > (int)ScanResult::Status::Unknown) return false;
+    if (result.FailCount < 0) return false;
+
+    ScanResult::Result::RomFailList failures;
+    failures.reserve(result.FailCount);
+    for(int f = result.FailCount; --f >= 0; )
+    {
+      FailRecord fail { RomFileHolder::HashUnion(0u), RomFileHolder::HashUnion(0u), 0, 0, 0, 0 };
+      String rom;
+      if (!Read(image, offset, &fail, (int)sizeof(fail))) return false;
+      if (!Read(image, offset, fail.RomLength, rom)) return false;
+      if (fail.Failure < (int)ScanResult::Result::TypeFail::None || fail.Failure > (int)ScanResult::Result::TypeFail::ChdNotFound) return false;
+      if (fail.HashType < (int)RomFileHolder::HashType::Crc32 || fail.HashType > (int)RomFileHolder::HashType::Sha1) return false;
+      failures.emplace_back(rom, fail.Expected, fail.Real, (ScanResult::Result::TypeFail)fail.Failure, (RomFileHolder::HashType)fail.HashType);
+    }
+    scan->mResults.push_back(ScanResult::Result(emulator, core, (ScanResult::Status)result.Status, std::move(failures)));
+  }
+  entry.Result = scan;
+  entry.Used = false;
+  return true;
+}
+
+void RomsetScanCache::WriteGame(String& image, const String& path, const Entry& entry)
+{
+  GameRecord game { entry.DatStamp, (int)path.size(), (int)entry.Files.size(), entry.Result->Count(), 0 };
+  image.Append((const char*)&game, sizeof(game)).Append(path);
+
+  for(const RomsetFileCache::FileStamp& stamp : entry.Files)
+  {
+    FileRecord file { stamp.Size, stamp.Time, (int)stamp.Path.size(), 0 };
+    image.Append((const char*)&file, sizeof(file)).Append(stamp.Path);
+  }
+
+  for(const ScanResult::Result& result : entry.Result->mResults)
+  {
+    ResultRecord record { (int)result.mEmulator.size(), (int)result.mCore.size(), (int)result.mStatus, (int)result.mFailures.size() };
+    image.Append((const char*)&record, sizeof(record)).Append(result.mEmulator).Append(result.mCore);
+    for(const ScanResult::Result::RomFail& fail : result.mFailures)
+    {
+      FailRecord failRecord { fail.mExpectedHash, fail.mRealHash, (int)fail.mFailure, (int)fail.mHashType, (int)fail.mRom.size(), 0 };
+      image.Append((const char*)&failRecord, sizeof(failRecord)).Append(fail.mRom);
+    }
+  }
+}
+
+void RomsetScanCache::Load()
+{
+  Mutex::AutoLock locker(mLocker);
+  if (mLoaded) return;
+  mLoaded = true;
+
+  String image = Files::LoadFile(CachePath());
+  if ((int)image.size() < (int)sizeof(Header)) return;
+  const Header& header = *(const Header*)image.data();
+  if (memcmp(header.Magic, sMagic, sizeof(header.Magic)) != 0 || header.Version != sVersion) return;
+
+  // Read records, stop on any truncated or invalid record
+  int offset = (int)sizeof(Header);
+  mEntries.reserve(header.Count);
+  for(int i = header.Count; --i >= 0; )
+  {
+    String path;
+    Entry entry {};
+    if (!ReadGame(image, offset, path, entry)) break;
+    mEntries[path] = std::move(entry);
+  }
+  { LOG(LogDebug) << "[RomsetScanCache] " << mEntries.size() << " romset verifications loaded"; }
+}
+
+void RomsetScanCache::Save(bool prune)
+{
+  String image;
+  {
+    Mutex::AutoLock locker(mLocker);
+    if (prune)
+      for(auto it = mEntries.begin(); it != mEntries.end(); )
+      {
+        if (!it->second.Used) { it = mEntries.erase(it); mModified = true; }
+        else ++it;
+      }
+    for(auto& entry : mEntries)
+      entry.second.Used = false;
+    if (!mModified) return;
+    mModified = false;
+
+    Header header {};
+    memcpy(header.Magic, sMagic, sizeof(header.Magic));
+    header.Version = sVersion;
+    header.Count = (int)mEntries.size();
+    image.Append((const char*)&header, sizeof(header));
+    for(const auto& entry : mEntries)
+      WriteGame(image, entry.first, entry.second);
+  }
+
+  // Save in a temporary file first, then atomically replace the previous cache
+  Path path = CachePath();
+  Path temporary = path.ChangeExtension(".tmp");
+  (void)path.Directory().CreatePath();
+  if (!Files::SaveFile(temporary, image) || !Path::Rename(temporary, path))
+  {
+    { LOG(LogWarning) << "[RomsetScanCache] Cannot save " << path.ToString(); }
+    (void)temporary.Delete();
+  }
+}
+
+std::shared_ptr<const ScanResult> RomsetScanCache::Lookup(const Path& rom, unsigned long long datStamp)
+{
+  RomsetFileCache::FileStampList files;
+  std::shared_ptr<const ScanResult> result;
+  {
+    Mutex::AutoLock locker(mLocker);
+    Entry* entry = mEntries.try_get(rom.ToString());
+    if (entry == nullptr || entry->DatStamp != datStamp) return nullptr;
+    files = entry->Files;
+    result = entry->Result;
+  }
+
+  // Check files outside of the lock
+  for(const RomsetFileCache::FileStamp& stamp : files)
+  {
+    long long size = -1;
+    long long time = 0;
+    if (!RomsetFileCache::GetStamp(Path(stamp.Path), size, time)) { size = -1; time = 0; }
+    if (size != stamp.Size || time != stamp.Time) return nullptr;
+  }
+
+  Mutex::AutoLock locker(mLocker);
+  if (Entry* entry = mEntries.try_get(rom.ToString()); entry != nullptr) entry->Used = true;
+  return result;
+}
+
+void RomsetScanCache::Store(const Path& rom, unsigned long long datStamp, RomsetFileCache::FileStampList&& files, const ScanResult& result)
+{
+  Mutex::AutoLock locker(mLocker);
+  mEntries[rom.ToString()] = { datStamp, std::move(files), std::make_shared<const ScanResult>(result), true };
+  mModified = true;
+}
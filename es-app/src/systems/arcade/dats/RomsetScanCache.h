@@ -0,0 +1,166 @@
+#pragma once
+
+#include <utils/os/fs/Path.h>
+#include <utils/os/system/Mutex.h>
+#include <utils/storage/HashMap.h>
+#include <systems/arcade/dats/RomsetFileCache.h>
+#include <systems/arcade/dats/ScanResult.h>
+#include <memory>
+
+/*!
+ * @brief Persistent romset verification cache
+ *
+ * Scan results are keyed by rom path and validated against the dats stamp and the size & modification time
+ * of every file read during the scan (game zip, parent zip, CHDs), so that unchanged romsets
+ * are never verified twice, even across restarts.
+ * Thread safe.
+ */
+class RomsetScanCache
+{
+  public:
+    //! Constructor
+    RomsetScanCache();
+
+    /*!
+     * @brief Load the cache file, once
+     */
+    void Load();
+
+    /*!
+     * @brief Save the cache file if it has been modified
+     * @param prune Drop results neither looked up nor stored since the last save
+     */
+    void Save(bool prune);
+
+    /*!
+     * @brief Lookup a scan result
+     * @param rom Rom path
+     * @param datStamp Stamp of the dats the game is verified against
+     * @return Scan result if all files read to build it are unchanged, nullptr otherwise
+     */
+    std::shared_ptr<const ScanResult> Lookup(const Path& rom, unsigned long long datStamp);
+
+    /*!
+     * @brief Store a scan result
+     * @param rom Rom path
+     * @param datStamp Stamp of the dats the game has been verified against
+     * @param files Stamps of all files read during the scan
+     * @param result Scan result
+     */
+    void Store(const Path& rom, unsigned long long datStamp, RomsetFileCache::FileStampList&& files, const ScanResult& result);
+
+  private:
+    //! Magic
+    static constexpr const char* sMagic = "RRSC";
+    //! Version - Increment each time any record is modified
+    static constexpr int sVersion = 1;
+    //! Cache file
+    static constexpr const char* sCacheFile = "system/.emulationstation/cache/romsets.cache";
+
+    //! File header
+    struct Header
+    {
+      char Magic[4]; //!< Magic identifier
+      int  Version;  //!< File version
+      int  Count;    //!< Record count
+      int  Padding;  //!< Padding
+    };
+
+    //! Game record, followed by the rom path, file records & result records
+    struct GameRecord
+    {
+      unsigned long long DatStamp; //!< Dats stamp
+      int PathLength;              //!< Rom path length
+      int FileCount;               //!< File record count
+      int ResultCount;             //!< Result record count
+      int Padding;                 //!< Padding
+    };
+
+    //! File record, followed by the file path
+    struct FileRecord
+    {
+      long long Size; //!< File size, -1 if the file did not exist
+      long long Time; //!< Modification time
+      int PathLength; //!< Path length
+      int Padding;    //!< Padding
+    };
+
+    //! Result record, followed by emulator & core names, then failure records
+    struct ResultRecord
+    {
+      int EmulatorLength; //!< Emulator name length
+      int CoreLength;     //!< Core name length
+      int Status;         //!< Emulation status
+      int FailCount;      //!< Failure record count
+    };
+
+    //! Failure record, followed by the rom name
+    struct FailRecord
+    {
+      RomFileHolder::HashUnion Expected; //!< Expected hash
+      RomFileHolder::HashUnion Real;     //!< Real hash
+      int Failure;                       //!< Failure type
+      int HashType;                      //!< Hash kind
+      int RomLength;                     //!< Rom name length
+      int Padding;                       //!< Padding
+    };
+
+    //! Cached value
+    struct Entry
+    {
+      unsigned long long DatStamp;              //!< Dats stamp
+      RomsetFileCache::FileStampList Files;     //!< Files read during the scan
+      std::shared_ptr<const ScanResult> Result; //!< Scan result
+      bool Used;                                //!< Looked up or stored since the last save
+    };
+
+    //! Entries
+    HashMap<String, Entry> mEntries;
+    //! Protect entries
+    Mutex mLocker;
+    //! Loaded flag
+    bool mLoaded;
+    //! Modified flag
+    bool mModified;
+
+    //! Get cache file path
+    static Path CachePath();
+
+    /*!
+     * @brief Read a game record from the cache image
+     * @param image Cache image
+     * @param offset Read offset, updated
+     * @param path Output rom path
+     * @param entry Output entry
+     * @return True if the record is complete and valid
+     */
+    static bool ReadGame(const String& image, int& offset, String& path, Entry& entry);
+
+    /*!
+     * @brief Append a game record to the cache image
+     * @param image Cache image
+     * @param path Rom path
+     * @param entry Entry to write
+     */
+    static void WriteGame(String& image, const String& path, const Entry& entry);
+
+    /*!
+     * @brief Read raw bytes from the cache image
+     * @param image Cache image
+     * @param offset Read offset, updated
+     * @param to Destination
+     * @param size Byte count
+     * @return True if enough bytes are available
+     */
+    static bool Read(const String& image, int& offset, void* to, int size);
+
+    /*!
+     * @brief Read a string from the cache image
+     * @param image Cache image
+     * @param offset Read offset, updated
+     * @param length String length
+     * @param to Destination string
+     * @return True if enough bytes are available
+     */
+    static bool Read(const String& image, int& offset, int length, String& to);
+};
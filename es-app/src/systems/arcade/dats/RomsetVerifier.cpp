@@ -0,0 +1,214 @@
+#include "RomsetVerifier.h"
+#include <utils/os/system/WorkStealingThreadPool.h>
+#include <RecalboxConf.h>
+#include <chrono>
+
+RomsetVerifier::RomsetVerifier()
+  : mDats(nullptr)
+  , mPool(nullptr)
+  , mTotal(0)
+  , mCompleted(0)
+  , mDuration(0)
+{
+}
+
+RomsetVerifier::~RomsetVerifier()
+{
+  MustQuit();
+}
+
+bool RomsetVerifier::Start(const Array<SystemData*>& systems)
+{
+  Mutex::AutoLock startLocker(mStartLocker);
+  if (IsRunning()) return false;
+  {
+    Mutex::AutoLock locker(mLocker);
+    mSystems.Clear();
+    for(SystemData* system : systems)
+      if (!system->IsVirtual() && system->Descriptor().IsTrueArcade())
+        mSystems.Add(system);
+    mReports.clear();
+  }
+  mTotal = 0;
+  mCompleted = 0;
+  mDuration = 0;
+  Thread::Start("RomsetVerify");
+  return true;
+}
+
+void RomsetVerifier::MustQuit()
+{
+  Mutex::AutoLock startLocker(mStartLocker);
+  {
+    Mutex::AutoLock locker(mLocker);
+    if (mPool != nullptr) mPool->CancelPendingJobs();
+  }
+  Thread::Stop();
+  Mutex::AutoLock locker(mLocker);
+  mSystems.Clear();
+}
+
+int RomsetVerifier::WorkerCount()
+{
+  int forced = RecalboxConf::Instance().AsInt("emulationstation.arcade.verifier.workers", 0);
+  if (forced > 0) return forced;
+  // Mostly I/O bound: zip directories & CHD headers are small reads
+  return std::min(4, get_nprocs());
+}
+
+void RomsetVerifier::Run()
+{
+  auto start = std::chrono::steady_clock::now();
+  mScans.Load();
+  for(int s = 0; IsRunning(); ++s)
+  {
+    SystemData* system = nullptr;
+    {
+      Mutex::AutoLock locker(mLocker);
+      if (s >= mSystems.Count()) break;
+      system = mSystems[s];
+    }
+
+    DatManager dats(*system);
+    FileData::List games = system->getAllGames();
+    if (games.empty()) continue;
+    mTotal += (int)games.size();
+
+    WorkStealingThreadPool<FileData*, bool> pool(this, "RomsetVerify", false);
+    for(FileData* game : games)
+      pool.PushFeed(game);
+    int workers = std::min(WorkerCount(), (int)games.size());
+    { LOG(LogInfo) << "[RomsetVerifier] Verifying " << games.size() << " games of " << system->FullName() << " using " << workers << " workers"; }
+
+    mDats = &dats;
+    { Mutex::AutoLock locker(mLocker); mPool = &pool; }
+    pool.Run(workers, false);
+    { Mutex::AutoLock locker(mLocker); mPool = nullptr; }
+    mDats = nullptr;
+  }
+
+  // Parents are read once per run. CHD hashes are kept for the next one
+  mFiles.ReleaseDirectories();
+  // Prune results of removed games only when all systems have been verified
+  mScans.Save(IsRunning());
+  mDuration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  { LOG(LogInfo) << "[RomsetVerifier] " << (int)mCompleted << " games verified in " << (long long)mDuration << "ms"; }
+}
+
+bool RomsetVerifier::ThreadPoolRunJob(FileData*& feed)
+{
+  if (!IsRunning()) return false;
+
+  // Unchanged romsets are not scanned again
+  std::shared_ptr<const ScanResult> cached = mScans.Lookup(feed->RomPath(), mDats->Stamp());
+  if (!cached)
+  {
+    RomsetFileCache::FileStampList files;
+    RomsetFileCache::StartRecording(files);
+    ScanResult result = mDats->Scan(*feed, mFiles);
+    RomsetFileCache::StopRecording();
+    mScans.Store(feed->RomPath(), mDats->Stamp(), std::move(files), result);
+    cached = std::make_shared<const ScanResult>(result);
+  }
+
+  GameReport report { feed->System().Name(), feed->Name(), feed->RomPath(), *cached };
+  {
+    Mutex::AutoLock locker(mLocker);
+    mReports.push_back(std::move(report));
+  }
+  mCompleted++;
+  return true;
+}
+
+const char* RomsetVerifier::StatusName(ScanResult::Status status)
+{
+  switch(status)
+  {
+    case ScanResult::Status::Error: return "error";
+    case ScanResult::Status::NotSupported: return "notsupported";
+    case ScanResult::Status::Preliminar: return "preliminary";
+    case ScanResult::Status::Imperfect: return "imperfect";
+    case ScanResult::Status::Good: return "good";
+    case ScanResult::Status::Unknown:
+    default: break;
+  }
+  return "unknown";
+}
+
+const char* RomsetVerifier::FailureName(ScanResult::Result::TypeFail failure)
+{
+  switch(failure)
+  {
+    case ScanResult::Result::TypeFail::UnknownFile: return "unknownfile";
+    case ScanResult::Result::TypeFail::RomBadHash: return "rombadhash";
+    case ScanResult::Result::TypeFail::RomNotFound: return "romnotfound";
+    case ScanResult::Result::TypeFail::ChdBadHash: return "chdbadhash";
+    case ScanResult::Result::TypeFail::ChdNotFound: return "chdnotfound";
+    case ScanResult::Result::TypeFail::None:
+    default: break;
+  }
+  return "none";
+}
+
+String RomsetVerifier::Hexa(const RomFileHolder::HashUnion& hash, RomFileHolder::HashType type)
+{
+  const unsigned char* bytes = nullptr;
+  int count = 0;
+  switch(type)
+  {
+    case RomFileHolder::HashType::Crc32: return String::ToHexa(hash.mCrc32, 8, String::Hexa::None);
+    case RomFileHolder::HashType::Md5: bytes = hash.mMd5; count = (int)sizeof(hash.mMd5); break;
+    case RomFileHolder::HashType::Sha1: bytes = hash.mSha1; count = (int)sizeof(hash.mSha1); break;
+    default: break;
+  }
+  String result;
+  for(int i = 0; i < count; ++i)
+    result.AppendHexa((int)bytes[i], 2, String::Hexa::None);
+  return result;
+}
+
+String RomsetVerifier::Report()
+{
+  Mutex::AutoLock locker(mLocker);
+  JSONBuilder json;
+  json.Open()
+      .Field("running", IsRunning())
+      .Field("total", (int)mTotal)
+      .Field("completed", (int)mCompleted)
+      .Field("duration", (long long)mDuration)
+      .OpenArray("games");
+  for(const GameReport& game : mReports)
+  {
+    json.OpenObject(nullptr)
+        .Field("system", game.System)
+        .Field("name", game.Name)
+        .Field("path", game.RomPath.ToString())
+        .OpenArray("results");
+    for(int r = 0; r < game.Result.Count(); ++r)
+    {
+      const ScanResult::Result& result = game.Result.ResultAt(r);
+      json.OpenObject(nullptr)
+          .Field("emulator", result.Emulator())
+          .Field("core", result.Core())
+          .Field("status", StatusName(result.Status()))
+          .OpenArray("failures");
+      for(int f = 0; f < result.FailCount(); ++f)
+      {
+        const ScanResult::Result::RomFail& fail = result.FailAt(f);
+        json.OpenObject(nullptr)
+            .Field("file", fail.mRom)
+            .Field("type", FailureName(fail.mFailure))
+            .Field("expected", Hexa(fail.mExpectedHash, fail.mHashType))
+            .Field("real", Hexa(fail.mRealHash, fail.mHashType))
+            .CloseObject();
+      }
+      json.CloseArray()
+          .CloseObject();
+    }
+    json.CloseArray()
+        .CloseObject();
+  }
+  json.CloseArray()
+      .Close();
+  return json;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <utils/os/system/Thread.h>
+#include <utils/os/system/Mutex.h>
+#include <utils/os/system/IThreadPoolWorkerInterface.h>
+#include <utils/json/JSONBuilder.h>
+#include <systems/arcade/dats/DatManager.h>
+#include <systems/arcade/dats/RomsetFileCache.h>
+#include <systems/arcade/dats/RomsetScanCache.h>
+#include <atomic>
+
+template<class FeedObject, class ResultObject> class WorkStealingThreadPool;
+
+/*!
+ * @brief Batch verification of arcade romsets against their emulator dats
+ *
+ * Games of all true arcade systems are verified in the background, across a worker pool.
+ * Zip directories & CHD hashes are shared by all workers through a RomsetFileCache.
+ * Results of unchanged romsets are reused from the persistent RomsetScanCache.
+ * The report only holds copies of game data so that it survives system reloads.
+ * Start & MustQuit must be called from the main thread, which owns the systems.
+ */
+class RomsetVerifier : private Thread
+                     , private IThreadPoolWorkerInterface<FileData*, bool>
+{
+  public:
+    //! Constructor
+    RomsetVerifier();
+
+    //! Destructor
+    ~RomsetVerifier() override;
+
+    /*!
+     * @brief Start verifying all true arcade systems in the background
+     * @param systems All systems. Non arcade systems are ignored
+     * @return False if a verification is already running
+     */
+    bool Start(const Array<SystemData*>& systems);
+
+    //! Systems are about to be deleted - stop any processing asap
+    void MustQuit();
+
+    //! Verification running?
+    [[nodiscard]] bool IsVerifying() const { return IsRunning(); }
+
+    //! Get the last (or current) verification report, as JSON
+    [[nodiscard]] String Report();
+
+  private:
+    //! Verified game
+    struct GameReport
+    {
+      String System;     //!< System short name
+      String Name;       //!< Game name
+      Path RomPath;      //!< Rom path
+      ScanResult Result; //!< Scan result
+    };
+
+    //! Systems to verify
+    Array<SystemData*> mSystems;
+    //! Current system dats
+    const DatManager* mDats;
+    //! Running worker pool, if any
+    WorkStealingThreadPool<FileData*, bool>* mPool;
+    //! Zip directories & CHD hashes
+    RomsetFileCache mFiles;
+    //! Persistent scan results
+    RomsetScanCache mScans;
+    //! Protect reports & systems
+    Mutex mLocker;
+    //! Make running check & thread start/stop atomic
+    Mutex mStartLocker;
+    //! Verified games
+    std::vector<GameReport> mReports;
+
+    //! Games to verify
+    std::atomic<int> mTotal;
+    //! Verified games
+    std::atomic<int> mCompleted;
+    //! Verification duration (ms)
+    std::atomic<long long> mDuration;
+
+    //! Get the worker count
+    static int WorkerCount();
+
+    //! Status name, for reports
+    static const char* StatusName(ScanResult::Status status);
+
+    //! Failure name, for reports
+    static const char* FailureName(ScanResult::Result::TypeFail failure);
+
+    /*!
+     * @brief Get the hexadecimal representation of a hash
+     * @param hash Hash
+     * @param type Hash kind
+     * @return Hexadecimal string
+     */
+    static String Hexa(const RomFileHolder::HashUnion& hash, RomFileHolder::HashType type);
+
+    /*
+     * Thread implementation
+     */
+
+    //! Verify all queued systems
+    void Run() override;
+
+    /*
+     * IThreadPoolWorkerInterface implementation
+     */
+
+    //! Verify a single game
+    bool ThreadPoolRunJob(FileData*& feed) override;
+};
@@ -39,9 +39,10 @@ class ScanResult
           const RomFileHolder::HashUnion mExpectedHash;
           const RomFileHolder::HashUnion mRealHash;
           const TypeFail mFailure;
+          const RomFileHolder::HashType mHashType;
 
           //! Null constructor
-          RomFail() : mRom(), mExpectedHash(0), mRealHash(0), mFailure(TypeFail::None) {}
+          RomFail() : mRom(), mExpectedHash(0), mRealHash(0), mFailure(TypeFail::None), mHashType(RomFileHolder::HashType::Crc32) {}
 
           //! Rom not found constructor
           RomFail(const String& romNotFound, unsigned int crc32)
@@ -49,6 +50,7 @@ class ScanResult
             , mExpectedHash(crc32)
             , mRealHash(0)
             , mFailure(TypeFail::RomNotFound)
+            , mHashType(RomFileHolder::HashType::Crc32)
           {
           }
 
@@ -58,6 +60,7 @@ class ScanResult
             , mExpectedHash(md5)
             , mRealHash(0)
             , mFailure(TypeFail::ChdNotFound)
+            , mHashType(RomFileHolder::HashType::Md5)
           {
           }
 
@@ -67,6 +70,7 @@ class ScanResult
             , mExpectedHash(expectedcrc32)
             , mRealHash(realcrc32)
             , mFailure(TypeFail::RomBadHash)
+            , mHashType(RomFileHolder::HashType::Crc32)
           {
           }
 
@@ -76,6 +80,7 @@ class ScanResult
             , mExpectedHash(expectedmd5)
             , mRealHash(realdmd5)
             , mFailure(TypeFail::ChdBadHash)
+            , mHashType(RomFileHolder::HashType::Md5)
           {
           }
 
@@ -85,6 +90,7 @@ class ScanResult
             , mExpectedHash(0)
             , mRealHash(crc32)
             , mFailure(TypeFail::UnknownFile)
+            , mHashType(RomFileHolder::HashType::Crc32)
           {
           }
 
@@ -94,6 +100,37 @@ class ScanResult
             , mExpectedHash(0)
             , mRealHash(md5)
             , mFailure(TypeFail::UnknownFile)
+            , mHashType(RomFileHolder::HashType::Md5)
+          {
+          }
+
+          //! Chd not found constructor, any hash kind
+          explicit RomFail(const RomFileHolder& chdNotFound)
+            : mRom(chdNotFound.RomFile())
+            , mExpectedHash(chdNotFound.RomHashes())
+            , mRealHash(0)
+            , mFailure(TypeFail::ChdNotFound)
+            , mHashType(chdNotFound.RomHashType())
+          {
+          }
+
+          //! Raw constructor
+          RomFail(const String& rom, const RomFileHolder::HashUnion& expected, const RomFileHolder::HashUnion& real, TypeFail failure, RomFileHolder::HashType type)
+            : mRom(rom)
+            , mExpectedHash(expected)
+            , mRealHash(real)
+            , mFailure(failure)
+            , mHashType(type)
+          {
+          }
+
+          //! Bad chd constructor, any hash kind
+          RomFail(const RomFileHolder& chdBadHash, const RomFileHolder::HashUnion& realHash)
+            : mRom(chdBadHash.RomFile())
+            , mExpectedHash(chdBadHash.RomHashes())
+            , mRealHash(realHash)
+            , mFailure(TypeFail::ChdBadHash)
+            , mHashType(chdBadHash.RomHashType())
           {
           }
         };
@@ -126,6 +163,7 @@ class ScanResult
 
       private:
         friend class DatManager;
+        friend class RomsetScanCache;
 
         String mEmulator;           //!< Emulator short name
         String mCore;               //!< Core short name
@@ -158,6 +196,7 @@ class ScanResult
 
   private:
     friend class DatManager;
+    friend class RomsetScanCache;
 
     //! Result array
     std::vector<Result> mResults;
@@ -18,6 +18,8 @@
 #include <guis/GuiMsgBox.h>
 #include <utils/Files.h>
 #include <games/GameFilesUtils.h>
+#include <resources/TextureResource.h>
+#include <resources/Font.h>
 
 ViewController::ViewController(WindowManager& window, SystemManager& systemManager)
 	: StaticLifeCycleControler<ViewController>("ViewController")
@@ -665,9 +667,13 @@ ISimpleGameListView* ViewController::GetOrCreateGamelistView(SystemData* system)
 	//if we already made one, return that one
 	auto exists = mGameListViews.find(system);
 	if(exists != mGameListViews.end())
+  {
+    TouchGamelistView(system);
 		return exists->second;
+  }
 
 	//if we didn't, make it, remember it, and return it
+  long long memory = (long long)(TextureResource::getTotalMemUsage() + Font::getTotalMemUsage());
 	ISimpleGameListView* view =
     (system->Descriptor().IsArcade() && RecalboxConf::Instance().GetArcadeViewEnhanced() && !(system->Name() == "daphne")) ?
     new ArcadeGameListView(mWindow, mSystemManager, *system) :
@@ -682,9 +688,82 @@ ISimpleGameListView* ViewController::GetOrCreateGamelistView(SystemData* system)
 
 	mGameListViews[system] = view;
 	mInvalidGameList[system] = false;
+  TouchGamelistView(system);
+
+  // Restore the cursor of an evicted view
+  if (FileData** cursor = mEvictedCursors.try_get(system); cursor != nullptr)
+  {
+    if (*cursor != nullptr && system->MasterRoot().LookupGame(*cursor)) view->setCursor(*cursor);
+    mEvictedCursors.erase(system);
+  }
+
+  // Textures & fonts loaded by the view itself. Asynchronous textures are not counted
+  memory = std::max(0LL, (long long)(TextureResource::getTotalMemUsage() + Font::getTotalMemUsage()) - memory);
+  mGameListViewsFootprint[system] = memory;
+  { LOG(LogDebug) << "[ViewController] Gamelist view of " << system->FullName() << " built: " << (memory >> 10) << " KB, "
+                  << (int)mGameListViews.size() << " live views"; }
+
+  EvictGamelistViews(system);
 	return view;
 }
 
+void ViewController::TouchGamelistView(SystemData* system)
+{
+  if (!mGameListViewsUsage.empty() && mGameListViewsUsage.back() == system) return;
+  for(int i = (int)mGameListViewsUsage.size(); --i >= 0; )
+    if (mGameListViewsUsage[i] == system)
+    {
+      mGameListViewsUsage.erase(mGameListViewsUsage.begin() + i);
+      break;
+    }
+  mGameListViewsUsage.push_back(system);
+}
+
+void ViewController::EvictGamelistViews(SystemData* keep)
+{
+  int maxViews = std::max(2, RecalboxConf::Instance().AsInt("emulationstation.gamelistviews.max", sMaxGamelistViews));
+  long long budget = (long long)std::max(0, RecalboxConf::Instance().AsInt("emulationstation.gamelistviews.budget", sGamelistViewsBudget)) << 20;
+
+  long long total = 0;
+  for(const auto& footprint : mGameListViewsFootprint) total += footprint.second;
+
+  // Oldest first
+  for(int i = 0; i < (int)mGameListViewsUsage.size(); )
+  {
+    if ((int)mGameListViews.size() <= maxViews && (budget == 0 || total <= budget)) break;
+    SystemData* system = mGameListViewsUsage[i];
+    ISimpleGameListView** view = mGameListViews.try_get(system);
+    if (system == keep || view == nullptr || *view == mCurrentView) { i++; continue; }
+
+    long long* footprint = mGameListViewsFootprint.try_get(system);
+    if (footprint != nullptr) total -= *footprint;
+    { LOG(LogDebug) << "[ViewController] Evicting gamelist view of " << system->FullName() << " (" << (footprint != nullptr ? *footprint >> 10 : 0) << " KB)"; }
+    DeleteGamelistView(system);
+  }
+}
+
+void ViewController::DeleteGamelistView(SystemData* system)
+{
+  ISimpleGameListView** found = mGameListViews.try_get(system);
+  if (found == nullptr) return;
+  ISimpleGameListView* view = *found;
+
+  // Keep only the cursor. Sorts & filters are stored in the configuration
+  mEvictedCursors[system] = view->Count() != 0 ? view->getCursor() : nullptr;
+
+  removeChild(view);
+  mGameListViews.erase(system);
+  mGameListViewsFootprint.erase(system);
+  mInvalidGameList.erase(system);
+  for(int i = (int)mGameListViewsUsage.size(); --i >= 0; )
+    if (mGameListViewsUsage[i] == system)
+    {
+      mGameListViewsUsage.erase(mGameListViewsUsage.begin() + i);
+      break;
+    }
+  delete view;
+}
+
 bool ViewController::ProcessInput(const InputCompactEvent& event)
 {
 	if (mLockInput) return true;
@@ -802,25 +881,34 @@ void ViewController::Render(const Transform4x4f& parentTrans)
 
 bool ViewController::GetOrReCreateGamelistView(SystemData* system, bool reloadTheme)
 {
-  for (auto& it : mGameListViews)
-    if (it.first == system)
-    {
-      ISimpleGameListView* view = it.second;
-      bool isCurrent = (mCurrentView == view);
-      FileData *cursor = view->Count() != 0 ? view->getCursor() : nullptr;
-      mGameListViews.erase(system);
+  ISimpleGameListView** found = mGameListViews.try_get(system);
+  if (found == nullptr) return false;
 
-      if (reloadTheme) system->loadTheme();
+  ISimpleGameListView* view = *found;
+  bool isCurrent = (mCurrentView == view);
+  FileData *cursor = view->Count() != 0 ? view->getCursor() : nullptr;
 
-      if (system->HasVisibleGame())
-      {
-        ISimpleGameListView* newView = GetOrCreateGamelistView(system);
-        newView->setCursor(cursor);
-        if (isCurrent) mCurrentView = newView;
-        mGameListViews[system] = newView;
-        return true;
-      }
-    }
+  if (reloadTheme) system->loadTheme();
+
+  if (system->HasVisibleGame())
+  {
+    DeleteGamelistView(system);
+    mEvictedCursors.erase(system);
+    ISimpleGameListView* newView = GetOrCreateGamelistView(system);
+    newView->setCursor(cursor);
+    if (isCurrent) mCurrentView = newView;
+    return true;
+  }
+
+  // Keep the current view alive until another one is shown
+  if (isCurrent)
+  {
+    mGameListViews.erase(system);
+    mGameListViewsFootprint.erase(system);
+    TouchGamelistView(system);
+    mGameListViewsUsage.pop_back();
+  }
+  else DeleteGamelistView(system);
   return false;
 }
 
@@ -836,9 +924,16 @@ void ViewController::InvalidateGamelist(const SystemData* system)
 
 void ViewController::InvalidateAllGamelistsExcept(const SystemData* systemExclude)
 {
+  // Invalid views are rebuilt when shown: destroy hidden ones right now to free their resources
+  std::vector<SystemData*> hidden;
 	for (auto& mGameListView : mGameListViews)
 		if (systemExclude != (mGameListView.first))
-			mInvalidGameList[mGameListView.first] = true;
+    {
+      if (mGameListView.second == mCurrentView) mInvalidGameList[mGameListView.first] = true;
+      else hidden.push_back(mGameListView.first);
+    }
+  for(SystemData* system : hidden)
+    DeleteGamelistView(system);
 }
 
 bool ViewController::getHelpPrompts(Help& help)
@@ -931,7 +1026,6 @@ void ViewController::ShowSystem(SystemData* system)
   mSystemListView.addSystem(system);
   mSystemListView.Sort();
   InvalidateAllGamelistsExcept(nullptr);
-  GetOrCreateGamelistView(system);
 }
 
 void ViewController::HideSystem(SystemData* system)
@@ -972,6 +1066,7 @@ void ViewController::ToggleFavorite(FileData* game, bool forceStatus, bool force
 {
   // Toggle favorite
   game->Metadata().SetFavorite(forceStatus ? forcedStatus : !game->Metadata().Favorite());
+  SystemData::JournalGame(*game);
 
   // Fire dynamic system refresh
   mSystemManager.UpdateSystemsOnGameChange(game, MetadataType::Favorite, false);
@@ -1055,6 +1150,8 @@ void ViewController::FetchSlowDataFor(FileData* data)
 
 void ViewController::RequestSlowOperation(ISlowSystemOperation* interface, ISlowSystemOperation::List systems, bool autoSelectMonoSystem)
 {
+  // Main thread preparation, before the worker starts
+  if (interface != nullptr) interface->SlowPopulatePrepare(systems);
   String text = systems.Count() > 1 ?
                 _("INITIALIZING SYSTEMS...") :
                 (_F(_("INITIALIZING SYSTEM {0}")) / systems.First()->FullName()).ToString();
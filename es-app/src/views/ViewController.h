@@ -186,6 +186,11 @@ class ViewController : public StaticLifeCycleControler<ViewController>
     void Completed(const DelayedSystemOperationData& parameter, const bool& result) override;
 
   private:
+    //! Default maximum live gamelist views
+    static constexpr int sMaxGamelistViews = 8;
+    //! Default live gamelist views memory budget (MB)
+    static constexpr int sGamelistViewsBudget = 64;
+
     //! Fast menu types
     enum class FastMenuType
     {
@@ -214,7 +219,14 @@ class ViewController : public StaticLifeCycleControler<ViewController>
     // Current system for views dealing with systems (System list/Game list)
     SystemData* mCurrentSystem;
 
+    //! Live gamelist views. Bounded, least recently used views are evicted
     HashMap<SystemData*, ISimpleGameListView*> mGameListViews;
+    //! Live gamelist views usage order, most recently used last
+    std::vector<SystemData*> mGameListViewsUsage;
+    //! Approximate memory footprint of live gamelist views (bytes)
+    HashMap<SystemData*, long long> mGameListViewsFootprint;
+    //! Cursors of evicted gamelist views, restored when views are built again
+    HashMap<SystemData*, FileData*> mEvictedCursors;
     SystemView mSystemListView;
     SplashView mSplashView;
     GameClipView mGameClipView;
@@ -301,6 +313,25 @@ class ViewController : public StaticLifeCycleControler<ViewController>
 
     void playViewTransition();
 
+    /*!
+     * @brief Mark the given gamelist view as the most recently used
+     * @param system View's system
+     */
+    void TouchGamelistView(SystemData* system);
+
+    /*!
+     * @brief Evict least recently used gamelist views until they fit into their count & memory budgets
+     * The current view and the given one are never evicted
+     * @param keep System whose view must be kept
+     */
+    void EvictGamelistViews(SystemData* keep);
+
+    /*!
+     * @brief Destroy a live gamelist view, keeping its cursor so that it can be rebuilt
+     * @param system View's system
+     */
+    void DeleteGamelistView(SystemData* system);
+
     /*
      * IFastMenuLineCallback implementation
      */
@@ -4,6 +4,7 @@
 #include "animations/LambdaAnimation.h"
 #include "scraping/ScraperSeamless.h"
 #include "recalbox/RecalboxStorageWatcher.h"
+#include "games/FileSortEngine.h"
 
 DetailedGameListView::DetailedGameListView(WindowManager&window, SystemManager& systemManager, SystemData& system)
   : ISimpleGameListView(window, systemManager, system)
@@ -49,6 +50,8 @@ void DetailedGameListView::Initialize()
   addChild(&mList);
 
   mEmptyListItem.Metadata().SetName(_("YOUR LIST IS EMPTY. PRESS START TO CHANGE GAME FILTERS."));
+  // Names are built only when entries are displayed or looked up
+  mList.setNameProvider([this](FileData* const& item) { return GetDisplayName(*item); });
   populateList(mSystem.MasterRoot());
 
   mList.setCursorChangedCallback([this](const CursorState& state)
@@ -634,6 +637,7 @@ void DetailedGameListView::Update(int deltatime)
     int f = mFadeBetweenImage < 0 ? 0 : mFadeBetweenImage;
     mImage.setOpacity(255 - f);
     mNoImage.setOpacity(f);
+    mWindow.Invalidate();
   }
 
   // Cancel video
@@ -846,7 +850,7 @@ void DetailedGameListView::populateList(const FolderData& folder)
                             FileSorts::SortSets::SingleSystem;
   FileSorts::Sorts sort = mSystem.IsSelfSorted() ? mSystem.FixedSort() :
                           FileSorts::Clamp(RecalboxConf::Instance().GetSystemSort(mSystem), set);
-  FolderData::Sort(items, FileSorts::Comparer(sort), FileSorts::IsAscending(sort));
+  FileSortEngine::Sort(items, sort, &folder, (int)includesFilter | (flatfolders ? 0x100 : 0));
 
   // Region filtering?
   Regions::GameRegions currentRegion = Regions::Clamp((Regions::GameRegions)RecalboxConf::Instance().GetSystemRegionFilter(mSystem));
@@ -866,7 +870,7 @@ void DetailedGameListView::populateList(const FolderData& folder)
   bool onlyTate = RecalboxConf::Instance().GetTateOnly();
 
   // Add to list
-  //mList.reserve(items.size()); // TODO: Reserve memory once
+  mList.reserve((int)items.size());
   for (FileData* fd : items)
   {
     // Region filtering?
@@ -877,7 +881,7 @@ void DetailedGameListView::populateList(const FolderData& folder)
     // Tate filtering
     if (onlyTate && fd->Metadata().Rotation() == RotationType::None) continue;
     // Store
-    mList.add(GetDisplayName(*fd), fd, colorIndexOffset + (fd->IsFolder() ? 1 : 0), false);
+    mList.addLazy(fd, colorIndexOffset + (fd->IsFolder() ? 1 : 0));
   }
 }
 
@@ -47,6 +47,27 @@ class IRouter
      */
     virtual void SystemInfo(const Rest::Request& request, Http::ResponseWriter response) = 0;
 
+    /*!
+     * @brief Handle GET startup profile
+     * @param request Request object
+     * @param response Response object
+     */
+    virtual void StartupProfile(const Rest::Request& request, Http::ResponseWriter response) = 0;
+
+    /*!
+     * @brief Handle GET GPU memory statistics
+     * @param request Request object
+     * @param response Response object
+     */
+    virtual void GpuMemoryStatistics(const Rest::Request& request, Http::ResponseWriter response) = 0;
+
+    /*!
+     * @brief Handle GET rom hashing statistics
+     * @param request Request object
+     * @param response Response object
+     */
+    virtual void HashingStatistics(const Rest::Request& request, Http::ResponseWriter response) = 0;
+
     /*!
      * @brief Handle GET storage information
      * @param request Request object
@@ -82,6 +103,20 @@ class IRouter
      */
     virtual void BiosGetSystem(const Rest::Request& request, Http::ResponseWriter response) = 0;
 
+    /*!
+     * @brief Handle GET arcade romset verification report
+     * @param request Request object
+     * @param response Response object
+     */
+    virtual void ArcadeVerificationGet(const Rest::Request& request, Http::ResponseWriter response) = 0;
+
+    /*!
+     * @brief Handle POST start arcade romset verification
+     * @param request Request object
+     * @param response Response object
+     */
+    virtual void ArcadeVerificationStart(const Rest::Request& request, Http::ResponseWriter response) = 0;
+
     /*!
      * @brief Handle GET get all systems
      * @param request Request object
@@ -241,12 +276,18 @@ class IRouter
       Rest::Routes::Get(mRouter, "/api/architecture", Rest::Routes::bind(&IRouter::Architecture, this));
       // Monitoring
       Rest::Routes::Get(mRouter, "/api/monitoring/systeminfo", Rest::Routes::bind(&IRouter::SystemInfo, this));
+      Rest::Routes::Get(mRouter, "/api/monitoring/startup", Rest::Routes::bind(&IRouter::StartupProfile, this));
+      Rest::Routes::Get(mRouter, "/api/monitoring/gpumemory", Rest::Routes::bind(&IRouter::GpuMemoryStatistics, this));
+      Rest::Routes::Get(mRouter, "/api/monitoring/hashing", Rest::Routes::bind(&IRouter::HashingStatistics, this));
       Rest::Routes::Get(mRouter, "/api/monitoring/storageinfo", Rest::Routes::bind(&IRouter::StorageInfo, this));
       // Bios
       Rest::Routes::Get(mRouter, "/api/bios", Rest::Routes::bind(&IRouter::BiosGetAll, this));
       Rest::Routes::Get(mRouter, "/api/bios/get/*", Rest::Routes::bind(&IRouter::BiosGetSystem, this));
       Rest::Routes::Get(mRouter, "/api/bios/download", Rest::Routes::bind(&IRouter::BiosDownload, this));
       Rest::Routes::Post(mRouter, "/api/bios/upload/*", Rest::Routes::bind(&IRouter::BiosUpload, this));
+      // Arcade
+      Rest::Routes::Get(mRouter, "/api/arcade/verification", Rest::Routes::bind(&IRouter::ArcadeVerificationGet, this));
+      Rest::Routes::Post(mRouter, "/api/arcade/verification", Rest::Routes::bind(&IRouter::ArcadeVerificationStart, this));
       // Systems
       Rest::Routes::Get(mRouter, "/api/systems", Rest::Routes::bind(&IRouter::SystemsGetAll, this));
       Rest::Routes::Get(mRouter, "/api/systems/getactives", Rest::Routes::bind(&IRouter::SystemsGetActives, this));
@@ -7,6 +7,8 @@
 #include <utils/json/JSONBuilder.h>
 #include <systems/SystemDeserializer.h>
 #include <utils/datetime/DateTime.h>
+#include <utils/profiling/StartupProfiler.h>
+#include <resources/GpuMemory.h>
 #include "RequestHandler.h"
 #include "Mime.h"
 #include "RequestHandlerTools.h"
@@ -25,12 +27,14 @@ void RequestHandler::FileServer(const Rest::Request& request, Http::ResponseWrit
   const Pistache::Http::Mime::MediaType& mimeType = knownMime ? Mime::ExtToMIME[ext] : Mime::BinaryFile;
   if (!knownMime)
     LOG(LogWarning) << "Unknown MIME Type for file extension: " << ext;
-  RequestHandlerTools::SendResource(path, response, mimeType);
+  // Only fingerprinted assets are immutable. Everything else is revalidated using its ETag
+  ResponseCache::SendStaticFile(request, response, path, mimeType, ResponseCache::IsFingerprinted(path));
 }
 
 void RequestHandler::Versions(const Rest::Request& request, Http::ResponseWriter response)
 {
   RequestHandlerTools::LogRoute(request, "Versions");
+  if (mResponseCache.SendCached(request, response, "versions")) return;
 
   // Get libretro cores
   std::map<String, String> cores;
@@ -60,7 +64,9 @@ void RequestHandler::Versions(const Rest::Request& request, Http::ResponseWriter
       .CloseObject()
       .Close();
 
-  RequestHandlerTools::Send(response, Http::Code::Ok, json, Mime::Json);
+  // Versions only change on updates or core installations
+  mResponseCache.Send(request, response, "versions", json, Mime::Json, ResponseCache::Dependency::None, 0,
+                      { Path("/recalbox/share/system/configs/retroarch.corenames"), Path("/recalbox/recalbox.version") });
 }
 
 void RequestHandler::Architecture(const Rest::Request& request, Http::ResponseWriter response)
@@ -93,9 +99,31 @@ void RequestHandler::SystemInfo(const Rest::Request& request, Http::ResponseWrit
   RequestHandlerTools::Send(response, Http::Code::Ok, sysInfo, Mime::Json);
 }
 
+void RequestHandler::StartupProfile(const Rest::Request& request, Http::ResponseWriter response)
+{
+  RequestHandlerTools::LogRoute(request, "StartupProfile");
+
+  RequestHandlerTools::Send(response, Http::Code::Ok, StartupProfiler::Report(), Mime::Json);
+}
+
+void RequestHandler::GpuMemoryStatistics(const Rest::Request& request, Http::ResponseWriter response)
+{
+  RequestHandlerTools::LogRoute(request, "GpuMemoryStatistics");
+
+  RequestHandlerTools::Send(response, Http::Code::Ok, GpuMemory::Report(), Mime::Json);
+}
+
+void RequestHandler::HashingStatistics(const Rest::Request& request, Http::ResponseWriter response)
+{
+  RequestHandlerTools::LogRoute(request, "HashingStatistics");
+
+  RequestHandlerTools::Send(response, Http::Code::Ok, mSystemManager.HashingReport(), Mime::Json);
+}
+
 void RequestHandler::StorageInfo(const Rest::Request& request, Http::ResponseWriter response)
 {
   RequestHandlerTools::LogRoute(request, "StorageInfo");
+  if (mResponseCache.SendCached(request, response, "storages")) return;
 
   String::List lines = RequestHandlerTools::OutputLinesOf("df -T");
   JSONBuilder result;
@@ -121,7 +149,8 @@ void RequestHandler::StorageInfo(const Rest::Request& request, Http::ResponseWri
   }
   result.CloseObject()
         .Close();
-  RequestHandlerTools::Send(response, Http::Code::Ok, result, Mime::Json);
+  // Free space does not need to be more accurate than this
+  mResponseCache.Send(request, response, "storages", result, Mime::Json, ResponseCache::Dependency::None, sStorageLifetime);
 }
 
 void RequestHandler::BiosDownload(const Rest::Request& request, Http::ResponseWriter response)
@@ -224,9 +253,28 @@ void RequestHandler::BiosGetSystem(const Rest::Request& request, Http::ResponseW
     RequestHandlerTools::Error404(response);
 }
 
+void RequestHandler::ArcadeVerificationGet(const Rest::Request& request, Http::ResponseWriter response)
+{
+  RequestHandlerTools::LogRoute(request, "ArcadeVerificationGet");
+
+  RequestHandlerTools::Send(response, Http::Code::Ok, mSystemManager.RomsetVerificationReport(), Mime::Json);
+}
+
+void RequestHandler::ArcadeVerificationStart(const Rest::Request& request, Http::ResponseWriter response)
+{
+  RequestHandlerTools::LogRoute(request, "ArcadeVerificationStart");
+
+  // Verification runs in the background: the report is available through GET
+  if (mSystemManager.StartRomsetVerification())
+    RequestHandlerTools::Send(response, Http::Code::Accepted, mSystemManager.RomsetVerificationReport(), Mime::Json);
+  else
+    RequestHandlerTools::Send(response, Http::Code::Conflict, mSystemManager.RomsetVerificationReport(), Mime::Json);
+}
+
 void RequestHandler::SystemsGetAll(const Rest::Request& request, Http::ResponseWriter response)
 {
   RequestHandlerTools::LogRoute(request, "SystemsGetAll");
+  if (mResponseCache.SendCached(request, response, "systems")) return;
 
   JSONBuilder systems;
   systems.Open()
@@ -273,7 +321,8 @@ void RequestHandler::SystemsGetAll(const Rest::Request& request, Http::ResponseW
 
   systems.CloseObject()
          .Close();
-  RequestHandlerTools::Send(response, Http::Code::Ok, systems, Mime::Json);
+  mResponseCache.Send(request, response, "systems", systems, Mime::Json, ResponseCache::Dependency::Systems, 0,
+                      { SystemDeserializer::TemplateConfigurationPath(), SystemDeserializer::UserConfigurationPath() });
 }
 
 void RequestHandler::SystemsGetActives(const Rest::Request& request, Http::ResponseWriter response)
@@ -337,7 +386,10 @@ void RequestHandler::ConfigurationGet(const Rest::Request& request, Http::Respon
   if (keys.empty())
     RequestHandlerTools::Error404(response);
 
-  RequestHandlerTools::GetKeyValues(ns, keys, response);
+  String key("configuration."); key.Append(ns);
+  if (mResponseCache.SendCached(request, response, key)) return;
+  mResponseCache.Send(request, response, key, RequestHandlerTools::BuildKeyValues(ns, keys), Mime::Json,
+                      ResponseCache::Dependency::Configuration, 0, { Path(RequestHandlerTools::sConfiguration) });
 }
 
 void RequestHandler::ConfigurationOptions(const Rest::Request& request, Http::ResponseWriter response)
@@ -362,6 +414,8 @@ void RequestHandler::ConfigurationSet(const Rest::Request& request, Http::Respon
     RequestHandlerTools::Error404(response);
 
   RequestHandlerTools::SetKeyValues(ns, keys, request.body(), response);
+  // Invalidate once written, so that no request may cache the previous configuration again
+  mResponseCache.Invalidate(ResponseCache::Dependency::Configuration);
 }
 
 void RequestHandler::ConfigurationDelete(const Rest::Request& request, Http::ResponseWriter response)
@@ -374,6 +428,8 @@ void RequestHandler::ConfigurationDelete(const Rest::Request& request, Http::Res
     RequestHandlerTools::Error404(response);
 
   RequestHandlerTools::DeleteKeyValues(ns, keys, request.body(), response);
+  // Invalidate once written, so that no request may cache the previous configuration again
+  mResponseCache.Invalidate(ResponseCache::Dependency::Configuration);
 }
 
 void RequestHandler::SystemConfigurationGet(const Rest::Request& request, Http::ResponseWriter response)
@@ -390,7 +446,10 @@ void RequestHandler::SystemConfigurationGet(const Rest::Request& request, Http::
   if (keys.empty())
     RequestHandlerTools::Error404(response);
 
-  RequestHandlerTools::GetKeyValues(subSystem, keys, response);
+  String key("system."); key.Append(subSystem);
+  if (mResponseCache.SendCached(request, response, key)) return;
+  mResponseCache.Send(request, response, key, RequestHandlerTools::BuildKeyValues(subSystem, keys), Mime::Json,
+                      ResponseCache::Dependency::Configuration, 0, { Path(RequestHandlerTools::sConfiguration) });
 }
 
 void RequestHandler::SystemConfigurationSet(const Rest::Request& request, Http::ResponseWriter response)
@@ -408,6 +467,8 @@ void RequestHandler::SystemConfigurationSet(const Rest::Request& request, Http::
     RequestHandlerTools::Error404(response);
 
   RequestHandlerTools::SetKeyValues(subSystem, keys, request.body(), response);
+  // Invalidate once written, so that no request may cache the previous configuration again
+  mResponseCache.Invalidate(ResponseCache::Dependency::Configuration);
 }
 
 void RequestHandler::SystemConfigurationOptions(const Rest::Request& request, Http::ResponseWriter response)
@@ -442,6 +503,8 @@ void RequestHandler::SystemConfigurationDelete(const Rest::Request& request, Htt
     RequestHandlerTools::Error404(response);
 
   RequestHandlerTools::DeleteKeyValues(subSystem, keys, request.body(), response);
+  // Invalidate once written, so that no request may cache the previous configuration again
+  mResponseCache.Invalidate(ResponseCache::Dependency::Configuration);
 }
 
 void RequestHandler::MediaOptions(const Rest::Request& request, Http::ResponseWriter response)
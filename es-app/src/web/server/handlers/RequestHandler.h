@@ -8,11 +8,15 @@
 #include <bios/BiosManager.h>
 #include <mqtt/MqttClient.h>
 #include <web/server/handlers/providers/EmulationStationWatcher.h>
+#include <web/server/handlers/ResponseCache.h>
 #include "systems/SystemManager.h"
 
 class RequestHandler : public IRouter
 {
   private:
+    //! Storage information lifetime (seconds)
+    static constexpr int sStorageLifetime = 30;
+
     //! Bios Manager
     BiosManager& mBiosManager;
     //! SystemManager reference
@@ -21,6 +25,8 @@ class RequestHandler : public IRouter
     SysInfos mSysInfos;
     //! Event watcher
     EmulationStationWatcher mWatcher;
+    //! Costly responses
+    ResponseCache mResponseCache;
 
     //! WWW root
     Path mWWWRoot;
@@ -74,6 +80,27 @@ class RequestHandler : public IRouter
      */
     void SystemInfo(const Rest::Request& request, Http::ResponseWriter response) override;
 
+    /*!
+     * @brief Handle GET startup profile
+     * @param request Request object
+     * @param response Response object
+     */
+    void StartupProfile(const Rest::Request& request, Http::ResponseWriter response) override;
+
+    /*!
+     * @brief Handle GET GPU memory statistics
+     * @param request Request object
+     * @param response Response object
+     */
+    void GpuMemoryStatistics(const Rest::Request& request, Http::ResponseWriter response) override;
+
+    /*!
+     * @brief Handle GET rom hashing statistics
+     * @param request Request object
+     * @param response Response object
+     */
+    void HashingStatistics(const Rest::Request& request, Http::ResponseWriter response) override;
+
     /*!
      * @brief Handle GET version
      * @param request Request object
@@ -109,6 +136,20 @@ class RequestHandler : public IRouter
      */
     void BiosGetSystem(const Rest::Request& request, Http::ResponseWriter response) override;
 
+    /*!
+     * @brief Handle GET arcade romset verification report
+     * @param request Request object
+     * @param response Response object
+     */
+    void ArcadeVerificationGet(const Rest::Request& request, Http::ResponseWriter response) override;
+
+    /*!
+     * @brief Handle POST start arcade romset verification
+     * @param request Request object
+     * @param response Response object
+     */
+    void ArcadeVerificationStart(const Rest::Request& request, Http::ResponseWriter response) override;
+
     /*!
      * @brief Handle GET get all systems
      * @param request Request object
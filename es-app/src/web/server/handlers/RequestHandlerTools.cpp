@@ -729,6 +729,11 @@ void RequestHandlerTools::SaveConfiguration(IniFile& configuration)
 }
 
 void RequestHandlerTools::GetKeyValues(const String& domain, const HashMap<String, Validator>& keys, Http::ResponseWriter& response)
+{
+  RequestHandlerTools::Send(response, Http::Code::Ok, BuildKeyValues(domain, keys), Mime::Json);
+}
+
+String RequestHandlerTools::BuildKeyValues(const String& domain, const HashMap<String, Validator>& keys)
 {
   IniFile configuration = RequestHandlerTools::LoadConfiguration();
   JSONBuilder result;
@@ -753,7 +758,7 @@ void RequestHandlerTools::GetKeyValues(const String& domain, const HashMap<Strin
     result.Field(key.first.c_str(), value);
   }
   result.Close();
-  RequestHandlerTools::Send(response, Http::Code::Ok, result, Mime::Json);
+  return result;
 }
 
 void RequestHandlerTools::GetKeyValueOptions(const HashMap<String, Validator>& keys, Http::ResponseWriter& response)
@@ -244,6 +244,14 @@ class RequestHandlerTools
      */
     static void GetKeyValues(const String& domain, const HashMap<String, Validator>& keys, Pistache::Http::ResponseWriter& response);
 
+    /*!
+     * @brief Get all configuration values from the given keys of the given domain as a JSON object
+     * @param domain Namespace/Domain
+     * @param keys Key/Validator collection
+     * @return JSON object
+     */
+    static String BuildKeyValues(const String& domain, const HashMap<String, Validator>& keys);
+
     /*!
      * @brief Get all configuration options from the given keys and build
      * a JSON object. Then send them all back to the caller using the response object
@@ -0,0 +1,215 @@
+#include "ResponseCache.h"
+#include "RequestHandlerTools.h"
+#include <utils/hash/Crc32.h>
+#include <sys/stat.h>
+#include <ctime>
+
+using namespace Pistache;
+
+void ResponseCache::GetStamp(const Path& path, long long& size, long long& time)
+{
+  struct stat64 info {};
+  if (stat64(path.ToChars(), &info) != 0) { size = -1; time = 0; return; }
+  size = info.st_size;
+  time = (long long)info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+}
+
+String ResponseCache::HttpDate(long long time)
+{
+  time_t t = (time_t)time;
+  struct tm utc {};
+  gmtime_r(&t, &utc);
+  char buffer[64];
+  strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &utc);
+  return String(buffer);
+}
+
+bool ResponseCache::AcceptsEncoding(const Rest::Request& request, const char* encoding)
+{
+  std::optional<Http::Header::Raw> accept = request.headers().tryGetRaw("Accept-Encoding");
+  if (!accept) return false;
+  for(const String& item : String(accept->value()).Split(','))
+  {
+    String name;
+    String parameters;
+    if (!item.Extract(';', name, parameters, true)) name = String(item).Trim();
+    if (name == encoding)
+    {
+      int q = parameters.Find("q=");
+      return q < 0 || parameters.AsFloat(q + 2) > 0.f;
+    }
+  }
+  return false;
+}
+
+bool ResponseCache::NotModified(const Rest::Request& request, const String& etag, const String& lastModified)
+{
+  // If-None-Match takes precedence over If-Modified-Since (RFC 7232)
+  if (std::optional<Http::Header::Raw> match = request.headers().tryGetRaw("If-None-Match"); match)
+  {
+    for(const String& item : String(match->value()).Split(','))
+    {
+      String tag = String(item).Trim();
+      if (tag == "*" || tag == etag || (tag.StartsWith("W/") && tag.SubString(2) == etag)) return true;
+    }
+    return false;
+  }
+  if (std::optional<Http::Header::Raw> since = request.headers().tryGetRaw("If-Modified-Since"); since)
+    return String(since->value()).Trim() == lastModified;
+  return false;
+}
+
+void ResponseCache::SetValidators(Http::ResponseWriter& response, const String& etag, const String& lastModified, const char* cacheControl)
+{
+  response.headers().addRaw(Http::Header::Raw("ETag", etag))
+                    .addRaw(Http::Header::Raw("Last-Modified", lastModified))
+                    .addRaw(Http::Header::Raw("Cache-Control", cacheControl));
+}
+
+bool ResponseCache::SendCached(const Rest::Request& request, Http::ResponseWriter& response, const String& key)
+{
+  String body;
+  Http::Mime::MediaType mime;
+  String etag;
+  String lastModified;
+  bool notModified = false;
+  {
+    Mutex::AutoLock locker(mLocker);
+    Entry* entry = mEntries.try_get(key);
+    if (entry == nullptr) return false;
+
+    // Expired or built from outdated files?
+    bool valid = entry->Expiration == 0 || (long long)time(nullptr) < entry->Expiration;
+    for(const Source& source : entry->Sources)
+    {
+      if (!valid) break;
+      long long size = 0;
+      long long stamp = 0;
+      GetStamp(source.File, size, stamp);
+      valid = size == source.Size && stamp == source.Time;
+    }
+    if (!valid)
+    {
+      mEntries.erase(key);
+      return false;
+    }
+
+    etag = entry->ETag;
+    lastModified = entry->LastModified;
+    notModified = NotModified(request, etag, lastModified);
+    if (!notModified)
+    {
+      body = entry->Body;
+      mime = entry->Mime;
+    }
+  }
+
+  SetValidators(response, etag, lastModified, "no-cache");
+  if (notModified) RequestHandlerTools::Send(response, Http::Code::Not_Modified);
+  else RequestHandlerTools::Send(response, Http::Code::Ok, body, mime);
+  return true;
+}
+
+void ResponseCache::Send(const Rest::Request& request, Http::ResponseWriter& response, const String& key,
+                         const String& body, const Http::Mime::MediaType& mime, Dependency dependency, int lifetime,
+                         const Path::PathList& sources)
+{
+  long long now = (long long)time(nullptr);
+  Entry entry
+  {
+    body,
+    mime,
+    String('"').AppendHexa(crc32_16bytes(body.data(), body.size()), 8, String::Hexa::None).Append('-').AppendHexa((int)body.size(), String::Hexa::None).Append('"'),
+    HttpDate(now),
+    dependency,
+    lifetime > 0 ? now + lifetime : 0,
+    {},
+  };
+  for(const Path& source : sources)
+  {
+    Source stamp { source, 0, 0 };
+    GetStamp(source, stamp.Size, stamp.Time);
+    entry.Sources.push_back(stamp);
+  }
+
+  // Same body as the previous build? Keep validators so that clients still get 304s
+  bool notModified = false;
+  {
+    Mutex::AutoLock locker(mLocker);
+    if (Entry* previous = mEntries.try_get(key); previous != nullptr && previous->ETag == entry.ETag)
+      entry.LastModified = previous->LastModified;
+    notModified = NotModified(request, entry.ETag, entry.LastModified);
+    SetValidators(response, entry.ETag, entry.LastModified, "no-cache");
+    mEntries[key] = std::move(entry);
+  }
+
+  if (notModified) RequestHandlerTools::Send(response, Http::Code::Not_Modified);
+  else RequestHandlerTools::Send(response, Http::Code::Ok, body, mime);
+}
+
+void ResponseCache::Invalidate(Dependency dependency)
+{
+  Mutex::AutoLock locker(mLocker);
+  for(auto it = mEntries.begin(); it != mEntries.end(); )
+    if (it->second.Group == dependency) it = mEntries.erase(it);
+    else ++it;
+}
+
+bool ResponseCache::IsFingerprinted(const Path& path)
+{
+  // Look for a hash-like part, after the first one: at least 8 letters/digits, mixing digits with letters
+  String name = path.FilenameWithoutExtension();
+  int start = -1;
+  for(int i = 0; i <= (int)name.size(); ++i)
+    if (i == (int)name.size() || name[i] == '.' || name[i] == '-' || name[i] == '_')
+    {
+      if (start >= 0 && i - start >= 8)
+      {
+        bool digits = false;
+        bool letters = false;
+        bool valid = true;
+        for(int c = start; c < i && valid; ++c)
+          if (name[c] >= '0' && name[c] <= '9') digits = true;
+          else if ((name[c] >= 'a' && name[c] <= 'z') || (name[c] >= 'A' && name[c] <= 'Z')) letters = true;
+          else valid = false;
+        if (valid && digits && letters) return true;
+      }
+      start = i + 1;
+    }
+  return false;
+}
+
+void ResponseCache::SendStaticFile(const Rest::Request& request, Http::ResponseWriter& response, const Path& path,
+                                   const Http::Mime::MediaType& mime, bool immutable)
+{
+  // Pick the smallest available representation
+  Path file = path;
+  const char* encoding = nullptr;
+  if (AcceptsEncoding(request, "br") && Path(path.ToString() + ".br").Exists()) { file = Path(path.ToString() + ".br"); encoding = "br"; }
+  else if (AcceptsEncoding(request, "gzip") && Path(path.ToString() + ".gz").Exists()) { file = Path(path.ToString() + ".gz"); encoding = "gzip"; }
+
+  long long size = 0;
+  long long stamp = 0;
+  GetStamp(file, size, stamp);
+  if (size < 0)
+  {
+    RequestHandlerTools::Error404(response);
+    return;
+  }
+
+  String etag = String('"').AppendHexa(size, String::Hexa::None).Append('-').AppendHexa(stamp, String::Hexa::None);
+  if (encoding != nullptr) etag.Append('-').Append(encoding);
+  etag.Append('"');
+  String lastModified = HttpDate(stamp / 1000000000LL);
+
+  SetValidators(response, etag, lastModified, immutable ? String("public, max-age=").Append(sImmutableLifetime).Append(", immutable").c_str() : "no-cache");
+  response.headers().addRaw(Http::Header::Raw("Vary", "Accept-Encoding"));
+  if (NotModified(request, etag, lastModified))
+  {
+    RequestHandlerTools::Send(response, Http::Code::Not_Modified);
+    return;
+  }
+  if (encoding != nullptr)
+    response.headers().addRaw(Http::Header::Raw("Content-Encoding", encoding));
+  RequestHandlerTools::SendResource(file, response, mime);
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <pistache/include/pistache/http.h>
+#include <pistache/include/pistache/router.h>
+#include <utils/os/fs/Path.h>
+#include <utils/os/system/Mutex.h>
+#include <utils/storage/HashMap.h>
+#include <vector>
+
+/*!
+ * @brief Web API response cache
+ *
+ * Responses are kept until they expire, until one of the files they are built from changes,
+ * or until their dependency is invalidated. All responses carry ETag & Last-Modified validators
+ * so that polling clients get a body-less 304 as long as nothing changed.
+ * Thread safe.
+ */
+class ResponseCache
+{
+  public:
+    //! Invalidation groups
+    enum class Dependency
+    {
+      None,          //!< Only expires
+      Configuration, //!< recalbox.conf changes
+      Systems,       //!< System list changes
+    };
+
+    /*!
+     * @brief Send the cached response of the given key, if any
+     * @param request Request object
+     * @param response Response object
+     * @param key Response key
+     * @return True if a response (200 or 304) has been sent, false if the response must be built
+     */
+    bool SendCached(const Pistache::Rest::Request& request, Pistache::Http::ResponseWriter& response, const String& key);
+
+    /*!
+     * @brief Store a freshly built response, then send it
+     * @param request Request object
+     * @param response Response object
+     * @param key Response key
+     * @param body Response body
+     * @param mime MIME type
+     * @param dependency Invalidation group
+     * @param lifetime Lifetime in seconds, 0 for no expiration
+     * @param sources Files the response is built from
+     */
+    void Send(const Pistache::Rest::Request& request, Pistache::Http::ResponseWriter& response, const String& key,
+              const String& body, const Pistache::Http::Mime::MediaType& mime, Dependency dependency, int lifetime,
+              const Path::PathList& sources = Path::PathList());
+
+    /*!
+     * @brief Drop all responses of the given invalidation group
+     * @param dependency Invalidation group
+     */
+    void Invalidate(Dependency dependency);
+
+    /*!
+     * @brief Send a static file with validators & cache headers, precompressed if the client accepts it
+     * Precompressed files (.br, .gz) must be generated next to the original file
+     * @param request Request object
+     * @param response Response object
+     * @param path File path
+     * @param mime MIME type of the original file
+     * @param immutable True to let clients keep the file for a long time, false to make them revalidate it
+     */
+    static void SendStaticFile(const Pistache::Rest::Request& request, Pistache::Http::ResponseWriter& response,
+                               const Path& path, const Pistache::Http::Mime::MediaType& mime, bool immutable);
+
+    /*!
+     * @brief Check if a file name holds a content hash, as build tools do (app.3f2a9c1b.js, index-BXk3sD2q.css)
+     * Only such files may be served as immutable: any content change changes their name
+     * @param path File path
+     * @return True if the file name is fingerprinted
+     */
+    static bool IsFingerprinted(const Path& path);
+
+  private:
+    //! Immutable static files lifetime (seconds)
+    static constexpr int sImmutableLifetime = 365 * 24 * 3600;
+
+    //! Source file stamp
+    struct Source
+    {
+      Path File;      //!< File path
+      long long Size; //!< Size, -1 if missing
+      long long Time; //!< Modification time (ns)
+    };
+
+    //! Cached response
+    struct Entry
+    {
+      String Body;                          //!< Body
+      Pistache::Http::Mime::MediaType Mime; //!< MIME type
+      String ETag;                          //!< Entity tag
+      String LastModified;                  //!< Build date
+      Dependency Group;                     //!< Invalidation group
+      long long Expiration;                 //!< Expiration time (s), 0 for none
+      std::vector<Source> Sources;          //!< Source files
+    };
+
+    //! Responses
+    HashMap<String, Entry> mEntries;
+    //! Protect responses
+    Mutex mLocker;
+
+    /*!
+     * @brief Check request validators
+     * @param request Request object
+     * @param etag Current entity tag
+     * @param lastModified Current modification date
+     * @return True if the client copy is still valid
+     */
+    static bool NotModified(const Pistache::Rest::Request& request, const String& etag, const String& lastModified);
+
+    /*!
+     * @brief Add validators & cache headers to the response
+     * @param response Response object
+     * @param etag Entity tag
+     * @param lastModified Modification date
+     * @param cacheControl Cache-Control header value
+     */
+    static void SetValidators(Pistache::Http::ResponseWriter& response, const String& etag, const String& lastModified, const char* cacheControl);
+
+    /*!
+     * @brief Get size & modification time of a file
+     * @param path File path
+     * @param size Output size, -1 if the file does not exist
+     * @param time Output modification time (ns)
+     */
+    static void GetStamp(const Path& path, long long& size, long long& time);
+
+    /*!
+     * @brief Format an HTTP date
+     * @param time Epoch time (s)
+     * @return RFC 7231 date
+     */
+    static String HttpDate(long long time);
+
+    /*!
+     * @brief Check if the client accepts the given encoding
+     * @param request Request object
+     * @param encoding Encoding name
+     * @return True if the encoding is listed in Accept-Encoding
+     */
+    static bool AcceptsEncoding(const Pistache::Rest::Request& request, const char* encoding);
+};
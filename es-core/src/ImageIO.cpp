@@ -1,8 +1,21 @@
 #include "ImageIO.h"
 #include <utils/Log.h>
 #include <FreeImage.h>
+#include <algorithm>
 
-std::vector<unsigned char> ImageIO::loadFromMemoryRGBA32(const unsigned char * data, const size_t size, size_t & width, size_t & height)
+void ImageIO::fitSize(size_t width, size_t height, size_t maxWidth, size_t maxHeight, size_t & fitWidth, size_t & fitHeight)
+{
+  fitWidth = width;
+  fitHeight = height;
+  if (maxWidth == 0 || maxHeight == 0 || width == 0 || height == 0) return;
+  if (width <= maxWidth && height <= maxHeight) return;
+
+  double scale = std::min((double)maxWidth / (double)width, (double)maxHeight / (double)height);
+  fitWidth = std::max((size_t)1, (size_t)((double)width * scale + 0.5));
+  fitHeight = std::max((size_t)1, (size_t)((double)height * scale + 0.5));
+}
+
+std::vector<unsigned char> ImageIO::loadFromMemoryRGBA32(const unsigned char * data, const size_t size, size_t & width, size_t & height, size_t maxWidth, size_t maxHeight)
 {
 	std::vector<unsigned char> rawData;
 	width = 0;
@@ -18,7 +31,9 @@ std::vector<unsigned char> ImageIO::loadFromMemoryRGBA32(const unsigned char * d
       if (format != FIF_UNKNOWN && (FreeImage_FIFSupportsReading(format) != 0))
       {
         //file type is supported. load image
-        FIBITMAP* fiBitmap = FreeImage_LoadFromMemory(format, fiMemory);
+        // JPEG can be decoded directly at a reduced scale (at least the requested size)
+        int flags = (format == FIF_JPEG && maxWidth != 0 && maxHeight != 0) ? (int)(std::max(maxWidth, maxHeight) << 16) : 0;
+        FIBITMAP* fiBitmap = FreeImage_LoadFromMemory(format, fiMemory, flags);
         if (fiBitmap != nullptr)
         {
           //loaded. convert to 32bit if necessary
@@ -32,6 +47,18 @@ std::vector<unsigned char> ImageIO::loadFromMemoryRGBA32(const unsigned char * d
               fiBitmap = fiConverted;
             }
           }
+          // scale down to the requested size
+          size_t fitWidth = 0, fitHeight = 0;
+          fitSize(FreeImage_GetWidth(fiBitmap), FreeImage_GetHeight(fiBitmap), maxWidth, maxHeight, fitWidth, fitHeight);
+          if (fitWidth != FreeImage_GetWidth(fiBitmap) || fitHeight != FreeImage_GetHeight(fiBitmap))
+          {
+            FIBITMAP* fiScaled = FreeImage_Rescale(fiBitmap, (int)fitWidth, (int)fitHeight, FILTER_BILINEAR);
+            if (fiScaled != nullptr)
+            {
+              FreeImage_Unload(fiBitmap);
+              fiBitmap = fiScaled;
+            }
+          }
           width = FreeImage_GetWidth(fiBitmap);
           height = FreeImage_GetHeight(fiBitmap);
           // loop through scanlines and add all pixel data to the return vector
@@ -86,6 +113,31 @@ std::vector<unsigned char> ImageIO::loadFromMemoryRGBA32(const unsigned char * d
 	return rawData;
 }
 
+bool ImageIO::loadSizeFromMemory(const unsigned char * data, const size_t size, size_t & width, size_t & height)
+{
+  width = 0;
+  height = 0;
+
+  FIMEMORY* fiMemory = FreeImage_OpenMemory((BYTE*) data, (DWORD) size);
+  if (fiMemory == nullptr) return false;
+
+  // Read header only
+  FREE_IMAGE_FORMAT format = FreeImage_GetFileTypeFromMemory(fiMemory);
+  if (format != FIF_UNKNOWN && (FreeImage_FIFSupportsReading(format) != 0) && (FreeImage_FIFSupportsNoPixels(format) != 0))
+  {
+    FIBITMAP* fiBitmap = FreeImage_LoadFromMemory(format, fiMemory, FIF_LOAD_NOPIXELS);
+    if (fiBitmap != nullptr)
+    {
+      width = FreeImage_GetWidth(fiBitmap);
+      height = FreeImage_GetHeight(fiBitmap);
+      FreeImage_Unload(fiBitmap);
+    }
+  }
+  FreeImage_CloseMemory(fiMemory);
+
+  return (width != 0) && (height != 0);
+}
+
 void ImageIO::flipPixelsVert(unsigned char* imagePx, const size_t& width, const size_t& height)
 {
 	unsigned int* arr = (unsigned int*)imagePx;
@@ -5,6 +5,10 @@
 class ImageIO
 {
 public:
-	static std::vector<unsigned char> loadFromMemoryRGBA32(const unsigned char * data, size_t size, size_t & width, size_t & height);
+	// Decode an image. If maxWidth & maxHeight are set, the image is scaled down to fit, keeping its aspect ratio
+	static std::vector<unsigned char> loadFromMemoryRGBA32(const unsigned char * data, size_t size, size_t & width, size_t & height, size_t maxWidth = 0, size_t maxHeight = 0);
+	// Compute the size of an image scaled down to fit the given box. Images smaller than the box are left unchanged
+	static void fitSize(size_t width, size_t height, size_t maxWidth, size_t maxHeight, size_t & fitWidth, size_t & fitHeight);
+	static bool loadSizeFromMemory(const unsigned char * data, size_t size, size_t & width, size_t & height);
 	static void flipPixelsVert(unsigned char* imagePx, const size_t& width, const size_t& height);
 };
\ No newline at end of file
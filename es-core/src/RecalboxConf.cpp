@@ -11,8 +11,14 @@ RecalboxConf::RecalboxConf()
 {
 }
 
+void RecalboxConf::OnLoad()
+{
+  NotifyWatchers();
+}
+
 void RecalboxConf::OnSave() const
 {
+  NotifyWatchers();
   NotificationManager::Instance().Notify(Notification::ConfigurationChanged, recalboxConfFile.ToString());
 }
 
@@ -219,6 +225,28 @@ DefineEmulationStationSystemListGetterSetterImplementation(ArcadeSystemHiddenMan
 
 void RecalboxConf::Watch(const String& key, IRecalboxConfChanged& callback)
 {
+  Mutex::AutoLock locker(mWatchersLocker);
   mWatchers[key].Add(&callback);
 }
 
+void RecalboxConf::Unwatch(const String& key, IRecalboxConfChanged& callback)
+{
+  Mutex::AutoLock locker(mWatchersLocker);
+  if (Array<IRecalboxConfChanged*>* callbacks = mWatchers.try_get(key); callbacks != nullptr)
+    callbacks->Remove(&callback);
+}
+
+void RecalboxConf::NotifyWatchers() const
+{
+  // Copy watchers so that callbacks may watch or unwatch
+  std::vector<std::pair<String, IRecalboxConfChanged*>> watchers;
+  {
+    Mutex::AutoLock locker(mWatchersLocker);
+    for(const auto& watcher : mWatchers)
+      for(int i = 0; i < watcher.second.Count(); ++i)
+        watchers.push_back({ watcher.first, watcher.second[i] });
+  }
+  for(const auto& watcher : watchers)
+    watcher.second->ConfigurationChanged(watcher.first);
+}
+
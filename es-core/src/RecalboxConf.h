@@ -30,6 +30,11 @@ class RecalboxConf: public IniFile, public StaticLifeCycleControler<RecalboxConf
     //! Virtual destructor
     ~RecalboxConf() override = default;
 
+    /*!
+     * @brief Called when file has been loaded
+     */
+    void OnLoad() override;
+
     /*!
      * @brief Called when file has been saved
      */
@@ -39,8 +44,20 @@ class RecalboxConf: public IniFile, public StaticLifeCycleControler<RecalboxConf
      * Watching
      */
 
+    /*!
+     * @brief Watch a key: the callback is called each time the configuration is saved or reloaded
+     * @param key Key to watch
+     * @param callback Callback
+     */
     void Watch(const String& key, IRecalboxConfChanged& callback);
 
+    /*!
+     * @brief Stop watching a key
+     * @param key Watched key
+     * @param callback Callback
+     */
+    void Unwatch(const String& key, IRecalboxConfChanged& callback);
+
     /*
      * Enums
      */
@@ -575,6 +592,11 @@ class RecalboxConf: public IniFile, public StaticLifeCycleControler<RecalboxConf
 
   private:
     HashMap<String, Array<IRecalboxConfChanged*>> mWatchers;
+    //! Watchers protection
+    mutable Mutex mWatchersLocker;
+
+    //! Call all watchers
+    void NotifyWatchers() const;
 
     /*
      * Culture
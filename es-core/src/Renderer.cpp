@@ -8,11 +8,20 @@
 #include "resources/ResourceManager.h"
 #include <RecalboxConf.h>
 #include <hardware/Board.h>
+#include <cstring>
 
 #ifdef USE_OPENGL_ES
   #define glOrtho glOrthof
 #endif
 
+Transform4x4f Renderer::sMatrix = Transform4x4f::Identity();
+RenderState Renderer::sState {};
+HashMap<GLuint, bool> Renderer::sTextureTiling;
+RenderBatch Renderer::sBatch;
+bool Renderer::sBatching = true;
+Renderer::FrameCounters Renderer::sCounters {};
+Renderer::FrameCounters Renderer::sLastFrameCounters {};
+
 #ifdef DEBUG
 
 static void APIENTRY GLDebugCallback(GLenum source,
@@ -184,12 +193,20 @@ bool Renderer::CreateSdlSurface(int width, int height)
 
 void Renderer::SwapBuffers()
 {
+  FlushBatch();
+  sLastFrameCounters = sCounters;
+  sCounters = {};
+
   SDL_GL_SwapWindow(mSdlWindow);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
 void Renderer::DestroySdlSurface()
 {
+  // Pending vertices & cached states belong to the context
+  sBatch.Clear();
+  sTextureTiling.clear();
+
   SDL_GL_DeleteContext(mSdlGLContext);
   mSdlGLContext = nullptr;
 
@@ -335,9 +352,127 @@ bool Renderer::Initialize(int w, int h)
   glScalef(mScale.x(),mScale.y(),1);
   glMatrixMode(GL_MODELVIEW);
   glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+
+  sBatching = RecalboxConf::Instance().AsBool("emulationstation.renderer.batching", true);
+  ResetState();
   return true;
 }
 
+void Renderer::ResetState()
+{
+  glDisable(GL_TEXTURE_2D);
+  glDisable(GL_BLEND);
+  glDisableClientState(GL_VERTEX_ARRAY);
+  glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+  glDisableClientState(GL_COLOR_ARRAY);
+  glColor4ub(0xFF, 0xFF, 0xFF, 0xFF);
+  sState.Reset();
+}
+
+void Renderer::SetCapability(bool& current, bool wanted, GLenum capability)
+{
+  if (!RenderState::Set(current, wanted)) return;
+  if (wanted) glEnable(capability);
+  else glDisable(capability);
+  sCounters.StateChanges++;
+}
+
+void Renderer::SetClientState(bool& current, bool wanted, GLenum array)
+{
+  if (!RenderState::Set(current, wanted)) return;
+  if (wanted) glEnableClientState(array);
+  else glDisableClientState(array);
+  sCounters.StateChanges++;
+}
+
+void Renderer::Batch(const BatchKey& key, const Vertex vertices[], const GLubyte colors[], Colors::ColorARGB color, int count)
+{
+  if (count <= 0) return;
+  if (!sBatch.Accepts(key)) FlushBatch();
+  sBatch.Add(key, sMatrix, vertices, colors, color, count);
+  if (!sBatching) FlushBatch();
+}
+
+void Renderer::FlushBatch()
+{
+  if (sBatch.IsEmpty()) return;
+  const BatchKey& key = sBatch.BatchKey();
+
+  // Vertices are already transformed
+  if (!sState.IdentityLoaded)
+  {
+    glLoadIdentity();
+    sState.IdentityLoaded = true;
+    sCounters.StateChanges++;
+  }
+  SetCapability(sState.Blending, true, GL_BLEND);
+  if (sState.SetBlending(key.SourceFactor, key.DestinationFactor))
+  {
+    glBlendFunc(key.SourceFactor, key.DestinationFactor);
+    sCounters.StateChanges++;
+  }
+  SetCapability(sState.Texturing, key.Textured, GL_TEXTURE_2D);
+  SetClientState(sState.VertexArray, true, GL_VERTEX_ARRAY);
+  SetClientState(sState.ColorArray, true, GL_COLOR_ARRAY);
+  SetClientState(sState.TexCoordArray, key.Textured, GL_TEXTURE_COORD_ARRAY);
+  if (key.Textured)
+  {
+    if (sState.SetTexture(key.Texture))
+    {
+      glBindTexture(GL_TEXTURE_2D, key.Texture);
+      sCounters.StateChanges++;
+    }
+    // Wrap mode is a texture parameter: set it only once per texture
+    if (bool* tiled = sTextureTiling.try_get(key.Texture); tiled == nullptr || *tiled != key.Tiled)
+    {
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, key.Tiled ? GL_REPEAT : GL_CLAMP_TO_EDGE);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, key.Tiled ? GL_REPEAT : GL_CLAMP_TO_EDGE);
+      sTextureTiling[key.Texture] = key.Tiled;
+      sCounters.StateChanges++;
+    }
+    glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &sBatch.VertexArray()[0].Source);
+  }
+  glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &sBatch.VertexArray()[0].Target);
+  glColorPointer(4, GL_UNSIGNED_BYTE, 0, sBatch.ColorArray());
+
+  glDrawArrays(GL_TRIANGLES, 0, (GLsizei)sBatch.Count());
+  sCounters.DrawCalls++;
+  sCounters.Vertices += sBatch.Count();
+
+  sBatch.Clear();
+}
+
+void Renderer::BeginDirectDraw()
+{
+  FlushBatch();
+  SetCapability(sState.Texturing, false, GL_TEXTURE_2D);
+  SetCapability(sState.Blending, false, GL_BLEND);
+  SetClientState(sState.VertexArray, false, GL_VERTEX_ARRAY);
+  SetClientState(sState.TexCoordArray, false, GL_TEXTURE_COORD_ARRAY);
+  SetClientState(sState.ColorArray, false, GL_COLOR_ARRAY);
+  glLoadMatrixf((const float*)&sMatrix);
+  // Direct drawers bind textures & set blending on their own, then go back to the default state
+  sState.InvalidateBindings();
+  sCounters.DrawCalls++;
+}
+
+GLuint Renderer::BoundTexture()
+{
+  // All binds are tracked: query GL only if the state has been invalidated (direct drawing)
+  if (sState.Texture != RenderState::sUnknown) return sState.Texture;
+  GLint id = 0;
+  glGetIntegerv(GL_TEXTURE_BINDING_2D, &id);
+  sState.Texture = (GLuint)id;
+  return (GLuint)id;
+}
+
+void Renderer::TextureDeleted(GLuint id)
+{
+  if (!sBatch.IsEmpty() && sBatch.BatchKey().Textured && sBatch.BatchKey().Texture == id) FlushBatch();
+  sState.TextureDeleted(id);
+  sTextureTiling.erase(id);
+}
+
 void Renderer::Finalize()
 {
   DestroySdlSurface();
@@ -345,10 +480,7 @@ void Renderer::Finalize()
 
 void Renderer::BuildGLColorArray(GLubyte* ptr, Colors::ColorARGB color, int vertCount)
 {
-  unsigned int colorGl = 0;
-  ColorToByteArray((GLubyte*) &colorGl, color);
-  for (int i = vertCount; --i >= 0; )
-    ((GLuint*) ptr)[i] = colorGl;
+  RenderBatch::FillColors(ptr, color, vertCount);
 }
 
 void Renderer::PushClippingRect(Vector2i pos, Vector2i dim)
@@ -392,6 +524,7 @@ void Renderer::PushClippingRect(Vector2i pos, Vector2i dim)
   if (box[3] < 0)
     box[3] = 0;
 
+  FlushBatch();
   mClippingStack.push(box);
   glScissor(box[0], box[1], box[2], box[3]);
   glEnable(GL_SCISSOR_TEST);
@@ -415,6 +548,7 @@ void Renderer::PopClippingRect()
     return;
   }
 
+  FlushBatch();
   mClippingStack.pop();
   if (mClippingStack.empty())
   {
@@ -433,6 +567,7 @@ GLuint Renderer::CreateGLTexture()
 
   glGenTextures(1, &id);
   glBindTexture(GL_TEXTURE_2D, id);
+  sState.Texture = id;
 
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -442,6 +577,7 @@ GLuint Renderer::CreateGLTexture()
 
 void Renderer::DestroyGLTexture(GLuint id)
 {
+  TextureDeleted(id);
   glDeleteTextures(1, &id);
 }
 
@@ -460,57 +596,32 @@ Renderer::DrawRectangle(float x, float y, float w, float h, Colors::ColorARGB co
 
 void Renderer::DrawRectangle(int x, int y, int w, int h, Colors::ColorARGB color, GLenum blend_sfactor, GLenum blend_dfactor)
 {
-  #ifdef USE_OPENGL_ES
-  GLshort points[12];
-  #else
-  GLint points[12];
-  #endif
-
-  points[0] = x;
-  points[1] = y;
-  points[2] = x;
-  points[3] = y + h;
-  points[4] = x + w;
-  points[5] = y;
-
-  points[6] = x + w;
-  points[7] = y;
-  points[8] = x;
-  points[9] = y + h;
-  points[10] = x + w;
-  points[11] = y + h;
+  Vertex vertices[Vertex::sVertexPerRectangle];
 
-  GLubyte colors[6 * 4];
-  BuildGLColorArray(colors, color, 6);
+  vertices[0].Target.Set(x, y);
+  vertices[1].Target.Set(x, y + h);
+  vertices[2].Target.Set(x + w, y);
 
-  glEnable(GL_BLEND);
-  glBlendFunc(blend_sfactor, blend_dfactor);
-  glEnableClientState(GL_VERTEX_ARRAY);
-  glEnableClientState(GL_COLOR_ARRAY);
-
-  #ifdef USE_OPENGL_ES
-  glVertexPointer(2, GL_SHORT, 0, points);
-  #else
-  glVertexPointer(2, GL_INT, 0, points);
-  #endif
-  glColorPointer(4, GL_UNSIGNED_BYTE, 0, colors);
+  vertices[3].Target.Set(x + w, y);
+  vertices[4].Target.Set(x, y + h);
+  vertices[5].Target.Set(x + w, y + h);
 
-  glDrawArrays(GL_TRIANGLES, 0, 6);
+  for(Vertex& vertex : vertices) vertex.Source.Set(0, 0);
 
-  glDisable(GL_BLEND);
-  glDisableClientState(GL_VERTEX_ARRAY);
-  glDisableClientState(GL_COLOR_ARRAY);
+  Batch({ 0, blend_sfactor, blend_dfactor, false, false }, vertices, nullptr, color, Vertex::sVertexPerRectangle);
 }
 
 void Renderer::SetMatrix(const Transform4x4f& transform)
 {
-  glLoadMatrixf((float*) &transform);
+  // Applied to batched vertices, or loaded by BeginDirectDraw()
+  sMatrix = transform;
 }
 
 Renderer::Error Renderer::UploadAlpha(GLuint id, int width, int height, const void* data)
 {
   glBindTexture(GL_TEXTURE_2D, id);
   if (glGetError() != GL_NO_ERROR) return Error::NoResource;
+  sState.Texture = id;
 
   glPixelStorei(GL_PACK_ALIGNMENT, 1);
   glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
@@ -525,6 +636,7 @@ Renderer::Error Renderer::UploadRGBA(GLuint id, int width, int height, const voi
 {
   glBindTexture(GL_TEXTURE_2D, id);
   if (glGetError() != GL_NO_ERROR) return Error::NoResource;
+  sState.Texture = id;
 
   glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
   if (glGetError() == GL_OUT_OF_MEMORY) return Error::OutOfGPUMemory;
@@ -536,6 +648,7 @@ Renderer::Error Renderer::UploadAlphaPart(GLuint id, int x, int y, int width, in
 {
   glBindTexture(GL_TEXTURE_2D, id);
   if (glGetError() != GL_NO_ERROR) return Error::NoResource;
+  sState.Texture = id;
 
   glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_ALPHA, GL_UNSIGNED_BYTE, data);
   if (glGetError() == GL_OUT_OF_MEMORY) return Error::OutOfGPUMemory;
@@ -547,6 +660,7 @@ Renderer::Error Renderer::UploadRGBAPart(GLuint id, int x, int y, int width, int
 {
   glBindTexture(GL_TEXTURE_2D, id);
   if (glGetError() != GL_NO_ERROR) return Error::NoResource;
+  sState.Texture = id;
 
   glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data);
   if (glGetError() == GL_OUT_OF_MEMORY) return Error::OutOfGPUMemory;
@@ -556,6 +670,8 @@ Renderer::Error Renderer::UploadRGBAPart(GLuint id, int x, int y, int width, int
 
 void Renderer::DrawLines(const Vector2f coordinates[], const Colors::ColorARGB colors[], int count)
 {
+  BeginDirectDraw();
+
   glEnable(GL_BLEND);
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
   glEnableClientState(GL_VERTEX_ARRAY);
@@ -573,69 +689,17 @@ void Renderer::DrawLines(const Vector2f coordinates[], const Colors::ColorARGB c
 
 void Renderer::DrawTexturedTriangles(GLuint id, const Vertex vertices[], const GLubyte colors[], int count, bool tiled)
 {
-  if (id != 0)
-    glBindTexture(GL_TEXTURE_2D, id);
-
-  glEnable(GL_TEXTURE_2D);
-  glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, tiled ? GL_REPEAT : GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, tiled ? GL_REPEAT : GL_CLAMP_TO_EDGE);
-
-  glEnableClientState(GL_VERTEX_ARRAY);
-  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-  glEnableClientState(GL_COLOR_ARRAY);
-
-  glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &vertices[0].Target);
-  glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &vertices[0].Source);
-  glColorPointer(4, GL_UNSIGNED_BYTE, 0, colors);
-
-  glDrawArrays(GL_TRIANGLES, 0, count);
-
-  glDisableClientState(GL_VERTEX_ARRAY);
-  glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-  glDisableClientState(GL_COLOR_ARRAY);
-
-  glDisable(GL_TEXTURE_2D);
-  glDisable(GL_BLEND);
+  if (id == 0) id = BoundTexture();
+  Batch({ id, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, true, tiled }, vertices, colors, 0, count);
 }
 
 void Renderer::DrawTexturedTriangles(GLuint id, const Vertex vertices[], Colors::ColorARGB color, int count, bool tiled)
 {
-  if (id != 0)
-    glBindTexture(GL_TEXTURE_2D, id);
-
-  glEnable(GL_TEXTURE_2D);
-  glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, tiled ? GL_REPEAT : GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, tiled ? GL_REPEAT : GL_CLAMP_TO_EDGE);
-
-  glColor4ub((GLubyte)(color >> 24),
-             (GLubyte)(color >> 16),
-             (GLubyte)(color >> 8),
-             (GLubyte)(color >> 0));
-
-  glEnableClientState(GL_VERTEX_ARRAY);
-  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-
-  glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &vertices[0].Target);
-  glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &vertices[0].Source);
-
-  glDrawArrays(GL_TRIANGLES, 0, count);
-
-  glDisableClientState(GL_VERTEX_ARRAY);
-  glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-
-  glColor4ub(0xFF, 0xFF, 0xFF, 0xFF);
-
-  glDisable(GL_TEXTURE_2D);
-  glDisable(GL_BLEND);
+  if (id == 0) id = BoundTexture();
+  Batch({ id, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, true, tiled }, vertices, nullptr, color, count);
 }
 
-void Renderer::DrawTexture(TextureResource& texture, int x, int y, int w, int h, bool keepratio)
+void Renderer::BuildTextureRectangle(Vertex vertices[], TextureResource& texture, int x, int y, int w, int h, bool keepratio)
 {
   if (keepratio && texture.width() != 0 && texture.height() != 0)
   {
@@ -655,187 +719,39 @@ void Renderer::DrawTexture(TextureResource& texture, int x, int y, int w, int h,
     }
   }
 
-  if (texture.bind())
-  {
-    Vertex vertices[Vertex::sVertexPerRectangle];
-
-    vertices[0].Target.Set(x, y);
-    vertices[1].Target.Set(x, y + h);
-    vertices[2].Target.Set(x + w, y);
-
-    vertices[3].Target.Set(x + w, y);
-    vertices[4].Target.Set(x, y + h);
-    vertices[5].Target.Set(x + w, y + h);
-
-    vertices[0].Source.Set(0, 1);
-    vertices[1].Source.Set(0, 0);
-    vertices[2].Source.Set(1, 1);
+  vertices[0].Target.Set(x, y);
+  vertices[1].Target.Set(x, y + h);
+  vertices[2].Target.Set(x + w, y);
 
-    vertices[3].Source.Set(1, 1);
-    vertices[4].Source.Set(0, 0);
-    vertices[5].Source.Set(1, 0);
+  vertices[3].Target.Set(x + w, y);
+  vertices[4].Target.Set(x, y + h);
+  vertices[5].Target.Set(x + w, y + h);
 
-    glEnable(GL_TEXTURE_2D);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  vertices[0].Source.Set(0, 1);
+  vertices[1].Source.Set(0, 0);
+  vertices[2].Source.Set(1, 1);
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-    glEnableClientState(GL_VERTEX_ARRAY);
-    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-
-    glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &vertices[0].Target);
-    glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &vertices[0].Source);
-
-    glDrawArrays(GL_TRIANGLES, 0, Vertex::sVertexPerRectangle);
-
-    glDisableClientState(GL_VERTEX_ARRAY);
-    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+  vertices[3].Source.Set(1, 1);
+  vertices[4].Source.Set(0, 0);
+  vertices[5].Source.Set(1, 0);
+}
 
-    glDisable(GL_TEXTURE_2D);
-    glDisable(GL_BLEND);
-  }
+void Renderer::DrawTexture(TextureResource& texture, int x, int y, int w, int h, bool keepratio)
+{
+  DrawTexture(texture, x, y, w, h, keepratio, (Colors::ColorARGB)0xFFFFFFFF);
 }
 
 void Renderer::DrawTexture(TextureResource& texture, int x, int y, int w, int h, bool keepratio, unsigned char alpha)
 {
-  if (keepratio && texture.width() != 0 && texture.height() != 0)
-  {
-    float areaRatio = (float)w / (float)h;
-    float textureRatio = texture.width() / texture.height();
-    if (areaRatio < textureRatio)
-    {
-      double height = (float)w / textureRatio;
-      y += (h - (int) height) / 2;
-      h = (int)height;
-    }
-    else
-    {
-      double width = (float)h * textureRatio;
-      x += (w - (int) width) / 2;
-      w = (int)width;
-    }
-  }
-
-  if (texture.bind())
-  {
-    Vertex vertices[Vertex::sVertexPerRectangle];
-
-    vertices[0].Target.Set(x, y);
-    vertices[1].Target.Set(x, y + h);
-    vertices[2].Target.Set(x + w, y);
-
-    vertices[3].Target.Set(x + w, y);
-    vertices[4].Target.Set(x, y + h);
-    vertices[5].Target.Set(x + w, y + h);
-
-    vertices[0].Source.Set(0, 1);
-    vertices[1].Source.Set(0, 0);
-    vertices[2].Source.Set(1, 1);
-
-    vertices[3].Source.Set(1, 1);
-    vertices[4].Source.Set(0, 0);
-    vertices[5].Source.Set(1, 0);
-
-    glEnable(GL_TEXTURE_2D);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-    glColor4ub(0xFF, 0xFF, 0xFF, alpha);
-
-    glEnableClientState(GL_VERTEX_ARRAY);
-    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-
-    glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &vertices[0].Target);
-    glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &vertices[0].Source);
-
-    glDrawArrays(GL_TRIANGLES, 0, Vertex::sVertexPerRectangle);
-
-    glDisableClientState(GL_VERTEX_ARRAY);
-    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-
-    glColor4ub(0xFF, 0xFF, 0xFF, 0xFF);
-
-    glDisable(GL_TEXTURE_2D);
-    glDisable(GL_BLEND);
-  }
+  DrawTexture(texture, x, y, w, h, keepratio, (Colors::ColorARGB)(0xFFFFFF00 | alpha));
 }
 
 void Renderer::DrawTexture(TextureResource& texture, int x, int y, int w, int h, bool keepratio, Colors::ColorARGB color)
 {
-  //DrawRectangle(x, y, w, h, 0xFF000040);
-  if (keepratio && texture.width() != 0 && texture.height() != 0)
-  {
-    float areaRatio = (float)w / (float)h;
-    float textureRatio = texture.width() / texture.height();
-    if (areaRatio < textureRatio)
-    {
-      double height = (float)w / textureRatio;
-      y += (h - (int) height) / 2;
-      h = (int)height;
-    }
-    else
-    {
-      double width = (float)h * textureRatio;
-      x += (w - (int) width) / 2;
-      w = (int)width;
-    }
-  }
-  //DrawRectangle(x, y, w, h, 0x00FF0040);
-
   if (texture.bind())
   {
     Vertex vertices[Vertex::sVertexPerRectangle];
-
-    vertices[0].Target.Set(x, y);
-    vertices[1].Target.Set(x, y + h);
-    vertices[2].Target.Set(x + w, y);
-
-    vertices[3].Target.Set(x + w, y);
-    vertices[4].Target.Set(x, y + h);
-    vertices[5].Target.Set(x + w, y + h);
-
-    vertices[0].Source.Set(0, 1);
-    vertices[1].Source.Set(0, 0);
-    vertices[2].Source.Set(1, 1);
-
-    vertices[3].Source.Set(1, 1);
-    vertices[4].Source.Set(0, 0);
-    vertices[5].Source.Set(1, 0);
-
-    glEnable(GL_TEXTURE_2D);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-    glColor4ub((GLubyte)(color >> 24),
-               (GLubyte)(color >> 16),
-               (GLubyte)(color >> 8),
-               (GLubyte)(color >> 0));
-
-    glEnableClientState(GL_VERTEX_ARRAY);
-    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-
-    glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &vertices[0].Target);
-    glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &vertices[0].Source);
-
-    glDrawArrays(GL_TRIANGLES, 0, Vertex::sVertexPerRectangle);
-
-    glDisableClientState(GL_VERTEX_ARRAY);
-    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-
-    glColor4ub(0xFF, 0xFF, 0xFF, 0xFF);
-
-    glDisable(GL_TEXTURE_2D);
-    glDisable(GL_BLEND);
+    BuildTextureRectangle(vertices, texture, x, y, w, h, keepratio);
+    Batch({ BoundTexture(), GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, true, false }, vertices, nullptr, color, Vertex::sVertexPerRectangle);
   }
 }
-
-
-
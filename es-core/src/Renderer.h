@@ -12,8 +12,12 @@
 #include <utils/gl/Rectangle.h>
 #include <utils/gl/Vertex.h>
 #include <utils/gl/Colors.h>
+#include <utils/gl/RenderBatch.h>
+#include <utils/gl/RenderState.h>
 #include <utils/storage/Stack.h>
+#include <utils/storage/HashMap.h>
 #include <hardware/RotationType.h>
+#include <vector>
 
 // Forward declaration
 class Component;
@@ -51,13 +55,31 @@ class Renderer : public StaticLifeCycleControler<Renderer>
     //! Windowed mode
     bool mWindowed;
 
-    static void ColorToByteArray(GLubyte* array, Colors::ColorARGB color)
+    //! Batch key: consecutive draws sharing the same key are merged into a single draw call
+    typedef RenderBatch::Key BatchKey;
+
+    //! Per-frame counters
+    struct FrameCounters
     {
-      array[0] = (GLubyte)(color >> 24);
-      array[1] = (GLubyte)(color >> 16);
-      array[2] = (GLubyte)(color >> 8);
-      array[3] = (GLubyte)color;
-    }
+      int DrawCalls;    //!< glDrawArrays calls
+      int StateChanges; //!< GL state changes
+      int Vertices;     //!< Drawn vertices
+    };
+
+    //! Current modelview matrix. Batched vertices are transformed on the CPU
+    static Transform4x4f sMatrix;
+    //! Cached GL state
+    static RenderState sState;
+    //! Texture wrap mode (tiled yes/no), per texture
+    static HashMap<GLuint, bool> sTextureTiling;
+    //! Pending batch
+    static RenderBatch sBatch;
+    //! Batching enabled? If not, every draw is flushed immediately
+    static bool sBatching;
+    //! Current frame counters
+    static FrameCounters sCounters;
+    //! Last frame counters
+    static FrameCounters sLastFrameCounters;
 
     /*!
      * @brief Create SDL display surface
@@ -91,6 +113,49 @@ class Renderer : public StaticLifeCycleControler<Renderer>
      */
     static bool GetResolutionFromString(const String& resolution, int& w, int& h);
 
+    /*!
+     * @brief Set GL to the default state (everything disabled) and reset the state cache accordingly
+     */
+    static void ResetState();
+
+    /*!
+     * @brief Enable/Disable a GL capability if its cached state differs
+     * @param current Cached state
+     * @param wanted Required state
+     * @param capability GL capability
+     */
+    static void SetCapability(bool& current, bool wanted, GLenum capability);
+
+    /*!
+     * @brief Enable/Disable a GL client state if its cached state differs
+     * @param current Cached state
+     * @param wanted Required state
+     * @param array GL client array
+     */
+    static void SetClientState(bool& current, bool wanted, GLenum array);
+
+    /*!
+     * @brief Add triangles to the pending batch. The batch is flushed first if its key differs
+     * @param key Batch key
+     * @param vertices Vertices, in current matrix coordinates
+     * @param colors Color array (4 bytes per vertex) or nullptr to use the given color
+     * @param color Single color, used only if colors is nullptr
+     * @param count Vertex count
+     */
+    static void Batch(const BatchKey& key, const Vertex vertices[], const GLubyte colors[], Colors::ColorARGB color, int count);
+
+    /*!
+     * @brief Build a textured rectangle, keeping ratio or not
+     * @param vertices Vertices to fill
+     * @param texture Texture
+     * @param x X coordinate
+     * @param y Y coordinate
+     * @param w Width
+     * @param h Height
+     * @param keepratio True to keep ratio, false to stretch
+     */
+    static void BuildTextureRectangle(Vertex vertices[], TextureResource& texture, int x, int y, int w, int h, bool keepratio);
+
   public:
     //! Error status
     enum class Error
@@ -147,6 +212,47 @@ class Renderer : public StaticLifeCycleControler<Renderer>
      */
     void SwapBuffers();
 
+    /*
+     * Batching & state cache
+     */
+
+    /*!
+     * @brief Draw pending batched triangles
+     */
+    static void FlushBatch();
+
+    /*!
+     * @brief Prepare GL for code issuing its own GL calls:
+     * flush the batch, restore the default state (everything disabled) and load the current matrix
+     */
+    static void BeginDirectDraw();
+
+    /*!
+     * @brief Get the currently bound texture, i.e. the one bound by TextureResource::bind()
+     * The tracked binding is returned. GL is queried only when the binding is unknown
+     * @return GL texture identifier
+     */
+    static GLuint BoundTexture();
+
+    /*!
+     * @brief Notify a texture has been bound outside the renderer
+     * @param id GL texture identifier
+     */
+    static void TextureBound(GLuint id) { (void)sState.SetTexture(id); }
+
+    /*!
+     * @brief Notify a texture is about to be deleted outside the renderer
+     * @param id GL texture identifier
+     */
+    static void TextureDeleted(GLuint id);
+
+    //! Get last frame draw calls
+    static int FrameDrawCalls() { return sLastFrameCounters.DrawCalls; }
+    //! Get last frame state changes
+    static int FrameStateChanges() { return sLastFrameCounters.StateChanges; }
+    //! Get last frame drawn vertices
+    static int FrameVertices() { return sLastFrameCounters.Vertices; }
+
     /*
      * Clipping
      */
@@ -225,7 +331,7 @@ class Renderer : public StaticLifeCycleControler<Renderer>
 
     /*!
      * @brief Draw textured triangles
-     * @param id GL texture id
+     * @param id GL texture id, 0 for the currently bound texture
      * @param vertices Vertice list
      * @param colors Color list
      * @param count Vertice count
@@ -235,7 +341,7 @@ class Renderer : public StaticLifeCycleControler<Renderer>
 
     /*!
      * @brief Draw textured triangles using a single color
-     * @param id GL texture id
+     * @param id GL texture id, 0 for the currently bound texture
      * @param vertices Vertice list
      * @param color Color
      * @param count Vertice count
@@ -243,6 +349,34 @@ class Renderer : public StaticLifeCycleControler<Renderer>
      */
     static void DrawTexturedTriangles(GLuint id, const Vertex vertices[], Colors::ColorARGB color, int count, bool tiled);
 
+    /*!
+     * @brief Draw textured triangles from any vertex structure made of a position and a texture coordinate
+     * @param id GL texture id, 0 for the currently bound texture
+     * @param vertices Vertice list
+     * @param colors Color list
+     * @param count Vertice count
+     * @param tiled draw tiled texture
+     */
+    template<class T> static void DrawTexturedTriangles(GLuint id, const T vertices[], const GLubyte colors[], int count, bool tiled)
+    {
+      static_assert(sizeof(T) == sizeof(Vertex), "Vertices must be made of 2 coordinates & 2 texture coordinates");
+      DrawTexturedTriangles(id, (const Vertex*)vertices, colors, count, tiled);
+    }
+
+    /*!
+     * @brief Draw textured triangles from any vertex structure made of a position and a texture coordinate, using a single color
+     * @param id GL texture id, 0 for the currently bound texture
+     * @param vertices Vertice list
+     * @param color Color
+     * @param count Vertice count
+     * @param tiled draw tiled texture
+     */
+    template<class T> static void DrawTexturedTriangles(GLuint id, const T vertices[], Colors::ColorARGB color, int count, bool tiled)
+    {
+      static_assert(sizeof(T) == sizeof(Vertex), "Vertices must be made of 2 coordinates & 2 texture coordinates");
+      DrawTexturedTriangles(id, (const Vertex*)vertices, color, count, tiled);
+    }
+
     /*!
      * @brief Upload Alpha texture data to GPU memory
      * @param id GL Texture id
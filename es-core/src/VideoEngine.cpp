@@ -7,10 +7,9 @@
 
 #include <SDL_audio.h>
 #include <utils/datetime/HighResolutionTimer.h>
+#include <RecalboxConf.h>
 #include "VideoEngine.h"
 
-#define PIXEL_FORMAT AV_PIX_FMT_RGBA
-
 #define RETURN_ERROR(x, y) do{ LOG(LogError) << "[Video Engine]" << x; return y; }while(false)
 
 static unsigned char converted_data[(192000 * 3) / 2];
@@ -96,6 +95,9 @@ bool VideoEngine::AudioPacketQueue::Dequeue(AVPacket& pkt)
 VideoEngine::VideoEngine()
   : StaticLifeCycleControler<VideoEngine>("VideoEngine")
   , mIsPlaying(false)
+  , mDecodedSequence(0)
+  , mUploadedSequence(0)
+  , mLowColor(RecalboxConf::Instance().AsBool("emulationstation.videosnaps.lowcolor", false))
 {
   StartEngine();
 }
@@ -213,6 +215,7 @@ void VideoEngine::StopVideo(bool waitforstop)
   {
     AquireTexture();
     mTexture.reset();
+    mUploadedSequence = 0;
     ReleaseTexture();
   }
 
@@ -289,6 +292,7 @@ bool VideoEngine::InitializeDecoder()
   }
 
   // Initialize video codec
+  mContext.PixelFormat = mLowColor ? AV_PIX_FMT_RGB565 : AV_PIX_FMT_RGBA;
   mContext.VideoCodec = avcodec_find_decoder(mContext.AudioVideoContext->streams[mContext.VideoStreamIndex]->codecpar->codec_id);
   if (mContext.VideoCodec == nullptr) RETURN_ERROR("Error finding video codec " << mContext.AudioVideoContext->streams[mContext.VideoStreamIndex]->codecpar->codec_id, false);
   mContext.VideoCodecContext = avcodec_alloc_context3(mContext.VideoCodec);
@@ -300,7 +304,7 @@ bool VideoEngine::InitializeDecoder()
                                                mContext.VideoCodecContext->pix_fmt,
                                                mContext.VideoCodecContext->width,
                                                mContext.VideoCodecContext->height,
-                                               PIXEL_FORMAT,
+                                               mContext.PixelFormat,
                                                SWS_BILINEAR,
                                                nullptr,
                                                nullptr,
@@ -320,15 +324,15 @@ bool VideoEngine::InitializeDecoder()
 
   mContext.Width = mContext.AudioVideoContext->streams[mContext.VideoStreamIndex]->codecpar->width;
   mContext.Height = mContext.AudioVideoContext->streams[mContext.VideoStreamIndex]->codecpar->height;
-  int argbSize = av_image_get_buffer_size(PIXEL_FORMAT, mContext.Width, mContext.Height, 8);
+  int argbSize = av_image_get_buffer_size(mContext.PixelFormat, mContext.Width, mContext.Height, 8);
   if (argbSize < 1) RETURN_ERROR("Error getting video frame size", false);
-  mContext.FrameBuffer = (unsigned char*)av_malloc(argbSize);
-  if (mContext.FrameBuffer == nullptr) RETURN_ERROR("Error allocating frame buffer", false);
-
-  if (av_image_fill_arrays(&mContext.FrameRGB[0]->data[0], &mContext.FrameRGB[0]->linesize[0], mContext.FrameBuffer, PIXEL_FORMAT, mContext.Width, mContext.Height, 1) < 0)
-    RETURN_ERROR("Error setting frame buffer", false);
-  if (av_image_fill_arrays(&mContext.FrameRGB[1]->data[0], &mContext.FrameRGB[1]->linesize[0], mContext.FrameBuffer, PIXEL_FORMAT, mContext.Width, mContext.Height, 1) < 0)
-    RETURN_ERROR("Error setting frame buffer", false);
+  for(int i = 2; --i >= 0; )
+  {
+    mContext.FrameBuffer[i] = (unsigned char*)av_malloc(argbSize);
+    if (mContext.FrameBuffer[i] == nullptr) RETURN_ERROR("Error allocating frame buffer", false);
+    if (av_image_fill_arrays(&mContext.FrameRGB[i]->data[0], &mContext.FrameRGB[i]->linesize[0], mContext.FrameBuffer[i], mContext.PixelFormat, mContext.Width, mContext.Height, 1) < 0)
+      RETURN_ERROR("Error setting frame buffer", false);
+  }
 
   // Initialize audio callback
   if (mContext.AudioCodec != nullptr)
@@ -425,10 +429,16 @@ TextureData& VideoEngine::GetDisplayableFrame()
 {
   int frame = ((int)mContext.FrameInUse ^ 1) & 1;
   mContext.FrammeRGBLocker[frame].Lock();
-  if (mContext.FrameRGB[frame] != nullptr)
+  // Upload only frames not already in the texture
+  unsigned int sequence = mContext.FrameSequence[frame];
+  if (mContext.FrameRGB[frame] != nullptr && sequence != 0 && sequence != mUploadedSequence)
   {
     AquireTexture();
-    mTexture.updateFromRGBA(mContext.FrameRGB[frame]->data[0], mContext.Width, mContext.Height);
+    if (mContext.PixelFormat == AV_PIX_FMT_RGB565)
+      mTexture.updateFromRGB565(mContext.FrameRGB[frame]->data[0], mContext.Width, mContext.Height);
+    else
+      mTexture.updateFromRGBA(mContext.FrameRGB[frame]->data[0], mContext.Width, mContext.Height);
+    mUploadedSequence = sequence;
     ReleaseTexture();
   }
   mContext.FrammeRGBLocker[frame].UnLock();
@@ -478,6 +488,8 @@ void VideoEngine::DecodeFrames(bool decodeAudio)
                     mContext.VideoCodecContext->height,
                     mContext.FrameRGB[mContext.FrameInUse & 1U]->data,
                     mContext.FrameRGB[mContext.FrameInUse & 1U]->linesize);
+          if (++mDecodedSequence == 0) mDecodedSequence = 1;
+          mContext.FrameSequence[mContext.FrameInUse & 1U] = mDecodedSequence;
           mContext.FrammeRGBLocker[mContext.FrameInUse & 1U].UnLock();
 
           // Swap frame
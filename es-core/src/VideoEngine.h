@@ -138,8 +138,8 @@ class VideoEngine : public StaticLifeCycleControler<VideoEngine>, private Thread
         //! Audio packets
         AudioPacketQueue AudioQueue;
 
-        //! Frame buffer
-        unsigned char* FrameBuffer;
+        //! Frame buffers, one per decoded frame so that the decoder never overwrites the displayed one
+        unsigned char* FrameBuffer[2];
 
         //! Source video Frame in native pixel format
         AVFrame* Frame;
@@ -147,8 +147,12 @@ class VideoEngine : public StaticLifeCycleControler<VideoEngine>, private Thread
         AVFrame* FrameRGB[2];
         //! RGB frame access locker
         Mutex FrammeRGBLocker[2];
+        //! Sequence number of the frame held in each RGB frame, 0 if none
+        unsigned int FrameSequence[2];
         //! Buffer in use by the decoder (0/1)
         unsigned int FrameInUse;
+        //! RGB frame pixel format
+        AVPixelFormat PixelFormat;
 
         //! Video width in pixel
         int Width;
@@ -170,10 +174,12 @@ class VideoEngine : public StaticLifeCycleControler<VideoEngine>, private Thread
             VideoCodecContext(nullptr),
             ResamplerContext(nullptr),
             ColorsSpaceContext(nullptr),
-            FrameBuffer(nullptr),
+            FrameBuffer(),
             Frame(nullptr),
             FrameRGB(),
+            FrameSequence(),
             FrameInUse(0),
+            PixelFormat(AV_PIX_FMT_RGBA),
             Width(0),
             Height(0),
             FrameTime(0),
@@ -195,7 +201,8 @@ class VideoEngine : public StaticLifeCycleControler<VideoEngine>, private Thread
           if (Frame != nullptr             ) av_frame_free(&Frame);
           if (FrameRGB[0] != nullptr       ) av_frame_free(&FrameRGB[0]);
           if (FrameRGB[1] != nullptr       ) av_frame_free(&FrameRGB[1]);
-          if (FrameBuffer != nullptr       ) av_free(FrameBuffer);
+          if (FrameBuffer[0] != nullptr    ) av_free(FrameBuffer[0]);
+          if (FrameBuffer[1] != nullptr    ) av_free(FrameBuffer[1]);
 
           AudioVideoContext = nullptr;
           AudioCodec = VideoCodec = nullptr;
@@ -203,8 +210,9 @@ class VideoEngine : public StaticLifeCycleControler<VideoEngine>, private Thread
           ResamplerContext = nullptr;
           ColorsSpaceContext = nullptr;
           AudioStreamIndex = VideoStreamIndex = -1;
-          FrameBuffer = nullptr;
+          FrameBuffer[0] = FrameBuffer[1] = nullptr;
           Frame = FrameRGB[0] = FrameRGB[1] = nullptr;
+          FrameSequence[0] = FrameSequence[1] = 0;
           Width = Height = 0;
           FrameInUse = 0;
           FrameTime = 0;
@@ -270,6 +278,13 @@ class VideoEngine : public StaticLifeCycleControler<VideoEngine>, private Thread
     //! Texture protector
     Mutex mTextureSyncer;
 
+    //! Sequence number of the last decoded frame. Never reset so that frames of a new video always differ
+    unsigned int mDecodedSequence;
+    //! Sequence number of the frame currently in mTexture, 0 if none
+    unsigned int mUploadedSequence;
+    //! Decode to 16bit RGB565 instead of 32bit RGBA, halving conversion output & upload bandwidth
+    bool mLowColor;
+
     //! Order message provider
     MessageFactory<OrderMessage> mMessageProvider;
     //! Order Queue
@@ -356,7 +371,7 @@ class VideoEngine : public StaticLifeCycleControler<VideoEngine>, private Thread
 
     /*!
      * @brief Get current image of the current playing video
-     * This must be called fr
+     * The texture is only updated when a new frame has been decoded since the last call
      * @return TextureData containing last image
      */
     TextureData& GetDisplayableFrame();
@@ -7,6 +7,8 @@
 #include <views/ViewController.h>
 #include <usernotifications/NotificationManager.h>
 #include "guis/GuiInfoPopup.h"
+#include "resources/TextureResource.h"
+#include "resources/Font.h"
 
 WindowManager::WindowManager()
   : mOSD(*this)
@@ -16,10 +18,15 @@ WindowManager::WindowManager()
   , mGuiStack(16) // Allocate memory once for all gui
   , mAverageDeltaTime(10)
   , mTimeSinceLastInput(0)
+  , mTimeSinceInvalidation(0)
+  , mTimeSinceLastFrame(0)
   , mNormalizeNextUpdate(false)
   , mSleeping(false)
   , mRenderedHelpPrompts(false)
   , mDisplayEnabled(true)
+  , mInvalidated(true)
+  , mIdleRendering(RecalboxConf::Instance().AsBool("emulationstation.idlerendering", true))
+  , mResumeTiming(false)
 {
   auto menuTheme = MenuThemeData::getInstance()->getCurrentTheme();
   mBackgroundOverlay.setImage(menuTheme->menuBackground.fadePath);
@@ -43,6 +50,7 @@ bool WindowManager::UpdateHelpSystem()
 
 void WindowManager::pushGui(Gui* gui)
 {
+  Invalidate();
   if (Gui* top = peekGui(); top != nullptr) top->onHide();
   mGuiStack.Push(gui);
   gui->onShow();
@@ -51,6 +59,7 @@ void WindowManager::pushGui(Gui* gui)
 
 void WindowManager::RemoveGui(Gui* gui)
 {
+  Invalidate();
   Gui* previousTop = peekGui();
   for(int i = mGuiStack.Count(); --i >= 0;)
     if (mGuiStack[i] == gui)
@@ -77,7 +86,10 @@ void WindowManager::deleteClosePendingGui()
 
   // Refresh help system
   if (deleted)
+  {
     UpdateHelpSystem();
+    Invalidate();
+  }
 }
 
 void WindowManager::deleteAllGui()
@@ -130,6 +142,7 @@ bool WindowManager::ReInitialize()
   ResourceManager::getInstance()->reloadAll();
   // Update help system
   UpdateHelpSystem();
+  Invalidate();
 
   return true;
 }
@@ -176,6 +189,13 @@ void WindowManager::Finalize()
   Renderer::Instance().Finalize();
 }
 
+void WindowManager::Suspend()
+{
+  ResourceManager::getInstance()->suspendAll();
+  TextureResource::trimRAM((size_t)RecalboxConf::Instance().AsInt("emulationstation.resume.texturecache", 32) << 20);
+  Renderer::Instance().Finalize();
+}
+
 void WindowManager::textInput(const char* text)
 {
   if (!mGuiStack.Empty())
@@ -238,6 +258,9 @@ void WindowManager::Update(int deltaTime)
   }
 
   mTimeSinceLastInput += deltaTime;
+  mTimeSinceInvalidation += deltaTime;
+  mTimeSinceLastFrame += deltaTime;
+  mOSD.GetFpsOSD().RecordWakeup();
 
   // Process GUI pending for deletion
   deleteClosePendingGui();
@@ -387,9 +410,25 @@ bool WindowManager::KonamiCode(const InputCompactEvent& input)
   return false;
 }
 
+bool WindowManager::NeedRendering() const
+{
+  if (!mIdleRendering || mInvalidated) return true;
+  // Non-reporting components & popups
+  if (mTimeSinceInvalidation < sRenderingGracePeriod || !mInfoPopups.Empty()) return true;
+  // Decoded textures & rasterized glyphs waiting for their upload
+  if (TextureResource::needNewFrame() || Font::needNewFrame()) return true;
+  return mTimeSinceLastFrame >= sRenderingKeepAlive;
+}
+
 void WindowManager::RenderAll(bool halfLuminosity)
 {
+  // Reset before rendering, so that components invalidated while rendering get a new frame
+  mInvalidated = false;
+  mTimeSinceLastFrame = 0;
+
   Transform4x4f transform(Transform4x4f::Identity());
+  TextureResource::newFrame();
+  Font::newFrame();
   Render(transform);
   if (halfLuminosity)
   {
@@ -399,6 +438,13 @@ void WindowManager::RenderAll(bool halfLuminosity)
   mOSD.GetFpsOSD().RecordStopFrame();
   Renderer::Instance().SwapBuffers();
   mOSD.GetFpsOSD().RecordStartFrame();
+
+  if (mResumeTiming)
+  {
+    mResumeTiming = false;
+    long long elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - mResumeStart).count();
+    { LOG(LogInfo) << "[WindowManager] Return-to-menu latency: " << elapsed << "ms"; }
+  }
 }
 
 void WindowManager::CloseAll()
@@ -409,6 +455,7 @@ void WindowManager::CloseAll()
 
 void WindowManager::DoWake()
 {
+  Invalidate();
   mTimeSinceLastInput = 0;
   if (mSleeping)
   {
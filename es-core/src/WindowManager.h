@@ -8,6 +8,7 @@
 #include <input/InputManager.h>
 #include "guis/PopupType.h"
 #include "osd/OSDManager.h"
+#include <chrono>
 
 // Forward declaration
 class GuiInfoPopupBase;
@@ -47,12 +48,37 @@ class WindowManager
 
     void RenderAll(bool halfLuminosity = false);
 
+    /*!
+     * @brief Request a new frame
+     * Components must call this method each time their display changes by itself (animations,
+     * scrolling texts, videos, ...). Inputs, sync messages & file events invalidate the window as well
+     */
+    void Invalidate() { mInvalidated = true; mTimeSinceInvalidation = 0; }
+
+    /*!
+     * @brief Check if a new frame must be rendered
+     * @return True if the screen is invalidated or if something is still moving
+     */
+    [[nodiscard]] bool NeedRendering() const;
+
     bool Initialize(unsigned int width, unsigned int height, bool initRenderer = true);
 
     bool ReInitialize();
 
     static void Finalize();
 
+    /*!
+     * @brief Release the renderer & GPU resources before running an external program.
+     * Decoded textures (within the configured RAM budget) & glyph atlases are kept in RAM,
+     * so that ReInitialize() does not decode nor rasterize them again
+     */
+    static void Suspend();
+
+    /*!
+     * @brief Start measuring the return-to-menu latency, until the next frame is displayed
+     */
+    void StartResumeTiming() { mResumeStart = std::chrono::steady_clock::now(); mResumeTiming = true; }
+
     void normalizeNextUpdate() { mNormalizeNextUpdate = true; }
 
     [[nodiscard]] bool isSleeping() const { return mSleeping; }
@@ -156,6 +182,10 @@ class WindowManager
     static constexpr int sMaxInfoPopups = 10;
     //! Maximum displayable popup info
     static constexpr int sMaxDisplayableInfoPopups = 4;
+    //! Keep rendering for this time after the last invalidation (ms), to catch non-reporting components
+    static constexpr int sRenderingGracePeriod = 500;
+    //! Maximum time without frame (ms), even when nothing is invalidated
+    static constexpr int sRenderingKeepAlive = 1000;
 
     // Returns true if at least one component on the stack is processing
     bool isProcessing();
@@ -182,6 +212,10 @@ class WindowManager
 
     int mAverageDeltaTime;
     unsigned int mTimeSinceLastInput;
+    //! Time since the last invalidation (ms)
+    int mTimeSinceInvalidation;
+    //! Time since the last rendered frame (ms)
+    int mTimeSinceLastFrame;
 
     bool mNormalizeNextUpdate;
     bool mSleeping;
@@ -189,6 +223,14 @@ class WindowManager
 
     //! Screen refresh enabled?
     bool mDisplayEnabled;
+    //! Something changed since the last frame?
+    bool mInvalidated;
+    //! Render only when the screen changes?
+    bool mIdleRendering;
+    //! Measuring return-to-menu latency?
+    bool mResumeTiming;
+    //! Return-to-menu start time
+    std::chrono::steady_clock::time_point mResumeStart;
 
     /*!
      * @brief Delete GUI pending for deletion
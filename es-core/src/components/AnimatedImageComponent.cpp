@@ -1,5 +1,6 @@
 #include "components/AnimatedImageComponent.h"
 #include "utils/Log.h"
+#include "WindowManager.h"
 #include "themes/MenuThemeData.h"
 
 AnimatedImageComponent::AnimatedImageComponent(WindowManager&window)
@@ -60,6 +61,7 @@ void AnimatedImageComponent::Update(int deltaTime)
 
 	mFrameAccumulator += deltaTime;
 
+	int previousFrame = mCurrentFrame;
 	while(mFrames[mCurrentFrame].second <= mFrameAccumulator)
 	{
 		mCurrentFrame++;
@@ -80,6 +82,9 @@ void AnimatedImageComponent::Update(int deltaTime)
 
 		mFrameAccumulator -= mFrames[mCurrentFrame].second;
 	}
+
+	if (mCurrentFrame != previousFrame)
+		mWindow.Invalidate();
 }
 
 void AnimatedImageComponent::Render(const Transform4x4f& trans)
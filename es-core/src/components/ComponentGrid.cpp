@@ -470,6 +470,9 @@ void ComponentGrid::Render(const Transform4x4f& parentTrans)
   // draw cell separators
   if (!mLines.empty())
   {
+    Renderer::SetMatrix(trans);
+    Renderer::BeginDirectDraw();
+
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glEnableClientState(GL_VERTEX_ARRAY);
@@ -111,6 +111,7 @@ void DateTimeComponent::Update(int deltaTime)
 		{
 			mRelativeUpdateAccumulator = 0;
 			updateTextCache();
+			mWindow.Invalidate();
 		}
 	}
 
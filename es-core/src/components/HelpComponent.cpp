@@ -2,6 +2,7 @@
 #include <utils/cplusplus/StaticLifeCycleControler.h>
 #include "components/HelpComponent.h"
 #include "Renderer.h"
+#include "WindowManager.h"
 #include "components/ImageComponent.h"
 #include "components/TextComponent.h"
 
@@ -125,6 +126,7 @@ void HelpComponent::Render(const Transform4x4f& parentTrans)
 
 void HelpComponent::Update(int deltaTime)
 {
+  int previousOffset = mScrollingOffset;
   if (mGrid.EntryCount() != 0)
     if (mScrollingLength > 10)
       switch(mScrolling)
@@ -175,4 +177,5 @@ void HelpComponent::Update(int deltaTime)
           break;
         }
       }
+  if (mScrollingOffset != previousOffset) mWindow.Invalidate();
 }
@@ -6,6 +6,7 @@
 #include "guis/Gui.h"
 #include "components/ImageComponent.h"
 #include "Renderer.h"
+#include "WindowManager.h"
 #include "resources/Font.h"
 
 enum class CursorState
@@ -67,6 +68,7 @@ class IList : public Gui
       String name;
       UserData object;
       EntryData data;
+      bool lazyName = false; //!< Name not resolved yet - see ResolveName()
     };
 
   protected:
@@ -160,13 +162,13 @@ class IList : public Gui
     inline const String& getSelectedName()
     {
       assert(size() > 0);
-      return mEntries[mCursor].name;
+      return NameOf(mEntries[mCursor]);
     }
 
     inline const String& getNameAt(int index)
     {
       assert(size() > 0);
-      return mEntries[index].name;
+      return NameOf(mEntries[index]);
     }
 
     inline const UserData& getSelected() const
@@ -228,7 +230,7 @@ class IList : public Gui
     {
       for (auto it = mEntries.begin(); it != mEntries.end(); it++)
       {
-        if ((*it).name == name)
+        if (NameOf(*it) == name)
         {
           mCursor = it - mEntries.begin();
           onCursorChanged(CursorState::Stopped);
@@ -246,6 +248,7 @@ class IList : public Gui
         if ((*it).object == obj)
         {
           (*it).name = name;
+          (*it).lazyName = false;
           (*it).data.textCache.reset();
           return true;
         }
@@ -263,10 +266,17 @@ class IList : public Gui
 
       auto& entry = mEntries[cursor];
       entry.name = name;
+      entry.lazyName = false;
       entry.data.textCache.reset();
       return true;
     }
 
+    // reserve memory for the given entry count
+    void reserve(int count)
+    {
+      mEntries.reserve(count);
+    }
+
     // entry management
     void add(const Entry& e)
     {
@@ -312,6 +322,29 @@ class IList : public Gui
     [[nodiscard]] inline int getCursor() const { return mCursor; }
 
   protected:
+    /*!
+     * @brief Resolve the name of an entry added without name
+     * Called once per entry, the first time its name is required
+     * @param object Entry object
+     * @return Entry name
+     */
+    virtual String ResolveName(const UserData& object) { (void)object; return String(); }
+
+    /*!
+     * @brief Get an entry name, resolving it on first access
+     * @param entry Entry
+     * @return Entry name
+     */
+    String& NameOf(Entry& entry)
+    {
+      if (entry.lazyName)
+      {
+        entry.name = ResolveName(entry.object);
+        entry.lazyName = false;
+      }
+      return entry.name;
+    }
+
     void remove(typename std::vector<Entry>::iterator& it)
     {
       if (mCursor > 0 && it - mEntries.begin() <= mCursor)
@@ -338,6 +371,9 @@ class IList : public Gui
 
     void listUpdate(int deltaTime)
     {
+      // Scrolling & title overlay fading need new frames
+      if (mScrollVelocity != 0 || (mTitleOverlayOpacity != 0 && mTitleOverlayOpacity != 255)) mWindow.Invalidate();
+
       // update the title overlay opacity
       const int dir = (mScrollTier >= mTierList.count - 1) ? 1
                                                            : -1; // fade in if scroll tier is >= 1, otherwise fade out
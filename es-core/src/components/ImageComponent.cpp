@@ -1,6 +1,7 @@
 #include <components/ImageComponent.h>
 #include <utils/Log.h>
 #include <Renderer.h>
+#include <WindowManager.h>
 #include <help/Help.h>
 #include <themes/ThemeData.h>
 #include <utils/locale/LocaleHelper.h>
@@ -234,26 +235,7 @@ void ImageComponent::Render(const Transform4x4f& parentTrans)
             // when it finally loads
             fadeIn(mTexture->bind());
 
-            glEnable(GL_TEXTURE_2D);
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-            glEnableClientState(GL_VERTEX_ARRAY);
-            glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-            glEnableClientState(GL_COLOR_ARRAY);
-
-            glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &mVertices[0].pos);
-            glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &mVertices[0].tex);
-            glColorPointer(4, GL_UNSIGNED_BYTE, 0, mColors);
-
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-
-            glDisableClientState(GL_VERTEX_ARRAY);
-            glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-            glDisableClientState(GL_COLOR_ARRAY);
-
-            glDisable(GL_TEXTURE_2D);
-            glDisable(GL_BLEND);
+            Renderer::DrawTexturedTriangles(0, mVertices, mColors, 6, mTexture->isTiled());
         } else {
           { LOG(LogError) << "[ImageComponent] Image texture is not initialized!"; }
             mTexture.reset();
@@ -294,6 +276,8 @@ void ImageComponent::fadeIn(bool textureLoaded) {
             mColorShift = (mColorShift >> 8 << 8) | (unsigned char)newOpacity;
             updateColors();
         }
+        // Keep rendering while waiting for the texture and until the fade completes
+        if (mFading) mWindow.Invalidate();
     }
 }
 
@@ -1,5 +1,6 @@
 #include "components/ScrollableContainer.h"
 #include "Renderer.h"
+#include "WindowManager.h"
 
 #define AUTO_SCROLL_RESET_DELAY 10000 // ms to reset to top after we reach the bottom
 #define AUTO_SCROLL_DELAY 8000 // ms to wait before we start to scroll
@@ -58,6 +59,7 @@ void ScrollableContainer::setAutoScroll(bool autoScroll)
 
 void ScrollableContainer::Update(int deltaTime)
 {
+	Vector2f previousPos = mScrollPos;
 	if(mAutoScrollSpeed != 0)
 	{
 		mAutoScrollAccumulator += deltaTime;
@@ -100,6 +102,9 @@ void ScrollableContainer::Update(int deltaTime)
 			reset();
 	}
 
+	if (mScrollPos != previousPos)
+		mWindow.Invalidate();
+
   Component::Update(deltaTime);
 }
 
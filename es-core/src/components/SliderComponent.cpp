@@ -1,6 +1,7 @@
 #include <components/SliderComponent.h>
 #include <cassert>
 #include <Renderer.h>
+#include <WindowManager.h>
 #include <themes/MenuThemeData.h>
 #include <help/Help.h>
 #include <input/InputCompactEvent.h>
@@ -67,6 +68,7 @@ void SliderComponent::Update(int deltaTime)
 		{
 			setSlider(mValue + mMoveRate);
 			mMoveAccumulator -= MOVE_REPEAT_RATE;
+			mWindow.Invalidate();
 		}
 	}
 
@@ -109,8 +109,10 @@ void TextComponent::setOpacity(unsigned char opacity)
 
 void TextComponent::setText(const String& text)
 {
+  String previous(std::move(mText));
   mText = text;
   if (mUppercase) mText.UpperCaseUTF8();
+  if (mText != previous) mWindow.Invalidate();
 	onTextChanged();
 }
 
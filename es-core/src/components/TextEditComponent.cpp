@@ -178,6 +178,7 @@ void TextEditComponent::updateCursorRepeat(int deltaTime)
 	{
 		moveCursor(mCursorRepeatDir);
 		mCursorRepeatTimer -= CURSOR_REPEAT_SPEED;
+		mWindow.Invalidate();
 	}
 }
 
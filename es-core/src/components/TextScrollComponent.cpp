@@ -120,6 +120,7 @@ void TextScrollComponent::setUppercase(bool uppercase)
 
 void TextScrollComponent::Update(int deltaTime)
 {
+  int previousOffset = mOffset;
   mOffset = 0;
   if (mTextCache && mTextCache->metrics.size.x() > mSize.x())
   {
@@ -158,6 +159,7 @@ void TextScrollComponent::Update(int deltaTime)
       mMarqueeTime += deltaTime;
     }
   }
+  if (mOffset != previousOffset) mWindow.Invalidate();
 
   Component::Update(deltaTime);
 }
@@ -7,6 +7,7 @@
 
 #include "components/VerticalScrollableContainer.h"
 #include "Renderer.h"
+#include "WindowManager.h"
 #include "VerticalScrollableContainer.h"
 
 
@@ -52,6 +53,7 @@ void VerticalScrollableContainer::Render(const Transform4x4f& parentTrans)
 
 void VerticalScrollableContainer::Update(int deltaTime)
 {
+  int previousOffset = mScrollOffset;
   int min = 0, max = 0;
   getContentHeight(min, max);
   int childrenHeight = max - min;
@@ -95,6 +97,7 @@ void VerticalScrollableContainer::Update(int deltaTime)
     }
     mScrollTime += deltaTime;
   }
+  if (mScrollOffset != previousOffset) mWindow.Invalidate();
 
   Component::Update(deltaTime);
 }
@@ -2,6 +2,7 @@
 #include <audio/AudioManager.h>
 #include <VideoEngine.h>
 #include <Renderer.h>
+#include <WindowManager.h>
 #include <help/Help.h>
 #include <themes/ThemeData.h>
 #include <utils/Log.h>
@@ -321,6 +322,8 @@ void VideoComponent::Render(const Transform4x4f& parentTrans)
 
   double effect = 0.0;
   bool display = ProcessDisplay(effect);
+  // Video states & frames move on at each frame
+  if (!mVideoPath.IsEmpty()) mWindow.Invalidate();
 
   if (display)
   {
@@ -338,26 +341,7 @@ void VideoComponent::Render(const Transform4x4f& parentTrans)
     setRotation(mEffect == Effect::BreakingNews ? (float)(Pi * 4.0) * (float)effect : 0.0f);
     setRotationOrigin(0.5f, 0.5f);
 
-    glEnable(GL_TEXTURE_2D);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    glEnableClientState(GL_VERTEX_ARRAY);
-    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-    glEnableClientState(GL_COLOR_ARRAY);
-
-    glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &mVertices[0].pos);
-    glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &mVertices[0].tex);
-    glColorPointer(4, GL_UNSIGNED_BYTE, 0, mColors);
-
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-
-    glDisableClientState(GL_VERTEX_ARRAY);
-    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-    glDisableClientState(GL_COLOR_ARRAY);
-
-    glDisable(GL_TEXTURE_2D);
-    glDisable(GL_BLEND);
+    Renderer::DrawTexturedTriangles(0, mVertices, mColors, 6, false);
   }
 
   Component::renderChildren(trans);
@@ -50,8 +50,12 @@ bool Component::ProcessInput(const InputCompactEvent& event)
 
 void Component::updateSelf(int deltaTime)
 {
+	bool animated = false;
 	for (int i = MAX_ANIMATIONS; --i >= 0; )
-		advanceAnimation(i, deltaTime);
+		animated |= advanceAnimation(i, deltaTime);
+	// Running animations need a new frame
+	if (animated)
+		mWindow.Invalidate();
 }
 
 void Component::updateChildren(int deltaTime) const
@@ -3,6 +3,7 @@
 //
 
 #include <Renderer.h>
+#include <WindowManager.h>
 #include <help/Help.h>
 #include <utils/locale/LocaleHelper.h>
 #include "GuiArcadeVirtualKeyboard.h"
@@ -343,6 +344,9 @@ void GuiArcadeVirtualKeyboard::Update(int deltaTime)
   if (mWheelDimmingColor > 0 && !mWheelDimming)
     if (mWheelDimmingColor -= deltaTime; mWheelDimmingColor < 0)
       mWheelDimmingColor = 0;
+
+  // Blinking cursor: always animated
+  mWindow.Invalidate();
 }
 
 void GuiArcadeVirtualKeyboard::RenderEditedString()
@@ -492,26 +496,7 @@ void GuiArcadeVirtualKeyboard::RenderSelector()
 
   mSelectedChar->bind();
 
-  glEnable(GL_TEXTURE_2D);
-  glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-  glEnableClientState(GL_VERTEX_ARRAY);
-  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-  glEnableClientState(GL_COLOR_ARRAY);
-
-  glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &vertices[0].pos);
-  glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &vertices[0].tex);
-  glColorPointer(4, GL_UNSIGNED_BYTE, 0, colors);
-
-  glDrawArrays(GL_TRIANGLES, 0, 6);
-
-  glDisableClientState(GL_VERTEX_ARRAY);
-  glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-  glDisableClientState(GL_COLOR_ARRAY);
-
-  glDisable(GL_TEXTURE_2D);
-  glDisable(GL_BLEND);
+  Renderer::DrawTexturedTriangles(0, vertices, colors, 6, false);
 }
 
 unsigned int GuiArcadeVirtualKeyboard::BlendColor(unsigned int from, unsigned int to, double ratio)
@@ -117,6 +117,7 @@ void GuiDetectDevice::Update(int deltaTime)
 		int t = HOLD_TIME / deltaTime;
 		mAlpha += 255 / t;
 		mDeviceHeld->setColor(mColor | mAlpha);
+		mWindow.Invalidate();
 		if(mHoldTime <= 0)
 		{
 			// picked one!
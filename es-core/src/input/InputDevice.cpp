@@ -140,6 +140,37 @@ void InputDevice::LoadFrom(const InputDevice& source)
   *this = source;
 }
 
+bool InputDevice::IsSameDevice(SDL_Joystick* device, int deviceIndex) const
+{
+  SDL_JoystickGUID guid = SDL_JoystickGetGUID(device);
+  if (memcmp(&mDeviceGUID, &guid, sizeof(SDL_JoystickGUID)) != 0) return false;
+  if (mDeviceNbAxes != SDL_JoystickNumAxes(device) ||
+      mDeviceNbHats != SDL_JoystickNumHats(device) ||
+      mDeviceNbButtons != SDL_JoystickNumButtons(device)) return false;
+  if (mDeviceName != SDL_JoystickName(device)) return false;
+  #ifdef SDL_JOYSTICK_IS_OVERRIDEN_BY_RECALBOX
+  // Distinguish identical pads
+  if (mPath != Path(SDL_JoystickDevicePathById(deviceIndex))) return false;
+  #else
+  (void)deviceIndex;
+  #endif
+  return true;
+}
+
+void InputDevice::Reattach(SDL_Joystick* device, SDL_JoystickID deviceId, int deviceIndex)
+{
+  mDeviceSDL = device;
+  mDeviceId = deviceId;
+  mDeviceIndex = deviceIndex;
+  mHotkeyState = false;
+  mKillSelect = false;
+
+  memset(mPreviousAxisValues, 0, sizeof(mPreviousAxisValues));
+  memset(mPreviousHatsValues, 0, sizeof(mPreviousHatsValues));
+
+  RecordAxisNeutralPosition();
+}
+
 String InputDevice::NameExtented()
 {
   String result(Name());
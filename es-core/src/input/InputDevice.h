@@ -311,6 +311,22 @@ class InputDevice
      */
     void LoadFrom(const InputDevice& source);
 
+    /*!
+     * @brief Check if the given SDL2 joystick is this device, reopened after an SDL2 restart or a refresh
+     * @param device SDL2 joystick
+     * @param deviceIndex SDL2 joystick index
+     * @return True if name, guid, axis, hats, buttons and device path are matching
+     */
+    [[nodiscard]] bool IsSameDevice(SDL_Joystick* device, int deviceIndex) const;
+
+    /*!
+     * @brief Attach this device to its reopened SDL2 joystick, keeping udev information & configuration
+     * @param device SDL2 joystick
+     * @param deviceId New SDL2 joystick identifier
+     * @param deviceIndex New SDL2 joystick index
+     */
+    void Reattach(SDL_Joystick* device, SDL_JoystickID deviceId, int deviceIndex);
+
     /*
      * Non SDL2 LowLevel
      */
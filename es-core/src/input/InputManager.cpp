@@ -177,8 +177,9 @@ void InputManager::LoadAllJoysticksConfiguration(std::vector<InputDevice> previo
 {
   int numJoysticks = SDL_NumJoysticks();
   { LOG(LogInfo) << "[InputManager] Joystick count: " << numJoysticks; }
+  std::vector<InputDevice> known(previous);
   for (int i = 0; i < numJoysticks; i++)
-    LoadJoystickConfiguration(i);
+    LoadJoystickConfiguration(i, known);
 
   //! Notify
   for(IInputChange* input : mNotificationInterfaces)
@@ -222,7 +223,7 @@ String InputManager::DeviceGUIDString(SDL_Joystick* joystick)
   return guid;
 }
 
-void InputManager::LoadJoystickConfiguration(int index)
+void InputManager::LoadJoystickConfiguration(int index, std::vector<InputDevice>& known)
 {
   bool autoConfigured = true;
   { LOG(LogInfo) << "[InputManager] Load configuration for Joystick #: " << index; }
@@ -231,6 +232,21 @@ void InputManager::LoadJoystickConfiguration(int index)
   SDL_Joystick* joy = SDL_JoystickOpen(index);
   if (joy == nullptr) return;
 
+  // Known device? Reattach it rather than querying udev & configurations again
+  for (auto it = known.begin(); it != known.end(); ++it)
+    if (it->IsSameDevice(joy, index))
+    {
+      SDL_JoystickID identifier = SDL_JoystickInstanceID(joy);
+      mIdToSdlJoysticks[identifier] = joy;
+      mIndexToId[index] = identifier;
+      InputDevice device(*it);
+      device.Reattach(joy, identifier, index);
+      mIdToDevices[identifier] = device;
+      known.erase(it);
+      { LOG(LogInfo) << "[Input] Reattached joystick " << device.Name() << " (Instance ID: " << identifier << ", Device Index: " << index << ')'; }
+      return;
+    }
+
   // Get device properties
   int buttons = SDL_JoystickNumButtons(joy);
   int axes    = SDL_JoystickNumAxes(joy);
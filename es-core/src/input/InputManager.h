@@ -243,8 +243,9 @@ class InputManager : public StaticLifeCycleControler<InputManager>
     /*!
      * @brief Load joystick configuration (by index)
      * @param index Joystick index from to 0 to available joysticks-1
+     * @param known Devices known before the refresh. Matching devices are reattached & removed from this list
      */
-    void LoadJoystickConfiguration(int index);
+    void LoadJoystickConfiguration(int index, std::vector<InputDevice>& known);
 
     /*!
      * @brief Process an Axis SDL event and generate an InputCompactEvent accordingly
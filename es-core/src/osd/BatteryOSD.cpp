@@ -3,6 +3,7 @@
 //
 
 #include "BatteryOSD.h"
+#include <WindowManager.h>
 
 BatteryOSD::BatteryOSD(WindowManager& window, Side side)
   : BaseOSD(window, side, false)
@@ -18,10 +19,17 @@ BatteryOSD::BatteryOSD(WindowManager& window, Side side)
   RecalboxConf::Instance().Watch(RecalboxConf::sBatteryHidden, *this);
 }
 
+BatteryOSD::~BatteryOSD()
+{
+  RecalboxConf::Instance().Unwatch(RecalboxConf::sBatteryHidden, *this);
+}
+
 void BatteryOSD::Update(int deltaTime)
 {
   (void)deltaTime;
 
+  String::Unicode previousIcon = mIcon;
+  Colors::ColorRGBA previousColor = mColor;
   mIcon = 0xf1b4;
   mColor = 0xFFFFFFFF;
   if (!Board::Instance().IsBatteryCharging())
@@ -39,6 +47,7 @@ void BatteryOSD::Update(int deltaTime)
       if ((charge < 10) && ((SDL_GetTicks() >> 8) & 3) == 0) mColor = 0xFF0000FF;
     }
   }
+  if (mIcon != previousIcon || mColor != previousColor) mWindow.Invalidate();
 }
 
 void BatteryOSD::Render(const Transform4x4f& parentTrans)
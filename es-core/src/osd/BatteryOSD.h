@@ -20,6 +20,9 @@ class BatteryOSD : public BaseOSD
      */
     explicit BatteryOSD(WindowManager& window, Side side);
 
+    //! Destructor
+    ~BatteryOSD() override;
+
     /*
      * Component override
      */
@@ -4,6 +4,7 @@
 
 #include "BluetoothOSD.h"
 #include "Renderer.h"
+#include "WindowManager.h"
 #include "themes/MenuThemeData.h"
 
 BluetoothOSD::BluetoothOSD(WindowManager& window, BaseOSD::Side side)
@@ -73,6 +74,7 @@ void BluetoothOSD::Update(int deltaTime)
   mBtBottom.setOpacity((int)(2.55f * (float)(30 + ((90 + percent) % 100))));
   mBtMiddle.setOpacity((int)(2.55f * (float)(30 + ((60 + percent) % 100))));
   mBtTop.setOpacity((int)(2.55f * (float)(30 + ((30 + percent) % 100))));
+  mWindow.Invalidate();
 }
 
 void BluetoothOSD::Render(const Transform4x4f& parentTrans)
@@ -6,6 +6,7 @@
 #include "FpsOSD.h"
 #include <Renderer.h>
 #include <resources/Font.h>
+#include <resources/GpuMemory.h>
 
 FpsOSD::FpsOSD(WindowManager& window, Side side)
   : BaseOSD(window, side, false)
@@ -15,13 +16,18 @@ FpsOSD::FpsOSD(WindowManager& window, Side side)
   , mFrameTimingTotal(0)
   , mTimingIndex(0)
   , mRecordedTimings(0)
+  , mWakeups(0)
+  , mWakeupStart(0)
+  , mWakeupRate(0)
 {
   memset(mFrameStart, 0, sizeof(mFrameStart));
   memset(mFrameTimingComputations, 0, sizeof(mFrameTimingComputations));
   memset(mFrameTimingTotal, 0, sizeof(mFrameTimingTotal));
 
-  Vector2f size = mFPSFont->sizeText(" 00.0 Fps (00.0%) ");
-  mFPSArea = Rectangle(0, 0, size.x(), size.y());
+  // Three lines: frame timings, GPU memory & draw statistics
+  Vector2f size = mFPSFont->sizeText(" 00.0 Fps (00.0%) 000 W/s ");
+  Vector2f gpuSize = mFPSFont->sizeText(" GPU 000/000MB (T000 S000 G00 V00) Hit 100% Ev 00000 ");
+  mFPSArea = Rectangle(0, 0, std::max(size.x(), gpuSize.x()), size.y() * 3);
 }
 
 void FpsOSD::RecordStopFrame()
@@ -43,6 +49,18 @@ void FpsOSD::RecordStartFrame()
   }
 }
 
+void FpsOSD::RecordWakeup()
+{
+  mWakeups++;
+  int now = (int)SDL_GetTicks();
+  if (now - mWakeupStart >= 1000)
+  {
+    mWakeupRate = (mWakeups * 1000) / (now - mWakeupStart);
+    mWakeups = 0;
+    mWakeupStart = now;
+  }
+}
+
 float FpsOSD::CalculateFPS()
 {
   float fps = 0;
@@ -69,10 +87,17 @@ void FpsOSD::Render(const Transform4x4f& parentTrans)
   (void)parentTrans;
   float fps = CalculateFPS();
   float percent = CalculateFramePercentage();
-  String s = (_F(" {0} Fps ({1}%) ") / _FOV(Frac, 1) / fps / percent).ToString();
+  String s = (_F(" {0} Fps ({1}%) {2} W/s ") / _FOV(Frac, 1) / fps / percent / mWakeupRate).ToString();
   Renderer::DrawRectangle(mFPSArea, 0x000000C0);
   TextCache* text = mFPSFont->buildTextCache(s, mFPSArea.Left(), mFPSArea.Top(), 0xFFFFFFFF);
   mFPSFont->renderTextCache(text);
   delete text;
+  text = mFPSFont->buildTextCache(GpuMemory::OSDLine(), mFPSArea.Left(), mFPSArea.Top() + mFPSArea.Height() / 3, 0xFFFFFFFF);
+  mFPSFont->renderTextCache(text);
+  delete text;
+  s = (_F(" Draws {0} States {1} Vertices {2} ") / Renderer::FrameDrawCalls() / Renderer::FrameStateChanges() / Renderer::FrameVertices()).ToString();
+  text = mFPSFont->buildTextCache(s, mFPSArea.Left(), mFPSArea.Top() + (mFPSArea.Height() * 2) / 3, 0xFFFFFFFF);
+  mFPSFont->renderTextCache(text);
+  delete text;
 }
 
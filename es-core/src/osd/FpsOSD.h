@@ -27,6 +27,11 @@ class FpsOSD : public BaseOSD
      */
     void RecordStopFrame();
 
+    /*!
+     * @brief Record a main loop wakeup, whether a frame is rendered or not
+     */
+    void RecordWakeup();
+
     /*
      * Component override
      */
@@ -69,6 +74,12 @@ class FpsOSD : public BaseOSD
     int mTimingIndex;
     //! Recorded timings
     int mRecordedTimings;
+    //! Wakeups in the current second
+    int mWakeups;
+    //! Current second start
+    int mWakeupStart;
+    //! Wakeups during the last second
+    int mWakeupRate;
 
     /*!
      * @brief Calculate FPS using recorded operations
@@ -4,6 +4,7 @@
 
 #include "PadOSD.h"
 #include <input/InputManager.h>
+#include <WindowManager.h>
 
 PadOSD::PadOSD(WindowManager& window, Side side)
   : BaseOSD(window, side, true)
@@ -21,6 +22,11 @@ PadOSD::PadOSD(WindowManager& window, Side side)
   UpdateActiveFlag();
 }
 
+PadOSD::~PadOSD()
+{
+  RecalboxConf::Instance().Unwatch(RecalboxConf::sPadOSD, *this);
+}
+
 void PadOSD::UpdatePadIcon()
 {
   mPadChar = 0xF25E;
@@ -54,7 +60,11 @@ void PadOSD::Update(int deltaTime)
   // Set alphas
   mPadCount = InputManager::Instance().Mapper().ConnectedPadCount();
   for(int i = Input::sMaxInputDevices; --i >= 0; )
+  {
+    int previousAlpha = mAlpha[i];
     mAlpha[i] = Math::clampi(mAlpha[i] -= deltaTime / 4, i < mPadCount ? sMinAlpha : 0, sMaxAlpha);
+    if (mAlpha[i] != previousAlpha) mWindow.Invalidate();
+  }
 }
 
 void PadOSD::Render(const Transform4x4f& transform)
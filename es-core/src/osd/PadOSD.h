@@ -18,6 +18,9 @@ class PadOSD : public BaseOSD
      */
     explicit PadOSD(WindowManager& window, Side side);
 
+    //! Destructor
+    ~PadOSD() override;
+
     //! Update pad icon on change
     void UpdatePadIcon();
 
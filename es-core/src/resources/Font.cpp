@@ -3,6 +3,9 @@
 #include <Renderer.h>
 #include <utils/Log.h>
 #include <resources/ResourceManager.h>
+#include <resources/GpuMemory.h>
+#include <resources/GlyphPrewarmer.h>
+#include <RecalboxConf.h>
 #include <themes/ThemeElement.h>
 #include <utils/math/Misc.h>
 
@@ -18,6 +21,8 @@ int Font::getSize() const
 
 std::map<std::pair<Path, int>, std::weak_ptr<Font> > Font::sFontMap;
 
+static const std::vector<UnicodeChar>& getLanguageCharacters();
+
 
 // utf8 stuff
 size_t Font::getNextCursor(const String& str, size_t cursor)
@@ -132,10 +137,10 @@ UnicodeChar Font::readUnicodeChar(const String& str, size_t& cursor)
 }
 
 
-Font::FontFace::FontFace(ResourceData&& d, int size)
+Font::FontFace::FontFace(const std::shared_ptr<const String>& d, int size)
   : data(d), face(nullptr)
 {
-  int err = FT_New_Memory_Face(sLibrary, (const unsigned char*) data.data(), (int)data.size(), 0, &face);
+  int err = FT_New_Memory_Face(sLibrary, (const unsigned char*) data->data(), (int)data->size(), 0, &face);
   (void) err;
   assert(!err);
 
@@ -165,7 +170,7 @@ size_t Font::getMemUsage() const
     memUsage += (size_t)(mTexture.textureSize.x() * mTexture.textureSize.y() * 4);
 
   for (const auto& it : mFaceCache)
-    memUsage += it.second->data.size();
+    memUsage += it.second->data->size();
 
   return memUsage;
 }
@@ -191,7 +196,7 @@ size_t Font::getTotalMemUsage()
 }
 
 Font::Font(int size, const Path& path)
-  : mSize(size), mPath(path)
+  : mShapedTexts(sMaxShapedTexts), mWrappedTexts(sMaxWrappedTexts), mSize(size), mPath(path)
 {
   assert(mSize > 0);
 
@@ -210,8 +215,6 @@ Font::Font(int size, const Path& path)
     float height = g->texSize.y() * (float) g->texture->textureSize.y();
     if (height > mSizeMax) mSizeMax = height;
   }
-
-  clearFaceCache();
 }
 
 Font::~Font()
@@ -232,6 +235,7 @@ std::shared_ptr<Font> Font::get(int size, const Path& path)
   std::shared_ptr<Font> font = std::shared_ptr<Font>(new Font(def.second, def.first));
   sFontMap[def] = std::weak_ptr<Font>(font);
   ResourceManager::getInstance()->addReloadable(font);
+  font->prewarm(getLanguageCharacters());
   return font;
 }
 
@@ -241,6 +245,7 @@ void Font::unloadTextures()
   {
     mTexture.deinitTexture();
   }
+  clearFaceCache();
 }
 
 Font::FontTexture::FontTexture()
@@ -287,6 +292,7 @@ void Font::FontTexture::initTexture()
 
   glGenTextures(1, &textureId);
   glBindTexture(GL_TEXTURE_2D, textureId);
+  Renderer::TextureBound(textureId);
 
   glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
   glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -298,17 +304,34 @@ void Font::FontTexture::initTexture()
   glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
   glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, textureSize.x(), textureSize.y(), 0, GL_ALPHA, GL_UNSIGNED_BYTE, nullptr);
+  (void)GpuMemory::CheckAllocation();
+  GpuMemory::Allocate(GpuMemory::Category::Glyphs, (long long)textureSize.x() * textureSize.y());
 }
 
 void Font::FontTexture::deinitTexture()
 {
   if (textureId != 0)
   {
+    Renderer::TextureDeleted(textureId);
     glDeleteTextures(1, &textureId);
     textureId = 0;
+    GpuMemory::Release(GpuMemory::Category::Glyphs, (long long)textureSize.x() * textureSize.y());
   }
 }
 
+void Font::FontTexture::storeGlyph(const Vector2i& cursor, const Vector2i& size, const unsigned char* bitmap, int pitch)
+{
+  if (size.x() <= 0 || size.y() <= 0 || bitmap == nullptr) return;
+
+  // Grow to the last used row
+  size_t rows = cursor.y() + size.y();
+  if (shadow.size() < rows * textureSize.x())
+    shadow.resize(rows * textureSize.x(), 0);
+
+  for (int y = 0; y < size.y(); ++y)
+    memcpy(&shadow[(cursor.y() + y) * textureSize.x() + cursor.x()], bitmap + y * pitch, size.x());
+}
+
 void Font::getTextureForNewGlyph(const Vector2i& glyphSize, FontTexture*& tex_out, Vector2i& cursor_out)
 {
   if (!mTextures.empty())
@@ -323,7 +346,7 @@ void Font::getTextureForNewGlyph(const Vector2i& glyphSize, FontTexture*& tex_ou
 
   // current textures are full,
   // make a new one
-  mTextures.push_back(FontTexture());
+  mTextures.emplace_back();
   tex_out = &mTextures.back();
   tex_out->initTexture();
 
@@ -368,8 +391,7 @@ FT_Face Font::getFaceForChar(UnicodeChar id)
       // i == 0 -> mPath
       // otherwise, take from fallbackFonts
       const Path& path = (i == 0 ? mPath : fallbackFonts[i - 1]);
-      ResourceData data = ResourceManager::getFileData(path);
-      mFaceCache[i] = std::unique_ptr<FontFace>(new FontFace(std::move(data), mSize));
+      mFaceCache[i] = std::unique_ptr<FontFace>(new FontFace(getFaceData(path), mSize));
       fit = mFaceCache.find(i);
     }
 
@@ -386,12 +408,113 @@ void Font::clearFaceCache()
   mFaceCache.clear();
 }
 
+std::shared_ptr<const String> Font::getFaceData(const Path& path)
+{
+  static std::map<Path, std::weak_ptr<const String> > sFaceData;
+  std::shared_ptr<const String> data = sFaceData[path].lock();
+  if (!data)
+  {
+    data = std::make_shared<const String>(ResourceManager::getFileData(path));
+    sFaceData[path] = data;
+  }
+  return data;
+}
+
+// background rasterizer, shared by all fonts
+static GlyphPrewarmer& getPrewarmer()
+{
+  static GlyphPrewarmer sPrewarmer;
+  return sPrewarmer;
+}
+
+// characters commonly used by the current language, beyond ASCII
+static const std::vector<UnicodeChar>& getLanguageCharacters()
+{
+  static std::vector<UnicodeChar> sCharacters;
+  static bool sInitialized = false;
+  if (!sInitialized)
+  {
+    sInitialized = true;
+    auto range = [](UnicodeChar from, UnicodeChar to) { for (UnicodeChar c = from; c <= to; c++) sCharacters.push_back(c); };
+    String language = RecalboxConf::Instance().GetSystemLanguage().LowerCase().SubString(0, 2);
+    // latin-1 supplement, latin extended-A & typographic quotes: all latin languages
+    range(0x00A0, 0x017F);
+    range(0x2018, 0x201F);
+    if (language == "ru" || language == "uk" || language == "bg" || language == "sr") range(0x0400, 0x045F);
+    else if (language == "el") range(0x0370, 0x03FF);
+    else if (language == "vi") range(0x1EA0, 0x1EF9);
+    else if (language == "ja" || language == "zh" || language == "ko")
+    {
+      // CJK punctuation & fullwidth forms, then kana or jamo. Ideographs & syllables are too many:
+      // they are prewarmed from the texts about to be displayed
+      range(0x3000, 0x303F);
+      range(0xFF01, 0xFF5E);
+      if (language == "ja") range(0x3041, 0x30FF);
+      if (language == "ko") range(0x3131, 0x318E);
+    }
+  }
+  return sCharacters;
+}
+
+void Font::prewarm(const std::vector<UnicodeChar>& characters)
+{
+  static bool sEnabled = RecalboxConf::Instance().AsBool("emulationstation.font.prewarm", true);
+  if (!sEnabled) return;
+
+  std::vector<UnicodeChar> missing;
+  for (UnicodeChar character : characters)
+    if (mGlyphMap.find(character) == mGlyphMap.end() && mPrewarmRequested.insert(character).second)
+      missing.push_back(character);
+  if (missing.empty()) return;
+
+  // same faces, in the same order as getFaceForChar
+  std::vector<Path> faces { mPath };
+  const std::vector<Path>& fallbackFonts = getFallbackFontPaths();
+  faces.insert(faces.end(), fallbackFonts.begin(), fallbackFonts.end());
+  getPrewarmer().Push(mPath, mSize, faces, std::move(missing));
+}
+
+void Font::prewarmText(const String& text)
+{
+  // ASCII characters are always loaded
+  std::vector<UnicodeChar> characters;
+  for (size_t cursor = 0; cursor < text.length(); )
+    if ((text[cursor] & 0x80) == 0) cursor++;
+    else characters.push_back(readUnicodeChar(text, cursor));
+  if (!characters.empty())
+    prewarm(characters);
+}
+
+void Font::newFrame()
+{
+  GlyphPrewarmer::Glyph rasterized;
+  for (int i = sPrewarmUploadsPerFrame; --i >= 0 && getPrewarmer().Pop(rasterized); )
+  {
+    auto it = sFontMap.find(std::pair<Path, int>(rasterized.FontPath, rasterized.FontSize));
+    if (it == sFontMap.end() || it->second.expired()) continue;
+    std::shared_ptr<Font> font = it->second.lock();
+    // it may have been loaded on demand in the meantime
+    if (font->mGlyphMap.find(rasterized.Character) == font->mGlyphMap.end())
+      font->createGlyph(rasterized.Character, Vector2i(rasterized.Width, rasterized.Height), rasterized.Bitmap.data(), rasterized.Width,
+                        rasterized.Advance, rasterized.Bearing, false);
+  }
+}
+
+bool Font::needNewFrame()
+{
+  return getPrewarmer().HasPendingGlyphs();
+}
+
 Font::Glyph* Font::getGlyph(UnicodeChar id)
 {
   // is it already loaded?
   auto it = mGlyphMap.find(id);
   if (it != mGlyphMap.end())
+  {
+    if (!it->second.measured)
+      measureGlyph(it->second);
     return &it->second;
+  }
 
   // nope, need to make a glyph
   FT_Face face = getFaceForChar(id);
@@ -409,8 +532,14 @@ Font::Glyph* Font::getGlyph(UnicodeChar id)
     return nullptr;
   }
 
-  Vector2i glyphSize((int) g->bitmap.width, (int) g->bitmap.rows);
+  return createGlyph(id, Vector2i((int) g->bitmap.width, (int) g->bitmap.rows), g->bitmap.buffer, g->bitmap.pitch,
+                     Vector2f((float) g->metrics.horiAdvance / 64.0f, (float) g->metrics.vertAdvance / 64.0f),
+                     Vector2f((float) g->metrics.horiBearingX / 64.0f, (float) g->metrics.horiBearingY / 64.0f), true);
+}
 
+Font::Glyph* Font::createGlyph(UnicodeChar id, const Vector2i& glyphSize, const unsigned char* bitmap, int pitch,
+                               const Vector2f& advance, const Vector2f& bearing, bool measure)
+{
   FontTexture* tex = nullptr;
   Vector2i cursor(0);
   getTextureForNewGlyph(glyphSize, tex, cursor);
@@ -431,57 +560,55 @@ Font::Glyph* Font::getGlyph(UnicodeChar id)
   glyph.texSize.Set((float) glyphSize.x() / (float) tex->textureSize.x(),
                     (float) glyphSize.y() / (float) tex->textureSize.y());
 
-  glyph.advance.Set((float) g->metrics.horiAdvance / 64.0f, (float) g->metrics.vertAdvance / 64.0f);
-  glyph.bearing.Set((float) g->metrics.horiBearingX / 64.0f, (float) g->metrics.horiBearingY / 64.0f);
+  glyph.advance = advance;
+  glyph.bearing = bearing;
+  glyph.measured = false;
 
   // upload glyph bitmap to texture
   glBindTexture(GL_TEXTURE_2D, tex->textureId);
   glTexSubImage2D(GL_TEXTURE_2D, 0, cursor.x(), cursor.y(), glyphSize.x(), glyphSize.y(), GL_ALPHA, GL_UNSIGNED_BYTE,
-                  g->bitmap.buffer);
+                  bitmap);
   glBindTexture(GL_TEXTURE_2D, 0);
+  Renderer::TextureBound(0);
+  tex->storeGlyph(cursor, glyphSize, bitmap, pitch);
 
-  // update max glyph height
-  if (glyphSize.y() > mMaxGlyphHeight)
-    mMaxGlyphHeight = glyphSize.y();
+  if (measure)
+    measureGlyph(glyph);
 
   // done
   return &glyph;
 }
 
-// completely recreate the texture data for all textures based on mGlyphs information
+void Font::measureGlyph(Glyph& glyph)
+{
+  glyph.measured = true;
+
+  // update max glyph height. Shaped texts depend on it
+  int height = (int) Math::round(glyph.texSize.y() * (float) glyph.texture->textureSize.y());
+  if (height > mMaxGlyphHeight)
+  {
+    mMaxGlyphHeight = height;
+    mShapedTexts.clear();
+  }
+}
+
+// completely recreate the texture data for all textures from their RAM shadow
 void Font::rebuildTextures()
 {
-  // recreate OpenGL textures
   for (auto& mTexture : mTextures)
   {
+    // recreate OpenGL texture
     mTexture.deinitTexture();
     mTexture.initTexture();
-  }
-
-  // reupload the texture data
-  for (auto& it : mGlyphMap)
-  {
-    FT_Face face = getFaceForChar(it.first);
-    FT_GlyphSlot glyphSlot = face->glyph;
-
-    // load the glyph bitmap through FT
-    FT_Load_Char(face, it.first, FT_LOAD_RENDER);
-
-    FontTexture* tex = it.second.texture;
 
-    // find the position/size
-    Vector2i cursor((int) (it.second.texPos.x() * (float) tex->textureSize.x()),
-                    (int) (it.second.texPos.y() * (float) tex->textureSize.y()));
-    Vector2i glyphSize((int) (it.second.texSize.x() * (float) tex->textureSize.x()),
-                       (int) (it.second.texSize.y() * (float) tex->textureSize.y()));
-
-    // upload to texture
-    glBindTexture(GL_TEXTURE_2D, tex->textureId);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, cursor.x(), cursor.y(), glyphSize.x(), glyphSize.y(), GL_ALPHA, GL_UNSIGNED_BYTE,
-                    glyphSlot->bitmap.buffer);
+    // reupload the used rows at once
+    if (!mTexture.shadow.empty())
+      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, mTexture.textureSize.x(), (int)mTexture.shadow.size() / mTexture.textureSize.x(),
+                      GL_ALPHA, GL_UNSIGNED_BYTE, mTexture.shadow.data());
   }
 
   glBindTexture(GL_TEXTURE_2D, 0);
+  Renderer::TextureBound(0);
 }
 
 void Font::renderCharacter(unsigned int character, float x, float y, float wr, float hr, unsigned int color)
@@ -529,30 +656,7 @@ void Font::renderCharacter(unsigned int character, float x, float y, float wr, f
   vertices[4].tex.Set(tx, sy);
   vertices[5].tex.Set(sx, sy);
 
-  GLubyte colors[6 * 4];
-  Renderer::BuildGLColorArray(colors, color, 6);
-
-  glBindTexture(GL_TEXTURE_2D, texture->textureId);
-  glEnable(GL_TEXTURE_2D);
-  glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-  glEnableClientState(GL_VERTEX_ARRAY);
-  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-  glEnableClientState(GL_COLOR_ARRAY);
-
-  glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &vertices[0].pos);
-  glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &vertices[0].tex);
-  glColorPointer(4, GL_UNSIGNED_BYTE, 0, colors);
-
-  glDrawArrays(GL_TRIANGLES, 0, 6);
-
-  glDisableClientState(GL_VERTEX_ARRAY);
-  glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-  glDisableClientState(GL_COLOR_ARRAY);
-
-  glDisable(GL_TEXTURE_2D);
-  glDisable(GL_BLEND);
+  Renderer::DrawTexturedTriangles(texture->textureId, vertices, color, 6, false);
 }
 
 void Font::renderTextCache(TextCache* cache)
@@ -567,27 +671,9 @@ void Font::renderTextCache(TextCache* cache)
   {
     assert(vertexList.textureIdPtr != nullptr);
 
-    glBindTexture(GL_TEXTURE_2D, *vertexList.textureIdPtr);
-    glEnable(GL_TEXTURE_2D);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    glEnableClientState(GL_VERTEX_ARRAY);
-    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-    glEnableClientState(GL_COLOR_ARRAY);
-
-    glVertexPointer(2, GL_FLOAT, sizeof(TextCache::Vertex), vertexList.verts[0].pos.data());
-    glTexCoordPointer(2, GL_FLOAT, sizeof(TextCache::Vertex), vertexList.verts[0].tex.data());
-    glColorPointer(4, GL_UNSIGNED_BYTE, 0, vertexList.colors.data());
-
-    glDrawArrays(GL_TRIANGLES, 0, (int)vertexList.verts.size());
-
-    glDisableClientState(GL_VERTEX_ARRAY);
-    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-    glDisableClientState(GL_COLOR_ARRAY);
-
-    glDisable(GL_TEXTURE_2D);
-    glDisable(GL_BLEND);
+    // Consecutive vertex lists sharing the same glyph texture end up in the same batch
+    const std::vector<TextCache::Vertex>& verts = *vertexList.verts;
+    Renderer::DrawTexturedTriangles(*vertexList.textureIdPtr, verts.data(), vertexList.colors.data(), (int)verts.size(), false);
   }
 }
 
@@ -642,6 +728,11 @@ float Font::getLetterHeight()
 //breaks up a normal string with newlines to make it fit xLen
 String Font::wrapText(String text, float xLen)
 {
+  WrappedTextKey key { text, xLen };
+  const String* wrapped = mWrappedTexts.try_get(key);
+  if (wrapped != nullptr)
+    return *wrapped;
+
   String out;
 
   String line, word, temp;
@@ -678,7 +769,7 @@ String Font::wrapText(String text, float xLen)
   // whatever's left should fit
   out += line;
 
-  return out;
+  return mWrappedTexts.insert(key, std::move(out));
 }
 
 Vector2f Font::sizeWrappedText(const String& text, float xLen, float lineSpacing)
@@ -754,6 +845,24 @@ float Font::getNewlineStartOffset(const String& text, unsigned int charStart, fl
 TextCache*
 Font::buildTextCache(const String& text, Vector2f offset, unsigned int color, float xLen, TextAlignment alignment,
                      float lineSpacing, bool nospacing)
+{
+  // same text & layout (list rows, labels refreshed with the same value): reuse the shaped vertices
+  ShapedTextKey key { text, offset, xLen, lineSpacing, alignment, nospacing };
+  const TextCache* shaped = mShapedTexts.try_get(key);
+  if (shaped == nullptr)
+  {
+    TextCache prototype = shapeText(text, offset, xLen, alignment, lineSpacing, nospacing);
+    shaped = &mShapedTexts.insert(key, std::move(prototype));
+  }
+
+  TextCache* cache = new TextCache(*shaped);
+  for (auto& vertexList : cache->vertexLists)
+    vertexList.colors.resize(4 * vertexList.verts->size());
+  cache->setColor(color);
+  return cache;
+}
+
+TextCache Font::shapeText(const String& text, Vector2f offset, float xLen, TextAlignment alignment, float lineSpacing, bool nospacing)
 {
   float x = offset[0] + (xLen != 0 ? getNewlineStartOffset(text, 0, xLen, alignment) : 0);
 
@@ -819,26 +928,20 @@ Font::buildTextCache(const String& text, Vector2f offset, unsigned int color, fl
     x += glyph->advance.x();
   }
 
-  //TextCache::CacheMetrics metrics = { sizeText(text, lineSpacing) };
-
-  TextCache* cache = new TextCache();
-  cache->vertexLists.resize(vertMap.size());
-  cache->metrics = {sizeText(text, lineSpacing)};
+  // colors are set by buildTextCache
+  TextCache cache;
+  cache.vertexLists.resize(vertMap.size());
+  cache.metrics = {sizeText(text, lineSpacing)};
 
   unsigned int i = 0;
   for (auto& it : vertMap)
   {
-    TextCache::VertexList& vertList = cache->vertexLists[i];
+    TextCache::VertexList& vertList = cache.vertexLists[i++];
 
     vertList.textureIdPtr = &it.first->textureId;
-    vertList.verts = it.second;
-
-    vertList.colors.resize(4 * it.second.size());
-    Renderer::BuildGLColorArray(vertList.colors.data(), color, (int)it.second.size());
+    vertList.verts = std::make_shared<const std::vector<TextCache::Vertex> >(std::move(it.second));
   }
 
-  clearFaceCache();
-
   return cache;
 }
 
@@ -851,7 +954,7 @@ Font::buildTextCache(const String& text, float offsetX, float offsetY, unsigned
 void TextCache::setColor(unsigned int color)
 {
   for (auto& vertexList : vertexLists)
-    Renderer::BuildGLColorArray(vertexList.colors.data(), color, (int)vertexList.verts.size());
+    Renderer::BuildGLColorArray(vertexList.colors.data(), color, (int)vertexList.verts->size());
 }
 
 std::shared_ptr<Font>
@@ -3,6 +3,8 @@
 #include <utils/String.h>
 #include <memory>
 #include <map>
+#include <list>
+#include <set>
 
 #include <platform_gl.h>
 #include <ft2build.h>
@@ -11,10 +13,12 @@
 #include <utils/math/Vector2i.h>
 #include <utils/math/Vector2f.h>
 #include <utils/os/fs/Path.h>
+#include <utils/storage/LruCache.h>
 #include <Renderer.h>
 
 #include FT_FREETYPE_H
 
+class Font;
 class TextCache;
 class ThemeElement;
 class ResourceManager;
@@ -41,6 +45,39 @@ enum class TextAlignment : unsigned char
 	Bottom
 };
 
+// Used to store a sort of "pre-rendered" string.
+// When a TextCache is constructed (Font::buildTextCache()), the vertices and texture coordinates of the string are calculated and stored in the TextCache object.
+// Rendering a previously constructed TextCache (Font::renderTextCache) every frame is MUCH faster than rebuilding one every frame.
+// Keep in mind you still need the Font object to render a TextCache (as the Font holds the OpenGL texture), and if a Font changes your TextCache may become invalid.
+class TextCache
+{
+protected:
+	struct Vertex
+	{
+		Vector2f pos;
+		Vector2f tex;
+	};
+
+	struct VertexList
+	{
+		GLuint* textureIdPtr; // this is a pointer because the texture ID can change during deinit/reinit (when launching a game)
+		std::shared_ptr<const std::vector<Vertex> > verts; // shared with the font's shaped text cache
+		std::vector<GLubyte> colors;
+	};
+
+	std::vector<VertexList> vertexLists;
+
+public:
+	struct CacheMetrics
+	{
+		Vector2f size;
+	} metrics;
+
+	void setColor(unsigned int color);
+
+	friend Font;
+};
+
 //A TrueType Font renderer that uses FreeType and OpenGL.
 //The library is automatically initialized when it's needed.
 class Font : public IReloadable
@@ -59,6 +96,9 @@ class Font : public IReloadable
       Vector2i writePos;
       int rowHeight;
 
+      // RAM copy of the used rows, to restore the texture without rasterizing glyphs again
+      std::vector<unsigned char> shadow;
+
       FontTexture();
       ~FontTexture();
       bool findEmpty(const Vector2i& size, Vector2i& cursor_out);
@@ -66,21 +106,25 @@ class Font : public IReloadable
       // you must call initTexture() after creating a FontTexture to get a textureId
       void initTexture(); // initializes the OpenGL texture according to this FontTexture's settings, updating textureId
       void deinitTexture(); // deinitializes the OpenGL texture if any exists, is automatically called in the destructor
+      void storeGlyph(const Vector2i& cursor, const Vector2i& size, const unsigned char* bitmap, int pitch); // copy a glyph bitmap into the shadow
     };
 
     struct FontFace
     {
-      const String data;
+      const std::shared_ptr<const String> data;
       FT_Face face;
 
-      FontFace(String&& d, int size);
+      FontFace(const std::shared_ptr<const String>& d, int size);
       virtual ~FontFace();
     };
 
+    // font files are shared by all sizes, so that fallback fonts are loaded once
+    static std::shared_ptr<const String> getFaceData(const Path& path);
+
     void rebuildTextures();
     void unloadTextures();
 
-    std::vector<FontTexture> mTextures;
+    std::list<FontTexture> mTextures; // list: glyphs & text caches keep pointers to the textures
 
     void getTextureForNewGlyph(const Vector2i& glyphSize, FontTexture*& tex_out, Vector2i& cursor_out);
 
@@ -98,12 +142,66 @@ class Font : public IReloadable
 
       Vector2f advance;
       Vector2f bearing;
+
+      bool measured; // taken into account in the font height. Prewarmed glyphs are not, until first used
     };
 
   private:
     std::map<UnicodeChar, Glyph> mGlyphMap;
 
     Glyph* getGlyph(UnicodeChar id);
+    Glyph* createGlyph(UnicodeChar id, const Vector2i& glyphSize, const unsigned char* bitmap, int pitch, const Vector2f& advance, const Vector2f& bearing, bool measure);
+    void measureGlyph(Glyph& glyph);
+
+    // Glyphs rasterized in the background, uploaded at most per frame
+    static constexpr int sPrewarmUploadsPerFrame = 32;
+    // Characters already queued for background rasterization
+    std::set<UnicodeChar> mPrewarmRequested;
+    void prewarm(const std::vector<UnicodeChar>& characters);
+
+    // Shaped texts: same text & layout give the same vertices
+    struct ShapedTextKey
+    {
+      String text;
+      Vector2f offset;
+      float xLen;
+      float lineSpacing;
+      TextAlignment alignment;
+      bool nospacing;
+
+      bool operator==(const ShapedTextKey& other) const
+      {
+        return text == other.text && offset.x() == other.offset.x() && offset.y() == other.offset.y() && xLen == other.xLen &&
+               lineSpacing == other.lineSpacing && alignment == other.alignment && nospacing == other.nospacing;
+      }
+    };
+    struct ShapedTextHash
+    {
+      size_t operator()(const ShapedTextKey& key) const
+      {
+        std::hash<float> hf;
+        return (size_t)key.text.Hash() ^ (hf(key.offset.x()) * 3) ^ (hf(key.offset.y()) * 5) ^ (hf(key.xLen) * 7) ^
+               (hf(key.lineSpacing) * 11) ^ ((size_t)key.alignment * 13) ^ (key.nospacing ? 17 : 0);
+      }
+    };
+    static constexpr int sMaxShapedTexts = 128;
+    LruCache<ShapedTextKey, TextCache, ShapedTextHash> mShapedTexts; // colorless prototypes
+    TextCache shapeText(const String& text, Vector2f offset, float xLen, TextAlignment alignment, float lineSpacing, bool nospacing);
+
+    // Wrapped texts
+    struct WrappedTextKey
+    {
+      String text;
+      float xLen;
+
+      bool operator==(const WrappedTextKey& other) const { return text == other.text && xLen == other.xLen; }
+    };
+    struct WrappedTextHash
+    {
+      size_t operator()(const WrappedTextKey& key) const { return (size_t)key.text.Hash() ^ (std::hash<float>()(key.xLen) * 3); }
+    };
+    static constexpr int sMaxWrappedTexts = 64;
+    LruCache<WrappedTextKey, String, WrappedTextHash> mWrappedTexts;
 
     int mMaxGlyphHeight;
 
@@ -129,6 +227,10 @@ class Font : public IReloadable
 
     static std::shared_ptr<Font> get(int size, const Path& path = getDefaultPath());
 
+    static void newFrame(); // Upload glyphs rasterized in the background. Must be called between frames
+    static bool needNewFrame(); // true while glyphs rasterized in the background are waiting for the next frame to be uploaded
+    void prewarmText(const String& text); // Rasterize the glyphs of the given text in the background, ahead of its rendering
+
     virtual ~Font();
 
     Vector2f sizeText(const String& text, float lineSpacing = 1.5f); // Returns the expected size of a string when rendered.  Extra spacing is applied to the Y axis.
@@ -178,36 +280,3 @@ class Font : public IReloadable
 
     Glyph& Character(unsigned int unicode) { return *getGlyph(unicode); }
 };
-
-// Used to store a sort of "pre-rendered" string.
-// When a TextCache is constructed (Font::buildTextCache()), the vertices and texture coordinates of the string are calculated and stored in the TextCache object.
-// Rendering a previously constructed TextCache (Font::renderTextCache) every frame is MUCH faster than rebuilding one every frame.
-// Keep in mind you still need the Font object to render a TextCache (as the Font holds the OpenGL texture), and if a Font changes your TextCache may become invalid.
-class TextCache
-{
-protected:
-	struct Vertex
-	{
-		Vector2f pos;
-		Vector2f tex;
-	};
-
-	struct VertexList
-	{
-		GLuint* textureIdPtr; // this is a pointer because the texture ID can change during deinit/reinit (when launching a game)
-		std::vector<Vertex> verts;
-		std::vector<GLubyte> colors;
-	};
-
-	std::vector<VertexList> vertexLists;
-
-public:
-	struct CacheMetrics
-	{
-		Vector2f size;
-	} metrics;
-
-	void setColor(unsigned int color);
-
-	friend Font;
-};
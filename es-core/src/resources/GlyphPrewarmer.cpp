@@ -0,0 +1,155 @@
+#include "GlyphPrewarmer.h"
+#include <resources/ResourceManager.h>
+#include <utils/Log.h>
+#include <cstring>
+
+GlyphPrewarmer::GlyphPrewarmer()
+  : mLibrary(nullptr)
+{
+  if (FT_Init_FreeType(&mLibrary) != 0)
+  {
+    mLibrary = nullptr;
+    { LOG(LogError) << "[GlyphPrewarmer] Error initializing FreeType!"; }
+  }
+}
+
+GlyphPrewarmer::~GlyphPrewarmer()
+{
+  Thread::Stop();
+  ReleaseFaces();
+  if (mLibrary != nullptr)
+    FT_Done_FreeType(mLibrary);
+}
+
+void GlyphPrewarmer::Push(const Path& fontPath, int fontSize, const std::vector<Path>& faces, std::vector<unsigned int>&& characters)
+{
+  if (mLibrary == nullptr || characters.empty()) return;
+  {
+    Mutex::AutoLock locker(mLocker);
+    mJobs.push_back({ fontPath, fontSize, faces, std::move(characters) });
+  }
+  if (!IsRunning()) Thread::Start("GlyphPrewarm");
+  mSignal.Fire();
+}
+
+bool GlyphPrewarmer::Pop(Glyph& glyph)
+{
+  {
+    Mutex::AutoLock locker(mLocker);
+    if (mGlyphs.empty()) return false;
+    glyph = std::move(mGlyphs.front());
+    mGlyphs.pop_front();
+  }
+  mRoomSignal.Fire();
+  return true;
+}
+
+bool GlyphPrewarmer::HasPendingGlyphs() const
+{
+  Mutex::AutoLock locker(mLocker);
+  return !mGlyphs.empty();
+}
+
+void GlyphPrewarmer::Run()
+{
+  while(IsRunning())
+  {
+    Job job;
+    bool available = false;
+    {
+      Mutex::AutoLock locker(mLocker);
+      if (!mJobs.empty())
+      {
+        job = std::move(mJobs.front());
+        mJobs.pop_front();
+        available = true;
+      }
+    }
+    if (available) Rasterize(job);
+    else
+    {
+      // Nothing left to do, do not keep faces in memory
+      ReleaseFaces();
+      mSignal.WaitSignal();
+    }
+  }
+}
+
+void GlyphPrewarmer::Rasterize(const Job& job)
+{
+  for (unsigned int character : job.Characters)
+  {
+    // Same lookup as Font::getFaceForChar, except that missing characters are ignored
+    FT_Face face = nullptr;
+    for (const Path& path : job.Faces)
+    {
+      FT_Face candidate = GetFace(path, job.FontSize);
+      if (candidate != nullptr && FT_Get_Char_Index(candidate, character) != 0)
+      {
+        face = candidate;
+        break;
+      }
+    }
+    if (face == nullptr || FT_Load_Char(face, character, FT_LOAD_RENDER) != 0) continue;
+
+    FT_GlyphSlot g = face->glyph;
+    Glyph glyph
+    {
+      job.FontPath,
+      job.FontSize,
+      character,
+      (int)g->bitmap.width,
+      (int)g->bitmap.rows,
+      Vector2f((float)g->metrics.horiAdvance / 64.0f, (float)g->metrics.vertAdvance / 64.0f),
+      Vector2f((float)g->metrics.horiBearingX / 64.0f, (float)g->metrics.horiBearingY / 64.0f),
+      std::vector<unsigned char>((size_t)g->bitmap.width * g->bitmap.rows),
+    };
+    for (int y = 0; y < glyph.Height; ++y)
+      memcpy(&glyph.Bitmap[(size_t)y * glyph.Width], g->bitmap.buffer + y * g->bitmap.pitch, glyph.Width);
+
+    // Do not get too far ahead of the uploads
+    for (;;)
+    {
+      {
+        Mutex::AutoLock locker(mLocker);
+        if ((int)mGlyphs.size() < sMaxPendingGlyphs)
+        {
+          mGlyphs.push_back(std::move(glyph));
+          break;
+        }
+      }
+      if (!IsRunning()) return;
+      mRoomSignal.WaitSignal();
+    }
+  }
+}
+
+FT_Face GlyphPrewarmer::GetFace(const Path& path, int size)
+{
+  std::pair<Path, int> key(path, size);
+  auto it = mFaces.find(key);
+  if (it != mFaces.end()) return it->second;
+
+  auto data = mFaceData.find(path);
+  if (data == mFaceData.end())
+    data = mFaceData.insert({ path, ResourceManager::getFileData(path) }).first;
+
+  FT_Face face = nullptr;
+  if (FT_New_Memory_Face(mLibrary, (const unsigned char*)data->second.data(), (int)data->second.size(), 0, &face) != 0)
+  {
+    { LOG(LogError) << "[GlyphPrewarmer] Cannot load face " << path.ToString(); }
+    face = nullptr;
+  }
+  else FT_Set_Pixel_Sizes(face, 0, size);
+  mFaces[key] = face;
+  return face;
+}
+
+void GlyphPrewarmer::ReleaseFaces()
+{
+  for (auto& face : mFaces)
+    if (face.second != nullptr)
+      FT_Done_Face(face.second);
+  mFaces.clear();
+  mFaceData.clear();
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <utils/os/system/Thread.h>
+#include <utils/os/system/Mutex.h>
+#include <utils/os/system/Signal.h>
+#include <utils/os/fs/Path.h>
+#include <utils/math/Vector2f.h>
+#include <ft2build.h>
+#include <vector>
+#include <deque>
+#include <map>
+
+#include FT_FREETYPE_H
+
+/*!
+ * @brief Rasterize font glyphs ahead of time
+ *
+ * FreeType rasterization runs in a background thread owning its own library & faces.
+ * Rasterized glyphs are handed back to the main thread, which copies them into the font atlases
+ * between two frames.
+ */
+class GlyphPrewarmer : private Thread
+{
+  public:
+    //! Rasterized glyph
+    struct Glyph
+    {
+      Path FontPath;                     //!< Font path
+      int FontSize;                      //!< Font size
+      unsigned int Character;            //!< Unicode character
+      int Width;                         //!< Bitmap width
+      int Height;                        //!< Bitmap height
+      Vector2f Advance;                  //!< Advance
+      Vector2f Bearing;                  //!< Bearing
+      std::vector<unsigned char> Bitmap; //!< Packed bitmap (pitch = width)
+    };
+
+    //! Constructor
+    GlyphPrewarmer();
+
+    //! Destructor
+    ~GlyphPrewarmer() override;
+
+    /*!
+     * @brief Queue characters to rasterize
+     * @param fontPath Font path
+     * @param fontSize Font size
+     * @param faces Faces to look the characters up in, in order (font then fallbacks)
+     * @param characters Characters to rasterize. Characters not available in any face are ignored
+     */
+    void Push(const Path& fontPath, int fontSize, const std::vector<Path>& faces, std::vector<unsigned int>&& characters);
+
+    /*!
+     * @brief Get the next rasterized glyph
+     * @param glyph Glyph to fill
+     * @return False if no glyph is available
+     */
+    bool Pop(Glyph& glyph);
+
+    /*!
+     * @brief Check if rasterized glyphs are waiting for their upload
+     * @return True if at least one glyph can be popped
+     */
+    [[nodiscard]] bool HasPendingGlyphs() const;
+
+  private:
+    //! Maximum rasterized glyphs waiting for their upload
+    static constexpr int sMaxPendingGlyphs = 256;
+
+    //! Rasterization job
+    struct Job
+    {
+      Path FontPath;                       //!< Font path
+      int FontSize;                        //!< Font size
+      std::vector<Path> Faces;             //!< Faces
+      std::vector<unsigned int> Characters; //!< Characters to rasterize
+    };
+
+    //! FreeType library
+    FT_Library mLibrary;
+    //! Face data by path. Must outlive faces
+    std::map<Path, String> mFaceData;
+    //! Faces by path & size
+    std::map<std::pair<Path, int>, FT_Face> mFaces;
+
+    //! Queue protection
+    mutable Mutex mLocker;
+    //! Wake up signal
+    Signal mSignal;
+    //! Fired when glyphs are popped, to resume a rasterization waiting for room
+    Signal mRoomSignal;
+    //! Pending jobs
+    std::deque<Job> mJobs;
+    //! Rasterized glyphs
+    std::deque<Glyph> mGlyphs;
+
+    /*!
+     * @brief Rasterize all characters of the given job
+     * @param job Job
+     */
+    void Rasterize(const Job& job);
+
+    /*!
+     * @brief Get or load the given face
+     * @param path Face path
+     * @param size Pixel size
+     * @return Face or nullptr
+     */
+    FT_Face GetFace(const Path& path, int size);
+
+    //! Release all faces
+    void ReleaseFaces();
+
+    /*
+     * Thread implementation
+     */
+
+    //! Wake up the thread so that it can exit
+    void Break() override { mSignal.Fire(); mRoomSignal.Fire(); }
+
+    //! Rasterize queued jobs
+    void Run() override;
+};
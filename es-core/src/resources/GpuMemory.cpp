@@ -0,0 +1,129 @@
+#include "GpuMemory.h"
+#include "platform_gl.h"
+#include <RecalboxConf.h>
+#include <utils/Log.h>
+#include <utils/json/JSONBuilder.h>
+#include <sys/sysinfo.h>
+
+std::atomic<long long> GpuMemory::sByCategory[(int)Category::_Count] {};
+std::atomic<long long> GpuMemory::sUsed(0);
+std::atomic<long long> GpuMemory::sPeak(0);
+std::atomic<long long> GpuMemory::sHits(0);
+std::atomic<long long> GpuMemory::sMisses(0);
+std::atomic<long long> GpuMemory::sEvictions(0);
+std::atomic<long long> GpuMemory::sFailures(0);
+std::atomic<bool> GpuMemory::sPressure(false);
+std::atomic<long long> GpuMemory::sBudget(0);
+
+void GpuMemory::Allocate(Category category, long long bytes)
+{
+  sByCategory[(int)category].fetch_add(bytes, std::memory_order_relaxed);
+  long long used = sUsed.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  for(long long peak = sPeak.load(std::memory_order_relaxed); used > peak && !sPeak.compare_exchange_weak(peak, used); );
+}
+
+void GpuMemory::Release(Category category, long long bytes)
+{
+  sByCategory[(int)category].fetch_sub(bytes, std::memory_order_relaxed);
+  sUsed.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+bool GpuMemory::CheckAllocation()
+{
+  if (glGetError() != GL_OUT_OF_MEMORY) return true;
+  sFailures.fetch_add(1, std::memory_order_relaxed);
+  sPressure = true;
+  { LOG(LogWarning) << "[GpuMemory] GL allocation failure with " << (Used() >> 20) << "MB used. Budget: " << (Budget() >> 20) << "MB"; }
+  return false;
+}
+
+/*!
+ * @brief Read the budget again each time its configuration changes
+ */
+class GpuBudgetWatcher : public IRecalboxConfChanged
+{
+  public:
+    //! Constructor
+    explicit GpuBudgetWatcher(const char* key) { RecalboxConf::Instance().Watch(key, *this); }
+
+    void ConfigurationChanged(const String& key) override { (void)key; GpuMemory::InvalidateBudget(); }
+};
+
+long long GpuMemory::Budget()
+{
+  long long budget = sBudget.load(std::memory_order_relaxed);
+  if (budget != 0) return budget;
+
+  static GpuBudgetWatcher sWatcher(sBudgetKey);
+  static long long sDefaultBudget = []
+  {
+    // Boards sharing their memory with the GPU get a budget proportional to their RAM
+    struct sysinfo info {};
+    long long total = sysinfo(&info) == 0 ? (long long)info.totalram * info.mem_unit : 0;
+    return std::min(sMaxBudget, std::max(sMinBudget, total / 12));
+  }();
+  int configured = RecalboxConf::Instance().AsInt(sBudgetKey, 0);
+  budget = configured > 0 ? (long long)configured << 20 : sDefaultBudget;
+  sBudget.store(budget, std::memory_order_relaxed);
+  return budget;
+}
+
+GpuMemory::Statistics GpuMemory::GetStatistics()
+{
+  Statistics statistics {};
+  statistics.Budget = Budget();
+  statistics.Used = sUsed;
+  statistics.Peak = sPeak;
+  for(int i = (int)Category::_Count; --i >= 0; ) statistics.ByCategory[i] = sByCategory[i];
+  statistics.Hits = sHits;
+  statistics.Misses = sMisses;
+  statistics.Evictions = sEvictions;
+  statistics.Failures = sFailures;
+  return statistics;
+}
+
+const char* GpuMemory::CategoryName(Category category)
+{
+  switch(category)
+  {
+    case Category::Textures: return "textures";
+    case Category::Vectors: return "vectors";
+    case Category::Glyphs: return "glyphs";
+    case Category::Videos: return "videos";
+    case Category::_Count:
+    default: break;
+  }
+  return "unknown";
+}
+
+String GpuMemory::OSDLine()
+{
+  Statistics s = GetStatistics();
+  long long binds = s.Hits + s.Misses;
+  return String(" GPU ").Append(s.Used >> 20).Append('/').Append(s.Budget >> 20).Append("MB")
+         .Append(" (T").Append(s.ByCategory[(int)Category::Textures] >> 20)
+         .Append(" S").Append(s.ByCategory[(int)Category::Vectors] >> 20)
+         .Append(" G").Append(s.ByCategory[(int)Category::Glyphs] >> 20)
+         .Append(" V").Append(s.ByCategory[(int)Category::Videos] >> 20)
+         .Append(") Hit ").Append(binds != 0 ? (int)(s.Hits * 100 / binds) : 100).Append('%')
+         .Append(" Ev ").Append(s.Evictions).Append(' ');
+}
+
+String GpuMemory::Report()
+{
+  Statistics s = GetStatistics();
+  JSONBuilder json;
+  json.Open()
+      .Field("budget", s.Budget)
+      .Field("used", s.Used)
+      .Field("peak", s.Peak)
+      .OpenObject("categories");
+  for(int i = 0; i < (int)Category::_Count; ++i) json.Field(CategoryName((Category)i), s.ByCategory[i]);
+  json.CloseObject()
+      .Field("hits", s.Hits)
+      .Field("misses", s.Misses)
+      .Field("evictions", s.Evictions)
+      .Field("failures", s.Failures)
+      .Close();
+  return json;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <utils/String.h>
+#include <atomic>
+
+/*!
+ * @brief GPU memory accounting
+ *
+ * All GL allocations (textures, vector rasters, glyph atlases & video frames) are declared here,
+ * so that a single budget applies to all of them. Textures are evicted by the TextureDataManager
+ * when the budget is exceeded, or when the driver reports an allocation failure.
+ * Counters are atomic: statistics may be read from any thread.
+ */
+class GpuMemory
+{
+  public:
+    //! Allocation category
+    enum class Category
+    {
+      Textures, //!< Raster images
+      Vectors,  //!< Rasterized SVG images
+      Glyphs,   //!< Font atlases
+      Videos,   //!< Video frames
+      _Count,
+    };
+
+    //! Statistics snapshot
+    struct Statistics
+    {
+      long long Budget;                         //!< Budget (bytes)
+      long long Used;                           //!< Total used (bytes)
+      long long Peak;                           //!< Peak usage (bytes)
+      long long ByCategory[(int)Category::_Count]; //!< Usage per category (bytes)
+      long long Hits;                           //!< Texture binds served from VRAM
+      long long Misses;                         //!< Texture binds requiring a decode or an upload
+      long long Evictions;                      //!< Evicted textures
+      long long Failures;                       //!< GL allocation failures
+    };
+
+    /*!
+     * @brief Declare a GL allocation
+     * @param category Category
+     * @param bytes Allocated bytes
+     */
+    static void Allocate(Category category, long long bytes);
+
+    /*!
+     * @brief Declare a GL release
+     * @param category Category
+     * @param bytes Released bytes
+     */
+    static void Release(Category category, long long bytes);
+
+    //! Check the last GL allocation and record a failure if the driver ran out of memory
+    static bool CheckAllocation();
+
+    //! Record a texture bind
+    static void RecordBind(bool hit) { (hit ? sHits : sMisses).fetch_add(1, std::memory_order_relaxed); }
+
+    //! Record a texture eviction
+    static void RecordEviction() { sEvictions.fetch_add(1, std::memory_order_relaxed); }
+
+    //! Get & clear the memory pressure flag, set on allocation failures
+    static bool ConsumePressure() { return sPressure.exchange(false); }
+
+    //! Total used bytes
+    static long long Used() { return sUsed.load(std::memory_order_relaxed); }
+
+    //! Budget in bytes: configured or derived from the physical memory
+    static long long Budget();
+
+    //! Configuration changed: read the budget again on next use
+    static void InvalidateBudget() { sBudget.store(0, std::memory_order_relaxed); }
+
+    //! Get a statistics snapshot
+    static Statistics GetStatistics();
+
+    //! Short statistics line for the OSD
+    static String OSDLine();
+
+    //! Build a JSON report of the statistics
+    static String Report();
+
+  private:
+    //! Budget configuration key
+    static constexpr const char* sBudgetKey = "emulationstation.gpu.budget";
+    //! Default budget bounds
+    static constexpr long long sMinBudget = 64LL << 20;
+    static constexpr long long sMaxBudget = 256LL << 20;
+
+    //! Usage per category
+    static std::atomic<long long> sByCategory[(int)Category::_Count];
+    //! Total usage
+    static std::atomic<long long> sUsed;
+    //! Peak usage
+    static std::atomic<long long> sPeak;
+    //! Bind hits
+    static std::atomic<long long> sHits;
+    //! Bind misses
+    static std::atomic<long long> sMisses;
+    //! Evictions
+    static std::atomic<long long> sEvictions;
+    //! Allocation failures
+    static std::atomic<long long> sFailures;
+    //! Memory pressure
+    static std::atomic<bool> sPressure;
+    //! Cached budget, 0 if it must be read again
+    static std::atomic<long long> sBudget;
+
+    //! Category names
+    static const char* CategoryName(Category category);
+};
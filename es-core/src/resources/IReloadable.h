@@ -10,4 +10,10 @@ class IReloadable
   public:
     virtual void unload(ResourceManager& rm) = 0;
     virtual void reload(ResourceManager& rm) = 0;
+
+    /*!
+     * @brief Release GPU resources only, keeping in RAM what is required to restore them quickly.
+     * Default to a full unload
+     */
+    virtual void suspend(ResourceManager& rm) { unload(rm); }
 };
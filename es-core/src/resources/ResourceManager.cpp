@@ -78,6 +78,21 @@ void ResourceManager::reloadAll()
 	}
 }
 
+void ResourceManager::suspendAll()
+{
+	auto iter = mReloadables.begin();
+	while(iter != mReloadables.end())
+	{
+		if(!iter->expired())
+		{
+			iter->lock()->suspend(*sInstance);
+			iter++;
+		}else{
+			iter = mReloadables.erase(iter);
+		}
+	}
+}
+
 void ResourceManager::addReloadable(const std::weak_ptr<IReloadable>& reloadable)
 {
 	mReloadables.push_back(reloadable);
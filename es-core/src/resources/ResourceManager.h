@@ -20,6 +20,8 @@ public:
 
 	void unloadAll();
 	void reloadAll();
+	// Release GPU resources, keeping decoded data in RAM for a fast reloadAll()
+	void suspendAll();
 
 	static ResourceData getFileData(const Path& path) ;
 	static bool fileExists(const Path& path) ;
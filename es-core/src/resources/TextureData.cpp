@@ -1,7 +1,9 @@
 #include "resources/TextureData.h"
+#include "Renderer.h"
 #include "resources/ResourceManager.h"
 #include "utils/Log.h"
 #include "ImageIO.h"
+#include "resources/ThumbnailCache.h"
 #include <cstring>
 #include "nanosvg/nanosvg.h"
 #include "nanosvg/nanosvgrast.h"
@@ -9,20 +11,28 @@
 #include <vector>
 #include <cassert>
 #include <utils/math/Misc.h>
+#include <utils/Files.h>
+#include <algorithm>
 
 #define DPI 96
 
 TextureData::TextureData()
   : mTile(false),
     mTextureID(0),
+    mFormat(GL_RGBA),
     mDataRGBA(nullptr),
     mWidth(0),
     mHeight(0),
     mSourceWidth(0.0f),
     mSourceHeight(0.0f),
+    mTargetWidth(0),
+    mTargetHeight(0),
     mScalable(false),
     mReloadable(false),
-    mSVGImage(nullptr)
+    mSVGImage(nullptr),
+    mGPUBytes(0),
+    mGPUCategory(GpuMemory::Category::Textures),
+    mLastUsedFrame(0)
 {
 }
 
@@ -123,25 +133,43 @@ bool TextureData::initSVGFromMemory(const unsigned char* fileData, size_t length
 bool TextureData::initImageFromMemory(const unsigned char* fileData, size_t length)
 {
   size_t width = 0, height = 0;
+  size_t targetWidth = 0, targetHeight = 0;
 
   // If already initialised then don't read again
   {
     std::unique_lock<std::mutex> lock(mMutex);
     if (mDataRGBA != nullptr)
       return true;
+    targetWidth = mTargetWidth;
+    targetHeight = mTargetHeight;
   }
 
-  std::vector<unsigned char> imageRGBA = ImageIO::loadFromMemoryRGBA32((const unsigned char*)(fileData), length, width, height);
+  // Downscale-on-decode requires the original size
+  size_t sourceWidth = 0, sourceHeight = 0;
+  bool scaled = (targetWidth != 0) && (targetHeight != 0) &&
+                ImageIO::loadSizeFromMemory(fileData, length, sourceWidth, sourceHeight);
+  if (!scaled) targetWidth = targetHeight = 0;
+
+  std::vector<unsigned char> imageRGBA = ImageIO::loadFromMemoryRGBA32((const unsigned char*)(fileData), length, width, height, targetWidth, targetHeight);
   if (imageRGBA.empty())
   {
     { LOG(LogError) << "[TextureBeta] Could not initialize texture from memory, invalid data!  (file path: " << mPath.ToString() << ", data ptr: " << (size_t)fileData << ", reported size: " << length << ')'; }
     return false;
   }
 
-  mSourceWidth = width;
-  mSourceHeight = height;
+  scaled = scaled && (width != sourceWidth || height != sourceHeight);
+  mSourceWidth = scaled ? sourceWidth : width;
+  mSourceHeight = scaled ? sourceHeight : height;
   mScalable = false;
 
+  // Keep the scaled image for next time
+  if (scaled && ThumbnailCache::IsCacheable(mPath))
+  {
+    ThumbnailCache::Image thumbnail { std::move(imageRGBA), (int)width, (int)height, (int)sourceWidth, (int)sourceHeight };
+    ThumbnailCache::Save(mPath, (int)targetWidth, (int)targetHeight, thumbnail);
+    return initFromRGBA(thumbnail.Pixels.data(), width, height);
+  }
+
   return initFromRGBA(imageRGBA.data(), width, height);
 }
 
@@ -167,6 +195,10 @@ bool TextureData::load()
   // Need to load. See if there is a file
   if (!mPath.IsEmpty())
   {
+    // Try the thumbnail cache first
+    if (loadThumbnail())
+      return true;
+
     const ResourceData& data = ResourceManager::getFileData(mPath);
     // is it an SVG?
     if (mPath.Extension() == ".svg")
@@ -180,6 +212,61 @@ bool TextureData::load()
   return retval;
 }
 
+bool TextureData::loadThumbnail()
+{
+  size_t targetWidth = 0, targetHeight = 0;
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    targetWidth = mTargetWidth;
+    targetHeight = mTargetHeight;
+  }
+  if (targetWidth == 0 || targetHeight == 0 || mPath.Extension() == ".svg" || !ThumbnailCache::IsCacheable(mPath))
+    return false;
+
+  ThumbnailCache::Image thumbnail {};
+  if (!ThumbnailCache::Load(mPath, (int)targetWidth, (int)targetHeight, thumbnail))
+    return false;
+
+  mSourceWidth = (float)thumbnail.SourceWidth;
+  mSourceHeight = (float)thumbnail.SourceHeight;
+  mScalable = false;
+  return initFromRGBA(thumbnail.Pixels.data(), thumbnail.Width, thumbnail.Height);
+}
+
+bool TextureData::probeSize()
+{
+  if (mPath.IsEmpty() || mPath.Extension() == ".svg")
+    return false;
+
+  size_t width = 0, height = 0;
+  // Headers are at the beginning of the file: try to read a few Kb first
+  bool probed = false;
+  if (!mPath.ToString().StartsWith(LEGACY_STRING(":/")))
+  {
+    String header = Files::LoadFile(mPath, 0, sProbeSize);
+    probed = ImageIO::loadSizeFromMemory((const unsigned char*)header.data(), header.size(), width, height);
+  }
+  if (!probed)
+  {
+    const ResourceData& data = ResourceManager::getFileData(mPath);
+    if (!ImageIO::loadSizeFromMemory((const unsigned char*)data.data(), data.size(), width, height))
+      return false;
+  }
+
+  std::unique_lock<std::mutex> lock(mMutex);
+  mWidth = width;
+  mHeight = height;
+  mSourceWidth = width;
+  mSourceHeight = height;
+  return true;
+}
+
+bool TextureData::isUploaded()
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  return mTextureID != 0;
+}
+
 bool TextureData::isLoaded()
 {
   std::unique_lock<std::mutex> lock(mMutex);
@@ -193,6 +280,7 @@ bool TextureData::uploadAndBind()
   if (mTextureID != 0)
   {
     glBindTexture(GL_TEXTURE_2D, mTextureID);
+    Renderer::TextureBound(mTextureID);
   }
   else
   {
@@ -208,55 +296,112 @@ bool TextureData::uploadAndBind()
     //now for the openGL texture stuff
     glGenTextures(1, &mTextureID);
     glBindTexture(GL_TEXTURE_2D, mTextureID);
+    Renderer::TextureBound(mTextureID);
 
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, mWidth, mHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, mDataRGBA);
+    mFormat = GL_RGBA;
+    if (!declareAllocation(mWidth * mHeight * 4, mScalable ? GpuMemory::Category::Vectors : GpuMemory::Category::Textures))
+      return false;
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, Board::Instance().CrtBoard().IsCrtAdapterAttached() ? GL_NEAREST : GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, Board::Instance().CrtBoard().IsCrtAdapterAttached() ? GL_NEAREST : GL_LINEAR);
-
-    const GLint wrapMode = mTile ? GL_REPEAT : GL_CLAMP_TO_EDGE;
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapMode);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapMode);
+    setTextureParameters();
   }
   return true;
 }
 
 bool TextureData::updateFromRGBA(const unsigned char* dataRGBA, size_t width, size_t height)
 {
-  // First time init or reset
-  if (mWidth != width || mHeight != height)
-  {
-    // Already exists?
-    if (mWidth * mHeight != 0)
-      reset();
+  return updateFromPixels(dataRGBA, width, height, GL_RGBA, GL_UNSIGNED_BYTE);
+}
 
-    // First time
-    if (initFromRGBA(dataRGBA, width, height))
-      if (uploadAndBind()) return true;
-    return false;
-  }
+bool TextureData::updateFromRGB565(const unsigned char* dataRGB565, size_t width, size_t height)
+{
+  return updateFromPixels(dataRGB565, width, height, GL_RGB, GL_UNSIGNED_SHORT_5_6_5);
+}
+
+bool TextureData::updateFromPixels(const void* pixels, size_t width, size_t height, GLenum format, GLenum type)
+{
+  // Size or format changed?
+  if (mWidth != width || mHeight != height || mFormat != format)
+    reset();
 
+  std::unique_lock<std::mutex> lock(mMutex);
+  // 16bit rows are not always 4-byte aligned
+  if (type != GL_UNSIGNED_BYTE) glPixelStorei(GL_UNPACK_ALIGNMENT, (width & 1) != 0 ? 2 : 4);
+  if (mTextureID == 0)
   {
-    // Update only
-    std::unique_lock <std::mutex> lock(mMutex);
-    if (width != mWidth) return false;
-    if (height != mHeight) return false;
+    // First time: allocate the texture
+    glGenTextures(1, &mTextureID);
     glBindTexture(GL_TEXTURE_2D, mTextureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, dataRGBA);
+    Renderer::TextureBound(mTextureID);
+    glTexImage2D(GL_TEXTURE_2D, 0, (GLint)format, (GLsizei)width, (GLsizei)height, 0, format, type, pixels);
+    if (!declareAllocation(width * height * (format == GL_RGBA ? 4 : 2), GpuMemory::Category::Videos))
+    {
+      if (type != GL_UNSIGNED_BYTE) glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+      return false;
+    }
+    setTextureParameters();
+    mWidth = width;
+    mHeight = height;
+    mFormat = format;
   }
+  else
+  {
+    // Update only, reusing texture storage
+    glBindTexture(GL_TEXTURE_2D, mTextureID);
+    Renderer::TextureBound(mTextureID);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, (GLsizei)width, (GLsizei)height, format, type, pixels);
+  }
+  if (type != GL_UNSIGNED_BYTE) glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
   return true;
 }
 
+void TextureData::setTextureParameters()
+{
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, Board::Instance().CrtBoard().IsCrtAdapterAttached() ? GL_NEAREST : GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, Board::Instance().CrtBoard().IsCrtAdapterAttached() ? GL_NEAREST : GL_LINEAR);
+
+  const GLint wrapMode = mTile ? GL_REPEAT : GL_CLAMP_TO_EDGE;
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapMode);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapMode);
+}
+
 void TextureData::releaseVRAM()
 {
   std::unique_lock<std::mutex> lock(mMutex);
   if (mTextureID != 0)
   {
+    Renderer::TextureDeleted(mTextureID);
     glDeleteTextures(1, &mTextureID);
     mTextureID = 0;
+    GpuMemory::Release(mGPUCategory, (long long)mGPUBytes);
+    mGPUBytes = 0;
   }
 }
 
+bool TextureData::declareAllocation(size_t bytes, GpuMemory::Category category)
+{
+  // Must be called locked, right after the texture allocation
+  if (!GpuMemory::CheckAllocation())
+  {
+    Renderer::TextureDeleted(mTextureID);
+    glDeleteTextures(1, &mTextureID);
+    mTextureID = 0;
+    return false;
+  }
+  mGPUBytes = bytes;
+  mGPUCategory = category;
+  GpuMemory::Allocate(category, (long long)bytes);
+  return true;
+}
+
+float TextureData::reloadCost() const
+{
+  // Vector images are rasterized again, downscaled images are decoded at full size before being scaled
+  if (mScalable) return 4.f;
+  if (mSourceWidth * mSourceHeight > (float)(mWidth * mHeight)) return 2.f;
+  return 1.f;
+}
+
 void TextureData::releaseRAM()
 {
   std::unique_lock<std::mutex> lock(mMutex);
@@ -292,6 +437,36 @@ float TextureData::sourceHeight()
   return mSourceHeight;
 }
 
+void TextureData::setTargetSize(size_t width, size_t height)
+{
+  // Scalable images are rasterized at their source size, tiled & in-memory images are kept as is
+  if (mScalable || mTile || !mReloadable || width == 0 || height == 0)
+    return;
+
+  bool reload = false;
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (width <= mTargetWidth && height <= mTargetHeight)
+      return;
+    mTargetWidth = std::max(mTargetWidth, width);
+    mTargetHeight = std::max(mTargetHeight, height);
+
+    // Already decoded smaller than required now?
+    if ((mDataRGBA != nullptr || mTextureID != 0) && mSourceWidth > 0 && mSourceHeight > 0)
+    {
+      size_t fitWidth = 0, fitHeight = 0;
+      ImageIO::fitSize((size_t)mSourceWidth, (size_t)mSourceHeight, mTargetWidth, mTargetHeight, fitWidth, fitHeight);
+      reload = mWidth < fitWidth || mHeight < fitHeight;
+    }
+  }
+
+  if (reload)
+  {
+    releaseVRAM();
+    releaseRAM();
+  }
+}
+
 void TextureData::setSourceSize(float width, float height)
 {
   if (mScalable)
@@ -309,7 +484,7 @@ void TextureData::setSourceSize(float width, float height)
 size_t TextureData::getVRAMUsage()
 {
   if ((mTextureID != 0) || (mDataRGBA != nullptr))
-    return mWidth * mHeight * 4;
+    return mWidth * mHeight * (mFormat == GL_RGBA ? 4 : 2);
   else
     return 0;
 }
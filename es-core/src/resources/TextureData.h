@@ -2,6 +2,7 @@
 
 #include <mutex>
 #include "platform_gl.h"
+#include "resources/GpuMemory.h"
 #include <nanosvg/nanosvg.h>
 #include <utils/os/fs/Path.h>
 
@@ -22,13 +23,23 @@ public:
 	bool initImageFromMemory(const unsigned char* fileData, size_t length);
 	bool initFromRGBA(const unsigned char* dataRGBA, size_t width, size_t height);
 
-  bool updateFromRGBA(const unsigned char* dataRGBA, size_t width, size_t height);
+	// These functions stream pixels straight to VRAM, without keeping a copy in RAM.
+	// The texture is created on first call, then only updated while size & format remain the same
+	bool updateFromRGBA(const unsigned char* dataRGBA, size_t width, size_t height);
+	bool updateFromRGB565(const unsigned char* dataRGB565, size_t width, size_t height);
 
     // Read the data into memory if necessary
 	bool load();
 
+	// Read image dimensions from the file header, without decoding pixels.
+	// Returns false if the size cannot be read that way (SVG, unsupported format)
+	bool probeSize();
+
 	bool isLoaded();
 
+	// True if the texture is in VRAM
+	bool isUploaded();
+
 	// Upload the texture to VRAM if necessary and bind. Returns true if bound ok or
 	// false if either not loaded
 	bool uploadAndBind();
@@ -51,19 +62,52 @@ public:
 	float sourceHeight();
 	void setSourceSize(float width, float height);
 
+	// Set the size the texture is displayed at. Raster images are decoded scaled down to fit it.
+	// When shared by several components, the largest size is kept
+	void setTargetSize(size_t width, size_t height);
+
 	bool tiled() { return mTile; }
 
+	// Record the frame the texture has been bound in, and get it back
+	void touch(unsigned int frame) { mLastUsedFrame = frame; }
+	unsigned int lastUsedFrame() const { return mLastUsedFrame; }
+
+	// Relative cost of decoding the texture again once evicted
+	float reloadCost() const;
+
 private:
+	// Bytes read to probe image size
+	static constexpr int sProbeSize = 64 * 1024;
+
+	// Load the scaled image from the thumbnail cache, if any
+	bool loadThumbnail();
+
+	// Create or update the texture from raw pixels of the given GL format & type
+	bool updateFromPixels(const void* pixels, size_t width, size_t height, GLenum format, GLenum type);
+
+	// Set filtering & wrapping parameters of the bound texture
+	void setTextureParameters();
+
 	std::mutex		mMutex;
 	bool			mTile;
 	Path		mPath;
 	GLuint 			mTextureID;
+	GLenum			mFormat;
 	unsigned char*	mDataRGBA;
 	size_t			mWidth;
 	size_t			mHeight;
 	float			mSourceWidth;
 	float			mSourceHeight;
+	size_t			mTargetWidth;
+	size_t			mTargetHeight;
 	bool			mScalable;
 	bool			mReloadable;
 	NSVGimage*		mSVGImage;
+	// GPU memory allocated by the texture & its category
+	size_t			mGPUBytes;
+	GpuMemory::Category mGPUCategory;
+	unsigned int	mLastUsedFrame;
+
+	// Declare the bound texture allocation, releasing it on GL failure
+	bool declareAllocation(size_t bytes, GpuMemory::Category category);
 };
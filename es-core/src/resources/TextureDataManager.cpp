@@ -1,9 +1,15 @@
 #include "resources/TextureDataManager.h"
 
 #include <memory>
+#include <chrono>
 #include "resources/TextureResource.h"
+#include "resources/GpuMemory.h"
+#include <algorithm>
 
 TextureDataManager::TextureDataManager()
+  : mFrameUploadTime(0),
+    mFrameUploads(0),
+    mFrame(sPinnedFrames + 1)
 {
 	unsigned char data[5 * 5 * 4];
 	mBlank = std::make_shared<TextureData>(false);
@@ -38,6 +44,8 @@ void TextureDataManager::remove(const TextureResource* key)
 	auto it = mTextureLookup.find(key);
 	if (it != mTextureLookup.end())
 	{
+		// Cancel any pending load
+		mLoader->remove(*(*it).second);
 		// Remove the list entry
 		mTextures.erase((*it).second);
 		// And the lookup
@@ -45,7 +53,7 @@ void TextureDataManager::remove(const TextureResource* key)
 	}
 }
 
-std::shared_ptr<TextureData> TextureDataManager::get(const TextureResource* key)
+std::shared_ptr<TextureData> TextureDataManager::get(const TextureResource* key, TextureLoader::Priority priority)
 {
 	// If it's in the cache then we want to remove it from it's current location and
 	// move it to the top
@@ -62,22 +70,124 @@ std::shared_ptr<TextureData> TextureDataManager::get(const TextureResource* key)
 		mTextureLookup[key] = mTextures.begin();
 
 		// Make sure it's loaded or queued for loading
-		load(tex);
+		load(tex, false, priority);
 	}
 	return tex;
 }
 
 bool TextureDataManager::bind(const TextureResource* key)
 {
-	std::shared_ptr<TextureData> tex = get(key);
+	std::shared_ptr<TextureData> tex = get(key, TextureLoader::Priority::Visible);
 	bool bound = false;
 	if (tex != nullptr)
-		bound = tex->uploadAndBind();
+	{
+		tex->touch(mFrame);
+		GpuMemory::RecordBind(tex->isUploaded());
+		bound = uploadAndBind(tex);
+	}
 	if (!bound)
 		mBlank->uploadAndBind();
 	return bound;
 }
 
+bool TextureDataManager::uploadAndBind(const std::shared_ptr<TextureData>& tex)
+{
+	// Already in VRAM or not decoded yet: nothing to upload
+	if (tex->isUploaded() || !tex->isLoaded())
+		return tex->uploadAndBind();
+
+	// Over budget? Always allow one upload per frame so that the queue keeps moving
+	if (mFrameUploads != 0 && mFrameUploadTime >= sUploadBudgetUs)
+		return false;
+
+	auto start = std::chrono::steady_clock::now();
+	bool bound = tex->uploadAndBind();
+	mFrameUploadTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	mFrameUploads++;
+	return bound;
+}
+
+void TextureDataManager::newFrame()
+{
+	mFrameUploadTime = 0;
+	mFrameUploads = 0;
+	mFrame++;
+	mLoader->newFrame();
+
+	// Glyph atlases & video frames may have grown, or the driver may have run out of memory
+	long long budget = GpuMemory::Budget();
+	if (GpuMemory::ConsumePressure())
+		evict(budget * 3 / 4);
+	else if (GpuMemory::Used() > budget)
+		evict(budget);
+
+	// Upload freshly decoded textures before they are bound
+	std::shared_ptr<TextureData> tex;
+	while ((mFrameUploads == 0 || mFrameUploadTime < sUploadBudgetUs) && mLoader->popDecoded(tex))
+		if (!tex->isUploaded() && tex->isLoaded())
+			uploadAndBind(tex);
+}
+
+void TextureDataManager::suspend(const TextureResource* key)
+{
+	// Lookup without touching the MRU order nor queuing a load
+	auto it = mTextureLookup.find(key);
+	if (it != mTextureLookup.end())
+	{
+		const std::shared_ptr<TextureData>& tex = *(*it).second;
+		mLoader->remove(tex);
+		tex->releaseVRAM();
+	}
+}
+
+void TextureDataManager::trimRAM(size_t budget)
+{
+	// Most recently used textures first
+	size_t kept = 0;
+	for (const auto& tex : mTextures)
+		if (tex->isLoaded())
+		{
+			size_t size = tex->width() * tex->height() * 4;
+			if (kept + size <= budget)
+				kept += size;
+			else
+				tex->releaseRAM();
+		}
+}
+
+void TextureDataManager::evict(long long target)
+{
+	if (GpuMemory::Used() <= target)
+		return;
+
+	// Candidates: textures in VRAM, not visible. Oldest & cheapest to reload first
+	struct Candidate
+	{
+		std::shared_ptr<TextureData> Texture;
+		float Score;
+	};
+	std::vector<Candidate> candidates;
+	for (auto it = mTextures.rbegin(); it != mTextures.rend(); ++it)
+	{
+		const std::shared_ptr<TextureData>& tex = *it;
+		if (!tex->isUploaded() || mFrame - tex->lastUsedFrame() <= sPinnedFrames)
+			continue;
+		candidates.push_back({ tex, (float)(mFrame - tex->lastUsedFrame()) / tex->reloadCost() });
+	}
+	std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) { return a.Score > b.Score; });
+
+	for (const Candidate& candidate : candidates)
+	{
+		if (GpuMemory::Used() <= target)
+			break;
+		candidate.Texture->releaseVRAM();
+		candidate.Texture->releaseRAM();
+		// It may be already in the loader queue. Remove it so that it does not come back
+		mLoader->remove(candidate.Texture);
+		GpuMemory::RecordEviction();
+	}
+}
+
 size_t TextureDataManager::getTotalSize()
 {
 	size_t total = 0;
@@ -99,105 +209,160 @@ size_t TextureDataManager::getQueueSize()
 	return mLoader->getQueueSize();
 }
 
-void TextureDataManager::load(const std::shared_ptr<TextureData>& tex, bool block)
+void TextureDataManager::load(const std::shared_ptr<TextureData>& tex, bool block, TextureLoader::Priority priority)
 {
 	// See if it's already loaded
 	if (tex->isLoaded())
 		return;
 	// Not loaded. Make sure there is room
-	size_t size = TextureResource::getTotalMemUsage();
-	size_t max_texture = 80 * 1024 * 1024;
-
-	//size_t in = size;
-
-	for (auto it = mTextures.rbegin(); it != mTextures.rend(); ++it)
-	{
-		if (size < max_texture)
-			break;
-		//size -= (*it)->getVRAMUsage();
-		(*it)->releaseVRAM();
-		(*it)->releaseRAM();
-		// It may be already in the loader queue. In this case it wouldn't have been using
-		// any VRAM yet but it will be. Remove it from the loader queue
-		mLoader->remove(*it);
-		size = TextureResource::getTotalMemUsage();
-	}
+	evict(GpuMemory::Budget());
 	if (!block)
-		mLoader->load(tex);
+		mLoader->load(tex, priority);
 	else
-		tex->load();
+		mLoader->loadNow(tex);
 }
 
-TextureLoader::TextureLoader() : mExit(false)
+TextureLoader::TextureLoader()
+  : mFrame(0),
+    mExit(false)
 {
-	mThread = new std::thread(&TextureLoader::threadProc, this);
+	int count = (int)std::thread::hardware_concurrency();
+	if (count < 1) count = 1;
+	if (count > sMaxWorkers) count = sMaxWorkers;
+	for (int i = 0; i < count; ++i)
+		mThreads.push_back(new std::thread(&TextureLoader::threadProc, this));
 }
 
 TextureLoader::~TextureLoader()
 {
-	// Exit the thread
-	mExit = true;
-	mEvent.notify_one();
-	mThread->join();
-	delete mThread;
+	// Exit the threads
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mExit = true;
+	}
+	mEvent.notify_all();
+	for (std::thread* thread : mThreads)
+	{
+		thread->join();
+		delete thread;
+	}
+	mThreads.clear();
 
   // Just abort any waiting texture
-  mTextureDataQ.clear();
+  for (RequestList& queue : mTextureDataQ)
+    queue.clear();
   mTextureDataLookup.clear();
+  mInFlight.clear();
+  mDecodedQ.clear();
 }
 
 void TextureLoader::threadProc()
 {
-	while (!mExit)
+	for (;;)
 	{
 		std::shared_ptr<TextureData> textureData;
 		{
-			// Wait for an event to say there is something in the queue
+			// Wait for something in the queues, highest priority first
 			std::unique_lock<std::mutex> lock(mMutex);
-			mEvent.wait(lock);
-			if (!mTextureDataQ.empty())
-			{
-				textureData = mTextureDataQ.front();
-				mTextureDataQ.pop_front();
-				mTextureDataLookup.erase(mTextureDataLookup.find(textureData.get()));
-			}
+			RequestList::iterator request;
+			mEvent.wait(lock, [this, &request] { return mExit || nextRequest(request); });
+			if (mExit)
+				return;
+			textureData = request->Data;
+			mTextureDataQ[(int)request->Level].erase(request);
+			mTextureDataLookup.erase(textureData.get());
+			mInFlight.insert(textureData.get());
 		}
-		// Queue has been released here but we might have a texture to process
-		while (textureData && !mExit)
-		{
-			textureData->load();
 
-			// See if there is another item in the queue
-			textureData = nullptr;
+		// Decode outside the lock
+		bool loaded = textureData->load();
+		{
 			std::unique_lock<std::mutex> lock(mMutex);
-			if (!mTextureDataQ.empty())
-			{
-				textureData = mTextureDataQ.front();
-				mTextureDataQ.pop_front();
-				mTextureDataLookup.erase(mTextureDataLookup.find(textureData.get()));
-			}
+			mInFlight.erase(textureData.get());
+			// Hand it to the upload stage
+			if (loaded)
+				mDecodedQ.push_back(textureData);
+		}
+		// Wake up loadNow() waiters
+		mEvent.notify_all();
+	}
+}
+
+void TextureLoader::loadNow(const std::shared_ptr<TextureData>& textureData)
+{
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		unqueue(textureData.get());
+		if (mInFlight.count(textureData.get()) != 0)
+		{
+			mEvent.wait(lock, [this, &textureData] { return mInFlight.count(textureData.get()) == 0; });
+			return;
+		}
+		mInFlight.insert(textureData.get());
+	}
+
+	textureData->load();
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mInFlight.erase(textureData.get());
+	}
+	mEvent.notify_all();
+}
+
+bool TextureLoader::nextRequest(RequestList::iterator& request)
+{
+	RequestList& visible = mTextureDataQ[(int)Priority::Visible];
+	if (!visible.empty())
+	{
+		request = visible.begin();
+		return true;
+	}
+	// Prefetch requests are delayed until the frame they were issued in is over,
+	// so that components have set their display size before decoding starts
+	RequestList& prefetch = mTextureDataQ[(int)Priority::Prefetch];
+	for (auto it = prefetch.begin(); it != prefetch.end(); ++it)
+		if (it->Frame != mFrame)
+		{
+			request = it;
+			return true;
 		}
+	return false;
+}
+
+void TextureLoader::unqueue(TextureData* textureData)
+{
+	auto td = mTextureDataLookup.find(textureData);
+	if (td != mTextureDataLookup.end())
+	{
+		mTextureDataQ[(int)(*td).second->Level].erase((*td).second);
+		mTextureDataLookup.erase(td);
 	}
 }
 
-void TextureLoader::load(const std::shared_ptr<TextureData>& textureData)
+void TextureLoader::load(const std::shared_ptr<TextureData>& textureData, Priority priority)
 {
 	// Make sure it's not already loaded
 	if (!textureData->isLoaded())
 	{
 		std::unique_lock<std::mutex> lock(mMutex);
-		// Remove it from the queue if it is already there
+		// Already being decoded: it will reach the upload stage soon
+		if (mInFlight.count(textureData.get()) != 0)
+			return;
+		// Remove it from the queue if it is already there.
+		// A prefetch request never demotes a visible one, nor delays a pending prefetch
 		auto td = mTextureDataLookup.find(textureData.get());
 		if (td != mTextureDataLookup.end())
 		{
-			mTextureDataQ.erase((*td).second);
-			mTextureDataLookup.erase(td);
+			if (priority == Priority::Prefetch)
+				return;
+			unqueue(textureData.get());
 		}
 
 		// Put it on the start of the queue as we want the newly requested textures to load first
-		mTextureDataQ.push_front(textureData);
-		mTextureDataLookup[textureData.get()] = mTextureDataQ.begin();
-		mEvent.notify_one();
+		RequestList& queue = mTextureDataQ[(int)priority];
+		queue.push_front({ textureData, priority, mFrame });
+		mTextureDataLookup[textureData.get()] = queue.begin();
+		mEvent.notify_all();
 	}
 }
 
@@ -205,12 +370,51 @@ void TextureLoader::remove(const std::shared_ptr<TextureData>& textureData)
 {
 	// Just remove it from the queue so we don't attempt to load it
 	std::unique_lock<std::mutex> lock(mMutex);
-	auto td = mTextureDataLookup.find(textureData.get());
-	if (td != mTextureDataLookup.end())
+	unqueue(textureData.get());
+}
+
+void TextureLoader::newFrame()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	// Visible requests are renewed each time the texture is bound for rendering.
+	// Those not renewed during the last frame are out of view
+	RequestList& queue = mTextureDataQ[(int)Priority::Visible];
+	for (auto it = queue.begin(); it != queue.end(); )
+		if (it->Frame != mFrame)
+		{
+			mTextureDataLookup.erase(it->Data.get());
+			it = queue.erase(it);
+		}
+		else ++it;
+	mFrame++;
+	// Delayed prefetch requests are now available
+	if (!mTextureDataQ[(int)Priority::Prefetch].empty())
+		mEvent.notify_all();
+}
+
+bool TextureLoader::popDecoded(std::shared_ptr<TextureData>& textureData)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (!mDecodedQ.empty())
 	{
-		mTextureDataQ.erase((*td).second);
-		mTextureDataLookup.erase(td);
+		textureData = mDecodedQ.front().lock();
+		mDecodedQ.pop_front();
+		// Skip textures deleted in the meantime
+		if (textureData)
+			return true;
 	}
+	return false;
+}
+
+bool TextureLoader::needNewFrame()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	if (!mDecodedQ.empty())
+		return true;
+	for (const auto& request : mTextureDataQ[(int)Priority::Prefetch])
+		if (request.Frame == mFrame)
+			return true;
+	return false;
 }
 
 size_t TextureLoader::getQueueSize()
@@ -219,9 +423,8 @@ size_t TextureLoader::getQueueSize()
 	// the queue are loaded
 	size_t mem = 0;
 	std::unique_lock<std::mutex> lock(mMutex);
-	for (const auto& tex : mTextureDataQ)
-	{
-		mem += tex->width() * tex->height() * 4;
-	}
+	for (const RequestList& queue : mTextureDataQ)
+		for (const auto& request : queue)
+			mem += request.Data->width() * request.Data->height() * 4;
 	return mem;
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <map>
+#include <set>
+#include <vector>
 #include <list>
 #include <memory>
 #include <thread>
@@ -16,23 +18,62 @@ class TextureResource;
 class TextureLoader
 {
 public:
+	// Load priorities. Visible textures are decoded first, then prefetched ones
+	enum class Priority
+	{
+		Visible,
+		Prefetch,
+		Count,
+	};
+
 	TextureLoader();
 	~TextureLoader();
 
-	void load(const std::shared_ptr<TextureData>& textureData);
+	void load(const std::shared_ptr<TextureData>& textureData, Priority priority);
 	void remove(const std::shared_ptr<TextureData>& textureData);
 
+	// Decode the given texture in the calling thread, or wait for the worker already decoding it
+	void loadNow(const std::shared_ptr<TextureData>& textureData);
+
+	// Start a new frame. Visible requests not renewed during the previous frame
+	// have scrolled out of view and are cancelled
+	void newFrame();
+
+	// Get the next decoded texture waiting to be uploaded to VRAM
+	bool popDecoded(std::shared_ptr<TextureData>& textureData);
+
+	// Check if a new frame is required to move on: decoded textures waiting for their upload,
+	// or prefetch requests waiting for the end of the current frame
+	bool needNewFrame();
+
 	size_t getQueueSize();
 
 private:
+	// Maximum decoding threads
+	static constexpr int sMaxWorkers = 4;
+
+	struct Request
+	{
+		std::shared_ptr<TextureData> Data;     // Texture to decode
+		Priority                     Level;    // Priority
+		unsigned int                 Frame;    // Frame of the last request
+	};
+	typedef std::list<Request> RequestList;
+
 	void threadProc();
+	void unqueue(TextureData* textureData);
+	// Get the next request to decode, if any. Must be called locked
+	bool nextRequest(RequestList::iterator& request);
 
-	std::list<std::shared_ptr<TextureData> > 										mTextureDataQ;
-	std::map<TextureData*, std::list<std::shared_ptr<TextureData> >::iterator > 	mTextureDataLookup;
+	RequestList																mTextureDataQ[(int)Priority::Count];
+	std::map<TextureData*, RequestList::iterator>							mTextureDataLookup;
+	std::set<TextureData*>													mInFlight; // Being decoded, never queued again meanwhile
+	std::list<std::weak_ptr<TextureData> >									mDecodedQ;
 
-	std::thread*				mThread;
+	std::vector<std::thread*>	mThreads;
 	std::mutex					mMutex;
 	std::condition_variable		mEvent;
+	unsigned int				mFrame;
 	bool 						mExit;
 };
 
@@ -50,6 +91,14 @@ private:
 // to releaseRAM() which frees the memory buffer if the texture can be reloaded from
 // disk if needed again
 //
+// Background loads are decoded by a pool of workers, visible textures first.
+// Decoded textures are uploaded to VRAM at the start of each frame, and when bound,
+// as long as the per-frame upload budget is not exhausted
+//
+// GPU memory (textures, glyph atlases & video frames) is kept within the GpuMemory budget
+// by evicting the least recently bound textures, weighted by their reload cost. Textures
+// bound during the last frames are visible and never evicted
+//
 class TextureDataManager
 {
 public:
@@ -63,9 +112,21 @@ public:
 	// will be deleted when the other thread has finished with it
 	void remove(const TextureResource* key);
 
-	std::shared_ptr<TextureData> get(const TextureResource* key);
+	std::shared_ptr<TextureData> get(const TextureResource* key, TextureLoader::Priority priority = TextureLoader::Priority::Prefetch);
 	bool bind(const TextureResource* key);
 
+	// Start a new frame: cancel out-of-view requests and upload decoded textures, within the frame budget
+	void newFrame();
+
+	// Release the VRAM of the given texture, keeping its decoded data, and cancel its pending load
+	void suspend(const TextureResource* key);
+
+	// Release decoded data of the least recently used textures, once the given RAM budget (bytes) is exhausted
+	void trimRAM(size_t budget);
+
+	// Check if a new frame is required to upload decoded textures or to start prefetching
+	bool needNewFrame() { return mLoader->needNewFrame(); }
+
 	// Get the total size of all textures managed by this object, loaded and unloaded in bytes
 	size_t	getTotalSize();
 	// Get the total size of all committed textures (in VRAM) in bytes
@@ -74,12 +135,26 @@ public:
 	// be committed to VRAM as the queue is processed
 	size_t  getQueueSize();
 	// Load a texture, freeing resources as necessary to make space
-	void load(const std::shared_ptr<TextureData>& tex, bool block = false);
+	void load(const std::shared_ptr<TextureData>& tex, bool block = false, TextureLoader::Priority priority = TextureLoader::Priority::Prefetch);
 
 private:
+	// Maximum time spent uploading textures to VRAM per frame, in microseconds
+	static constexpr long long sUploadBudgetUs = 4000;
+
+	// Textures bound during the last frames are pinned
+	static constexpr unsigned int sPinnedFrames = 2;
+
+	// Upload the given texture if the frame budget allows it, then bind it
+	bool uploadAndBind(const std::shared_ptr<TextureData>& tex);
+
+	// Evict textures until the GPU memory usage fits the given target (bytes)
+	void evict(long long target);
 
 	std::list<std::shared_ptr<TextureData> >												mTextures;
 	std::map<const TextureResource*, std::list<std::shared_ptr<TextureData> >::iterator > 	mTextureLookup;
 	std::shared_ptr<TextureData>															mBlank;
 	TextureLoader*																			mLoader;
+	long long																				mFrameUploadTime;
+	int																						mFrameUploads;
+	unsigned int																			mFrame;
 };
@@ -25,8 +25,9 @@ TextureResource::TextureResource(const Path& path, bool tile, bool dynamic)
 		{
 			data = sTextureDataManager.add(this, tile);
 			data->initFromPath(path);
-			// Force the texture manager to load it using a blocking load
-			sTextureDataManager.load(data, true);
+			// Read the size from the image header and let the loader decode it in background.
+			// Otherwise (SVG, ...) force the texture manager to load it using a blocking load
+			sTextureDataManager.load(data, !data->probeSize());
 		}
 		else
 		{
@@ -156,10 +157,21 @@ void TextureResource::rasterizeAt(size_t width, size_t height)
 		data = sTextureDataManager.get(this);
 	mSourceSize.Set((float)width, (float)height);
 	data->setSourceSize((float)width, (float)height);
+	data->setTargetSize(width, height);
 	if (mForceLoad || (mTextureData != nullptr))
 		data->load();
 }
 
+void TextureResource::newFrame()
+{
+	sTextureDataManager.newFrame();
+}
+
+bool TextureResource::needNewFrame()
+{
+	return sTextureDataManager.needNewFrame();
+}
+
 size_t TextureResource::getTotalMemUsage()
 {
 	size_t total = 0;
@@ -206,6 +218,22 @@ void TextureResource::unload(ResourceManager& rm)
 	data->releaseRAM();
 }
 
+void TextureResource::suspend(ResourceManager& rm)
+{
+	(void)rm;
+
+	// Keep decoded data so that textures are uploaded again without decoding
+	if (mTextureData == nullptr)
+		sTextureDataManager.suspend(this);
+	else
+		mTextureData->releaseVRAM();
+}
+
+void TextureResource::trimRAM(size_t budget)
+{
+	sTextureDataManager.trimRAM(budget);
+}
+
 void TextureResource::reload(ResourceManager& rm)
 {
 	(void)rm;
@@ -32,6 +32,12 @@ public:
   Vector2i getSize() const { return mSize; }
 	bool bind();
 
+	// Must be called by the render thread before each frame
+	static void newFrame();
+	static bool needNewFrame(); // true while decoded textures are waiting for the next frame to be uploaded
+
+	static void trimRAM(size_t budget); // release decoded data of the least recently used textures over the given budget (in bytes)
+
 	static size_t getTotalMemUsage(); // returns an approximation of total VRAM used by textures (in bytes)
 	static size_t getTotalTextureSize(); // returns the number of bytes that would be used if all textures were in memory
 
@@ -39,6 +45,7 @@ protected:
 	TextureResource(const Path& path, bool tile, bool dynamic);
 	void unload(ResourceManager& rm) override;
 	void reload(ResourceManager& rm) override;
+	void suspend(ResourceManager& rm) override;
 
 private:
 	// mTextureData is used for textures that are not loaded from a file - these ones
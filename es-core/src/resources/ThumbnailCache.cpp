@@ -0,0 +1,182 @@
+#include "resources/ThumbnailCache.h"
+#include <RootFolders.h>
+#include <RecalboxConf.h>
+#include <utils/Files.h>
+#include <utils/Log.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <algorithm>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+Mutex ThumbnailCache::sLocker;
+long long ThumbnailCache::sCacheSize = -1;
+
+bool ThumbnailCache::IsCacheable(const Path& source)
+{
+  static bool enabled = RecalboxConf::Instance().AsBool("emulationstation.thumbnailcache", true);
+  // Embedded resources are never cached
+  return enabled && !source.IsEmpty() && !source.ToString().StartsWith(LEGACY_STRING(":/"));
+}
+
+long long ThumbnailCache::Budget()
+{
+  static long long budget = (long long)RecalboxConf::Instance().AsInt("emulationstation.thumbnailcache.size", sDefaultBudgetMb) << 20;
+  return budget;
+}
+
+Path ThumbnailCache::CacheFolder()
+{
+  return RootFolders::DataRootFolder / sCacheFolder;
+}
+
+Path ThumbnailCache::EntryPath(const Path& source)
+{
+  String name(source.ToString().Hash(), 8, String::Hexa::None);
+  name.Append(".rgba");
+  return CacheFolder() / name;
+}
+
+long long ThumbnailCache::EntrySize(const Path& entry)
+{
+  struct stat64 info {};
+  return stat64(entry.ToChars(), &info) == 0 ? (long long)info.st_size : 0;
+}
+
+void ThumbnailCache::Account(long long delta)
+{
+  Mutex::AutoLock locker(sLocker);
+  if (sCacheSize < 0) Evict();
+  sCacheSize += delta;
+  if (sCacheSize > Budget()) Evict();
+}
+
+void ThumbnailCache::Evict()
+{
+  struct Entry
+  {
+    Path File;
+    long long Time;
+    long long Size;
+  };
+
+  // Scan the cache
+  std::vector<Entry> entries;
+  long long total = 0;
+  for(const Path& file : CacheFolder().GetDirectoryContent(false))
+  {
+    struct stat64 info {};
+    if (stat64(file.ToChars(), &info) != 0) continue;
+    entries.push_back({ file, (long long)info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec, (long long)info.st_size });
+    total += info.st_size;
+  }
+
+  // Remove least recently used entries until the cache is back under 3/4 of its budget
+  long long budget = Budget();
+  if (total > budget)
+  {
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.Time < b.Time; });
+    int removed = 0;
+    for(const Entry& entry : entries)
+    {
+      if (total <= (budget / 4) * 3) break;
+      if (entry.File.Delete()) { total -= entry.Size; removed++; }
+    }
+    { LOG(LogDebug) << "[ThumbnailCache] " << removed << " least recently used thumbnails evicted"; }
+  }
+  sCacheSize = total;
+}
+
+bool ThumbnailCache::SourceStamp(const Path& source, long long& time, long long& size)
+{
+  struct stat64 info {};
+  if (stat64(source.ToChars(), &info) != 0) return false;
+  time = (long long)info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+  size = info.st_size;
+  return true;
+}
+
+bool ThumbnailCache::Load(const Path& source, int targetWidth, int targetHeight, Image& image)
+{
+  long long time = 0;
+  long long size = 0;
+  if (!SourceStamp(source, time, size)) return false;
+
+  int fd = open(EntryPath(source).ToChars(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return false;
+
+  // Check header & source path
+  Header header {};
+  const String& path = source.ToString();
+  bool ok = read(fd, &header, sizeof(header)) == (ssize_t)sizeof(header) &&
+            memcmp(header.Magic, sMagic, sizeof(header.Magic)) == 0 &&
+            header.Version == sVersion &&
+            header.SourceTime == time &&
+            header.SourceSize == size &&
+            header.TargetWidth == targetWidth &&
+            header.TargetHeight == targetHeight &&
+            header.PathLength == (int)path.size() &&
+            header.Width > 0 && header.Height > 0;
+  if (ok)
+  {
+    String storedPath;
+    storedPath.resize(header.PathLength);
+    ok = read(fd, (void*)storedPath.data(), header.PathLength) == (ssize_t)header.PathLength && storedPath == path;
+  }
+
+  // Read pixels
+  if (ok)
+  {
+    size_t length = (size_t)header.Width * (size_t)header.Height * 4;
+    image.Pixels.resize(length);
+    ok = read(fd, image.Pixels.data(), length) == (ssize_t)length;
+    image.Width = header.Width;
+    image.Height = header.Height;
+    image.SourceWidth = header.SourceWidth;
+    image.SourceHeight = header.SourceHeight;
+  }
+  // Touch used entries, so that least recently used ones are evicted first
+  if (ok) (void)futimens(fd, nullptr);
+  close(fd);
+
+  if (!ok) image.Pixels.clear();
+  return ok;
+}
+
+void ThumbnailCache::Save(const Path& source, int targetWidth, int targetHeight, const Image& image)
+{
+  Header header {};
+  if (!SourceStamp(source, header.SourceTime, header.SourceSize)) return;
+
+  const String& path = source.ToString();
+  memcpy(header.Magic, sMagic, sizeof(header.Magic));
+  header.Version = sVersion;
+  header.TargetWidth = targetWidth;
+  header.TargetHeight = targetHeight;
+  header.Width = image.Width;
+  header.Height = image.Height;
+  header.SourceWidth = image.SourceWidth;
+  header.SourceHeight = image.SourceHeight;
+  header.PathLength = (int)path.size();
+
+  String content;
+  content.reserve(sizeof(header) + path.size() + image.Pixels.size());
+  content.Append((const char*)&header, (int)sizeof(header))
+         .Append(path)
+         .Append((const char*)image.Pixels.data(), (int)image.Pixels.size());
+
+  // Several decoders may save at the same time: use a per-thread temporary file, then atomically replace the entry
+  // Only one size is kept per source: a new size replaces the previous entry
+  Path entry = EntryPath(source);
+  Path temporary = entry.ChangeExtension(String(".").Append((int)syscall(SYS_gettid)).Append(".tmp"));
+  (void)entry.Directory().CreatePath();
+  long long previousSize = EntrySize(entry);
+  if (!Files::SaveFile(temporary, content) || !Path::Rename(temporary, entry))
+  {
+    { LOG(LogWarning) << "[ThumbnailCache] Cannot save thumbnail of " << path; }
+    (void)temporary.Delete();
+    return;
+  }
+  Account((long long)content.size() - previousSize);
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <vector>
+#include <utils/os/fs/Path.h>
+#include <utils/os/system/Mutex.h>
+
+/*!
+ * @brief Persistent cache of downscaled, GPU-ready images
+ *
+ * Each entry holds the RGBA pixels of a source image decoded and scaled to fit a target size,
+ * in the exact layout uploaded to VRAM.
+ * Entries are keyed by source path, source modification time and target size,
+ * so that a modified image or a new display size never hits a stale entry.
+ * Only one size is kept per source, and the cache size is bounded by a byte budget
+ * (emulationstation.thumbnailcache.size, in Mb): least recently used entries are evicted first.
+ */
+class ThumbnailCache
+{
+  public:
+    //! Cached image
+    struct Image
+    {
+      std::vector<unsigned char> Pixels; //!< RGBA pixels
+      int Width;                         //!< Pixel width
+      int Height;                        //!< Pixel height
+      int SourceWidth;                   //!< Source image width
+      int SourceHeight;                  //!< Source image height
+    };
+
+    /*!
+     * @brief Check if the cache is enabled and can be used for the given source
+     * @param source Source image path
+     * @return True if the source image can be cached
+     */
+    static bool IsCacheable(const Path& source);
+
+    /*!
+     * @brief Load a cached image
+     * @param source Source image path
+     * @param targetWidth Target width
+     * @param targetHeight Target height
+     * @param image Image to fill in
+     * @return True if a valid entry has been found
+     */
+    static bool Load(const Path& source, int targetWidth, int targetHeight, Image& image);
+
+    /*!
+     * @brief Store an image
+     * @param source Source image path
+     * @param targetWidth Target width
+     * @param targetHeight Target height
+     * @param image Image to store
+     */
+    static void Save(const Path& source, int targetWidth, int targetHeight, const Image& image);
+
+  private:
+    //! Magic
+    static constexpr const char* sMagic = "RTHC";
+    //! Version - Increment each time the header is modified
+    static constexpr int sVersion = 1;
+    //! Cache folder
+    static constexpr const char* sCacheFolder = "system/.emulationstation/cache/thumbnails";
+    //! Default cache budget, in Mb
+    static constexpr int sDefaultBudgetMb = 256;
+
+    //! Protect cache size accounting & eviction
+    static Mutex sLocker;
+    //! Current cache size in bytes, or -1 if not yet computed
+    static long long sCacheSize;
+
+    //! Entry header, followed by the source path then the pixels
+    struct Header
+    {
+      char      Magic[4];     //!< Magic identifier
+      int       Version;      //!< File version
+      long long SourceTime;   //!< Source modification time (ns)
+      long long SourceSize;   //!< Source file size
+      int       TargetWidth;  //!< Requested width
+      int       TargetHeight; //!< Requested height
+      int       Width;        //!< Pixel width
+      int       Height;       //!< Pixel height
+      int       SourceWidth;  //!< Source width
+      int       SourceHeight; //!< Source height
+      int       PathLength;   //!< Source path length
+      int       Padding;      //!< Alignment
+    };
+
+    //! Get the cache budget in bytes
+    static long long Budget();
+
+    //! Get the cache folder
+    static Path CacheFolder();
+
+    /*!
+     * @brief Get the cache entry path
+     * @param source Source image path
+     * @return Entry path
+     */
+    static Path EntryPath(const Path& source);
+
+    /*!
+     * @brief Get the size of an entry
+     * @param entry Entry path
+     * @return Entry size, or 0 if it does not exist
+     */
+    static long long EntrySize(const Path& entry);
+
+    /*!
+     * @brief Update the cache size & evict entries if the budget is exceeded
+     * @param delta Size difference in bytes
+     */
+    static void Account(long long delta);
+
+    //! Compute the cache size & evict least recently used entries until the cache fits in its budget. Lock must be held
+    static void Evict();
+
+    /*!
+     * @brief Get source modification time & size
+     * @param source Source image path
+     * @param time Modification time in ns
+     * @param size File size
+     * @return True if the source exists
+     */
+    static bool SourceStamp(const Path& source, long long& time, long long& size);
+};
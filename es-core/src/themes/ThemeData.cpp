@@ -6,8 +6,13 @@
 #include "RootFolders.h"
 #include "ThemeException.h"
 #include "MenuThemeData.h"
+#include "ThemeSerializer.h"
+#include <utils/Files.h>
+#include <utils/hash/Crc32.h>
 
 ThemeData* ThemeData::sCurrent = nullptr;
+ThemeData::ThemeSetsCache ThemeData::sThemeSets;
+Mutex ThemeData::sThemeSetsLocker;
 bool ThemeData::sThemeChanged = false;
 bool ThemeData::sThemeHasMenuView = true;
 bool ThemeData::sThemeHasHelpSystem = true;
@@ -309,6 +314,8 @@ unsigned int getHexColor(const char* str)
 }
 
 ThemeData::ThemeData()
+  : mHasMenuView(false)
+  , mHasHelpSystem(false)
 {
 	mVersion = 0;
 	SetThemeHasMenuView(false);
@@ -343,13 +350,18 @@ void ThemeData::loadFile(const String& systemThemeFolder, const Path& path)
 
 	mVersion = 0;
 	mViews.clear();
+	mFiles.clear();
+	mHasMenuView = false;
+	mHasHelpSystem = false;
 	
 	mSystemThemeFolder = systemThemeFolder;
 
 	String themeName = path.IsDirectory() ? path.Filename() : path.Directory().Filename();
-	HashMap<String, String> subSets = getThemeSubSets(themeName);
-
 	bool main = systemThemeFolder.empty();
+	// Subsets are only required to check main theme options: don't crawl the whole theme for each system
+	HashMap<String, String> subSets;
+	if (main) subSets = getThemeSubSets(themeName);
+
   bool needSave = false;
   mColorset = RecalboxConf::Instance().GetThemeColorSet(themeName);
   if (main && CheckThemeOption(mColorset, subSets, "colorset")) { RecalboxConf::Instance().SetThemeColorSet(themeName, mColorset); needSave = true; }
@@ -367,12 +379,21 @@ void ThemeData::loadFile(const String& systemThemeFolder, const Path& path)
   if (main && mRegion != "us" && mRegion != "eu" && mRegion != "jp") { mRegion="us"; RecalboxConf::Instance().SetThemeRegion(themeName, mRegion); needSave = true; }
   if (needSave) RecalboxConf::Instance().Save();
 
-  pugi::xml_document doc;
-	pugi::xml_parse_result res = doc.load_file(path.ToChars());
+  // Already compiled?
+  String key = CompiledKey(path);
+  if (LoadCompiled(key))
+  {
+    mPaths.pop_back();
+    return;
+  }
+
+	pugi::xml_parse_result res;
+	ThemeFileCache::Document doc = ThemeFileCache::Load(path, res);
 	if(!res)
 		throw ThemeException("XML parsing error: \n    " + String(res.description()), mPaths);
+	mFiles.push_back(path);
 
-	pugi::xml_node root = doc.child("theme");
+	pugi::xml_node root = doc->child("theme");
 	if(!root)
 		throw ThemeException("Missing <theme> tag!", mPaths);
 
@@ -388,6 +409,9 @@ void ThemeData::loadFile(const String& systemThemeFolder, const Path& path)
 	parseViews(root);
 	parseFeatures(root);
 	mPaths.pop_back();
+
+	// Random paths must be picked again on each load
+	if (mRandomPath.empty()) SaveCompiled(key);
 }
 
 
@@ -414,12 +438,13 @@ void ThemeData::parseIncludes(const pugi::xml_node& root)
 
 				mPaths.push_back(path);
 
-				pugi::xml_document includeDoc;
-				pugi::xml_parse_result result = includeDoc.load_file(path.ToChars());
+				pugi::xml_parse_result result;
+				ThemeFileCache::Document includeDoc = ThemeFileCache::Load(path, result);
 				if(!result)
 					throw ThemeException(errorString + "Error parsing file: \n    " + result.description(), mPaths);
+				mFiles.push_back(path);
 
-				pugi::xml_node newRoot = includeDoc.child("theme");
+				pugi::xml_node newRoot = includeDoc->child("theme");
 				if(!newRoot)
 					throw ThemeException(errorString + "Missing <theme> tag!", mPaths);
 				parseIncludes(newRoot);
@@ -504,7 +529,10 @@ void ThemeData::parseViews(const pugi::xml_node& root)
 		{
 			viewKey = nameAttr.SubString(prevOff, off - prevOff);
 			if (viewKey == "menu")
+			{
 				SetThemeHasMenuView(true);
+				mHasMenuView = true;
+			}
 			prevOff = nameAttr.find_first_not_of(delim, off);
 			off = nameAttr.find_first_of(delim, prevOff);
 			
@@ -524,7 +552,10 @@ void ThemeData::parseView(const pugi::xml_node& root, ThemeView& view)
 		if(!node.attribute("name"))
 			throw ThemeException("Element of type \"" + String(node.name()) + R"(" missing "name" attribute!)", mPaths);
 		if (String(node.name()) == "helpsystem")
+		{
 			SetThemeHasHelpSystem(true);
+			mHasHelpSystem = true;
+		}
 
     const HashMap< String, HashMap<String, ThemeData::ElementProperty> >& elementMap = ElementMap();
 
@@ -832,8 +863,6 @@ std::vector<Component*> ThemeData::makeExtras(const ThemeData& theme, const Stri
 
 HashMap<String, ThemeSet> ThemeData::getThemeSets()
 {
-	HashMap<String, ThemeSet> sets;
-
 	static const size_t pathCount = 3;
 	static Path paths[pathCount] =
 	{
@@ -842,6 +871,20 @@ HashMap<String, ThemeSet> ThemeData::getThemeSets()
 		RootFolders::DataRootFolder     / "/system/.emulationstation/themes"
 	};
 
+	// Theme sets are listed for each system: list them again only when a theme root has changed
+	ThemeFileCache::Stamp stamps[pathCount] {};
+	for (size_t i = 0; i < pathCount; ++i)
+		if (!ThemeFileCache::GetStamp(paths[i], stamps[i])) stamps[i] = { -1, -1 };
+	Mutex::AutoLock locker(sThemeSetsLocker);
+	if (sThemeSets.mValid)
+	{
+		bool unchanged = true;
+		for (size_t i = 0; i < pathCount; ++i)
+			unchanged &= (stamps[i] == sThemeSets.mStamps[i]);
+		if (unchanged) return sThemeSets.mSets;
+	}
+
+	HashMap<String, ThemeSet> sets;
 	for (const auto& path : paths)
 	{
     Path::PathList list = path.GetDirectoryContent();
@@ -855,6 +898,10 @@ HashMap<String, ThemeSet> ThemeData::getThemeSets()
 		}
 	}
 
+	for (size_t i = 0; i < pathCount; ++i)
+		sThemeSets.mStamps[i] = stamps[i];
+	sThemeSets.mSets = sets;
+	sThemeSets.mValid = true;
 	return sets;
 }
 
@@ -880,10 +927,9 @@ HashMap<String, String> ThemeData::getThemeSubSets(const String& theme)
 			{
 				Path themePath = setPath / "theme.xml";
 				dequepath.push_back(themePath);
-				pugi::xml_document doc;
-				doc.load_file(themePath.ToChars());
-				pugi::xml_node root = doc.child("theme");
-				crawlIncludes(root, sets, dequepath);
+				pugi::xml_parse_result result;
+				ThemeFileCache::Document doc = ThemeFileCache::Load(themePath, result);
+				if (doc) crawlIncludes(doc->child("theme"), sets, dequepath);
 				dequepath.pop_back();
 			}
 		}
@@ -891,11 +937,13 @@ HashMap<String, String> ThemeData::getThemeSubSets(const String& theme)
     if (master.Exists())
     {
       dequepath.push_back(master);
-      pugi::xml_document doc;
-      doc.load_file(master.ToChars());
-      pugi::xml_node root = doc.child("theme");
-      crawlIncludes(root, sets, dequepath);
-      findRegion(doc, sets);
+      pugi::xml_parse_result result;
+      ThemeFileCache::Document doc = ThemeFileCache::Load(master, result);
+      if (doc)
+      {
+        crawlIncludes(doc->child("theme"), sets, dequepath);
+        findRegion(*doc, sets);
+      }
       dequepath.pop_back();
     }
 	}
@@ -912,11 +960,13 @@ void ThemeData::crawlIncludes(const pugi::xml_node& root, HashMap<String, String
 		Path relPath(node.text().get());
 		Path path = relPath.ToAbsolute(dequepath.back().Directory());
 		dequepath.push_back(path);
-		pugi::xml_document includeDoc;
-		/*pugi::xml_parse_result result =*/ includeDoc.load_file(path.ToChars());
-		pugi::xml_node newRoot = includeDoc.child("theme");
-		crawlIncludes(newRoot, sets, dequepath);
-		findRegion(includeDoc, sets);
+		pugi::xml_parse_result result;
+		ThemeFileCache::Document includeDoc = ThemeFileCache::Load(path, result);
+		if (includeDoc)
+		{
+			crawlIncludes(includeDoc->child("theme"), sets, dequepath);
+			findRegion(*includeDoc, sets);
+		}
 		dequepath.pop_back();
 	}
 }
@@ -996,4 +1046,120 @@ bool ThemeData::isFolderHandled() const
 {
 	const auto* elem = getElement("detailed", "md_folder_name", "text");
 	return elem != nullptr && elem->HasProperty("pos");
-}
\ No newline at end of file
+}
+String ThemeData::CompiledKey(const Path& path) const
+{
+  return String(path.ToString()).Append('|').Append(mSystemThemeFolder)
+                                .Append('|').Append(mColorset)
+                                .Append('|').Append(mIconset)
+                                .Append('|').Append(mMenu)
+                                .Append('|').Append(mSystemview)
+                                .Append('|').Append(mGamelistview)
+                                .Append('|').Append(mGameClipView)
+                                .Append('|').Append(mRegion)
+                                .Append('|').Append(RecalboxConf::Instance().GetSystemLanguage());
+}
+
+Path ThemeData::CompiledPath(const String& key)
+{
+  char name[16];
+  snprintf(name, sizeof(name), "%08x", crc32_16bytes(key.data(), key.size()));
+  return RootFolders::DataRootFolder / sCompiledFolder / String(name).Append(".cache");
+}
+
+bool ThemeData::LoadCompiled(const String& key)
+{
+  String image = Files::LoadFile(CompiledPath(key));
+  if (image.empty()) return false;
+  ThemeSerializer from(image.data(), (int)image.size());
+
+  // Header & key
+  if (from.Read<int>() != *(const int*)sCompiledMagic || from.Read<int>() != sCompiledVersion) return false;
+  if (from.ReadString() != key) return false;
+
+  // Source files must be unchanged
+  std::vector<Path> files;
+  for(int count = from.Read<int>(); --count >= 0 && from.IsValid(); )
+  {
+    Path file(from.ReadString());
+    ThemeFileCache::Stamp stamp { from.Read<long long>(), from.Read<long long>() };
+    ThemeFileCache::Stamp current {};
+    if (!ThemeFileCache::GetStamp(file, current) || !(current == stamp)) return false;
+    files.push_back(file);
+  }
+
+  // Views
+  float version = from.Read<float>();
+  bool hasMenuView = from.Read<bool>();
+  bool hasHelpSystem = from.Read<bool>();
+  HashMap<String, ThemeView> views;
+  for(int viewCount = from.Read<int>(); --viewCount >= 0 && from.IsValid(); )
+  {
+    ThemeView& view = views[from.ReadString()];
+    for(int count = from.Read<int>(); --count >= 0 && from.IsValid(); )
+      view.orderedKeys.push_back(from.ReadString());
+    for(int count = from.Read<int>(); --count >= 0 && from.IsValid(); )
+    {
+      String name = from.ReadString();
+      view.elements[name].Deserialize(from);
+    }
+  }
+  if (!from.IsValid()) return false;
+
+  mVersion = version;
+  mViews = std::move(views);
+  mFiles = std::move(files);
+  mHasMenuView = hasMenuView;
+  mHasHelpSystem = hasHelpSystem;
+  if (mHasMenuView) SetThemeHasMenuView(true);
+  if (mHasHelpSystem) SetThemeHasHelpSystem(true);
+  return true;
+}
+
+void ThemeData::SaveCompiled(const String& key) const
+{
+  String image;
+  ThemeSerializer::Write(image, *(const int*)sCompiledMagic);
+  ThemeSerializer::Write(image, sCompiledVersion);
+  ThemeSerializer::Write(image, key);
+
+  // Source files
+  ThemeSerializer::Write(image, (int)mFiles.size());
+  for(const Path& file : mFiles)
+  {
+    ThemeFileCache::Stamp stamp {};
+    if (!ThemeFileCache::GetStamp(file, stamp)) return;
+    ThemeSerializer::Write(image, file.ToString());
+    ThemeSerializer::Write(image, stamp.Size);
+    ThemeSerializer::Write(image, stamp.Time);
+  }
+
+  // Views
+  ThemeSerializer::Write(image, mVersion);
+  ThemeSerializer::Write(image, mHasMenuView);
+  ThemeSerializer::Write(image, mHasHelpSystem);
+  ThemeSerializer::Write(image, (int)mViews.size());
+  for(const auto& view : mViews)
+  {
+    ThemeSerializer::Write(image, view.first);
+    ThemeSerializer::Write(image, (int)view.second.orderedKeys.size());
+    for(const String& orderedKey : view.second.orderedKeys)
+      ThemeSerializer::Write(image, orderedKey);
+    ThemeSerializer::Write(image, (int)view.second.elements.size());
+    for(const auto& element : view.second.elements)
+    {
+      ThemeSerializer::Write(image, element.first);
+      element.second.Serialize(image);
+    }
+  }
+
+  // Save in a temporary file first, then atomically replace the previous compiled theme
+  Path path = CompiledPath(key);
+  Path temporary = path.ChangeExtension(String(".tmp").Append((unsigned long long)pthread_self()));
+  (void)path.Directory().CreatePath();
+  if (!Files::SaveFile(temporary, image) || !Path::Rename(temporary, path))
+  {
+    { LOG(LogWarning) << "[ThemeData] Cannot save compiled theme " << path.ToString(); }
+    (void)temporary.Delete();
+  }
+}
@@ -8,6 +8,7 @@
 #include <RecalboxConf.h>
 #include "pugixml/pugixml.hpp"
 #include "ThemeElement.h"
+#include "ThemeFileCache.h"
 
 template<typename T> class TextListComponent;
 
@@ -40,7 +41,17 @@ class ThemeData
         String::List orderedKeys;
     };
 
+    //! Theme sets, valid as long as theme roots are unchanged
+    struct ThemeSetsCache
+    {
+      ThemeFileCache::Stamp mStamps[3]; //!< Theme roots stamps
+      HashMap<String, ThemeSet> mSets;  //!< Theme sets
+      bool mValid = false;              //!< Validity flag
+    };
+
     static ThemeData* sCurrent;
+    static ThemeSetsCache sThemeSets;
+    static Mutex sThemeSetsLocker;
     static bool sThemeChanged;
     static bool sThemeHasMenuView;
     static bool sThemeHasHelpSystem;
@@ -110,6 +121,19 @@ class ThemeData
 	String mSystemThemeFolder;
 	String mRandomPath;
 	static constexpr const char* sRandomMethod = "$random(";
+	//! Files parsed by the last load, compiled cache dependencies
+	std::vector<Path> mFiles;
+	//! Menu view found in the last load
+	bool mHasMenuView;
+	//! Help system found in the last load
+	bool mHasHelpSystem;
+
+	//! Compiled theme magic
+	static constexpr const char* sCompiledMagic = "RTHM";
+	//! Compiled theme version - Increment each time the format or the parser output changes
+	static constexpr int sCompiledVersion = 1;
+	//! Compiled theme cache folder
+	static constexpr const char* sCompiledFolder = "system/.emulationstation/cache/themes";
 
 
     void parseFeatures(const pugi::xml_node& themeRoot);
@@ -120,6 +144,33 @@ class ThemeData
     bool parseRegion(const pugi::xml_node& root);
     bool parseSubset(const pugi::xml_node& node);
     static void crawlIncludes(const pugi::xml_node& root, HashMap<String, String>& sets, std::deque<Path>& dequepath);
+
+    /*!
+     * @brief Build the compiled theme key: everything but file content the parsing depends on
+     * @param path Theme file
+     * @return Key
+     */
+    String CompiledKey(const Path& path) const;
+
+    /*!
+     * @brief Get the compiled theme file of the given key
+     * @param key Compiled theme key
+     * @return Compiled theme path
+     */
+    static Path CompiledPath(const String& key);
+
+    /*!
+     * @brief Load the compiled theme matching the given key, if all its source files are unchanged
+     * @param key Compiled theme key
+     * @return True if the theme has been loaded
+     */
+    bool LoadCompiled(const String& key);
+
+    /*!
+     * @brief Save the current theme as compiled theme
+     * @param key Compiled theme key
+     */
+    void SaveCompiled(const String& key) const;
     static void findRegion(const pugi::xml_document& doc, HashMap<String, String>& sets);
 
     static bool CheckThemeOption(String& selected, const HashMap<String, String>& subsets, const String& subset);
@@ -7,6 +7,7 @@
 #include <utils/String.h>
 
 #include <utils/math/Vector2f.h>
+#include <themes/ThemeSerializer.h>
 
 class ThemeElement
 {
@@ -113,6 +114,24 @@ class ThemeElement
           }
           return { 0.0f, 0.0f };
         }
+
+        //! Serialize into the compiled theme cache
+        void Serialize(String& to) const
+        {
+          ThemeSerializer::Write(to, mType);
+          ThemeSerializer::Write(to, mInteger);
+          ThemeSerializer::Write(to, mSecondFloat);
+          if (mType == Type::String) ThemeSerializer::Write(to, mString);
+        }
+
+        //! Deserialize from the compiled theme cache
+        void Deserialize(ThemeSerializer& from)
+        {
+          mType = (decltype(mType))from.Read<char>();
+          mInteger = from.Read<int>();
+          mSecondFloat = from.Read<float>();
+          if (mType == Type::String) mString = from.ReadString();
+        }
     };
 
     std::map<String, PropertyBag> mProperties;
@@ -175,5 +194,30 @@ class ThemeElement
     void AddIntProperty(const String& name, int v) { mProperties[name] = PropertyBag(v); }
     void AddFloatProperty(const String& name, float v) { mProperties[name] = PropertyBag(v); }
     void AddBoolProperty(const String& name, bool v) { mProperties[name] = PropertyBag(v); }
+
+    //! Serialize into the compiled theme cache
+    void Serialize(String& to) const
+    {
+      ThemeSerializer::Write(to, mType);
+      ThemeSerializer::Write(to, mExtra);
+      ThemeSerializer::Write(to, (int)mProperties.size());
+      for(const auto& property : mProperties)
+      {
+        ThemeSerializer::Write(to, property.first);
+        property.second.Serialize(to);
+      }
+    }
+
+    //! Deserialize from the compiled theme cache
+    void Deserialize(ThemeSerializer& from)
+    {
+      mType = from.ReadString();
+      mExtra = from.Read<bool>();
+      for(int count = from.Read<int>(); --count >= 0 && from.IsValid(); )
+      {
+        String name = from.ReadString();
+        mProperties[name].Deserialize(from);
+      }
+    }
 };
 
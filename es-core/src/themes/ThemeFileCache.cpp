@@ -0,0 +1,52 @@
+#include "ThemeFileCache.h"
+#include <sys/stat.h>
+
+HashMap<String, ThemeFileCache::Entry> ThemeFileCache::sDocuments;
+long long ThemeFileCache::sCachedSize = 0;
+Mutex ThemeFileCache::sLocker;
+
+bool ThemeFileCache::GetStamp(const Path& path, Stamp& stamp)
+{
+  struct stat64 info {};
+  if (stat64(path.ToChars(), &info) != 0) return false;
+  stamp.Size = info.st_size;
+  stamp.Time = (long long)info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+  return true;
+}
+
+ThemeFileCache::Document ThemeFileCache::Load(const Path& path, pugi::xml_parse_result& result)
+{
+  Stamp stamp {};
+  if (!GetStamp(path, stamp))
+  {
+    result.status = pugi::status_file_not_found;
+    return nullptr;
+  }
+
+  {
+    Mutex::AutoLock locker(sLocker);
+    Entry* entry = sDocuments.try_get(path.ToString());
+    if (entry != nullptr && entry->mStamp == stamp)
+    {
+      result.status = pugi::status_ok;
+      return entry->mDocument;
+    }
+  }
+
+  // Parse outside the lock, so that systems may load their themes in parallel
+  std::shared_ptr<pugi::xml_document> document = std::make_shared<pugi::xml_document>();
+  result = document->load_file(path.ToChars());
+  if (!result) return nullptr;
+
+  Mutex::AutoLock locker(sLocker);
+  if (sCachedSize + stamp.Size > sMaxCachedSize)
+  {
+    sDocuments.clear();
+    sCachedSize = 0;
+  }
+  Entry& entry = sDocuments[path.ToString()];
+  if (entry.mDocument != nullptr) sCachedSize -= entry.mStamp.Size;
+  entry = { stamp, document };
+  sCachedSize += stamp.Size;
+  return document;
+}
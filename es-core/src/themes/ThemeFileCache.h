@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+#include <utils/os/fs/Path.h>
+#include <utils/os/system/Mutex.h>
+#include <utils/storage/HashMap.h>
+#include "pugixml/pugixml.hpp"
+
+/*!
+ * @brief Parsed theme files, shared by all systems
+ *
+ * Most system themes include the same files: they are parsed once and reused
+ * as long as their size & modification time are unchanged.
+ * Thread safe.
+ */
+class ThemeFileCache
+{
+  public:
+    //! Shared read-only document
+    typedef std::shared_ptr<const pugi::xml_document> Document;
+
+    //! File stamp
+    struct Stamp
+    {
+      long long Size; //!< File size
+      long long Time; //!< Modification time (ns)
+      bool operator == (const Stamp& other) const { return Size == other.Size && Time == other.Time; }
+    };
+
+    /*!
+     * @brief Get a parsed document, parsing it only if required
+     * @param path Xml file path
+     * @param result Parsing result
+     * @return Document or nullptr on parsing error
+     */
+    static Document Load(const Path& path, pugi::xml_parse_result& result);
+
+    /*!
+     * @brief Get a file stamp
+     * @param path File path
+     * @param stamp Output stamp
+     * @return True if the file exists
+     */
+    static bool GetStamp(const Path& path, Stamp& stamp);
+
+  private:
+    //! Maximum size of cached files. Past this size, the cache is cleared
+    static constexpr long long sMaxCachedSize = 8 << 20;
+
+    //! Cached document
+    struct Entry
+    {
+      Stamp mStamp;        //!< File stamp
+      Document mDocument;  //!< Parsed document
+    };
+
+    //! Cached documents by path
+    static HashMap<String, Entry> sDocuments;
+    //! Total size of cached files
+    static long long sCachedSize;
+    //! Cache protection
+    static Mutex sLocker;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <utils/String.h>
+#include <cstring>
+
+/*!
+ * @brief Minimal binary (de)serializer used by the compiled theme cache
+ * Values are stored in native endianness: cache files are never shared between machines
+ */
+class ThemeSerializer
+{
+  public:
+    /*!
+     * @brief Constructor
+     * @param data Data to read from
+     * @param size Data size
+     */
+    ThemeSerializer(const char* data, int size)
+      : mData(data)
+      , mEnd(data + size)
+      , mValid(true)
+    {
+    }
+
+    //! Write a raw value
+    template<typename T> static void Write(String& to, T value) { to.Append((const char*)&value, (int)sizeof(T)); }
+
+    //! Write a string
+    static void Write(String& to, const String& value) { Write(to, (int)value.size()); to.Append(value); }
+
+    //! Read a raw value
+    template<typename T> T Read()
+    {
+      T value {};
+      if (mData + sizeof(T) > mEnd) { mValid = false; return value; }
+      memcpy(&value, mData, sizeof(T));
+      mData += sizeof(T);
+      return value;
+    }
+
+    //! Read a string
+    String ReadString()
+    {
+      int size = Read<int>();
+      if (size < 0 || mData + size > mEnd) { mValid = false; return String(); }
+      String value(mData, size);
+      mData += size;
+      return value;
+    }
+
+    //! All reads successful?
+    [[nodiscard]] bool IsValid() const { return mValid; }
+
+  private:
+    //! Current position
+    const char* mData;
+    //! End of data
+    const char* mEnd;
+    //! Validity flag
+    bool mValid;
+};
@@ -1,10 +1,20 @@
 #include "Log.h"
 #include "RootFolders.h"
 #include "utils/datetime/DateTime.h"
+#include <utils/os/system/Thread.h>
+#include <utils/os/system/Signal.h>
+#include <utils/os/system/Mutex.h>
+#include <atomic>
+#include <vector>
+#include <cstring>
+#include <csignal>
+#include <unistd.h>
 
 LogLevel Log::reportingLevel = LogLevel::LogInfo;
 FILE* Log::sFile = nullptr;
+std::atomic<int> Log::sFileDescriptor(-1);
 Path Log::mPath;
+long long Log::sFileSize = 0;
 
 const char* Log::sStringLevel[] =
 {
@@ -15,6 +25,328 @@ const char* Log::sStringLevel[] =
   "TRACE",
 };
 
+/*!
+ * @brief Single producer/single consumer ring of log records
+ * Records are stored as [length:16][level:8][message]
+ */
+class LogRing
+{
+  public:
+    //! Ring size - Must be a power of 2
+    static constexpr unsigned int sSize = 64 << 10;
+    //! Record header size
+    static constexpr unsigned int sHeaderSize = 3;
+    //! Longer messages are truncated
+    static constexpr unsigned int sMaxMessage = sSize / 4;
+
+    LogRing()
+      : mBuffer()
+      , mHead(0)
+      , mTail(0)
+      , mOwned(true)
+    {
+    }
+
+    /*!
+     * @brief Push a message - Producer side
+     * @param level Message level
+     * @param message Message
+     * @return False if the ring is full
+     */
+    bool Push(LogLevel level, const String& message)
+    {
+      unsigned int length = std::min((unsigned int)message.size(), sMaxMessage);
+      unsigned int head = mHead.load(std::memory_order_relaxed);
+      unsigned int tail = mTail.load(std::memory_order_acquire);
+      if (sSize - (head - tail) < length + sHeaderSize) return false;
+
+      unsigned char header[sHeaderSize] = { (unsigned char)length, (unsigned char)(length >> 8), (unsigned char)level };
+      Copy(head, (const char*)header, sHeaderSize);
+      Copy(head + sHeaderSize, message.data(), length);
+      if (length != (unsigned int)message.size()) Copy(head + sHeaderSize + length - 1, "\n", 1);
+      mHead.store(head + sHeaderSize + length, std::memory_order_release);
+      return true;
+    }
+
+    /*!
+     * @brief Pop all messages - Consumer side
+     * @param batch Messages to write into the log file
+     * @param console Messages to echo on the console
+     * @return True if at least one message has been popped
+     */
+    bool PopAll(String& batch, String& console)
+    {
+      unsigned int tail = mTail.load(std::memory_order_relaxed);
+      unsigned int head = mHead.load(std::memory_order_acquire);
+      if (tail == head) return false;
+
+      while(tail != head)
+      {
+        unsigned char header[sHeaderSize];
+        Extract(tail, (char*)header, sHeaderSize);
+        unsigned int length = header[0] | (header[1] << 8);
+        LogLevel level = (LogLevel)header[2];
+        int start = (int)batch.size();
+        batch.resize(start + length);
+        Extract(tail + sHeaderSize, batch.data() + start, length);
+        if (level == LogLevel::LogError || Log::ReportingLevel() >= LogLevel::LogDebug)
+          console.Append(batch, start, (int)length);
+        tail += sHeaderSize + length;
+      }
+      mTail.store(tail, std::memory_order_release);
+      return true;
+    }
+
+    /*!
+     * @brief Write all pending messages to the given file, without consuming them
+     * Async-signal-safe: only used when the process is about to die
+     * @param fd Target file descriptor
+     */
+    void Dump(int fd) const
+    {
+      static char sMessage[sMaxMessage];
+      unsigned int tail = mTail.load(std::memory_order_acquire);
+      unsigned int head = mHead.load(std::memory_order_acquire);
+      while(head - tail >= sHeaderSize)
+      {
+        unsigned char header[sHeaderSize];
+        Extract(tail, (char*)header, sHeaderSize);
+        unsigned int length = header[0] | (header[1] << 8);
+        if (length > sMaxMessage || head - tail < sHeaderSize + length) break;
+        Extract(tail + sHeaderSize, sMessage, length);
+        (void)!write(fd, sMessage, length);
+        tail += sHeaderSize + length;
+      }
+    }
+
+    //! Try to take ownership of a released ring
+    bool Acquire() { bool released = false; return mOwned.compare_exchange_strong(released, true, std::memory_order_acquire); }
+
+    //! Release ownership when the producer thread exits
+    void Release() { mOwned.store(false, std::memory_order_release); }
+
+  private:
+    //! Ring buffer
+    char mBuffer[sSize];
+    //! Producer position
+    std::atomic<unsigned int> mHead;
+    //! Consumer position
+    std::atomic<unsigned int> mTail;
+    //! Owned by a living thread
+    std::atomic<bool> mOwned;
+
+    //! Copy into the ring, wrapping around
+    void Copy(unsigned int position, const char* from, unsigned int length)
+    {
+      unsigned int offset = position & (sSize - 1);
+      unsigned int first = std::min(length, sSize - offset);
+      memcpy(mBuffer + offset, from, first);
+      memcpy(mBuffer, from + first, length - first);
+    }
+
+    //! Copy from the ring, wrapping around
+    void Extract(unsigned int position, char* to, unsigned int length) const
+    {
+      unsigned int offset = position & (sSize - 1);
+      unsigned int first = std::min(length, sSize - offset);
+      memcpy(to, mBuffer + offset, first);
+      memcpy(to + first, mBuffer, length - first);
+    }
+};
+
+/*!
+ * @brief Background log writer
+ * Drains all thread rings and writes them in batches, one write & flush per batch
+ */
+class LogWriter : private Thread
+{
+  public:
+    //! Get the unique writer. Never destroyed, so that threads may log until the very end
+    static LogWriter& Instance() { static LogWriter* sWriter = new LogWriter(); return *sWriter; }
+
+    //! Start writing asynchronously
+    void StartWriter()
+    {
+      if (mActive) return;
+      Thread::Start("Logger");
+      mActive.store(true, std::memory_order_release);
+    }
+
+    //! Stop writing asynchronously & write all pending messages
+    void StopWriter()
+    {
+      if (!mActive.exchange(false)) return;
+      Thread::Stop();
+      Drain();
+    }
+
+    /*!
+     * @brief Push a message into the ring of the calling thread
+     * @param level Message level
+     * @param message Message
+     * @return False if the writer is not running and the message must be written synchronously
+     */
+    bool Push(LogLevel level, const String& message)
+    {
+      if (!mActive.load(std::memory_order_acquire)) return false;
+      if (!CurrentRing().Push(level, message)) mDropped.fetch_add(1, std::memory_order_relaxed);
+      else if (mSleeping.exchange(false)) mSignal.Fire();
+      return true;
+    }
+
+    /*!
+     * @brief Write all pending messages
+     * Batches are popped & written atomically, so that concurrent drains keep messages in order
+     * @return True if at least one message has been written
+     */
+    bool Drain()
+    {
+      Mutex::AutoLock drainLocker(mDrainLocker);
+      String batch;
+      String console;
+      {
+        Mutex::AutoLock locker(mRingsLocker);
+        for(LogRing* ring : mRings)
+          ring->PopAll(batch, console);
+      }
+      if (int dropped = mDropped.exchange(0); dropped != 0)
+        batch.Append('[').Append(DateTime().ToPreciseTimeStamp()).Append("] (WARN!) : [Log] ").Append(dropped).Append(" messages dropped\n");
+      if (batch.empty()) return false;
+      Log::Write(batch, console);
+      return true;
+    }
+
+    /*!
+     * @brief Write all pending messages of all rings to the given file, from a fatal signal handler
+     * Async-signal-safe: no lock, no allocation. Rings are left untouched
+     * @param fd Target file descriptor
+     */
+    void EmergencyDrain(int fd) const
+    {
+      int count = std::min(mSignalRingCount.load(std::memory_order_acquire), sMaxSignalRings);
+      for(int i = 0; i < count; ++i)
+        if (const LogRing* ring = mSignalRings[i].load(std::memory_order_acquire); ring != nullptr)
+          ring->Dump(fd);
+    }
+
+  private:
+    //! Maximum time between two drains
+    static constexpr int sDrainPeriod = 250;
+    //! Maximum rings reachable from a signal handler
+    static constexpr int sMaxSignalRings = 256;
+
+    //! Release a thread's ring when the thread exits
+    struct RingOwner
+    {
+      LogRing* mRing = nullptr;
+      ~RingOwner() { if (mRing != nullptr) mRing->Release(); }
+    };
+
+    //! All rings, including released ones
+    std::vector<LogRing*> mRings;
+    //! Rings protection
+    Mutex mRingsLocker;
+    //! Serialize drains
+    Mutex mDrainLocker;
+    //! Lock-free copy of the ring list, for signal handlers
+    std::atomic<const LogRing*> mSignalRings[sMaxSignalRings];
+    //! Ring count in the lock-free list
+    std::atomic<int> mSignalRingCount;
+    //! Wake up signal
+    Signal mSignal;
+    //! Async writing enabled
+    std::atomic<bool> mActive;
+    //! Writer is about to sleep
+    std::atomic<bool> mSleeping;
+    //! Dropped messages
+    std::atomic<int> mDropped;
+
+    LogWriter()
+      : mSignalRings()
+      , mSignalRingCount(0)
+      , mActive(false)
+      , mSleeping(false)
+      , mDropped(0)
+    {
+    }
+
+    //! Get the calling thread's ring, reusing a released ring or creating a new one
+    LogRing& CurrentRing()
+    {
+      static thread_local RingOwner sOwner;
+      if (sOwner.mRing == nullptr)
+      {
+        Mutex::AutoLock locker(mRingsLocker);
+        for(LogRing* ring : mRings)
+          if (ring->Acquire()) { sOwner.mRing = ring; break; }
+        if (sOwner.mRing == nullptr)
+        {
+          mRings.push_back(sOwner.mRing = new LogRing());
+          if (int index = mSignalRingCount.load(std::memory_order_relaxed); index < sMaxSignalRings)
+          {
+            mSignalRings[index].store(sOwner.mRing, std::memory_order_release);
+            mSignalRingCount.store(index + 1, std::memory_order_release);
+          }
+        }
+      }
+      return *sOwner.mRing;
+    }
+
+    /*
+     * Thread implementation
+     */
+
+    void Break() override { mSignal.Fire(); }
+
+    void Run() override
+    {
+      while(IsRunning())
+        if (!Drain())
+        {
+          // Check again after announcing sleep, so that no message is left behind
+          mSleeping = true;
+          std::atomic_thread_fence(std::memory_order_seq_cst);
+          if (!Drain()) mSignal.WaitSignal(sDrainPeriod);
+          mSleeping = false;
+        }
+    }
+};
+
+//! Protect log file writes
+static Mutex sWriteLocker;
+
+//! Signals whose default action kills the process
+static constexpr int sFatalSignals[] = { SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT };
+//! Handlers in effect before ours
+static struct sigaction sPreviousActions[sizeof(sFatalSignals) / sizeof(sFatalSignals[0])];
+
+void Log::FatalSignal(int signal)
+{
+  // Write pending messages, which would be lost otherwise
+  if (int fd = sFileDescriptor.load(std::memory_order_acquire); fd >= 0)
+  {
+    LogWriter::Instance().EmergencyDrain(fd);
+    static constexpr const char sDeath[] = "[Log] Fatal signal received. Pending messages written.\n";
+    (void)!write(fd, sDeath, sizeof(sDeath) - 1);
+    (void)fdatasync(fd);
+  }
+
+  // Restore the previous handler and let it (or the default action) kill the process
+  for(int i = (int)(sizeof(sFatalSignals) / sizeof(sFatalSignals[0])); --i >= 0; )
+    if (sFatalSignals[i] == signal)
+      (void)sigaction(signal, &sPreviousActions[i], nullptr);
+  (void)raise(signal);
+}
+
+void Log::InstallFatalSignalHandlers()
+{
+  struct sigaction action {};
+  action.sa_handler = &Log::FatalSignal;
+  (void)sigemptyset(&action.sa_mask);
+  for(int i = (int)(sizeof(sFatalSignals) / sizeof(sFatalSignals[0])); --i >= 0; )
+    (void)sigaction(sFatalSignals[i], &action, &sPreviousActions[i]);
+}
+
 Path Log::FormatLogPath(const char* filename)
 {
   if (filename == nullptr) filename = "unknown.log";
@@ -26,19 +358,69 @@ Path Log::FormatLogPath(const char* filename)
 
 void Log::Open(const char* filename)
 {
-  // Build log path
-  mPath = FormatLogPath(filename);
+  {
+    Mutex::AutoLock locker(sWriteLocker);
+
+    // Build log path
+    mPath = FormatLogPath(filename);
+
+    // Backup?
+    if (mPath.Exists()) Rotate();
+
+    // Open new log
+    sFile = fopen(mPath.ToChars(), "w");
+    sFileSize = 0;
+    sFileDescriptor = sFile != nullptr ? fileno(sFile) : -1;
+  }
+
+  // Write asynchronously from now on, and write pending messages on exit or crash
+  static bool sExitHook = atexit([] { LogWriter::Instance().StopWriter(); }) == 0;
+  (void)sExitHook;
+  static bool sSignalHook = (InstallFatalSignalHandlers(), true);
+  (void)sSignalHook;
+  LogWriter::Instance().StartWriter();
+}
+
+void Log::Rotate()
+{
+  Path last(mPath.ChangeExtension(String(".backup.").Append(sMaxBackups)));
+  if (last.Exists() && !last.Delete()) { printf("[Logs] Cannot remove old log!"); }
+  for(int i = sMaxBackups; --i >= 1; )
+  {
+    Path backup(mPath.ChangeExtension(i == 1 ? String(".backup") : String(".backup.").Append(i)));
+    if (backup.Exists())
+      if (!Path::Rename(backup, mPath.ChangeExtension(String(".backup.").Append(i + 1)))) { printf("[Logs] Cannot rotate old log!"); }
+  }
+  if (!Path::Rename(mPath, mPath.ChangeExtension(".backup"))) { printf("[Logs] Cannot backup current log!"); }
+}
 
-  // Backup?
-  if (mPath.Exists())
+void Log::Write(const String& batch, const String& console)
+{
   {
-    Path backup(mPath.ChangeExtension(".backup"));
-    if (!backup.Delete()) { printf("[Logs] Cannot remove old log!"); }
-    if (!Path::Rename(mPath, backup)) { printf("[Logs] Cannot backup current log!"); }
+    Mutex::AutoLock locker(sWriteLocker);
+    if (sFile != nullptr)
+    {
+      // Rotate?
+      if (sFileSize + (long long)batch.size() > sMaxFileSize)
+      {
+        DoClose();
+        Rotate();
+        sFile = fopen(mPath.ToChars(), "w");
+        sFileSize = 0;
+        sFileDescriptor = sFile != nullptr ? fileno(sFile) : -1;
+      }
+      if (sFile != nullptr)
+      {
+        (void)fwrite(batch.data(), 1, batch.size(), sFile);
+        sFileSize += (long long)batch.size();
+        Flush();
+      }
+    }
   }
 
-  // Open new log
-  sFile = fopen(mPath.ToChars(), "w");
+  // Errors or all messages if using --debug
+  if (!console.empty())
+    (void)fwrite(console.data(), 1, console.size(), stdout);
 }
 
 Log& Log::get(LogLevel level)
@@ -61,26 +443,36 @@ void Log::Flush()
 void Log::Close()
 {
   { Log().get(LogLevel::LogInfo) << "Closing logger..."; }
+  LogWriter::Instance().StopWriter();
+  Mutex::AutoLock locker(sWriteLocker);
   DoClose();
 }
 
 void Log::DoClose()
 {
+  sFileDescriptor = -1;
   if (sFile != nullptr) (void)fclose(sFile);
   sFile = nullptr;
 }
 
 Log::~Log()
 {
+  mMessage += '\n';
+  // Pushing wakes up the writer. Messages pending on a crash are written by the fatal signal handler
+  if (LogWriter::Instance().Push(messageLevel, mMessage)) return;
+
+  // Synchronous write, before Open or after Close
+  Mutex::AutoLock locker(sWriteLocker);
 	bool loggerClosed = (sFile == nullptr);
 	// Reopen temporarily
 	if (loggerClosed)
   {
-	  Open(mPath.ToChars());
-	  mMessage += " [closed!]";
+    if (mPath.IsEmpty()) return;
+	  sFile = fopen(mPath.ToChars(), "a");
+    if (sFile == nullptr) return;
+	  mMessage.Insert((int)mMessage.size() - 1, " [closed!]");
   }
 
-  mMessage += '\n';
   (void)fputs(mMessage.c_str(), sFile);
 	if (!loggerClosed) Flush();
 	else DoClose();
@@ -1,11 +1,17 @@
 #ifndef _LOG_H_
 #define _LOG_H_
 
+//! Highest level compiled in. Lower it (-DLOG_MAX_LEVEL=LogInfo) to remove debug & trace logs from the binary
+#ifndef LOG_MAX_LEVEL
+  #define LOG_MAX_LEVEL LogTrace
+#endif
+
 #define LOG(level) \
-if (::LogLevel::level <= ::Log::ReportingLevel()) ::Log().get(LogLevel::level)
+if constexpr (::LogLevel::level <= ::Log::sMaxLevel) if (::LogLevel::level <= ::Log::ReportingLevel()) ::Log().get(LogLevel::level)
 
 #include <utils/String.h>
 #include <utils/os/fs/Path.h>
+#include <atomic>
 
 //! Log level
 enum class LogLevel
@@ -18,9 +24,21 @@ enum class LogLevel
   _Count
 };
 
+/*!
+ * @brief Logger
+ *
+ * Messages are built by the caller, then pushed into a lock-free ring buffer owned by the calling thread.
+ * A background writer drains all rings, and writes & flushes them in batches.
+ * When a ring is full, messages are dropped and counted rather than stalling the caller.
+ * Pending messages are written by a fatal signal handler before the process dies.
+ * The log file is rotated when it grows too large, keeping a few backups.
+ */
 class Log
 {
   public:
+    //! Highest level compiled in
+    static constexpr LogLevel sMaxLevel = LogLevel::LOG_MAX_LEVEL;
+
     ~Log();
     Log& get(LogLevel level = LogLevel::LogInfo);
 
@@ -48,10 +66,19 @@ class Log
     Log& operator << (const std::vector<const char*>& v) { for(const char* s : v) mMessage.Append(s).Append(' '); return *this; }
 
   private:
+    //! Log file size triggering a rotation
+    static constexpr long long sMaxFileSize = 8 << 20;
+    //! Backups kept: .backup, .backup.2, ...
+    static constexpr int sMaxBackups = 3;
+
     static const char* sStringLevel[(int)LogLevel::_Count];
     static FILE* sFile;
+    //! Log file descriptor, for signal handlers. -1 when closed
+    static std::atomic<int> sFileDescriptor;
     static Path mPath;
     static LogLevel reportingLevel;
+    //! Current log file size
+    static long long sFileSize;
 
     String mMessage;
     LogLevel messageLevel;
@@ -59,6 +86,30 @@ class Log
     static void Flush();
 
     static void DoClose();
+
+    /*!
+     * @brief Shift backups & move the current log file to the first backup
+     */
+    static void Rotate();
+
+    /*!
+     * @brief Write a batch of messages to the log file, rotating it if required
+     * @param batch Messages
+     * @param console Messages to copy to the console
+     */
+    static void Write(const String& batch, const String& console);
+
+    /*!
+     * @brief Write pending messages synchronously, then let the signal kill the process
+     * @param signal Fatal signal
+     */
+    static void FatalSignal(int signal);
+
+    //! Install FatalSignal on all fatal signals, once
+    static void InstallFatalSignalHandlers();
+
+    //! Message writer
+    friend class LogWriter;
 };
 
 #endif
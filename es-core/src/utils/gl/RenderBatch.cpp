@@ -0,0 +1,37 @@
+#include "RenderBatch.h"
+#include <cstring>
+
+void RenderBatch::Add(const Key& key, const Transform4x4f& matrix, const Vertex vertices[], const unsigned char colors[], unsigned int color, int count)
+{
+  if (count <= 0) return;
+  mKey = key;
+
+  // Component transforms are 2D affine transforms
+  const float xx = matrix.r0().x(), xy = matrix.r0().y();
+  const float yx = matrix.r1().x(), yy = matrix.r1().y();
+  const float tx = matrix.r3().x(), ty = matrix.r3().y();
+  size_t first = mVertices.size();
+  mVertices.resize(first + count);
+  Vertex* target = &mVertices[first];
+  for(int i = 0; i < count; ++i)
+  {
+    const Vertex& source = vertices[i];
+    target[i].Target.X = xx * source.Target.X + yx * source.Target.Y + tx;
+    target[i].Target.Y = xy * source.Target.X + yy * source.Target.Y + ty;
+    target[i].Source = source.Source;
+  }
+
+  size_t firstColor = mColors.size();
+  mColors.resize(firstColor + count * 4);
+  if (colors != nullptr) memcpy(&mColors[firstColor], colors, count * 4);
+  else FillColors(&mColors[firstColor], color, count);
+}
+
+void RenderBatch::FillColors(unsigned char* array, unsigned int color, int count)
+{
+  const unsigned char bytes[4] = { (unsigned char)(color >> 24), (unsigned char)(color >> 16), (unsigned char)(color >> 8), (unsigned char)color };
+  unsigned int value = 0;
+  memcpy(&value, bytes, sizeof(value));
+  for (int i = count; --i >= 0; )
+    memcpy(array + i * 4, &value, sizeof(value));
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <utils/gl/Vertex.h>
+#include <utils/math/Transform4x4f.h>
+#include <vector>
+
+/*!
+ * @brief Pending renderer batch
+ *
+ * Consecutive draws sharing the same key are merged into a single draw call.
+ * Vertices are transformed into screen coordinates when added, so that draws using different matrices
+ * share the same batch. No GL call here: the renderer draws the batch content
+ */
+class RenderBatch
+{
+  public:
+    //! Batch key: consecutive draws sharing the same key are merged into a single draw call
+    struct Key
+    {
+      unsigned int Texture;           //!< Texture
+      unsigned int SourceFactor;      //!< Blending source factor
+      unsigned int DestinationFactor; //!< Blending destination factor
+      bool Textured;                  //!< Textured triangles?
+      bool Tiled;                     //!< Repeat texture?
+
+      bool operator ==(const Key& other) const
+      {
+        return Texture == other.Texture && SourceFactor == other.SourceFactor && DestinationFactor == other.DestinationFactor &&
+               Textured == other.Textured && Tiled == other.Tiled;
+      }
+    };
+
+    //! Constructor
+    RenderBatch()
+      : mKey()
+    {
+    }
+
+    /*!
+     * @brief Check if a draw using the given key can be merged into the pending batch
+     * @param key Draw key
+     * @return True if the draw can be added, false if the batch must be drawn first
+     */
+    [[nodiscard]] bool Accepts(const Key& key) const { return mVertices.empty() || mKey == key; }
+
+    /*!
+     * @brief Add triangles to the batch. The batch must accept the key
+     * @param key Batch key
+     * @param matrix Current matrix. Only 2D affine transforms are supported
+     * @param vertices Vertices, in matrix coordinates
+     * @param colors Color array (4 bytes per vertex) or nullptr to use the given color
+     * @param color Single color (Colors::ColorARGB), used only if colors is nullptr
+     * @param count Vertex count
+     */
+    void Add(const Key& key, const Transform4x4f& matrix, const Vertex vertices[], const unsigned char colors[], unsigned int color, int count);
+
+    //! Forget all batched triangles
+    void Clear()
+    {
+      mVertices.clear();
+      mColors.clear();
+    }
+
+    //! Empty batch?
+    [[nodiscard]] bool IsEmpty() const { return mVertices.empty(); }
+    //! Get the batch key
+    [[nodiscard]] const Key& BatchKey() const { return mKey; }
+    //! Get the vertex count
+    [[nodiscard]] int Count() const { return (int)mVertices.size(); }
+    //! Get the screen coordinates vertices
+    [[nodiscard]] const Vertex* VertexArray() const { return mVertices.data(); }
+    //! Get the color array (RGBA bytes)
+    [[nodiscard]] const unsigned char* ColorArray() const { return mColors.data(); }
+
+    /*!
+     * @brief Fill a color array with a single color
+     * @param array Color array (4 bytes per vertex)
+     * @param color Color (Colors::ColorARGB)
+     * @param count Vertex count
+     */
+    static void FillColors(unsigned char* array, unsigned int color, int count);
+
+  private:
+    //! Pending batch key
+    Key mKey;
+    //! Pending vertices, already transformed
+    std::vector<Vertex> mVertices;
+    //! Pending colors (RGBA bytes)
+    std::vector<unsigned char> mColors;
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+/*!
+ * @brief Cached GL state, to skip redundant state changes
+ *
+ * Setters update the cache and return true only when the matching GL call is required.
+ * No GL call here: the renderer issues them
+ */
+struct RenderState
+{
+  //! Unknown GL state value
+  static constexpr unsigned int sUnknown = 0xFFFFFFFF;
+
+  unsigned int Texture;           //!< Bound texture
+  unsigned int SourceFactor;      //!< Blending source factor
+  unsigned int DestinationFactor; //!< Blending destination factor
+  bool Texturing;                 //!< GL_TEXTURE_2D enabled
+  bool Blending;                  //!< GL_BLEND enabled
+  bool VertexArray;               //!< GL_VERTEX_ARRAY enabled
+  bool TexCoordArray;             //!< GL_TEXTURE_COORD_ARRAY enabled
+  bool ColorArray;                //!< GL_COLOR_ARRAY enabled
+  bool IdentityLoaded;            //!< Modelview matrix is identity
+
+  //! GL is in its default state: everything disabled, bindings unknown
+  void Reset()
+  {
+    Texture = SourceFactor = DestinationFactor = sUnknown;
+    Texturing = Blending = VertexArray = TexCoordArray = ColorArray = IdentityLoaded = false;
+  }
+
+  //! Direct drawers bind textures, set blending & load matrices on their own
+  void InvalidateBindings()
+  {
+    Texture = SourceFactor = DestinationFactor = sUnknown;
+    IdentityLoaded = false;
+  }
+
+  /*!
+   * @brief Change a capability or client state
+   * @param current Cached state
+   * @param wanted Required state
+   * @return True if GL must be called
+   */
+  static bool Set(bool& current, bool wanted)
+  {
+    if (current == wanted) return false;
+    current = wanted;
+    return true;
+  }
+
+  /*!
+   * @brief Bind a texture
+   * @param id Texture identifier
+   * @return True if GL must be called
+   */
+  bool SetTexture(unsigned int id)
+  {
+    if (Texture == id) return false;
+    Texture = id;
+    return true;
+  }
+
+  /*!
+   * @brief Change blending factors
+   * @param source Source factor
+   * @param destination Destination factor
+   * @return True if GL must be called
+   */
+  bool SetBlending(unsigned int source, unsigned int destination)
+  {
+    if (SourceFactor == source && DestinationFactor == destination) return false;
+    SourceFactor = source;
+    DestinationFactor = destination;
+    return true;
+  }
+
+  /*!
+   * @brief A texture has been deleted: deleting the bound texture reverts the binding to 0
+   * @param id Texture identifier
+   */
+  void TextureDeleted(unsigned int id)
+  {
+    if (Texture == id) Texture = 0;
+  }
+};
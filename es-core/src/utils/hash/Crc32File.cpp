@@ -4,18 +4,74 @@
 
 #include "Crc32File.h"
 #include "Crc32.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <sys/stat.h>
+#include <memory>
+
+#if defined(__aarch64__)
+  #include <sys/auxv.h>
+  #include <asm/hwcap.h>
+  #include <arm_acle.h>
+
+  // ARMv8 CRC32 instructions use the same polynomial as zlib & no-intro CRCs
+  __attribute__((target("arch=armv8-a+crc")))
+  static unsigned int HardwareCrc32(const unsigned char* data, size_t length, unsigned int previousCrc32)
+  {
+    unsigned int crc = ~previousCrc32;
+    for(; length != 0 && ((uintptr_t)data & 7) != 0; --length) crc = __crc32b(crc, *data++);
+    for(; length >= 8; length -= 8, data += 8) crc = __crc32d(crc, *(const uint64_t*)data);
+    for(; length != 0; --length) crc = __crc32b(crc, *data++);
+    return ~crc;
+  }
+
+  bool Crc32File::HasHardwareCrc32()
+  {
+    static const bool sHardware = (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+    return sHardware;
+  }
+#else
+  // x86 crc32 instructions compute CRC32C (Castagnoli), which is another polynomial
+  bool Crc32File::HasHardwareCrc32() { return false; }
+#endif
+
+unsigned int Crc32File::Crc32(const void* data, size_t length, unsigned int previousCrc32)
+{
+  #if defined(__aarch64__)
+  if (HasHardwareCrc32()) return HardwareCrc32((const unsigned char*)data, length, previousCrc32);
+  #endif
+  return crc32_16bytes(data, length, previousCrc32);
+}
 
 bool Crc32File::Crc32(unsigned int& targetCrc32)
 {
   targetCrc32 = 0;
-  FILE* f = fopen(mPath.ToChars(), "rb");
-  if (f != nullptr)
+  int fd = open(mPath.ToChars(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return false;
+
+  struct stat info {};
+  bool ok = fstat(fd, &info) == 0;
+  if (ok && info.st_size > 0)
   {
-    char buffer[1 << 20]; // 1Mb buffer
-    for (int read = 0; (read = (int) fread(buffer, 1, sizeof(buffer), f)) > 0;)
-      targetCrc32 = crc32_16bytes(buffer, read, targetCrc32);
-    fclose(f);
-    return true;
+    // Tell the kernel to read ahead aggressively
+    (void)posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    // Read by chunks rather than mapping: a file truncated while hashed must fail, not raise SIGBUS
+    std::unique_ptr<unsigned char[]> buffer(new unsigned char[sBufferSize]);
+    off_t offset = 0;
+    for (ssize_t read = 0; (read = pread(fd, buffer.get(), sBufferSize, offset)) != 0; offset += read)
+    {
+      if (read < 0)
+      {
+        if (errno == EINTR) { read = 0; continue; }
+        ok = false;
+        break;
+      }
+      targetCrc32 = Crc32(buffer.get(), (size_t)read, targetCrc32);
+    }
+    // Roms are hashed once: do not keep them in the page cache
+    (void)posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
   }
-  return false;
+  close(fd);
+  return ok;
 }
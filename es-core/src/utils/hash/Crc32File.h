@@ -26,4 +26,23 @@ class Crc32File
      * @return True if the Crc32 has been computed, false on error
      */
     bool Crc32(unsigned int& targetCrc32);
+
+    /*!
+     * @brief Compute Crc32 of a memory block, using CPU instructions when available
+     * @param data Data
+     * @param length Data length
+     * @param previousCrc32 Crc32 of previous blocks
+     * @return Crc32
+     */
+    static unsigned int Crc32(const void* data, size_t length, unsigned int previousCrc32);
+
+    /*!
+     * @brief Check if Crc32 CPU instructions are available
+     * @return True if Crc32 are computed by the CPU
+     */
+    static bool HasHardwareCrc32();
+
+  private:
+    //! Read chunk size
+    static constexpr int sBufferSize = 1 << 20;
 };
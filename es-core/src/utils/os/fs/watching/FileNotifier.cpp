@@ -28,17 +28,19 @@ FileNotifier& FileNotifier::ResetEventNotifier()
   return *this;
 }
 
-void FileNotifier::CheckAndDispatch()
+bool FileNotifier::CheckAndDispatch()
 {
-  FileSystemEvent fileSystemEvent;
-  if (!mInotify.GetNextEvent(fileSystemEvent))
-    return;
-
-  EventType currentEvent = (EventType)fileSystemEvent.mMask;
-
-  if ((mInotify.EventMask() & currentEvent) != 0)
+  // Dispatch all pending events at once
+  bool read = false;
+  for(FileSystemEvent fileSystemEvent; mInotify.GetNextEvent(fileSystemEvent); read = true)
   {
-    if (mEventNotifier != nullptr)
-      mEventNotifier->FileSystemWatcherNotification(currentEvent, fileSystemEvent.mPath, fileSystemEvent.mEventTime);
+    EventType currentEvent = (EventType)fileSystemEvent.mMask;
+
+    if ((mInotify.EventMask() & currentEvent) != 0)
+    {
+      if (mEventNotifier != nullptr)
+        mEventNotifier->FileSystemWatcherNotification(currentEvent, fileSystemEvent.mPath, fileSystemEvent.mEventTime);
+    }
   }
+  return read;
 }
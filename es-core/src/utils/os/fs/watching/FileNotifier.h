@@ -23,9 +23,10 @@ class FileNotifier
     }
 
     /*!
-     * @brief Check event and call Notifiers
+     * @brief Check all pending events and call Notifiers
+     * @return True if at least one event has been read
      */
-    void CheckAndDispatch();
+    bool CheckAndDispatch();
 
     /*!
      * @brief Watch recursively all files starting from the given path
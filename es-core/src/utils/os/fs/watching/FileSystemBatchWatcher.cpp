@@ -0,0 +1,187 @@
+#include "FileSystemBatchWatcher.h"
+#include <utils/Log.h>
+#include <chrono>
+
+FileSystemBatchWatcher::FileSystemBatchWatcher(IFileSystemBatchNotification& notification)
+  : mNotification(notification)
+  , mSender(*this)
+{
+  mWatcher.SetEventMask(EventType::Create | EventType::CloseWrite | EventType::Remove | EventType::Move);
+}
+
+FileSystemBatchWatcher::~FileSystemBatchWatcher()
+{
+  Thread::Stop();
+}
+
+long long FileSystemBatchWatcher::Now()
+{
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void FileSystemBatchWatcher::WatchRoot(const Path& root)
+{
+  {
+    Mutex::AutoLock locker(mLocker);
+    for(const Path& existing : mRoots)
+      if (existing == root) return;
+    mRoots.push_back(root);
+    mNewRoots.push_back(root);
+  }
+
+  // Folder trees are walked in the background, not to delay the caller
+  if (!IsRunning()) Thread::Start("FSBatchWatcher");
+  else mWatcher.Interrupt();
+}
+
+void FileSystemBatchWatcher::WatchNewRoots()
+{
+  Mutex::AutoLock locker(mLocker);
+  for(const Path& root : mNewRoots)
+  {
+    mWatcher.WatchDirectoryTree(root);
+    { LOG(LogDebug) << "[FileSystemBatchWatcher] Watching " << root.ToString(); }
+  }
+  mNewRoots.clear();
+}
+
+void FileSystemBatchWatcher::UnwatchAll()
+{
+  Mutex::AutoLock locker(mLocker);
+  mWatcher.UnwatchAll();
+  mRoots.clear();
+  mNewRoots.clear();
+  mPending.clear();
+  mReady.clear();
+}
+
+FileSystemBatchWatcher::Change FileSystemBatchWatcher::Combine(Change previous, Change next)
+{
+  switch(previous)
+  {
+    case Change::Created: return next == Change::Removed ? Change::None : Change::Created;
+    case Change::Modified: return next == Change::Removed ? Change::Removed : Change::Modified;
+    case Change::Removed: return next == Change::Removed ? Change::Removed : Change::Modified;
+    case Change::None:
+    default: break;
+  }
+  return next;
+}
+
+FileSystemBatchWatcher::PendingChanges& FileSystemBatchWatcher::PendingFor(const Path& root, long long now)
+{
+  for(PendingChanges& existing : mPending)
+    if (existing.Root == root)
+    {
+      existing.Last = now;
+      return existing;
+    }
+  mPending.push_back({ root, HashMap<String, Change>(), now, now, false });
+  return mPending.back();
+}
+
+void FileSystemBatchWatcher::Coalesce(const FileSystemEvent& event, long long now)
+{
+  // Lost events: all roots must be checked
+  if ((event.mMask & EventType::QOverflow) != 0)
+  {
+    for(const Path& root : mRoots)
+      PendingFor(root, now).Overflow = true;
+    return;
+  }
+
+  Change change = Change::None;
+  if ((event.mMask & (EventType::Create | EventType::MovedTo)) != 0) change = Change::Created;
+  else if ((event.mMask & (EventType::Remove | EventType::MovedFrom)) != 0) change = Change::Removed;
+  else if ((event.mMask & EventType::CloseWrite) != 0) change = Change::Modified;
+  else return;
+
+  // Lookup root, deepest first
+  const Path* root = nullptr;
+  for(const Path& candidate : mRoots)
+    if (event.mPath.StartWidth(candidate))
+      if (root == nullptr || candidate.ToString().size() > root->ToString().size())
+        root = &candidate;
+  if (root == nullptr) return;
+
+  Change& net = PendingFor(*root, now).Changes[event.mPath.ToString()];
+  net = Combine(net, change);
+}
+
+int FileSystemBatchWatcher::Flush(long long now)
+{
+  long long wait = -1;
+  bool ready = false;
+  for(int i = (int)mPending.size(); --i >= 0; )
+  {
+    PendingChanges& pending = mPending[i];
+    long long deadline = std::min(pending.Last + sDebounceTime, pending.First + sMaxLatency);
+    if (deadline > now)
+    {
+      if (wait < 0 || deadline - now < wait) wait = deadline - now;
+      continue;
+    }
+
+    FileSystemChangeSet changes(pending.Root);
+    changes.mOverflow = pending.Overflow;
+    for(const auto& change : pending.Changes)
+      switch(change.second)
+      {
+        case Change::Created: changes.mCreated.push_back(Path(change.first)); break;
+        case Change::Modified: changes.mModified.push_back(Path(change.first)); break;
+        case Change::Removed: changes.mRemoved.push_back(Path(change.first)); break;
+        case Change::None:
+        default: break;
+      }
+    if (!changes.Empty())
+    {
+      { LOG(LogDebug) << "[FileSystemBatchWatcher] " << pending.Root.ToString() << ": " << changes.mCreated.size() << " created, "
+                      << changes.mModified.size() << " modified, " << changes.mRemoved.size() << " removed" << (changes.mOverflow ? " (overflow)" : ""); }
+      mReady.push_back(std::move(changes));
+      ready = true;
+    }
+    mPending.erase(mPending.begin() + i);
+  }
+
+  if (ready) mSender.Send();
+  return (int)wait;
+}
+
+void FileSystemBatchWatcher::Run()
+{
+  int timeout = -1;
+  std::vector<FileSystemEvent> events;
+  while(IsRunning())
+  {
+    WatchNewRoots();
+    bool available = mWatcher.WaitForEvents(timeout);
+    if (!IsRunning()) break;
+
+    Mutex::AutoLock locker(mLocker);
+    if (available)
+    {
+      events.clear();
+      mWatcher.ReadAllEvents(events);
+      long long now = Now();
+      for(const FileSystemEvent& event : events)
+      {
+        // Watch new folders. Their content may be created before the watch: receivers must scan created folders
+        if ((event.mMask & EventType::IsDir) != 0 && (event.mMask & (EventType::Create | EventType::MovedTo)) != 0)
+          mWatcher.WatchDirectoryTree(event.mPath);
+        Coalesce(event, now);
+      }
+    }
+    timeout = Flush(Now());
+  }
+}
+
+void FileSystemBatchWatcher::ReceiveSyncMessage()
+{
+  std::vector<FileSystemChangeSet> ready;
+  {
+    Mutex::AutoLock locker(mLocker);
+    ready.swap(mReady);
+  }
+  for(const FileSystemChangeSet& changes : ready)
+    mNotification.FileSystemBatchNotification(changes);
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <utils/os/fs/watching/FileSystemWatcher.h>
+#include <utils/os/fs/watching/IFileSystemBatchNotification.h>
+#include <utils/os/system/Thread.h>
+#include <utils/os/system/Mutex.h>
+#include <utils/sync/SyncMessageSender.h>
+#include <vector>
+
+/*!
+ * @brief Background watcher of whole folder trees, delivering coalesced change sets
+ *
+ * Only directories are watched: inotify reports changes of their files anyway, with far less watches.
+ * Events are read in a background thread, then coalesced per root folder and per path
+ * until the root has been quiet for a debounce delay (or until a maximum latency is reached,
+ * so that long copies are still reported progressively).
+ * One change set per root is then delivered to the main thread.
+ */
+class FileSystemBatchWatcher : private Thread
+                             , private ISyncMessageReceiver<void>
+{
+  public:
+    /*!
+     * @brief Constructor
+     * @param notification Change set receiver
+     */
+    explicit FileSystemBatchWatcher(IFileSystemBatchNotification& notification);
+
+    //! Destructor
+    ~FileSystemBatchWatcher() override;
+
+    /*!
+     * @brief Watch the given root folder and all its sub-folders. New sub-folders are watched automatically
+     * The folder tree is walked in the background thread
+     * @param root Root folder
+     */
+    void WatchRoot(const Path& root);
+
+    /*!
+     * @brief Stop watching all roots & drop pending changes
+     */
+    void UnwatchAll();
+
+  private:
+    //! Time without any event before a root's changes are delivered (ms)
+    static constexpr long long sDebounceTime = 1000;
+    //! Maximum time changes may stay pending under a continuous flow of events (ms)
+    static constexpr long long sMaxLatency = 10000;
+
+    //! Net change of a single path
+    enum class Change : char
+    {
+      None,     //!< Nothing left (created then removed)
+      Created,  //!< Created or moved in
+      Modified, //!< Modified, or replaced
+      Removed,  //!< Removed or moved out
+    };
+
+    //! Pending changes of a root
+    struct PendingChanges
+    {
+      Path Root;                      //!< Root folder
+      HashMap<String, Change> Changes; //!< Net change per path
+      long long First;                //!< First event time (ms)
+      long long Last;                 //!< Last event time (ms)
+      bool Overflow;                  //!< Events have been lost
+    };
+
+    //! Notification interface
+    IFileSystemBatchNotification& mNotification;
+    //! Underlying watcher
+    FileSystemWatcher mWatcher;
+    //! Watched roots
+    Path::PathList mRoots;
+    //! Roots whose folder tree is not walked yet
+    Path::PathList mNewRoots;
+    //! Pending changes
+    std::vector<PendingChanges> mPending;
+    //! Change sets ready to deliver
+    std::vector<FileSystemChangeSet> mReady;
+    //! Protect watcher, roots & change sets
+    Mutex mLocker;
+    //! Main thread delivery
+    SyncMessageSender<void> mSender;
+
+    //! Monotonic time in ms
+    static long long Now();
+
+    /*!
+     * @brief Combine a new change with the current net change of a path
+     * @param previous Current net change
+     * @param next New change
+     * @return New net change
+     */
+    static Change Combine(Change previous, Change next);
+
+    /*!
+     * @brief Get the pending changes of the given root, creating them if required
+     * @param root Root folder
+     * @param now Current time (ms)
+     * @return Pending changes, last event time updated
+     */
+    PendingChanges& PendingFor(const Path& root, long long now);
+
+    /*!
+     * @brief Add an event to the pending changes of its root
+     * @param event Event
+     * @param now Current time (ms)
+     */
+    void Coalesce(const FileSystemEvent& event, long long now);
+
+    /*!
+     * @brief Move changes whose debounce window has elapsed to the ready list
+     * @param now Current time (ms)
+     * @return Time to wait before the next flush (ms), -1 if nothing is pending
+     */
+    int Flush(long long now);
+
+    //! Walk & watch the folder trees of new roots
+    void WatchNewRoots();
+
+    /*
+     * Thread implementation
+     */
+
+    void Run() override;
+    void Break() override { mWatcher.Interrupt(); }
+
+    /*
+     * ISyncMessageReceiver<void> implementation
+     */
+
+    void ReceiveSyncMessage() override;
+};
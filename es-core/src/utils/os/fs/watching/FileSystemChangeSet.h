@@ -0,0 +1,33 @@
+#pragma once
+
+#include <utils/os/fs/Path.h>
+
+/*!
+ * @brief Net changes of a watched root folder, coalesced over a debounce window
+ * A path appears at most once, in the list of its net change:
+ * create+modify is a creation, create+remove is nothing, remove+create is a modification
+ */
+class FileSystemChangeSet
+{
+  public:
+    explicit FileSystemChangeSet(const Path& root)
+      : mRoot(root)
+      , mOverflow(false)
+    {
+    }
+
+    //! True if there is no change at all
+    [[nodiscard]] bool Empty() const { return mCreated.empty() && mModified.empty() && mRemoved.empty() && !mOverflow; }
+
+  public:
+    //! Watched root folder
+    Path mRoot;
+    //! Created files & folders (including moved in)
+    Path::PathList mCreated;
+    //! Modified files & folders
+    Path::PathList mModified;
+    //! Removed files & folders (including moved out)
+    Path::PathList mRemoved;
+    //! Events have been lost: the whole root must be checked again
+    bool mOverflow;
+};
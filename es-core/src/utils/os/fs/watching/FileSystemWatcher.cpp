@@ -4,6 +4,7 @@
 
 #include <utils/String.h>
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <zconf.h>
 #include <cstring>
 
@@ -16,6 +17,7 @@ FileSystemWatcher::FileSystemWatcher()
     mEventMask(EventType::All),
     mInotifyFd(0),
     mEpollFd(0),
+    mInterruptFd(0),
     mPipeReadIdx(0),
     mPipeWriteIdx(1)
 {
@@ -31,11 +33,20 @@ FileSystemWatcher::FileSystemWatcher()
   mInotifyEpollEvent.data.fd = mInotifyFd;
   if (epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mInotifyFd, &mInotifyEpollEvent) == -1)
   { LOG(LogError) << "[FileWatcher] Can't add inotify filedescriptor to epoll ! " << strerror(errno) << "."; }
+
+  mInterruptFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  epoll_event interruptEvent {};
+  interruptEvent.events = EPOLLIN;
+  interruptEvent.data.fd = mInterruptFd;
+  if (mInterruptFd == -1 || epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mInterruptFd, &interruptEvent) == -1)
+  { LOG(LogError) << "[FileWatcher] Can't add interrupt filedescriptor to epoll ! " << strerror(errno) << "."; }
 }
 
 FileSystemWatcher::~FileSystemWatcher()
 {
   epoll_ctl(mEpollFd, EPOLL_CTL_DEL, mInotifyFd, nullptr);
+  epoll_ctl(mEpollFd, EPOLL_CTL_DEL, mInterruptFd, nullptr);
+  if (mInterruptFd >= 0) close(mInterruptFd);
 
   if (close(mInotifyFd) != 0)
   { LOG(LogError) << "[FileWatcher] Error closing notify fd."; }
@@ -78,6 +89,56 @@ void FileSystemWatcher::WatchFile(const Path& file)
   else { LOG(LogError) << "[FileWatcher] Can´t watch Path! Path does not exist. Path: " << file.ToString(); }
 }
 
+void FileSystemWatcher::WatchDirectoryTree(const Path& path)
+{
+  if (!path.IsDirectory()) return;
+  WatchFile(path);
+  for (const Path& p : path.GetDirectoryContent())
+    if (p.IsDirectory() && !p.IsSymLink())
+      WatchDirectoryTree(p);
+}
+
+void FileSystemWatcher::UnwatchAll()
+{
+  for (const auto& watch : mDirectorieMap)
+    inotify_rm_watch(mInotifyFd, watch.first);
+  mDirectorieMap.clear();
+}
+
+bool FileSystemWatcher::WaitForEvents(int timeout)
+{
+  int nFdsReady = epoll_wait(mEpollFd, mEpollEvents, MAX_EPOLL_EVENTS, timeout);
+  bool available = false;
+  for (int n = 0; n < nFdsReady; ++n)
+    if (mEpollEvents[n].data.fd == mInterruptFd)
+    {
+      eventfd_t dummy = 0;
+      (void)eventfd_read(mInterruptFd, &dummy);
+    }
+    else available = true;
+  return available;
+}
+
+void FileSystemWatcher::ReadAllEvents(std::vector<FileSystemEvent>& events)
+{
+  // Edge triggered: read until the queue is empty, or pending events would be reported only on the next event
+  for(;;)
+  {
+    ssize_t length = read(mInotifyFd, mEventBuffer, sizeof(mEventBuffer));
+    if (length <= 0)
+    {
+      if (length < 0 && errno == EINTR) continue;
+      break;
+    }
+    readEventsFromBuffer((int)length, events);
+  }
+}
+
+void FileSystemWatcher::Interrupt()
+{
+  (void)eventfd_write(mInterruptFd, 1);
+}
+
 bool FileSystemWatcher::GetNextEvent(FileSystemEvent& fsevent)
 {
   std::vector<FileSystemEvent> newEvents;
@@ -109,7 +170,7 @@ ssize_t FileSystemWatcher::readEventsIntoBuffer()
 
   for (int n = 0; n < nFdsReady; ++n)
   {
-    //if (mEpollEvents[n].data.fd == mStopPipeFd[mPipeReadIdx]) break;
+    if (mEpollEvents[n].data.fd != mInotifyFd) continue;
 
     length = read(mEpollEvents[n].data.fd, mEventBuffer, sizeof(mEventBuffer));
     if (length == -1 && errno == EINTR)
@@ -126,6 +187,13 @@ void FileSystemWatcher::readEventsFromBuffer(int length, std::vector<FileSystemE
   {
     inotify_event* event = ((struct inotify_event*) &mEventBuffer[i]);
 
+    if ((event->mask & IN_Q_OVERFLOW) != 0u)
+    {
+      i += (int)(EVENT_SIZE + event->len);
+      events.push_back(FileSystemEvent(event->wd, EventType::QOverflow, Path::Empty, DateTime()));
+      continue;
+    }
+
     if ((event->mask & IN_IGNORED) != 0u)
     {
       i += (int)(EVENT_SIZE + event->len);
@@ -63,6 +63,18 @@ class FileSystemWatcher
      */
     void WatchFile(const Path& file);
 
+    /*!
+     * @brief Recursively add every directory from the given path to the watch list
+     * Watching directories is enough to get events on their files, and costs far less watches
+     * @param path Path to watch
+     */
+    void WatchDirectoryTree(const Path& path);
+
+    /*!
+     * @brief Remove all watches
+     */
+    void UnwatchAll();
+
     /*!
      * @brief Set the event we want to be notified of
      * @param eventMask events
@@ -82,11 +94,29 @@ class FileSystemWatcher
      */
     bool GetNextEvent(FileSystemEvent& fsevent);
 
+    /*!
+     * @brief Block until events are available, the timeout is reached, or Interrupt() is called
+     * @param timeout Timeout in milliseconds, -1 to wait forever
+     * @return True if events are available, false on timeout or interruption
+     */
+    bool WaitForEvents(int timeout);
+
+    /*!
+     * @brief Read all available events at once, without blocking
+     * @param events Event list to fill in
+     */
+    void ReadAllEvents(std::vector<FileSystemEvent>& events);
+
+    /*!
+     * @brief Wake up a thread blocked in WaitForEvents
+     */
+    void Interrupt();
+
   private:
     //! Max events
     static constexpr int MAX_EVENTS = 256;
     //! Max polled event at once
-    static constexpr int MAX_EPOLL_EVENTS = 1;
+    static constexpr int MAX_EPOLL_EVENTS = 2;
     //! Event structure size
     static constexpr int EVENT_SIZE = (int) (sizeof(inotify_event));
 
@@ -126,6 +156,7 @@ class FileSystemWatcher
     EventType mEventMask;
     int mInotifyFd;
     int mEpollFd;
+    int mInterruptFd;
     const int mPipeReadIdx;
     const int mPipeWriteIdx;
 };
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "FileSystemChangeSet.h"
+
+class IFileSystemBatchNotification
+{
+  public:
+    //! Destructor
+    virtual ~IFileSystemBatchNotification() = default;
+
+    /*!
+     * @brief Called from the main thread with the net changes of a watched root folder
+     * @param changes Change set
+     */
+    virtual void FileSystemBatchNotification(const FileSystemChangeSet& changes) = 0;
+};
@@ -0,0 +1,525 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <sys/sysinfo.h>
+#include <utils/Log.h>
+#include <utils/os/system/Thread.h>
+#include <utils/os/system/Signal.h>
+#include <utils/os/system/IThreadPoolWorkerInterface.h>
+
+/*!
+ * @brief Drop-in replacement of ThreadPool, using one job deque per worker
+ *
+ * On Run, queued jobs are sorted by priority and dealt to workers in a round-robin manner.
+ * Each worker pops its own jobs from the bottom of its deque (highest priority first) without locking,
+ * and when it runs dry, steals jobs from the top of other workers' deques.
+ * Results are stored per worker so that workers never compete to push them.
+ *
+ * Jobs pushed after Run (permanent pools) go through a shared injection queue.
+ */
+template<class FeedObject, class ResultObject> class WorkStealingThreadPool
+{
+  private:
+    /*!
+     * @brief Indexed result (e.g: Result + injection index)
+     */
+    struct IndexedResult
+    {
+      public:
+        int          Index;  //!< Index
+        ResultObject Result; //!< Result object
+
+        /*!
+         * @brief Constructor
+         * @param index Index
+         * @param result Result
+         */
+        IndexedResult(int index, ResultObject result)
+          : Index(index),
+            Result(result)
+        {
+        }
+    };
+
+    /*!
+     * @brief Indexed feed (e.g: Feed + injection index)
+     */
+    struct IndexedFeed
+    {
+      public:
+        int        Index;    //!< Index
+        int        Priority; //!< Priority - Highest priority are processed first
+        FeedObject Feed;     //!< Source object
+
+        /*!
+         * @brief Constructor
+         * @param index Index
+         * @param feed Result
+         */
+        IndexedFeed(int index, FeedObject feed, int priority = 0)
+          : Index(index),
+            Priority(priority),
+            Feed(feed)
+        {
+        }
+
+        IndexedFeed()
+          : Index(0),
+            Priority(0),
+            Feed()
+        {
+        }
+    };
+
+    /*!
+     * @brief Work deque, filled once before workers start.
+     * The owner pops from the bottom, thieves steal from the top (Chase-Lev, without push).
+     * As items are never written while workers run, only top & bottom need to be atomic.
+     */
+    class WorkDeque
+    {
+      public:
+        //! Steal result
+        enum class Steal
+        {
+          Empty,   //!< Nothing to steal
+          Abort,   //!< Lost a race, retry
+          Success, //!< Item stolen
+        };
+
+        /*!
+         * @brief Fill the deque. Must not be called while workers are running
+         * @param items Feed indexes, bottom (first popped) last
+         */
+        void Reset(std::vector<int>&& items)
+        {
+          mItems = std::move(items);
+          mTop.store(0, std::memory_order_relaxed);
+          mBottom.store((int)mItems.size(), std::memory_order_release);
+        }
+
+        /*!
+         * @brief Pop an item from the bottom. Owner thread only
+         * @param item Popped item
+         * @return True if an item has been popped
+         */
+        bool Pop(int& item)
+        {
+          int b = mBottom.load(std::memory_order_relaxed) - 1;
+          mBottom.store(b, std::memory_order_relaxed);
+          std::atomic_thread_fence(std::memory_order_seq_cst);
+          int t = mTop.load(std::memory_order_relaxed);
+          if (t > b)
+          {
+            mBottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+          }
+          item = mItems[b];
+          if (t != b) return true;
+          // Last item: race against thieves
+          bool won = mTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+          mBottom.store(b + 1, std::memory_order_relaxed);
+          return won;
+        }
+
+        /*!
+         * @brief Steal an item from the top. Any thread
+         * @param item Stolen item
+         * @return Steal result
+         */
+        Steal TrySteal(int& item)
+        {
+          int t = mTop.load(std::memory_order_acquire);
+          std::atomic_thread_fence(std::memory_order_seq_cst);
+          int b = mBottom.load(std::memory_order_acquire);
+          if (t >= b) return Steal::Empty;
+          item = mItems[t];
+          if (!mTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return Steal::Abort;
+          return Steal::Success;
+        }
+
+      private:
+        //! Feed indexes
+        std::vector<int> mItems;
+        //! Top (steal side)
+        std::atomic<int> mTop { 0 };
+        //! Bottom (owner side)
+        std::atomic<int> mBottom { 0 };
+    };
+
+    /*!
+     * @brief Real worker threads
+     */
+    class WorkerThread: public Thread
+    {
+      private:
+        Signal                  mSignal;   //!< Signal to start new jobs
+        WorkStealingThreadPool& mParent;   //!< Manager
+        int                     mPriority; //!< Relative priority
+        int                     mSlot;     //!< Worker index in the pool
+
+      public:
+        WorkDeque                  mDeque;       //!< Own jobs
+        std::vector<IndexedResult> mResults;     //!< Own results
+        Mutex                      mResultMutex; //!< Result protection - only contended by PopResult
+
+        explicit WorkerThread(WorkStealingThreadPool& parent, int relativePriority, int slot)
+          : mParent(parent)
+          , mPriority(relativePriority)
+          , mSlot(slot)
+        {
+        }
+
+        void Run() override;
+
+        void Break() override { Fire(); }
+
+        /*!
+         * @brief Set the signal to wake up the thread
+         */
+        void Fire() { mSignal.Fire(); }
+
+        //! Get worker index
+        [[nodiscard]] int Slot() const { return mSlot; }
+    };
+
+    //! Name
+    String                     mThreadPoolName;
+    //! Worker threads
+    std::vector<WorkerThread*> mThreads;
+    //! Feeds dealt to workers at Run. Never modified while workers run
+    std::vector<IndexedFeed>   mFeeds;
+    //! Feeds waiting for Run, or pushed after Run
+    std::vector<IndexedFeed>   mInjected;
+    //! Injection queue protection
+    Mutex                      mInjectedMutex;
+    //! Interface
+    IThreadPoolWorkerInterface<FeedObject, ResultObject>* mInterface;
+    //! Global index (also total queue-ed object count)
+    std::atomic<int>           mIndex;
+    //! Jobs taken by workers or dropped
+    std::atomic<int>           mTaken;
+    //! Total completed
+    std::atomic<int>           mTotalCompleted;
+    //! Total cancelled
+    std::atomic<int>           mTotalCancelled;
+    //! Tick duration
+    int                        mTickDuration;
+    //! Permanent workers
+    volatile bool              mPermanent;
+
+    /*!
+     * @brief Get next feed object for the given worker: own deque first, then injection queue, then steal
+     * @param worker Requesting worker
+     * @param result Feed object
+     * @return True if a feed object has been taken, false if there is nothing left anywhere
+     */
+    bool NextFeed(WorkerThread& worker, IndexedFeed& result)
+    {
+      int item = 0;
+      if (worker.mDeque.Pop(item))
+      {
+        result = mFeeds[item];
+        mTaken++;
+        return true;
+      }
+
+      if (PopInjected(result)) return true;
+
+      // Steal from others, starting from the next worker to spread thieves
+      int count = (int)mThreads.size();
+      for(bool retry = true; retry; )
+      {
+        retry = false;
+        for(int i = 1; i < count; ++i)
+          switch(mThreads[(worker.Slot() + i) % count]->mDeque.TrySteal(item))
+          {
+            case WorkDeque::Steal::Success:
+            {
+              result = mFeeds[item];
+              mTaken++;
+              return true;
+            }
+            case WorkDeque::Steal::Abort: retry = true; break;
+            case WorkDeque::Steal::Empty:
+            default: break;
+          }
+      }
+      return false;
+    }
+
+    /*!
+     * @brief Pop a feed from the injection queue
+     * @param result Feed object
+     * @return True if a feed object has been popped
+     */
+    bool PopInjected(IndexedFeed& result)
+    {
+      Mutex::AutoLock locker(mInjectedMutex);
+      if (mInjected.empty()) return false;
+      result = mInjected.back();
+      mInjected.pop_back();
+      mTaken++;
+      return true;
+    }
+
+    /*!
+     * @brief Push result object into the worker's own result list
+     * @param worker Worker
+     * @param result Result object
+     */
+    void PushResult(WorkerThread& worker, IndexedResult& result)
+    {
+      {
+        Mutex::AutoLock locker(worker.mResultMutex);
+        worker.mResults.push_back(result);
+      }
+      mTotalCompleted++;
+    }
+
+    /*!
+     * @brief Deal sorted feeds to workers, round-robin, so that each worker starts with the highest priority jobs
+     */
+    void DealFeeds()
+    {
+      int count = (int)mThreads.size();
+      int total = (int)mFeeds.size();
+      for(int w = 0; w < count; ++w)
+      {
+        std::vector<int> items;
+        items.reserve(total / count + 1);
+        for(int i = w; i < total; i += count)
+          items.push_back(i);
+        // The bottom (last item) is popped first: highest priority must be last
+        std::reverse(items.begin(), items.end());
+        mThreads[w]->mDeque.Reset(std::move(items));
+      }
+    }
+
+  public:
+    /*!
+     * @brief Constructor
+     * @param parmanent if set to True, all workers do no die after job completion.
+     * They wait for next queued job instead
+     */
+    WorkStealingThreadPool(IThreadPoolWorkerInterface<FeedObject, ResultObject>* interface, const String& name, bool permanent, int tickduration = 0)
+      : mThreadPoolName(name),
+        mInterface(interface),
+        mIndex(0),
+        mTaken(0),
+        mTotalCompleted(0),
+        mTotalCancelled(0),
+        mTickDuration(tickduration),
+        mPermanent(permanent)
+    {
+    }
+
+    /*!
+     * @brief Destructor
+     */
+    ~WorkStealingThreadPool()
+    {
+      mPermanent = false;
+      for(auto& thread : mThreads)
+      {
+        thread->Stop();
+        thread->Fire();
+      }
+
+      for (auto& thread : mThreads)
+        thread->Join();
+
+      for(auto& thread : mThreads)
+        delete thread;
+
+      mThreads.clear();
+    }
+
+    /*!
+     * @brief Get pending job count
+     * @return Job count
+     */
+    int PendingJobs() { return mIndex - mTaken; }
+
+    /*!
+     * @brief Cancel all pending jobs
+     */
+    void CancelPendingJobs()
+    {
+      int cancelled = 0;
+      {
+        Mutex::AutoLock locker(mInjectedMutex);
+        cancelled = (int)mInjected.size();
+        mInjected.clear();
+      }
+      // Steal everything left in worker deques
+      int item = 0;
+      for(WorkerThread* thread : mThreads)
+        for(typename WorkDeque::Steal steal; (steal = thread->mDeque.TrySteal(item)) != WorkDeque::Steal::Empty; )
+          if (steal == WorkDeque::Steal::Success) cancelled++;
+      mTaken += cancelled;
+      mTotalCancelled += cancelled;
+    }
+
+    /*!
+     * @brief Populate working queue with feed objects
+     * @param feed Feed object
+     * @param Priority: higher priorities are executed first
+     */
+    void PushFeed(FeedObject feed, int priority = 0)
+    {
+      {
+        Mutex::AutoLock locker(mInjectedMutex);
+        mInjected.push_back(IndexedFeed(mIndex++, feed, priority));
+      }
+      if (mPermanent)
+        for(WorkerThread* thread : mThreads)
+          thread->Fire();
+    }
+
+    /*!
+     * @brief Pop result object
+     * @param result Result object, filled in only if the method returns true
+     * @return True if there is still a result object to fill result with, false otherwise
+     */
+    bool PopResult(ResultObject& result, int& index)
+    {
+      for(WorkerThread* thread : mThreads)
+      {
+        Mutex::AutoLock locker(thread->mResultMutex);
+        if (!thread->mResults.empty())
+        {
+          result = thread->mResults.back().Result;
+          index  = thread->mResults.back().Index;
+          thread->mResults.pop_back();
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /*!
+     * @brief Run the current thread pool
+     * @param threadCount Number of thread to allocate and launch
+     * Using 0 set the actual value to ncpu * 2
+     * @param async Do not wait for end of all thread, exit immediately.
+     * if async is used, WaitForCompletion must be used to ensure all worker thread have finished.
+     * @param priority Relative priority
+     */
+    void Run(int threadCount, bool async, int priority = 0);
+
+    /*!
+     * @brief Wait for completion of all worker threads
+     * If the threadpool is permanent, wait indefinitely
+     */
+    void WaitForCompletion()
+    {
+      int completed = 0;
+      if (mTickDuration > 0)
+        for(;;)
+        {
+          usleep(mTickDuration * 1000); // 20ms
+          int totalCompleted = mTotalCompleted;
+          if (completed != totalCompleted)
+          {
+            mInterface->ThreadPoolTick(totalCompleted, mIndex);
+            completed = totalCompleted;
+          }
+          if (!mPermanent)
+            if (totalCompleted + mTotalCancelled == mIndex) break;
+        }
+
+      // Wait for thread to die
+      for (auto& thread : mThreads)
+        thread->Join();
+    }
+
+    /*!
+     * @brief Get the worker count
+     * @return Worker count
+     */
+    [[nodiscard]] int WorkerCount() const { return mThreads.size(); }
+
+    /*!
+     * @brief Tell if the threadpool is parmanent or not
+     * @return True if it is permanent, false otherwise
+     */
+    [[nodiscard]] bool IsPermanent() const { return mPermanent; }
+};
+
+template<class FeedObject, class ResultObject>
+void WorkStealingThreadPool<FeedObject, ResultObject>::Run(int threadCount, bool async, int priority)
+{
+  // Set thread count
+  if (threadCount <= 0)
+    threadCount = get_nprocs_conf() * (threadCount == 0 ? 1 : -threadCount);
+
+  // Log
+  { LOG(LogDebug) << "[ThreadPool] Creating new work-stealing threadpool '" << mThreadPoolName << "' using " << threadCount << " workers " << (mPermanent ? "permanently" : "one-shoot"); }
+
+  // Delete previous threads
+  for(WorkerThread* thread : mThreads)
+    delete thread;
+  mThreads.clear();
+
+  // Take queued feeds and sort by descending priority, keeping push order for equal priorities
+  {
+    Mutex::AutoLock locker(mInjectedMutex);
+    mFeeds.swap(mInjected);
+    mInjected.clear();
+  }
+  std::stable_sort(mFeeds.begin(), mFeeds.end(), [](const IndexedFeed& a, const IndexedFeed& b) { return a.Priority > b.Priority; });
+
+  // Create threads & deal jobs before starting them
+  for(int i = 0; i < threadCount; ++i)
+    mThreads.push_back(new WorkerThread(*this, priority, i));
+  DealFeeds();
+
+  // Run threads
+  for(int i = threadCount; --i >= 0; )
+  {
+    String name(mThreadPoolName);
+    name.Append('#').Append(i);
+    mThreads[i]->Start(name);
+  }
+
+  // If not async wait for all job to be completed
+  if (!async)
+    WaitForCompletion();
+}
+
+template<class FeedObject, class ResultObject>
+void WorkStealingThreadPool<FeedObject, ResultObject>::WorkerThread::Run()
+{
+  int loop = -1;
+  if (nice(-mPriority) <0) { LOG(LogError) << "[ThreadPool] Cannot change thread priority!"; }
+  while(IsRunning())
+  {
+    // Wait start signal
+    if (++loop != 0)
+      mSignal.WaitSignal();
+
+    // Get feed
+    IndexedFeed feed;
+    while(mParent.NextFeed(*this, feed))
+      if (mParent.mInterface != nullptr)
+      {
+        // Start job
+        mParent.mInterface->ThreadPoolJobStart(feed.Feed);
+
+        // Run job
+        IndexedResult result(feed.Index, mParent.mInterface->ThreadPoolRunJob(feed.Feed));
+        mParent.PushResult(*this, result);
+
+        // Stop job
+        mParent.mInterface->ThreadPoolJobCompleted(feed.Feed, mParent.PendingJobs());
+      }
+
+    // Not permanent?
+    if (!mParent.mPermanent)
+      break;
+  }
+}
@@ -0,0 +1,116 @@
+#include "StartupProfiler.h"
+#include <RootFolders.h>
+#include <utils/Files.h>
+#include <utils/Log.h>
+#include <utils/json/JSONBuilder.h>
+#include <utils/datetime/DateTime.h>
+#include <algorithm>
+#include <chrono>
+
+Mutex StartupProfiler::sLocker;
+std::atomic<bool> StartupProfiler::sRecording(false);
+int StartupProfiler::sBootCount = 0;
+long long StartupProfiler::sBootStart = 0;
+long long StartupProfiler::sBootDuration = 0;
+String StartupProfiler::sBootDate;
+std::vector<StartupProfiler::Timing> StartupProfiler::sTimings;
+std::map<String, long long> StartupProfiler::sCounters;
+
+long long StartupProfiler::Now()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Path StartupProfiler::ReportPath()
+{
+  return RootFolders::DataRootFolder / sReportFile;
+}
+
+void StartupProfiler::Start()
+{
+  Mutex::AutoLock locker(sLocker);
+  sBootCount++;
+  sBootStart = Now();
+  sBootDuration = 0;
+  sBootDate = DateTime().ToISO8601();
+  sTimings.clear();
+  sTimings.reserve(1024);
+  sCounters.clear();
+  sRecording = true;
+}
+
+void StartupProfiler::Complete()
+{
+  {
+    Mutex::AutoLock locker(sLocker);
+    if (!sRecording) return;
+    sRecording = false;
+    sBootDuration = Now() - sBootStart;
+  }
+
+  // Keep the previous report to compare boots
+  Path path = ReportPath();
+  if (path.Exists())
+    (void)Path::Rename(path, path.ChangeExtension(".backup.json"));
+  if (!Files::SaveFile(path, Report()))
+    { LOG(LogWarning) << "[StartupProfiler] Cannot write " << path.ToString(); }
+  { LOG(LogInfo) << "[StartupProfiler] Boot completed in " << (sBootDuration / 1000) << "ms."; }
+}
+
+void StartupProfiler::Record(const char* category, const String& name, long long start, long long duration)
+{
+  Mutex::AutoLock locker(sLocker);
+  if (sRecording)
+    sTimings.push_back({ category, name, start - sBootStart, duration });
+}
+
+void StartupProfiler::Count(const char* counter, long long value)
+{
+  if (!sRecording) return;
+  Mutex::AutoLock locker(sLocker);
+  sCounters[counter] += value;
+}
+
+String StartupProfiler::Report()
+{
+  Mutex::AutoLock locker(sLocker);
+
+  // Group by category, slowest first
+  std::vector<const Timing*> timings;
+  timings.reserve(sTimings.size());
+  for(const Timing& timing : sTimings) timings.push_back(&timing);
+  std::stable_sort(timings.begin(), timings.end(), [](const Timing* a, const Timing* b)
+  {
+    int c = strcmp(a->Category, b->Category);
+    return c != 0 ? c < 0 : a->Duration > b->Duration;
+  });
+
+  // Totals
+  std::map<String, long long> totals;
+  for(const Timing* timing : timings) totals[timing->Category] += timing->Duration;
+
+  JSONBuilder json;
+  json.Open()
+      .Field("boot", sBootCount)
+      .Field("date", sBootDate)
+      .Field("version", Files::LoadFile(Path("/recalbox/recalbox.version")).Trim())
+      .Field("completed", !sRecording && sBootDuration != 0)
+      .Field("duration", sRecording ? Now() - sBootStart : sBootDuration)
+      .OpenObject("totals");
+  for(const auto& total : totals) json.Field(total.first.c_str(), total.second);
+  json.CloseObject()
+      .OpenObject("counters");
+  for(const auto& counter : sCounters) json.Field(counter.first.c_str(), counter.second);
+  json.CloseObject()
+      .OpenArray("timings");
+  for(const Timing* timing : timings)
+    json.OpenObject(nullptr)
+        .Field("category", timing->Category)
+        .Field("name", timing->Name)
+        .Field("start", timing->Start)
+        .Field("duration", timing->Duration)
+        .CloseObject();
+  json.CloseArray()
+      .Close();
+  return json;
+}
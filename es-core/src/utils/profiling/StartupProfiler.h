@@ -0,0 +1,121 @@
+#pragma once
+
+#include <utils/String.h>
+#include <utils/os/fs/Path.h>
+#include <utils/os/system/Mutex.h>
+#include <atomic>
+#include <map>
+#include <vector>
+
+/*!
+ * @brief Boot-time instrumentation
+ *
+ * Records scoped timings and counters from the start of a boot until its completion,
+ * from any thread. Once the boot is complete, a JSON report is written into the log folder
+ * and recording stops: remaining scopes cost a single atomic read.
+ *
+ * Timings are grouped by category (phase, system, gamelist, theme, ...) and named after
+ * the object they measure, so that the slowest systems stand out and reports from different
+ * releases can be compared.
+ */
+class StartupProfiler
+{
+  public:
+    /*!
+     * @brief Scoped timer. Records the time elapsed between its construction & its destruction
+     */
+    class Scope
+    {
+      public:
+        /*!
+         * @brief Start timing
+         * @param category Category. Must be a static string
+         * @param name Measured object name
+         */
+        Scope(const char* category, const String& name)
+          : mCategory(category)
+          , mName(sRecording ? name : String())
+          , mStart(sRecording ? Now() : 0)
+        {
+        }
+
+        //! Stop timing & record
+        ~Scope() { if (mStart != 0) Record(mCategory, mName, mStart, Now() - mStart); }
+
+      private:
+        //! Category
+        const char* mCategory;
+        //! Name
+        String mName;
+        //! Start time (µs), 0 if not recording
+        long long mStart;
+    };
+
+    /*!
+     * @brief Start a new boot record, dropping the previous one
+     */
+    static void Start();
+
+    /*!
+     * @brief Complete the current boot record, write the report & stop recording
+     */
+    static void Complete();
+
+    /*!
+     * @brief Record a timing
+     * @param category Category. Must be a static string
+     * @param name Measured object name
+     * @param start Start time (µs, from Now())
+     * @param duration Duration (µs)
+     */
+    static void Record(const char* category, const String& name, long long start, long long duration);
+
+    /*!
+     * @brief Add a value to a counter
+     * @param counter Counter name
+     * @param value Value to add
+     */
+    static void Count(const char* counter, long long value = 1);
+
+    /*!
+     * @brief Build the JSON report of the current or last boot
+     * @return JSON report
+     */
+    static String Report();
+
+    //! Monotonic time in µs
+    static long long Now();
+
+  private:
+    //! Report file
+    static constexpr const char* sReportFile = "system/logs/es_startup.json";
+
+    //! Timing record
+    struct Timing
+    {
+      const char* Category; //!< Category
+      String Name;          //!< Measured object name
+      long long Start;      //!< Start time relative to the boot start (µs)
+      long long Duration;   //!< Duration (µs)
+    };
+
+    //! Protect records
+    static Mutex sLocker;
+    //! Recording flag
+    static std::atomic<bool> sRecording;
+    //! Boot number since ES start
+    static int sBootCount;
+    //! Boot start time (µs)
+    static long long sBootStart;
+    //! Boot duration (µs), 0 while booting
+    static long long sBootDuration;
+    //! Boot date
+    static String sBootDate;
+    //! Timings
+    static std::vector<Timing> sTimings;
+    //! Counters
+    static std::map<String, long long> sCounters;
+
+    //! Get report path
+    static Path ReportPath();
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+/*!
+ * @brief Fixed capacity cache. The least recently used entry is dropped first when the capacity is exceeded
+ * @tparam KeyT Key type
+ * @tparam ValueT Value type
+ * @tparam HashT Key hasher
+ */
+template <typename KeyT, typename ValueT, typename HashT = std::hash<KeyT>>
+class LruCache
+{
+  public:
+    /*!
+     * @brief Constructor
+     * @param capacity Maximum entries
+     */
+    explicit LruCache(int capacity)
+      : mCapacity(capacity)
+    {
+    }
+
+    /*!
+     * @brief Get the value of the given key and mark it as the most recently used
+     * @param key Key to lookup
+     * @return Value pointer or nullptr if the key is not in the cache
+     */
+    ValueT* try_get(const KeyT& key)
+    {
+      auto it = mLookup.find(key);
+      if (it == mLookup.end()) return nullptr;
+      mEntries.splice(mEntries.begin(), mEntries, it->second);
+      return &it->second->second;
+    }
+
+    /*!
+     * @brief Insert or replace the value of the given key, as the most recently used
+     * @param key Key
+     * @param value Value
+     * @return Stored value
+     */
+    ValueT& insert(const KeyT& key, ValueT&& value)
+    {
+      auto it = mLookup.find(key);
+      if (it != mLookup.end())
+      {
+        it->second->second = std::move(value);
+        mEntries.splice(mEntries.begin(), mEntries, it->second);
+        return it->second->second;
+      }
+      mEntries.emplace_front(key, std::move(value));
+      mLookup[key] = mEntries.begin();
+      if ((int)mEntries.size() > mCapacity)
+      {
+        mLookup.erase(mEntries.back().first);
+        mEntries.pop_back();
+      }
+      return mEntries.front().second;
+    }
+
+    //! Remove all entries
+    void clear()
+    {
+      mLookup.clear();
+      mEntries.clear();
+    }
+
+    //! Entry count
+    [[nodiscard]] int size() const { return (int)mEntries.size(); }
+
+  private:
+    //! Entry list type, most recently used first
+    typedef std::list<std::pair<KeyT, ValueT>> EntryList;
+
+    //! Maximum entries
+    int mCapacity;
+    //! Entries
+    EntryList mEntries;
+    //! Lookup
+    std::unordered_map<KeyT, typename EntryList::iterator, HashT> mLookup;
+};
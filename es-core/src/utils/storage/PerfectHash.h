@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstring>
+#include <type_traits>
+
+/*!
+ * @brief Compile-time perfect hash over a static string table
+ *
+ * Built by a constexpr constructor using hash & displace: keys are spread into buckets,
+ * then buckets, largest first, get the smallest displacement that drops all their keys
+ * into free slots. The whole table lands in read-only data: no startup hashing, no allocation.
+ * A lookup is one hash, two table reads and one string compare.
+ *
+ * Keys must be unique, otherwise the table does not compile.
+ *
+ * @tparam KeyCount Key count
+ * @tparam BucketCount Bucket count, power of 2. KeyCount / 4 is a good start
+ * @tparam TableSize Slot count, power of 2, at least twice the key count to keep the build fast
+ */
+template<int KeyCount, int BucketCount, int TableSize>
+class PerfectHash
+{
+  static_assert((BucketCount & (BucketCount - 1)) == 0, "BucketCount must be a power of 2");
+  static_assert((TableSize & (TableSize - 1)) == 0, "TableSize must be a power of 2");
+  static_assert(TableSize > KeyCount, "TableSize must be greater than KeyCount");
+
+  public:
+    /*!
+     * @brief Build the table
+     * @param keys Key table. Keys are read at keys[index * stride]
+     * @param stride Key stride, allowing to index key/value tables
+     */
+    constexpr PerfectHash(const char* const* keys, int stride)
+      : mKeys(keys)
+      , mStride(stride)
+      , mDisplacements()
+      , mSlots()
+    {
+      // Hash all keys & count bucket sizes
+      unsigned long long hashes[KeyCount] {};
+      int bucketStarts[BucketCount + 1] {};
+      for(int k = 0; k < KeyCount; ++k)
+      {
+        hashes[k] = Hash(keys[k * stride]);
+        bucketStarts[Bucket(hashes[k]) + 1]++;
+      }
+      int maxBucketSize = 0;
+      for(int b = 0; b < BucketCount; ++b)
+      {
+        if (bucketStarts[b + 1] > maxBucketSize) maxBucketSize = bucketStarts[b + 1];
+        bucketStarts[b + 1] += bucketStarts[b];
+      }
+
+      // Group keys per bucket
+      int members[KeyCount] {};
+      int fill[BucketCount] {};
+      for(int k = 0; k < KeyCount; ++k)
+      {
+        int b = Bucket(hashes[k]);
+        members[bucketStarts[b] + fill[b]++] = k;
+      }
+
+      // Place buckets, largest first
+      bool used[TableSize] {};
+      int slots[KeyCount] {};
+      for(int size = maxBucketSize; size > 0; --size)
+        for(int b = 0; b < BucketCount; ++b)
+        {
+          if (bucketStarts[b + 1] - bucketStarts[b] != size) continue;
+          const int* bucket = &members[bucketStarts[b]];
+          int displacement = 0;
+          for(; displacement < TableSize; ++displacement)
+          {
+            bool ok = true;
+            for(int i = 0; ok && i < size; ++i)
+            {
+              slots[i] = Slot(hashes[bucket[i]], displacement);
+              ok = !used[slots[i]];
+              for(int j = 0; ok && j < i; ++j) ok = slots[j] != slots[i];
+            }
+            if (ok) break;
+          }
+          if (displacement == TableSize) throw "PerfectHash: duplicate keys or table too small";
+          mDisplacements[b] = (Displacement)displacement;
+          for(int i = 0; i < size; ++i)
+          {
+            used[slots[i]] = true;
+            mSlots[slots[i]] = (Index)(bucket[i] + 1);
+          }
+        }
+    }
+
+    /*!
+     * @brief Lookup a key
+     * @param key Key to lookup
+     * @return Key index, or -1 if the key is not in the table
+     */
+    [[nodiscard]] int Lookup(const char* key) const
+    {
+      unsigned long long hash = Hash(key);
+      int index = (int)mSlots[Slot(hash, mDisplacements[Bucket(hash)])] - 1;
+      if (index < 0 || strcmp(mKeys[index * mStride], key) != 0) return -1;
+      return index;
+    }
+
+    /*!
+     * @brief 64bit FNV-1a hash
+     * @param string String to hash
+     * @return Hash
+     */
+    static constexpr unsigned long long Hash(const char* string)
+    {
+      unsigned long long hash = 14695981039346656037ULL;
+      for(; *string != 0; ++string)
+      {
+        hash ^= (unsigned char)*string;
+        hash *= 1099511628211ULL;
+      }
+      return hash;
+    }
+
+  private:
+    //! Slot content type: key index + 1, 0 for empty slots
+    typedef std::conditional_t<(KeyCount < 0xFFFF), unsigned short, unsigned int> Index;
+    //! Displacement type
+    typedef std::conditional_t<(TableSize <= 0x10000), unsigned short, unsigned int> Displacement;
+
+    //! Keys
+    const char* const* mKeys;
+    //! Key stride
+    int mStride;
+    //! Displacement per bucket
+    Displacement mDisplacements[BucketCount];
+    //! Slots
+    Index mSlots[TableSize];
+
+    //! Get bucket from hash
+    static constexpr int Bucket(unsigned long long hash) { return (int)(hash & (BucketCount - 1)); }
+
+    //! Get slot from hash & displacement. Odd steps visit all slots of a power of 2 table
+    static constexpr int Slot(unsigned long long hash, int displacement)
+    {
+      unsigned int first = (unsigned int)(hash >> 32);
+      unsigned int step = (unsigned int)(hash >> 16) | 1;
+      return (int)((first + (unsigned int)displacement * step) & (TableSize - 1));
+    }
+};
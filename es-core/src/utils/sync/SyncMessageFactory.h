@@ -10,6 +10,7 @@
 #include <utils/sync/ISyncMessageReceiver.h>
 #include <utils/storage/Array.h>
 #include <utils/os/system/Mutex.h>
+#include <SDL_events.h>
 
 class SyncMessageFactory : public StaticLifeCycleControler<SyncMessageFactory>
 {
@@ -65,8 +66,11 @@ class SyncMessageFactory : public StaticLifeCycleControler<SyncMessageFactory>
       { LOG(LogDebug) << "[MessageFactory] Error unregistering identifier #" << identifier; }
     }
 
-    //! Dispatch all pending messages
-    void DispatchMessage()
+    /*!
+     * @brief Dispatch all pending messages
+     * @return True if at least one message has been dispatched
+     */
+    bool DispatchMessage()
     {
       // Copy pendings into a local list
       mPendingLocker.Lock();
@@ -86,10 +90,13 @@ class SyncMessageFactory : public StaticLifeCycleControler<SyncMessageFactory>
       }
 
       // Recycle
+      bool dispatched = !pending.Empty();
       {
         Mutex::AutoLock locker(mAvailableLocker);
         mAvailableMessages.MoveFrom(pending);
       }
+
+      return dispatched;
     }
 
   private:
@@ -146,14 +153,23 @@ class SyncMessageFactory : public StaticLifeCycleControler<SyncMessageFactory>
           return;
         }
       }
+      bool first = false;
       {
         Mutex::AutoLock locker(mPendingLocker);
         if (!mPendingMessages.Contains(message))
         {
           message->mIdentifier = identifier;
           mPendingMessages.Add(message);
+          first = mPendingMessages.Count() == 1;
         }
       }
+      // Wake up the main loop if it's waiting for events
+      if (first)
+      {
+        SDL_Event event {};
+        event.type = SDL_USEREVENT;
+        SDL_PushEvent(&event);
+      }
     }
 
     //! Allow sender to use private methods
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <systems/arcade/ArcadeFlatIndex.h>
+#include <utils/Files.h>
+#include <algorithm>
+#include <chrono>
+#include <set>
+
+static const String rootTest = "/tmp/googletests/";
+
+class ArcadeFlatIndexTest: public ::testing::Test
+{
+  protected:
+    //! Synthetic game count
+    static constexpr int sGameCount = 20000;
+    //! One clone line every n games
+    static constexpr int sCloneEvery = 4;
+
+    void SetUp() override
+    {
+      ASSERT_EQ(system(("mkdir -p " + rootTest + "index").c_str()), 0);
+
+      // Header, then one line per game and a clone line every few games, sharing the same zip name
+      String content("zip|name|manufacturer|year\n");
+      for(int i = 0; i < sGameCount; ++i)
+      {
+        String zip = String("game").Append(i);
+        content.Append(zip).Append("|Game ").Append(i).Append("|maker").Append(i % 97).Append("|19").Append(80 + i % 20).Append('\n');
+        if (i % sCloneEvery == 0)
+          content.Append(zip).Append("|Game ").Append(i).Append(" (clone)|maker").Append(i % 97).Append("|1999\n");
+      }
+      ASSERT_TRUE(Files::SaveFile(FlatFile(), content));
+
+      // Games available in rom folders: one out of 7, plus some unknown ones
+      for(int i = 0; i < sGameCount; i += 7) mAvailable.insert(String("game").Append(i));
+      for(int i = 0; i < 100; ++i) mAvailable.insert(String("missing").Append(i));
+    }
+
+    void TearDown() override
+    {
+      // Remove test set
+      ASSERT_EQ(system("rm -rf /tmp/googletests"), 0);
+    }
+
+    //! Flat database file
+    static Path FlatFile() { return Path(rootTest + "mame.lst"); }
+
+    //! Zip names of available games
+    std::set<String> mAvailable;
+
+    //! Whole-file load & scan, as ArcadeDatabaseManager used to do
+    String::List LinearLines() const
+    {
+      String::List lines = Files::LoadAllFileLines(FlatFile());
+      if (!lines.empty()) lines.erase(lines.begin()); // Remove header
+      String::List result;
+      for(int i = (int)lines.size(); --i >= 0; )
+        if (const String& line = lines[i]; !line.empty())
+          if (mAvailable.count(line.SubString(0, line.Find('|'))) != 0)
+            result.push_back(line);
+      return result;
+    }
+
+    //! Indexed lookups of available games, as ArcadeDatabaseManager does
+    String::List IndexedLines() const
+    {
+      ArcadeFlatIndex index(FlatFile(), Path(rootTest + "index"));
+      if (!index.Open()) return {};
+      std::vector<int> records;
+      for(const String& zip : mAvailable)
+        for(int record = index.Lookup(zip); record >= 0; record = index.Next(record))
+          records.push_back(record);
+      std::sort(records.begin(), records.end(), std::greater<int>());
+      String::List result;
+      for(int record : records)
+        result.push_back(index.Line(record));
+      return result;
+    }
+};
+
+TEST_F(ArcadeFlatIndexTest, TestLookup)
+{
+  ArcadeFlatIndex index(FlatFile(), Path(rootTest + "index"));
+  ASSERT_TRUE(index.Open());
+  ASSERT_EQ(index.Count(), sGameCount + (sGameCount + sCloneEvery - 1) / sCloneEvery);
+
+  // Parent then clone, in file order
+  int record = index.Lookup("game8");
+  ASSERT_GE(record, 0);
+  ASSERT_EQ(index.Line(record), "game8|Game 8|maker8|1988");
+  record = index.Next(record);
+  ASSERT_GE(record, 0);
+  ASSERT_EQ(index.Line(record), "game8|Game 8 (clone)|maker8|1999");
+  ASSERT_EQ(index.Next(record), -1);
+
+  // No clone
+  record = index.Lookup("game9");
+  ASSERT_GE(record, 0);
+  ASSERT_EQ(index.Next(record), -1);
+
+  // Missing & partial names
+  ASSERT_EQ(index.Lookup("game"), -1);
+  ASSERT_EQ(index.Lookup("game80000"), -1);
+  ASSERT_EQ(index.Lookup("zip"), -1);
+  ASSERT_EQ(index.Lookup(""), -1);
+}
+
+TEST_F(ArcadeFlatIndexTest, TestOutdatedIndex)
+{
+  {
+    ArcadeFlatIndex index(FlatFile(), Path(rootTest + "index"));
+    ASSERT_TRUE(index.Open());
+    ASSERT_EQ(index.Lookup("added"), -1);
+  }
+  String content = Files::LoadFile(FlatFile()).Append("added|Added|maker|2000\n");
+  ASSERT_TRUE(Files::SaveFile(FlatFile(), content));
+  ArcadeFlatIndex index(FlatFile(), Path(rootTest + "index"));
+  ASSERT_TRUE(index.Open());
+  ASSERT_GE(index.Lookup("added"), 0);
+}
+
+TEST_F(ArcadeFlatIndexTest, TestMatchesLinearScan)
+{
+  // Build the index image once, as the first load does
+  String::List indexed = IndexedLines();
+  String::List linear = LinearLines();
+  ASSERT_FALSE(linear.empty());
+  ASSERT_EQ(indexed, linear);
+
+  // Timed comparison of later loads, reported as test properties. Speed is not asserted: timings are up to the host
+  auto start = std::chrono::steady_clock::now();
+  linear = LinearLines();
+  auto scanned = std::chrono::steady_clock::now();
+  indexed = IndexedLines();
+  auto mapped = std::chrono::steady_clock::now();
+  ASSERT_EQ(indexed, linear);
+  RecordProperty("LinearScanUs", (int)std::chrono::duration_cast<std::chrono::microseconds>(scanned - start).count());
+  RecordProperty("MappedIndexUs", (int)std::chrono::duration_cast<std::chrono::microseconds>(mapped - scanned).count());
+}
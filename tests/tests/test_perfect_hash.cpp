@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <utils/storage/PerfectHash.h>
+#include <utils/String.h>
+#include <cstring>
+#include <chrono>
+
+//! Synthetic key table, built at compile time: "k0000", "k0001", ...
+template<int Count> struct SyntheticKeys
+{
+  char Storage[Count][8];
+  const char* Keys[Count];
+
+  constexpr SyntheticKeys()
+    : Storage()
+    , Keys()
+  {
+    for(int i = 0; i < Count; ++i)
+    {
+      Storage[i][0] = 'k';
+      for(int d = 4, v = i; d >= 1; --d, v /= 10) Storage[i][d] = (char)('0' + v % 10);
+      Storage[i][5] = 0;
+      Keys[i] = Storage[i];
+    }
+  }
+};
+
+static constexpr int sKeyCount = 4096;
+static constexpr SyntheticKeys<sKeyCount> sKeys;
+static constexpr PerfectHash<sKeyCount, 1024, 8192> sIndex(sKeys.Keys, 1);
+
+class PerfectHashTest: public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+    }
+
+    //! Runtime hash table + reverse linear scan, as GameNameMapManager used to do
+    static int LinearLookup(const int* hashes, const String& key)
+    {
+      int hash = key.Hash();
+      for(int i = sKeyCount; --i >= 0; )
+        if (hashes[i] == hash)
+          if (strcmp(key.c_str(), sKeys.Keys[i]) == 0)
+            return i;
+      return -1;
+    }
+};
+
+TEST_F(PerfectHashTest, TestLookup)
+{
+  for(int i = 0; i < sKeyCount; ++i)
+    ASSERT_EQ(sIndex.Lookup(sKeys.Keys[i]), i);
+  ASSERT_EQ(sIndex.Lookup(""), -1);
+  ASSERT_EQ(sIndex.Lookup("k"), -1);
+  ASSERT_EQ(sIndex.Lookup("k00000"), -1);
+  ASSERT_EQ(sIndex.Lookup("x0000"), -1);
+}
+
+TEST_F(PerfectHashTest, TestStrideLookup)
+{
+  static constexpr const char* const sPairs[] = { "instru_f", "Disk", "instru_e", "CD", "demo_uk", "Demo" };
+  static constexpr PerfectHash<3, 4, 16> sPairIndex(sPairs, 2);
+  ASSERT_EQ(sPairIndex.Lookup("instru_f"), 0);
+  ASSERT_EQ(sPairIndex.Lookup("instru_e"), 1);
+  ASSERT_EQ(sPairIndex.Lookup("demo_uk"), 2);
+  ASSERT_EQ(sPairIndex.Lookup("Disk"), -1);
+}
+
+TEST_F(PerfectHashTest, TestMatchesLinearScan)
+{
+  // Query set: all keys plus as many missing keys
+  String::List queries;
+  for(int i = 0; i < sKeyCount; ++i)
+  {
+    queries.push_back(sKeys.Keys[i]);
+    queries.push_back(String(sKeys.Keys[i]).Append('x'));
+  }
+
+  int hashes[sKeyCount];
+  for(int i = sKeyCount; --i >= 0; )
+    hashes[i] = String::Hash(sKeys.Keys[i]);
+  long long found = 0;
+  for(const String& query : queries)
+  {
+    int index = LinearLookup(hashes, query);
+    ASSERT_EQ(sIndex.Lookup(query.c_str()), index);
+    found += index >= 0 ? 1 : 0;
+  }
+  ASSERT_EQ(found, sKeyCount);
+
+  // Timed comparison, reported as test properties. Speed is not asserted: timings are up to the host
+  long long sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for(const String& query : queries) sink += LinearLookup(hashes, query);
+  auto linear = std::chrono::steady_clock::now();
+  for(const String& query : queries) sink -= sIndex.Lookup(query.c_str());
+  auto perfect = std::chrono::steady_clock::now();
+  ASSERT_EQ(sink, 0);
+  RecordProperty("LinearScanUs", (int)std::chrono::duration_cast<std::chrono::microseconds>(linear - start).count());
+  RecordProperty("PerfectHashUs", (int)std::chrono::duration_cast<std::chrono::microseconds>(perfect - linear).count());
+}
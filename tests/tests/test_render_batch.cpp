@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include <utils/gl/RenderBatch.h>
+#include <utils/gl/RenderState.h>
+
+class RenderBatchTest: public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+    }
+
+    //! Build a rectangle at the given position
+    static void Rectangle(Vertex vertices[], float x, float y, float w, float h)
+    {
+      vertices[0].Target.Set(x, y);
+      vertices[1].Target.Set(x, y + h);
+      vertices[2].Target.Set(x + w, y);
+      vertices[3].Target.Set(x + w, y);
+      vertices[4].Target.Set(x, y + h);
+      vertices[5].Target.Set(x + w, y + h);
+      for(int i = Vertex::sVertexPerRectangle; --i >= 0; ) vertices[i].Source.Set(0, 0);
+    }
+
+    static constexpr RenderBatch::Key sTextureA { 1, 0x302, 0x303, true, false };
+    static constexpr RenderBatch::Key sTextureB { 2, 0x302, 0x303, true, false };
+    static constexpr RenderBatch::Key sTextureATiled { 1, 0x302, 0x303, true, true };
+    static constexpr RenderBatch::Key sColored { 0, 0x302, 0x303, false, false };
+};
+
+TEST_F(RenderBatchTest, TestMergeSameKey)
+{
+  RenderBatch batch;
+  Vertex vertices[Vertex::sVertexPerRectangle];
+  Rectangle(vertices, 0, 0, 10, 10);
+
+  ASSERT_TRUE(batch.IsEmpty());
+  ASSERT_TRUE(batch.Accepts(sTextureA));
+  for(int i = 0; i < 100; ++i)
+  {
+    ASSERT_TRUE(batch.Accepts(sTextureA));
+    batch.Add(sTextureA, Transform4x4f::Identity(), vertices, nullptr, 0xFFFFFFFF, Vertex::sVertexPerRectangle);
+  }
+  ASSERT_EQ(batch.Count(), 100 * Vertex::sVertexPerRectangle);
+  ASSERT_TRUE(batch.BatchKey() == sTextureA);
+}
+
+TEST_F(RenderBatchTest, TestSplitOnKeyChange)
+{
+  RenderBatch batch;
+  Vertex vertices[Vertex::sVertexPerRectangle];
+  Rectangle(vertices, 0, 0, 10, 10);
+
+  batch.Add(sTextureA, Transform4x4f::Identity(), vertices, nullptr, 0xFFFFFFFF, Vertex::sVertexPerRectangle);
+  ASSERT_FALSE(batch.Accepts(sTextureB));
+  ASSERT_FALSE(batch.Accepts(sTextureATiled));
+  ASSERT_FALSE(batch.Accepts(sColored));
+
+  // Flushed batch accepts anything
+  batch.Clear();
+  ASSERT_TRUE(batch.IsEmpty());
+  ASSERT_TRUE(batch.Accepts(sColored));
+  batch.Add(sColored, Transform4x4f::Identity(), vertices, nullptr, 0xFFFFFFFF, Vertex::sVertexPerRectangle);
+  ASSERT_TRUE(batch.BatchKey() == sColored);
+}
+
+TEST_F(RenderBatchTest, TestTransform)
+{
+  RenderBatch batch;
+  Vertex vertices[Vertex::sVertexPerRectangle];
+  Rectangle(vertices, 0, 0, 10, 20);
+
+  // Same rectangle drawn with two matrices: both end up in screen coordinates
+  Transform4x4f matrix = Transform4x4f::Identity();
+  batch.Add(sColored, matrix, vertices, nullptr, 0xFFFFFFFF, Vertex::sVertexPerRectangle);
+  matrix.r3().x() = 100;
+  matrix.r3().y() = 50;
+  batch.Add(sColored, matrix, vertices, nullptr, 0xFFFFFFFF, Vertex::sVertexPerRectangle);
+
+  const Vertex* result = batch.VertexArray();
+  ASSERT_FLOAT_EQ(result[5].Target.X, 10);
+  ASSERT_FLOAT_EQ(result[5].Target.Y, 20);
+  ASSERT_FLOAT_EQ(result[6 + 0].Target.X, 100);
+  ASSERT_FLOAT_EQ(result[6 + 0].Target.Y, 50);
+  ASSERT_FLOAT_EQ(result[6 + 5].Target.X, 110);
+  ASSERT_FLOAT_EQ(result[6 + 5].Target.Y, 70);
+}
+
+TEST_F(RenderBatchTest, TestColors)
+{
+  RenderBatch batch;
+  Vertex vertices[Vertex::sVertexPerRectangle];
+  Rectangle(vertices, 0, 0, 10, 10);
+
+  unsigned char colors[Vertex::sVertexPerRectangle * 4];
+  for(int i = (int)sizeof(colors); --i >= 0; ) colors[i] = (unsigned char)i;
+  batch.Add(sColored, Transform4x4f::Identity(), vertices, nullptr, 0x11223344, Vertex::sVertexPerRectangle);
+  batch.Add(sColored, Transform4x4f::Identity(), vertices, colors, 0, Vertex::sVertexPerRectangle);
+
+  const unsigned char* result = batch.ColorArray();
+  for(int i = 0; i < Vertex::sVertexPerRectangle; ++i)
+  {
+    ASSERT_EQ(result[i * 4 + 0], 0x11);
+    ASSERT_EQ(result[i * 4 + 1], 0x22);
+    ASSERT_EQ(result[i * 4 + 2], 0x33);
+    ASSERT_EQ(result[i * 4 + 3], 0x44);
+  }
+  ASSERT_EQ(memcmp(result + sizeof(colors), colors, sizeof(colors)), 0);
+}
+
+TEST_F(RenderBatchTest, TestStateCache)
+{
+  RenderState state {};
+  state.Reset();
+
+  // Redundant changes are skipped
+  ASSERT_TRUE(state.SetTexture(1));
+  ASSERT_FALSE(state.SetTexture(1));
+  ASSERT_TRUE(state.SetTexture(2));
+  ASSERT_TRUE(state.SetBlending(0x302, 0x303));
+  ASSERT_FALSE(state.SetBlending(0x302, 0x303));
+  ASSERT_TRUE(state.SetBlending(0x302, 0x301));
+  ASSERT_TRUE(RenderState::Set(state.Blending, true));
+  ASSERT_FALSE(RenderState::Set(state.Blending, true));
+  ASSERT_TRUE(RenderState::Set(state.Blending, false));
+
+  // Deleting the bound texture reverts the binding to 0, deleting another one does not
+  state.TextureDeleted(1);
+  ASSERT_EQ(state.Texture, 2u);
+  state.TextureDeleted(2);
+  ASSERT_EQ(state.Texture, 0u);
+  ASSERT_TRUE(state.SetTexture(2));
+
+  // Direct drawing: bindings must be set again, capabilities are kept
+  ASSERT_TRUE(RenderState::Set(state.Texturing, true));
+  state.IdentityLoaded = true;
+  state.InvalidateBindings();
+  ASSERT_EQ(state.Texture, RenderState::sUnknown);
+  ASSERT_FALSE(state.IdentityLoaded);
+  ASSERT_TRUE(state.SetTexture(2));
+  ASSERT_TRUE(state.SetBlending(0x302, 0x301));
+  ASSERT_FALSE(RenderState::Set(state.Texturing, true));
+}
+
+TEST_F(RenderBatchTest, TestDrawCallReduction)
+{
+  // Interleaved draws of two textures: one draw call per key change, none per draw
+  RenderBatch batch;
+  Vertex vertices[Vertex::sVertexPerRectangle];
+  Rectangle(vertices, 0, 0, 10, 10);
+
+  int drawCalls = 0;
+  const RenderBatch::Key* sequence[] = { &sTextureA, &sTextureA, &sTextureA, &sTextureB, &sTextureB, &sTextureA, &sColored, &sColored };
+  for(const RenderBatch::Key* key : sequence)
+  {
+    if (!batch.Accepts(*key)) { batch.Clear(); drawCalls++; }
+    batch.Add(*key, Transform4x4f::Identity(), vertices, nullptr, 0xFFFFFFFF, Vertex::sVertexPerRectangle);
+  }
+  if (!batch.IsEmpty()) { batch.Clear(); drawCalls++; }
+  ASSERT_EQ(drawCalls, 4);
+}